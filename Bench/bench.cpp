@@ -0,0 +1,1125 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "KtxBitWriter.hpp"
+#include "KtxDecoder.hpp"
+#include "KtxDfd.hpp"
+#include "KtxFormat.hpp"
+#include "KtxMipmap.hpp"
+#include "KtxTranscoder.hpp"
+#include "KtxUtility.hpp"
+#include "KtxWriter.hpp"
+
+#if defined(KTX_WITH_ZSTD)
+#include <zstd.h>
+#endif
+
+#if defined(KTX_WITH_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using KTX::Test::BitWriter;
+    using KTX::Test::PutFlatHuffmanTable;
+
+    // Writes an uncompressed RGBA8 ktx2 file with a full mip chain, enough for the loader to do real work
+    void WriteSyntheticKtx2(const std::filesystem::path& path, const KTX::u32 size)
+    {
+        constexpr KTX::u8 identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+        KTX::u32 levelCount = 1;
+        while ((size >> levelCount) > 0)
+        {
+            ++levelCount;
+        }
+
+        std::vector<KTX::KtxLevelIndexEntry> levelIndex(levelCount);
+        KTX::u64 offset = 80 + levelCount * sizeof(KTX::KtxLevelIndexEntry);
+        for (KTX::u32 level = levelCount; level-- > 0;)
+        {
+            const KTX::u64 extent = std::max(size >> level, 1u);
+            levelIndex[level] = {offset, extent * extent * 4, extent * extent * 4};
+            offset += extent * extent * 4;
+        }
+
+        const KTX::u32 fields[9] = {37, 1, size, size, 0, 0, 1, levelCount, 0};
+        const KTX::u32 indices[4] = {};
+        const KTX::u64 globalData[2] = {};
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(identifier), sizeof(identifier));
+        file.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+        file.write(reinterpret_cast<const char*>(indices), sizeof(indices));
+        file.write(reinterpret_cast<const char*>(globalData), sizeof(globalData));
+        file.write(reinterpret_cast<const char*>(levelIndex.data()), levelIndex.size() * sizeof(levelIndex[0]));
+        const std::vector<char> pixels(offset - file.tellp(), 0x7F);
+        file.write(pixels.data(), static_cast<std::streamsize>(pixels.size()));
+    }
+
+    // 4x4 RGBA8 ktx header with a full mip chain and no key/value data
+    std::array<KTX::u8, 64> MakeKtx1Header(const bool bigEndian)
+    {
+        constexpr KTX::u8 identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+        KTX::u32 fields[13] = {0x04030201, 0x1401, 1, 0x1908, 0x8058, 0x1908, 4, 4, 0, 0, 1, 3, 0};
+        if (bigEndian)
+        {
+            for (auto& field : fields)
+            {
+                field = (field << 24) | ((field & 0xFF00) << 8) | ((field & 0xFF0000) >> 8) | (field >> 24);
+            }
+        }
+
+        std::array<KTX::u8, 64> header{};
+        std::memcpy(header.data(), identifier, sizeof(identifier));
+        std::memcpy(header.data() + sizeof(identifier), fields, sizeof(fields));
+        return header;
+    }
+
+    std::vector<std::string> CreateSyntheticLibrary(const KTX::u32 fileCount, const KTX::u32 size)
+    {
+        const auto directory = std::filesystem::temp_directory_path() / "KtxBench";
+        std::filesystem::create_directories(directory);
+
+        std::vector<std::string> fileNames;
+        fileNames.reserve(fileCount);
+        for (KTX::u32 i = 0; i < fileCount; ++i)
+        {
+            auto path = directory / ("texture_" + std::to_string(size) + "_" + std::to_string(i) + ".ktx2");
+            if (!std::filesystem::exists(path))
+            {
+                WriteSyntheticKtx2(path, size);
+            }
+            fileNames.emplace_back(path.string());
+        }
+        return fileNames;
+    }
+
+    void BenchBatchLoad()
+    {
+        constexpr KTX::u32 fileCount = 2000;
+        const auto fileNames = CreateSyntheticLibrary(fileCount, 64);
+
+        std::cout << "Batch load, " << fileCount << " files\n";
+        const KTX::u32 maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        for (KTX::u32 threads = 1;; threads = std::min(threads * 2, maxThreads))
+        {
+            KTX::KtxThreadPool pool(threads);
+            const auto start = Clock::now();
+            auto results = KTX::LoadKTXBatch(pool, fileNames, KTX::KtxCreateFlags::eLoadImageData);
+            size_t failed = 0;
+            for (auto& result : results)
+            {
+                failed += !result.get().has_value();
+            }
+            const std::chrono::duration<double> elapsed = Clock::now() - start;
+            std::cout << "  " << threads << " threads: " << fileCount / elapsed.count() << " files/s";
+            if (failed > 0)
+            {
+                std::cout << " (" << failed << " failed)";
+            }
+            std::cout << '\n';
+
+            if (threads == maxThreads)
+            {
+                break;
+            }
+        }
+    }
+
+    void BenchHeaderDecode()
+    {
+        constexpr KTX::u32 iterations = 2'000'000;
+        const auto headerPath = std::filesystem::temp_directory_path() / "KtxBench" / "header.ktx2";
+        std::filesystem::create_directories(headerPath.parent_path());
+        WriteSyntheticKtx2(headerPath, 64);
+        std::array<KTX::u8, 80> ktx2Header{};
+        std::ifstream(headerPath, std::ios::binary).read(reinterpret_cast<char*>(ktx2Header.data()), ktx2Header.size());
+
+        const auto ktx1Header = MakeKtx1Header(false);
+        const auto ktx1SwappedHeader = MakeKtx1Header(true);
+        const std::pair<const char*, std::span<const KTX::u8>> headers[] = {
+                {"ktx", ktx1Header},
+                {"ktx big endian", ktx1SwappedHeader},
+                {"ktx2", ktx2Header},
+        };
+
+        std::cout << "Header decode, " << iterations << " iterations\n";
+        for (const auto& [name, data] : headers)
+        {
+            KTX::u64 checksum = 0;
+            const auto start = Clock::now();
+            for (KTX::u32 i = 0; i < iterations; ++i)
+            {
+                const auto info = KTX::DecodeKTXHeader(data);
+                checksum += info ? info->baseWidth + info->numLevels : 0;
+            }
+            const std::chrono::duration<double> elapsed = Clock::now() - start;
+            std::cout << "  " << name << ": " << iterations / elapsed.count() / 1e6 << " M headers/s (checksum "
+                      << checksum << ")\n";
+        }
+    }
+
+    void BenchProbe()
+    {
+        constexpr KTX::u32 fileCount = 2000;
+        const auto fileNames = CreateSyntheticLibrary(fileCount, 64);
+
+        // Warm the page cache so only the per file cost is measured
+        for (const auto& fileName : fileNames)
+        {
+            (void)KTX::ProbeKTXFromFile(fileName);
+        }
+
+        std::cout << "Probe, " << fileCount << " files\n";
+        const auto measure = [&](const char* name, auto&& probe)
+        {
+            size_t failed = 0;
+            const auto start = Clock::now();
+            for (const auto& fileName : fileNames)
+            {
+                failed += !probe(fileName);
+            }
+            const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+            std::cout << "  " << name << ": " << elapsed.count() / fileCount << " us/file";
+            if (failed > 0)
+            {
+                std::cout << " (" << failed << " failed)";
+            }
+            std::cout << '\n';
+        };
+
+        measure("LoadKTXFromFile",
+                [](const std::string& fileName) { return KTX::LoadKTXFromFile(fileName).has_value(); });
+        measure("ProbeKTXFromFile",
+                [](const std::string& fileName) { return KTX::ProbeKTXFromFile(fileName).has_value(); });
+    }
+
+    void BenchFormatLookup()
+    {
+        constexpr KTX::u32 lookups = 1u << 24;
+        const auto measure = [&](const char* name, const auto& descriptors, auto&& getFormat, auto&& lookup)
+        {
+            // Random order so the branch predictor can't learn the sequence, like probing a mixed library
+            std::vector<KTX::u32> formats(4096);
+            std::mt19937 random(42);
+            for (auto& format : formats)
+            {
+                format = getFormat(descriptors[random() % descriptors.size()]);
+            }
+
+            KTX::u64 checksum = 0;
+            const auto start = Clock::now();
+            for (KTX::u32 i = 0; i < lookups; ++i)
+            {
+                checksum += lookup(formats[i % formats.size()]).blockSize;
+            }
+            const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+            std::cout << name << " format lookup: " << elapsed.count() / lookups << " ns/lookup (checksum " << checksum
+                      << ")\n";
+        };
+
+        measure("GL", KTX::Detail::glFormatDescriptors, [](const auto& row) { return row.glInternalFormat; },
+                KTX::GetGlFormatSize);
+        measure("Vk", KTX::Detail::vkFormatDescriptors,
+                [](const auto& row) { return static_cast<KTX::u32>(row.vkFormat); }, KTX::GetVkFormatSize);
+    }
+
+    // Parsing a DFD on every open against looking it up in the interned cache, for the DFDs of a mixed library
+    void BenchDescriptors()
+    {
+        constexpr KTX::u32 lookups = 1u << 20;
+        using enum KTX::KtxUtility_VkFormat;
+        std::vector<std::vector<KTX::u8>> descriptors;
+        for (const auto format : {VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_R16G16B16A16_SFLOAT, VK_FORMAT_BC7_SRGB_BLOCK,
+                                  VK_FORMAT_ASTC_4x4_UNORM_BLOCK})
+        {
+            KTX::KtxTextureInfo info{};
+            info.vkFormat = static_cast<KTX::u32>(format);
+            info.formatSize = KTX::GetVkFormatSize(info.vkFormat);
+            info.typeSize = 1;
+            info.baseWidth = 4;
+            info.baseHeight = 4;
+            info.baseDepth = 1;
+            info.numDimensions = 2;
+            info.numLevels = 1;
+            info.numLayers = 1;
+            info.numFaces = 1;
+            const std::vector<KTX::u8> level(16 * info.formatSize.blockSize / 8 /
+                                             (info.formatSize.blockWidth * info.formatSize.blockHeight));
+            const std::span<const KTX::u8> levels[] = {level};
+            const auto fileData = KTX::WriteKTX2ToMemory({.info = info, .levels = levels});
+            const auto texture = fileData ? KTX::LoadKTXFromMemory(*fileData) : std::unexpected(fileData.error());
+            if (texture)
+            {
+                const auto dfd = texture->GetDataFormatDescriptor();
+                descriptors.emplace_back(dfd.begin(), dfd.end());
+            }
+        }
+
+        std::vector<KTX::u32> order(4096);
+        std::mt19937 random(7);
+        for (auto& index : order)
+        {
+            index = random() % descriptors.size();
+        }
+        const auto measure = [&](const char* name, auto&& parse)
+        {
+            KTX::u64 checksum = 0;
+            const auto start = Clock::now();
+            for (KTX::u32 i = 0; i < lookups; ++i)
+            {
+                checksum += parse(descriptors[order[i % order.size()]]);
+            }
+            const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+            std::cout << "  " << name << ": " << elapsed.count() / lookups << " ns/descriptor (checksum " << checksum
+                      << ")\n";
+        };
+
+        std::cout << "DFD parse, " << descriptors.size() << " distinct descriptors\n";
+        measure("parse",
+                [](const auto& dfd)
+                {
+                    const auto descriptor = KTX::ParseDataFormatDescriptor(dfd);
+                    return descriptor ? descriptor->samples.size() : 0;
+                });
+        measure("interned",
+                [](const auto& dfd)
+                {
+                    const auto* descriptor = KTX::InternDataFormatDescriptor(dfd);
+                    return descriptor ? descriptor->samples.size() : 0;
+                });
+    }
+
+    void BenchBulkLoad()
+    {
+        constexpr KTX::u32 fileCount = 2000;
+        const auto fileNames = CreateSyntheticLibrary(fileCount, 64);
+
+        std::cout << "Bulk load, " << fileCount << " files\n";
+        const auto measure = [&](const char* name, auto&& load)
+        {
+            const auto start = Clock::now();
+            const size_t failed = load();
+            const std::chrono::duration<double> elapsed = Clock::now() - start;
+            std::cout << "  " << name << ": " << fileCount / elapsed.count() << " files/s";
+            if (failed > 0)
+            {
+                std::cout << " (" << failed << " failed)";
+            }
+            std::cout << '\n';
+        };
+
+        measure("LoadKTXFromFile",
+                [&]
+                {
+                    // Keep every texture alive like LoadKTXBulk does, otherwise the allocator recycles one buffer
+                    std::vector<KTX::KtxLoadResult> results;
+                    results.reserve(fileNames.size());
+                    size_t failed = 0;
+                    for (const auto& fileName : fileNames)
+                    {
+                        results.emplace_back(KTX::LoadKTXFromFile(fileName, KTX::KtxCreateFlags::eLoadImageData));
+                        failed += !results.back().has_value();
+                    }
+                    return failed;
+                });
+        measure("LoadKTXBulk",
+                [&]
+                {
+                    size_t failed = 0;
+                    for (const auto& result : KTX::LoadKTXBulk(fileNames, KTX::KtxCreateFlags::eLoadImageData))
+                    {
+                        failed += !result.has_value();
+                    }
+                    return failed;
+                });
+    }
+
+    // BasisLZ ktx2 file with a full mip chain. Every block picks a random endpoint and selector out of the codebooks,
+    // which is the worst case for the transcoder's caches. The alpha slices reuse the color slices.
+    std::vector<KTX::u8> MakeBasisLZKtx2(const KTX::u32 size, const bool hasAlpha)
+    {
+        constexpr KTX::u32 endpointCount = 512;
+        constexpr KTX::u32 selectorCount = 512;
+        constexpr KTX::u32 codebookBits = 9;
+        constexpr KTX::u8 identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+        KTX::u32 levelCount = 1;
+        while ((size >> levelCount) > 0)
+        {
+            ++levelCount;
+        }
+        std::mt19937 random(11);
+
+        BitWriter endpoints;
+        for (KTX::u32 model = 0; model < 3; ++model)
+        {
+            PutFlatHuffmanTable(endpoints, 32, 5);
+        }
+        PutFlatHuffmanTable(endpoints, 8, 3);
+        endpoints.Put(0, 1);
+        for (KTX::u32 i = 0; i < endpointCount; ++i)
+        {
+            endpoints.PutCode(random() % 8, 3);
+            for (KTX::u32 channel = 0; channel < 3; ++channel)
+            {
+                endpoints.PutCode(random() % 32, 5);
+            }
+        }
+
+        BitWriter selectors;
+        selectors.Put(0b100, 3);
+        for (KTX::u32 i = 0; i < selectorCount * 4; ++i)
+        {
+            selectors.Put(random() % 256, 8);
+        }
+
+        // Every 2x2 group predicts its endpoints as deltas from the previous block, no selector history
+        BitWriter tables;
+        PutFlatHuffmanTable(tables, 257, 9);
+        PutFlatHuffmanTable(tables, endpointCount, codebookBits);
+        PutFlatHuffmanTable(tables, selectorCount + 1, codebookBits + 1);
+        PutFlatHuffmanTable(tables, 64, 6);
+        tables.Put(0, 13);
+
+        std::vector<std::vector<KTX::u8>> levels(levelCount);
+        std::vector<KTX::u32> imageDescs;
+        for (KTX::u32 level = 0; level < levelCount; ++level)
+        {
+            const KTX::u32 blocks = (std::max(size >> level, 1u) + 3) / 4;
+            BitWriter slice;
+            for (KTX::u32 block = 0; block < blocks * blocks; ++block)
+            {
+                if (block / blocks % 2 == 0 && block % blocks % 2 == 0)
+                {
+                    slice.PutCode(0xFF, 9);
+                }
+                slice.PutCode(random() % endpointCount, codebookBits);
+                slice.PutCode(random() % selectorCount, codebookBits + 1);
+            }
+            levels[level] = std::move(slice.bytes);
+            const auto sliceLength = static_cast<KTX::u32>(levels[level].size());
+            imageDescs.insert(imageDescs.end(), {0, 0, sliceLength, 0, hasAlpha ? sliceLength : 0});
+        }
+
+        const KTX::u32 globalHeader[4] = {endpointCount | selectorCount << 16,
+                                          static_cast<KTX::u32>(endpoints.bytes.size()),
+                                          static_cast<KTX::u32>(selectors.bytes.size()),
+                                          static_cast<KTX::u32>(tables.bytes.size())};
+        std::vector<KTX::u8> globalData(sizeof(globalHeader) + sizeof(KTX::u32));
+        std::memcpy(globalData.data(), globalHeader, sizeof(globalHeader));
+        const auto* descs = reinterpret_cast<const KTX::u8*>(imageDescs.data());
+        globalData.insert(globalData.end(), descs, descs + imageDescs.size() * sizeof(KTX::u32));
+        for (const auto* part : {&endpoints.bytes, &selectors.bytes, &tables.bytes})
+        {
+            globalData.insert(globalData.end(), part->begin(), part->end());
+        }
+
+        const KTX::u64 globalDataOffset = 80 + levelCount * sizeof(KTX::KtxLevelIndexEntry);
+        KTX::u64 offset = globalDataOffset + globalData.size();
+        std::vector<KTX::KtxLevelIndexEntry> levelIndex(levelCount);
+        for (KTX::u32 level = levelCount; level-- > 0;)
+        {
+            levelIndex[level] = {offset, levels[level].size(), 0};
+            offset += levels[level].size();
+        }
+
+        const KTX::u32 fields[9] = {0, 1, size, size, 0, 0, 1, levelCount,
+                                    static_cast<KTX::u32>(KTX::KtxSupercompressionScheme::eBasisLZ)};
+        const KTX::u32 indices[4] = {};
+        const KTX::u64 globalDataIndex[2] = {globalDataOffset, globalData.size()};
+        std::vector<KTX::u8> file(80);
+        std::memcpy(file.data(), identifier, sizeof(identifier));
+        std::memcpy(file.data() + 12, fields, sizeof(fields));
+        std::memcpy(file.data() + 48, indices, sizeof(indices));
+        std::memcpy(file.data() + 64, globalDataIndex, sizeof(globalDataIndex));
+        const auto* index = reinterpret_cast<const KTX::u8*>(levelIndex.data());
+        file.insert(file.end(), index, index + levelIndex.size() * sizeof(KTX::KtxLevelIndexEntry));
+        file.insert(file.end(), globalData.begin(), globalData.end());
+        for (KTX::u32 level = levelCount; level-- > 0;)
+        {
+            file.insert(file.end(), levels[level].begin(), levels[level].end());
+        }
+        return file;
+    }
+
+    void BenchTranscode()
+    {
+        constexpr KTX::u32 size = 2048;
+        constexpr KTX::u32 iterations = 4;
+        const auto file = MakeBasisLZKtx2(size, true);
+        auto texture = KTX::LoadKTXFromMemory(file, KTX::KtxCreateFlags::eLoadImageData);
+        if (!texture)
+        {
+            std::cout << "Transcode: " << KTX::ToString(texture.error()) << '\n';
+            return;
+        }
+
+        const auto codebookStart = Clock::now();
+        const auto transcoder = KTX::KtxTranscoder::Create(*texture);
+        const std::chrono::duration<double, std::micro> codebookElapsed = Clock::now() - codebookStart;
+        if (!transcoder)
+        {
+            std::cout << "Transcode: " << KTX::ToString(transcoder.error()) << '\n';
+            return;
+        }
+
+        const KTX::u64 pixelCount = static_cast<KTX::u64>(size) * size * 4 / 3;
+        std::cout << "Transcode, " << size << "x" << size << " ETC1S with alpha and " << texture->GetInfo().numLevels
+                  << " levels, codebooks decoded in " << codebookElapsed.count() << " us\n";
+        const std::pair<const char*, KTX::KtxTranscodeTarget> targets[] = {
+                {"RGBA8", KTX::KtxTranscodeTarget::eRGBA8}, {"BC1", KTX::KtxTranscodeTarget::eBC1},
+                {"BC3", KTX::KtxTranscodeTarget::eBC3},     {"BC4", KTX::KtxTranscodeTarget::eBC4},
+                {"BC5", KTX::KtxTranscodeTarget::eBC5},     {"BC7", KTX::KtxTranscodeTarget::eBC7},
+                {"ETC2 RGB", KTX::KtxTranscodeTarget::eETC2RGB}, {"ETC2 RGBA", KTX::KtxTranscodeTarget::eETC2RGBA},
+                {"ASTC 4x4", KTX::KtxTranscodeTarget::eASTC4x4},
+        };
+        const KTX::u32 maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        for (const auto& [name, target] : targets)
+        {
+            // Level 0 on the calling thread, then the whole texture on the pool
+            std::vector<KTX::u8> destination(transcoder->GetTranscodedLevelSize(0, target));
+            bool succeeded = transcoder->TranscodeLevel(0, texture->GetLevel(0), target, destination) ==
+                             KTX::KtxResult::eSuccess;
+            auto start = Clock::now();
+            for (KTX::u32 i = 0; i < iterations; ++i)
+            {
+                succeeded &= transcoder->TranscodeLevel(0, texture->GetLevel(0), target, destination) ==
+                             KTX::KtxResult::eSuccess;
+            }
+            const std::chrono::duration<double> levelElapsed = Clock::now() - start;
+
+            KTX::KtxThreadPool pool(maxThreads);
+            start = Clock::now();
+            for (KTX::u32 i = 0; i < iterations; ++i)
+            {
+                succeeded &= transcoder->Transcode(pool, *texture, target).has_value();
+            }
+            const std::chrono::duration<double> textureElapsed = Clock::now() - start;
+
+            std::cout << "  " << name << ": " << iterations * size * size / levelElapsed.count() / 1e6
+                      << " Mpixels/s on 1 thread, " << iterations * pixelCount / textureElapsed.count() / 1e6
+                      << " Mpixels/s on " << maxThreads << " threads";
+            if (!succeeded)
+            {
+                std::cout << " (failed)";
+            }
+            std::cout << '\n';
+        }
+    }
+
+    // Layout of a UASTC mode, enough to write valid blocks with random contents
+    struct UastcMode
+    {
+        KTX::u8 code;
+        KTX::u8 codeLength;
+        KTX::u8 hintBits;
+        KTX::u8 patternCount;
+        KTX::u8 ccsBits;
+        KTX::u8 endpointCount;
+        KTX::u8 endpointBits;
+        KTX::u8 endpointTrits;
+        KTX::u8 endpointQuints;
+    };
+
+    // Modes 0 to 18, mode 8 (solid color) is followed by 32 bits of color that need no layout
+    constexpr std::array<UastcMode, 19> uastcModes = {{
+            {0x01, 4, 15, 0, 0, 6, 6, 1, 0},   {0x35, 6, 15, 0, 0, 6, 8, 0, 0},   {0x1D, 5, 15, 30, 0, 12, 4, 0, 0},
+            {0x03, 5, 15, 11, 0, 18, 2, 1, 0}, {0x13, 5, 15, 30, 0, 12, 3, 0, 1}, {0x0B, 5, 15, 0, 0, 6, 8, 0, 0},
+            {0x1B, 5, 15, 0, 2, 6, 5, 0, 1},   {0x07, 5, 15, 19, 0, 12, 3, 0, 1}, {0x17, 5, 0, 0, 0, 0, 0, 0, 0},
+            {0x0F, 5, 23, 30, 0, 16, 4, 0, 0}, {0x02, 3, 17, 0, 0, 8, 4, 1, 0},   {0x00, 2, 17, 0, 2, 8, 4, 1, 0},
+            {0x06, 3, 17, 0, 0, 8, 6, 1, 0},   {0x1F, 5, 23, 0, 2, 8, 8, 0, 0},   {0x0D, 5, 23, 0, 0, 4, 8, 0, 0},
+            {0x05, 7, 23, 0, 0, 4, 8, 0, 0},   {0x15, 6, 23, 30, 0, 8, 8, 0, 0},  {0x25, 6, 23, 0, 0, 4, 8, 0, 0},
+            {0x09, 4, 15, 0, 0, 6, 5, 0, 0},
+    }};
+
+    // UASTC ktx2 file with a full mip chain. Every block takes a random mode, pattern and endpoints, the rest of the
+    // block (weights) is random bits.
+    std::vector<KTX::u8> MakeUastcKtx2(const KTX::u32 size)
+    {
+        constexpr KTX::u8 identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+        KTX::u32 levelCount = 1;
+        while ((size >> levelCount) > 0)
+        {
+            ++levelCount;
+        }
+        std::mt19937 random(17);
+
+        const auto makeBlock = [&]
+        {
+            const auto& mode = uastcModes[random() % uastcModes.size()];
+            BitWriter writer;
+            writer.Put(mode.code, mode.codeLength);
+            writer.Put(random(), mode.hintBits);
+            if (mode.patternCount > 0)
+            {
+                writer.Put(random() % mode.patternCount, std::bit_width(mode.patternCount - 1u));
+            }
+            writer.Put(random(), mode.ccsBits);
+
+            // Trit and quint bundles first, then the low bits of every endpoint value
+            const KTX::u32 base = mode.endpointTrits ? 3 : 5;
+            const KTX::u32 bundleSize = mode.endpointTrits ? 5 : 3;
+            constexpr std::array<KTX::u8, 6> tritBundleBits = {0, 2, 4, 5, 7, 8};
+            constexpr std::array<KTX::u8, 4> quintBundleBits = {0, 3, 5, 7};
+            for (KTX::u32 first = 0; (mode.endpointTrits || mode.endpointQuints) && first < mode.endpointCount;
+                 first += bundleSize)
+            {
+                const KTX::u32 count = std::min<KTX::u32>(mode.endpointCount - first, bundleSize);
+                KTX::u32 bundle = 0;
+                for (KTX::u32 k = 0; k < count; ++k)
+                {
+                    bundle = bundle * base + random() % base;
+                }
+                writer.Put(bundle, mode.endpointTrits ? tritBundleBits[count] : quintBundleBits[count]);
+            }
+            for (KTX::u32 value = 0; value < mode.endpointCount; ++value)
+            {
+                writer.Put(random(), mode.endpointBits);
+            }
+            while (writer.position < 128)
+            {
+                writer.Put(random(), std::min(128 - writer.position, 16u));
+            }
+            return writer.bytes;
+        };
+
+        std::vector<std::vector<KTX::u8>> levels(levelCount);
+        for (KTX::u32 level = 0; level < levelCount; ++level)
+        {
+            const KTX::u32 blocks = (std::max(size >> level, 1u) + 3) / 4;
+            for (KTX::u32 block = 0; block < blocks * blocks; ++block)
+            {
+                const auto bytes = makeBlock();
+                levels[level].insert(levels[level].end(), bytes.begin(), bytes.end());
+            }
+        }
+
+        // Basic descriptor block with one RGBA sample of the UASTC color model
+        constexpr KTX::u32 dfdSize = 44;
+        const KTX::u32 dfd[dfdSize / 4] = {dfdSize, 0, 2 | 40 << 16, 166 | 1 << 8 | 1 << 16, 3 | 3 << 8, 16, 0,
+                                           127 << 16 | 3u << 24, 0, 0, 0xFFFFFFFF};
+        const KTX::u64 dfdOffset = 80 + levelCount * sizeof(KTX::KtxLevelIndexEntry);
+        KTX::u64 offset = dfdOffset + dfdSize;
+        std::vector<KTX::KtxLevelIndexEntry> levelIndex(levelCount);
+        for (KTX::u32 level = levelCount; level-- > 0;)
+        {
+            levelIndex[level] = {offset, levels[level].size(), levels[level].size()};
+            offset += levels[level].size();
+        }
+
+        const KTX::u32 fields[9] = {0, 1, size, size, 0, 0, 1, levelCount, 0};
+        const KTX::u32 indices[4] = {static_cast<KTX::u32>(dfdOffset), dfdSize};
+        const KTX::u64 globalDataIndex[2] = {};
+        std::vector<KTX::u8> file(80);
+        std::memcpy(file.data(), identifier, sizeof(identifier));
+        std::memcpy(file.data() + 12, fields, sizeof(fields));
+        std::memcpy(file.data() + 48, indices, sizeof(indices));
+        std::memcpy(file.data() + 64, globalDataIndex, sizeof(globalDataIndex));
+        const auto* index = reinterpret_cast<const KTX::u8*>(levelIndex.data());
+        file.insert(file.end(), index, index + levelIndex.size() * sizeof(KTX::KtxLevelIndexEntry));
+        const auto* descriptor = reinterpret_cast<const KTX::u8*>(dfd);
+        file.insert(file.end(), descriptor, descriptor + dfdSize);
+        for (KTX::u32 level = levelCount; level-- > 0;)
+        {
+            file.insert(file.end(), levels[level].begin(), levels[level].end());
+        }
+        return file;
+    }
+
+    void BenchUastcTranscode()
+    {
+        constexpr KTX::u32 size = 2048;
+        constexpr KTX::u32 iterations = 4;
+        const auto file = MakeUastcKtx2(size);
+        auto texture = KTX::LoadKTXFromMemory(file, KTX::KtxCreateFlags::eLoadImageData);
+        if (!texture)
+        {
+            std::cout << "UASTC transcode: " << KTX::ToString(texture.error()) << '\n';
+            return;
+        }
+        const auto transcoder = KTX::KtxTranscoder::Create(*texture);
+        if (!transcoder)
+        {
+            std::cout << "UASTC transcode: " << KTX::ToString(transcoder.error()) << '\n';
+            return;
+        }
+
+        const KTX::u64 levelBlocks = static_cast<KTX::u64>(size / 4) * (size / 4);
+        const KTX::u64 textureBlocks = levelBlocks * 4 / 3;
+        std::cout << "UASTC transcode, " << size << "x" << size << " random blocks of every mode and "
+                  << texture->GetInfo().numLevels << " levels\n";
+        const std::pair<const char*, KTX::KtxTranscodeTarget> targets[] = {
+                {"RGBA8", KTX::KtxTranscodeTarget::eRGBA8},         {"BC1", KTX::KtxTranscodeTarget::eBC1},
+                {"BC3", KTX::KtxTranscodeTarget::eBC3},             {"BC4", KTX::KtxTranscodeTarget::eBC4},
+                {"BC5", KTX::KtxTranscodeTarget::eBC5},             {"BC7", KTX::KtxTranscodeTarget::eBC7},
+                {"ETC2 RGB", KTX::KtxTranscodeTarget::eETC2RGB},    {"ETC2 RGBA", KTX::KtxTranscodeTarget::eETC2RGBA},
+                {"ASTC 4x4", KTX::KtxTranscodeTarget::eASTC4x4},
+        };
+        const KTX::u32 maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        for (const auto& [name, target] : targets)
+        {
+            // Level 0 on the calling thread, then the whole texture on the pool
+            std::vector<KTX::u8> destination(transcoder->GetTranscodedLevelSize(0, target));
+            bool succeeded = transcoder->TranscodeLevel(0, texture->GetLevel(0), target, destination) ==
+                             KTX::KtxResult::eSuccess;
+            auto start = Clock::now();
+            for (KTX::u32 i = 0; i < iterations; ++i)
+            {
+                succeeded &= transcoder->TranscodeLevel(0, texture->GetLevel(0), target, destination) ==
+                             KTX::KtxResult::eSuccess;
+            }
+            const std::chrono::duration<double> levelElapsed = Clock::now() - start;
+
+            KTX::KtxThreadPool pool(maxThreads);
+            start = Clock::now();
+            for (KTX::u32 i = 0; i < iterations; ++i)
+            {
+                succeeded &= transcoder->Transcode(pool, *texture, target).has_value();
+            }
+            const std::chrono::duration<double> textureElapsed = Clock::now() - start;
+
+            std::cout << "  " << name << ": " << iterations * levelBlocks / levelElapsed.count() / 1e6
+                      << " Mblocks/s on 1 thread, " << iterations * textureBlocks / textureElapsed.count() / 1e6
+                      << " Mblocks/s on " << maxThreads << " threads";
+            if (!succeeded)
+            {
+                std::cout << " (failed)";
+            }
+            std::cout << '\n';
+        }
+    }
+
+    // Random blocks of every format with a decoder, so BC6H, BC7 and ETC2 hit all of their modes, the reserved ones
+    // included. Most random ASTC blocks are malformed, so those keep a 4x4 grid of 3 bit weights (block mode 83) and
+    // randomize everything after it.
+    void BenchDecode()
+    {
+        constexpr KTX::u32 size = 2048;
+        constexpr KTX::u32 iterations = 4;
+        using enum KTX::KtxUtility_VkFormat;
+        const std::pair<const char*, KTX::KtxUtility_VkFormat> formats[] = {
+                {"BC1", VK_FORMAT_BC1_RGBA_UNORM_BLOCK},
+                {"BC2", VK_FORMAT_BC2_UNORM_BLOCK},
+                {"BC3", VK_FORMAT_BC3_UNORM_BLOCK},
+                {"BC4", VK_FORMAT_BC4_UNORM_BLOCK},
+                {"BC5", VK_FORMAT_BC5_SNORM_BLOCK},
+                {"BC6H", VK_FORMAT_BC6H_UFLOAT_BLOCK},
+                {"BC7", VK_FORMAT_BC7_UNORM_BLOCK},
+                {"ETC2 RGB", VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK},
+                {"ETC2 A1", VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK},
+                {"ETC2 RGBA", VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK},
+                {"EAC R11", VK_FORMAT_EAC_R11_UNORM_BLOCK},
+                {"EAC RG11", VK_FORMAT_EAC_R11G11_SNORM_BLOCK},
+                {"ASTC 4x4", VK_FORMAT_ASTC_4x4_UNORM_BLOCK},
+                {"ASTC 6x6 sRGB", VK_FORMAT_ASTC_6x6_SRGB_BLOCK},
+                {"ASTC 8x8", VK_FORMAT_ASTC_8x8_UNORM_BLOCK},
+                {"ASTC 12x12", VK_FORMAT_ASTC_12x12_UNORM_BLOCK},
+                {"ASTC 6x6 HDR", VK_FORMAT_ASTC_6x6_SFLOAT_BLOCK},
+        };
+        std::cout << "Block decode, " << size << "x" << size << " random blocks, MB/s of decoded texels\n";
+        std::mt19937 random(11);
+        const KTX::u32 maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        KTX::KtxThreadPool pool(maxThreads);
+        for (const auto& [name, format] : formats)
+        {
+            KTX::KtxTextureInfo info{};
+            info.vkFormat = static_cast<KTX::u32>(format);
+            info.formatSize = KTX::GetVkFormatSize(info.vkFormat);
+            info.isKtx2 = true;
+            info.isCompressed = true;
+            info.baseWidth = size;
+            info.baseHeight = size;
+            info.baseDepth = 1;
+            info.numDimensions = 2;
+            info.numLevels = 1;
+            info.numLayers = 1;
+            info.numFaces = 1;
+            const KTX::u32 blocksX = (size + info.formatSize.blockWidth - 1) / info.formatSize.blockWidth;
+            const KTX::u32 blocksY = (size + info.formatSize.blockHeight - 1) / info.formatSize.blockHeight;
+            const KTX::u32 blockSize = info.formatSize.blockSize / 8;
+            const KTX::u64 blocksSize = static_cast<KTX::u64>(blocksX) * blocksY * blockSize;
+            auto blocks = std::make_unique_for_overwrite<KTX::u8[]>(blocksSize);
+            for (KTX::u64 i = 0; i < blocksSize; ++i)
+            {
+                blocks[i] = static_cast<KTX::u8>(random());
+            }
+            if (std::strncmp(name, "ASTC", 4) == 0)
+            {
+                for (KTX::u64 offset = 0; offset < blocksSize; offset += blockSize)
+                {
+                    blocks[offset] = 83;
+                    blocks[offset + 1] &= 0xF8;
+                }
+            }
+            KTX::KtxTexture texture(info);
+            texture.SetImageData(std::move(blocks), blocksSize, {{.byteOffset = 0, .byteLength = blocksSize}});
+
+            // The whole level on the calling thread, then in bands on the pool
+            const KTX::u64 decodedSize = KTX::GetDecodedImageSize(info.vkFormat, size, size);
+            std::vector<KTX::u8> destination(decodedSize);
+            bool succeeded = true;
+            auto start = Clock::now();
+            for (KTX::u32 i = 0; i < iterations; ++i)
+            {
+                succeeded &= KTX::DecodeImageRows(info.vkFormat, texture.GetLevel(0), size, size, 0, blocksY,
+                                                  destination) == KTX::KtxResult::eSuccess;
+            }
+            const std::chrono::duration<double> levelElapsed = Clock::now() - start;
+
+            start = Clock::now();
+            for (KTX::u32 i = 0; i < iterations; ++i)
+            {
+                succeeded &= KTX::DecodeTexture(pool, texture).has_value();
+            }
+            const std::chrono::duration<double> textureElapsed = Clock::now() - start;
+
+            std::cout << "  " << name << ": " << iterations * decodedSize / levelElapsed.count() / 1e6
+                      << " MB/s on 1 thread, " << iterations * decodedSize / textureElapsed.count() / 1e6
+                      << " MB/s on " << maxThreads << " threads";
+            if (!succeeded)
+            {
+                std::cout << " (failed)";
+            }
+            std::cout << '\n';
+        }
+    }
+
+    void BenchMipmaps()
+    {
+        constexpr KTX::u32 size = 4096;
+        using enum KTX::KtxUtility_VkFormat;
+        using enum KTX::KtxMipFilter;
+        const std::pair<const char*, KTX::KtxUtility_VkFormat> formats[] = {
+                {"RGBA8", VK_FORMAT_R8G8B8A8_UNORM},
+                {"RGBA8 sRGB", VK_FORMAT_R8G8B8A8_SRGB},
+                {"RGBA16F", VK_FORMAT_R16G16B16A16_SFLOAT},
+                {"RGBA32F", VK_FORMAT_R32G32B32A32_SFLOAT},
+        };
+        const std::pair<const char*, KTX::KtxMipFilter> filters[] = {{"box", eBox}, {"Kaiser", eKaiser},
+                                                                      {"Lanczos", eLanczos}};
+        std::cout << "Mip generation, " << size << "x" << size << " level 0, full chain\n";
+        std::mt19937 random(13);
+        const KTX::u32 maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        KTX::KtxThreadPool singlePool(1);
+        KTX::KtxThreadPool pool(maxThreads);
+        for (const auto& [name, format] : formats)
+        {
+            KTX::KtxTextureInfo info{};
+            info.vkFormat = static_cast<KTX::u32>(format);
+            info.formatSize = KTX::GetVkFormatSize(info.vkFormat);
+            info.isKtx2 = true;
+            info.generateMipmaps = true;
+            info.baseWidth = size;
+            info.baseHeight = size;
+            info.baseDepth = 1;
+            info.numDimensions = 2;
+            info.numLevels = 1;
+            info.numLayers = 1;
+            info.numFaces = 1;
+            const KTX::u64 levelSize = static_cast<KTX::u64>(size) * size * info.formatSize.blockSize / 8;
+            // Values in [0, 1) for every format, random bits would make for NaNs and denormals
+            auto pixels = std::make_unique_for_overwrite<KTX::u8[]>(levelSize);
+            std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+            const KTX::u32 sampleSize = info.formatSize.blockSize / 8 / 4;
+            for (KTX::u64 i = 0; i < levelSize; i += sampleSize)
+            {
+                if (sampleSize == 1)
+                {
+                    pixels[i] = static_cast<KTX::u8>(random());
+                }
+                else if (sampleSize == 2)
+                {
+                    const auto half = static_cast<KTX::u16>(0x1400 + random() % (0x3C00 - 0x1400));
+                    std::memcpy(&pixels[i], &half, sizeof(half));
+                }
+                else
+                {
+                    const float value = uniform(random);
+                    std::memcpy(&pixels[i], &value, sizeof(value));
+                }
+            }
+            KTX::KtxTexture texture(info);
+            texture.SetImageData(std::move(pixels), levelSize, {{.byteOffset = 0, .byteLength = levelSize}});
+
+            for (const auto& [filterName, filter] : filters)
+            {
+                bool succeeded = true;
+                auto start = Clock::now();
+                succeeded &= KTX::GenerateMipmaps(singlePool, texture, {.filter = filter}).has_value();
+                const std::chrono::duration<double> singleElapsed = Clock::now() - start;
+                start = Clock::now();
+                succeeded &= KTX::GenerateMipmaps(pool, texture, {.filter = filter}).has_value();
+                const std::chrono::duration<double> poolElapsed = Clock::now() - start;
+
+                std::cout << "  " << name << " " << filterName << ": " << singleElapsed.count() * 1000
+                          << " ms on 1 thread, " << poolElapsed.count() * 1000 << " ms on " << maxThreads
+                          << " threads";
+                if (!succeeded)
+                {
+                    std::cout << " (failed)";
+                }
+                std::cout << '\n';
+            }
+        }
+    }
+
+    // Loads a big endian ktx1 RGBA16 file from memory next to the same file in native order, the difference is the
+    // byte swap fused into the image data copy
+    void BenchEndianSwap()
+    {
+        constexpr KTX::u32 size = 2048;
+        constexpr KTX::u32 iterations = 20;
+        constexpr KTX::u8 identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+        constexpr KTX::u32 levelSize = size * size * 8;
+        std::cout << "Ktx1 load, " << size << "x" << size << " RGBA16, " << iterations << " iterations\n";
+        for (const bool bigEndian : {false, true})
+        {
+            // glType UNSIGNED_SHORT, glFormat RGBA, glInternalFormat RGBA16, one level, then the image size
+            const KTX::u32 fields[14] = {0x04030201, 0x1403, 2, 0x1908, 0x805B, 0x1908, size, size, 0, 0, 1, 1, 0,
+                                         levelSize};
+            std::vector<KTX::u8> fileData(identifier, identifier + sizeof(identifier));
+            for (auto field : fields)
+            {
+                if (bigEndian)
+                {
+                    field = std::byteswap(field);
+                }
+                fileData.insert(fileData.end(), reinterpret_cast<const KTX::u8*>(&field),
+                                reinterpret_cast<const KTX::u8*>(&field) + sizeof(field));
+            }
+            std::mt19937 random(17);
+            fileData.resize(fileData.size() + levelSize);
+            std::generate(fileData.end() - levelSize, fileData.end(), [&] { return static_cast<KTX::u8>(random()); });
+
+            KTX::u64 checksum = 0;
+            const auto start = Clock::now();
+            for (KTX::u32 i = 0; i < iterations; ++i)
+            {
+                const auto texture = KTX::LoadKTXFromMemory(fileData, KTX::KtxCreateFlags::eLoadImageData);
+                checksum += texture ? texture->GetLevel(0)[i] : 0;
+            }
+            const std::chrono::duration<double> elapsed = Clock::now() - start;
+            std::cout << "  " << (bigEndian ? "big endian" : "native") << ": " << elapsed.count() * 1000 / iterations
+                      << " ms per load, "
+                      << static_cast<double>(levelSize) * iterations / elapsed.count() / (1024.0 * 1024.0 * 1024.0)
+                      << " GiB/s (checksum " << checksum << ")\n";
+        }
+    }
+
+#if defined(KTX_WITH_ZSTD) || defined(KTX_WITH_ZLIB)
+    std::vector<KTX::u8> CompressLevel(const KTX::KtxSupercompressionScheme scheme, const std::vector<KTX::u8>& pixels)
+    {
+        std::vector<KTX::u8> compressed;
+#if defined(KTX_WITH_ZSTD)
+        if (scheme == KTX::KtxSupercompressionScheme::eZstd)
+        {
+            compressed.resize(ZSTD_compressBound(pixels.size()));
+            compressed.resize(ZSTD_compress(compressed.data(), compressed.size(), pixels.data(), pixels.size(), 3));
+        }
+#endif
+#if defined(KTX_WITH_ZLIB)
+        if (scheme == KTX::KtxSupercompressionScheme::eZlib)
+        {
+            uLongf size = compressBound(static_cast<uLong>(pixels.size()));
+            compressed.resize(size);
+            compress2(compressed.data(), &size, pixels.data(), static_cast<uLong>(pixels.size()), 6);
+            compressed.resize(size);
+        }
+#endif
+        return compressed;
+    }
+
+    // Supercompressed RGBA8 ktx2 file with a full mip chain, the pixels are a noisy gradient so the levels compress to
+    // roughly a third
+    std::vector<KTX::u8> MakeSupercompressedKtx2(const KTX::u32 size, const KTX::KtxSupercompressionScheme scheme)
+    {
+        constexpr KTX::u8 identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+        KTX::u32 levelCount = 1;
+        while ((size >> levelCount) > 0)
+        {
+            ++levelCount;
+        }
+
+        std::mt19937 random(7);
+        std::vector<std::vector<KTX::u8>> levels(levelCount);
+        std::vector<KTX::KtxLevelIndexEntry> levelIndex(levelCount);
+        for (KTX::u32 level = 0; level < levelCount; ++level)
+        {
+            const KTX::u32 extent = std::max(size >> level, 1u);
+            std::vector<KTX::u8> pixels(static_cast<size_t>(extent) * extent * 4);
+            for (size_t i = 0; i < pixels.size(); ++i)
+            {
+                pixels[i] = static_cast<KTX::u8>((i / 4 % extent) * 255 / extent + (random() % 4 == 0));
+            }
+            levels[level] = CompressLevel(scheme, pixels);
+            levelIndex[level].uncompressedByteLength = pixels.size();
+        }
+
+        // Smallest level first, like every ktx2 writer does
+        KTX::u64 offset = 80 + levelCount * sizeof(KTX::KtxLevelIndexEntry);
+        for (KTX::u32 level = levelCount; level-- > 0;)
+        {
+            levelIndex[level].byteOffset = offset;
+            levelIndex[level].byteLength = levels[level].size();
+            offset += levels[level].size();
+        }
+
+        const KTX::u32 fields[9] = {37, 1, size, size, 0, 0, 1, levelCount, static_cast<KTX::u32>(scheme)};
+        std::vector<KTX::u8> file(80);
+        std::memcpy(file.data(), identifier, sizeof(identifier));
+        std::memcpy(file.data() + sizeof(identifier), fields, sizeof(fields));
+        const auto* index = reinterpret_cast<const KTX::u8*>(levelIndex.data());
+        file.insert(file.end(), index, index + levelIndex.size() * sizeof(KTX::KtxLevelIndexEntry));
+        for (KTX::u32 level = levelCount; level-- > 0;)
+        {
+            file.insert(file.end(), levels[level].begin(), levels[level].end());
+        }
+        return file;
+    }
+
+    void BenchSupercompressedDecode(const char* name, const KTX::KtxSupercompressionScheme scheme)
+    {
+        constexpr KTX::u32 size = 2048;
+        constexpr KTX::u32 iterations = 8;
+        const auto file = MakeSupercompressedKtx2(size, scheme);
+        auto texture = KTX::LoadKTXFromMemory(file);
+        if (!texture)
+        {
+            std::cout << name << " decode: " << KTX::ToString(texture.error()) << '\n';
+            return;
+        }
+
+        // Level 0 is three quarters of the data, so the speedup of one texture levels off early
+        const KTX::u64 dataSize = texture->GetUncompressedSize();
+        std::vector<KTX::u8> destination(dataSize);
+        std::cout << name << " decode, " << size << "x" << size << " RGBA8 with " << texture->GetInfo().numLevels
+                  << " levels, " << file.size() * 100 / dataSize << "% of the uncompressed size\n";
+        const KTX::u32 maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        for (KTX::u32 threads = 1;; threads = std::min(threads * 2, maxThreads))
+        {
+            KTX::KtxThreadPool pool(threads);
+            // Warm up the per thread decoder state
+            bool succeeded = texture->ReadLevels(pool, destination);
+            const auto start = Clock::now();
+            for (KTX::u32 i = 0; i < iterations; ++i)
+            {
+                succeeded &= texture->ReadLevels(pool, destination);
+            }
+            const std::chrono::duration<double> elapsed = Clock::now() - start;
+            std::cout << "  " << threads << " threads: " << iterations * dataSize / elapsed.count() / 1e6 << " MB/s";
+            if (!succeeded)
+            {
+                std::cout << " (failed)";
+            }
+            std::cout << '\n';
+
+            if (threads == maxThreads)
+            {
+                break;
+            }
+        }
+
+        // Level 0 through a buffer that stays in cache
+        std::vector<KTX::u8> buffer(256 * 1024);
+        KTX::u64 streamed = 0;
+        const auto start = Clock::now();
+        for (KTX::u32 i = 0; i < iterations; ++i)
+        {
+            texture->StreamLevel(0, buffer,
+                                 [&](const std::span<const KTX::u8> chunk)
+                                 {
+                                     streamed += chunk.size();
+                                     return true;
+                                 });
+        }
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        std::cout << "  StreamLevel, " << buffer.size() / 1024 << " KiB buffer: " << streamed / elapsed.count() / 1e6
+                  << " MB/s\n";
+    }
+#endif
+} // namespace
+
+int main(const int argc, char** argv)
+{
+    const auto shouldRun = [&](const char* name)
+    {
+        if (argc < 2)
+        {
+            return true;
+        }
+        for (int i = 1; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], name) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (shouldRun("batch"))
+    {
+        BenchBatchLoad();
+    }
+    if (shouldRun("headers"))
+    {
+        BenchHeaderDecode();
+    }
+    if (shouldRun("probe"))
+    {
+        BenchProbe();
+    }
+    if (shouldRun("formats"))
+    {
+        BenchFormatLookup();
+    }
+    if (shouldRun("dfd"))
+    {
+        BenchDescriptors();
+    }
+    if (shouldRun("bulk"))
+    {
+        BenchBulkLoad();
+    }
+    if (shouldRun("transcode"))
+    {
+        BenchTranscode();
+    }
+    if (shouldRun("uastc"))
+    {
+        BenchUastcTranscode();
+    }
+    if (shouldRun("decode"))
+    {
+        BenchDecode();
+    }
+    if (shouldRun("mipmaps"))
+    {
+        BenchMipmaps();
+    }
+    if (shouldRun("swap"))
+    {
+        BenchEndianSwap();
+    }
+#if defined(KTX_WITH_ZSTD)
+    if (shouldRun("zstd"))
+    {
+        BenchSupercompressedDecode("Zstd", KTX::KtxSupercompressionScheme::eZstd);
+    }
+#endif
+#if defined(KTX_WITH_ZLIB)
+    if (shouldRun("zlib"))
+    {
+        BenchSupercompressedDecode("Zlib", KTX::KtxSupercompressionScheme::eZlib);
+    }
+#endif
+}
@@ -0,0 +1,107 @@
+#include "KtxConvert.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace KTX;
+    namespace fs = std::filesystem;
+
+    // Ktx1 rows are padded to 4 bytes, ktx2 rows are tightly packed. Block compressed rows never carry padding.
+    bool RemoveRowPadding(const KtxTexture& texture, const u32 level, std::vector<u8>& destination)
+    {
+        const auto& info = texture.GetInfo();
+        const auto source = texture.GetLevel(level);
+        const u64 rowSize = u64{texture.GetLevelWidth(level)} * (info.formatSize.blockSize / 8);
+        const u64 paddedRowSize = (rowSize + 3) & ~u64{3};
+        const u64 rowCount =
+                u64{texture.GetLevelHeight(level)} * texture.GetLevelDepth(level) * info.numLayers * info.numFaces;
+        if (source.size() != paddedRowSize * rowCount)
+        {
+            return false;
+        }
+        destination.resize(rowSize * rowCount);
+        for (u64 row = 0; row < rowCount; ++row)
+        {
+            std::memcpy(destination.data() + row * rowSize, source.data() + row * paddedRowSize, rowSize);
+        }
+        return true;
+    }
+} // namespace
+
+std::expected<KTX::u64, KTX::KtxResult> KTX::ConvertKTXFile(const fs::path& input, const fs::path& output,
+                                                             const KtxWriteOptions& options)
+{
+    auto texture = LoadKTXFromFile(input.string(), KtxCreateFlags::eLoadImageData);
+    if (!texture)
+    {
+        return std::unexpected(texture.error());
+    }
+    const auto& info = texture->GetInfo();
+    if (info.isKtx2)
+    {
+        return 0;
+    }
+    if (info.vkFormat == 0)
+    {
+        return std::unexpected(KtxResult::eUnsupportedFeature);
+    }
+
+    std::vector<std::vector<u8>> unpaddedLevels;
+    std::vector<std::span<const u8>> levels(info.numLevels);
+    for (u32 level = 0; level < info.numLevels; ++level)
+    {
+        levels[level] = texture->GetLevel(level);
+        const u64 rowSize = u64{texture->GetLevelWidth(level)} * (info.formatSize.blockSize / 8);
+        if (info.isCompressed || rowSize % 4 == 0)
+        {
+            continue;
+        }
+        if (!RemoveRowPadding(*texture, level, unpaddedLevels.emplace_back()))
+        {
+            return std::unexpected(KtxResult::eFileDataError);
+        }
+        levels[level] = unpaddedLevels.back();
+    }
+
+    // Ktx1 writes the orientation as "S=r,T=d,R=i", ktx2 keeps one letter per dimension
+    std::array orientation{static_cast<char>(info.orientation.x), static_cast<char>(info.orientation.y),
+                           static_cast<char>(info.orientation.z), char{0}};
+    const auto orientationLength = std::clamp(info.numDimensions, 1u, 3u);
+    orientation[orientationLength] = 0;
+    std::vector<KtxKeyValue> keyValues;
+    for (const auto& entry : texture->GetKeyValues().GetEntries())
+    {
+        if (entry.key != "KTXorientation")
+        {
+            keyValues.push_back(entry);
+        }
+    }
+    if (texture->GetKeyValues().Find("KTXorientation") != nullptr)
+    {
+        keyValues.push_back(
+                {"KTXorientation", std::span(reinterpret_cast<const u8*>(orientation.data()), orientationLength + 1)});
+    }
+
+    KtxWriteSource source{};
+    source.info = info;
+    source.info.typeSize = std::max(info.typeSize, 1u);
+    source.levels = levels;
+    source.keyValues = keyValues;
+    std::error_code error;
+    if (const auto result = WriteKTX2ToFile(output.string(), source, options); result != KtxResult::eSuccess)
+    {
+        fs::remove(output, error);
+        return std::unexpected(result);
+    }
+    const u64 size = fs::file_size(output, error);
+    if (error)
+    {
+        return std::unexpected(KtxResult::eFileOpenFailed);
+    }
+    return size;
+}
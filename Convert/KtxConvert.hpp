@@ -0,0 +1,18 @@
+#pragma once
+#include <expected>
+#include <filesystem>
+
+#include "KtxUtility.hpp"
+#include "KtxWriter.hpp"
+
+// Conversion of one ktx file into a ktx2 file, the work of KtxConvertExec for every file it finds
+
+namespace KTX
+{
+    // Writes input as a ktx2 file with the rows unpadded, the data in little endian and the orientation in ktx2 form.
+    // Returns the size of the written file, or 0 if input already is a ktx2 file and was skipped. Fails with
+    // eUnsupportedFeature when glInternalFormat has no VkFormat or the writer has no descriptor for it, see
+    // KtxWriteSource::dataFormatDescriptor. A partly written output is removed.
+    std::expected<u64, KtxResult> ConvertKTXFile(const std::filesystem::path& input,
+                                                 const std::filesystem::path& output, const KtxWriteOptions& options);
+} // namespace KTX
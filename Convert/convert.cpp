@@ -0,0 +1,225 @@
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <expected>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "KtxConvert.hpp"
+#include "KtxUtility.hpp"
+
+// Converts every ktx file under a directory into a ktx2 file under another one, keeping the directory structure:
+//   KtxConvertExec <input dir> <output dir> [--zstd level] [--zlib level] [--threads n] [--align bytes] [--memory MiB]
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    namespace fs = std::filesystem;
+
+    struct ConvertOptions
+    {
+        fs::path inputDirectory;
+        fs::path outputDirectory;
+        KTX::KtxWriteOptions writeOptions;
+        KTX::u32 threadCount = std::thread::hardware_concurrency();
+        KTX::u64 memoryBudget = KTX::u64{1024} << 20;
+    };
+
+    struct ConvertStats
+    {
+        std::atomic<KTX::u32> converted = 0;
+        std::atomic<KTX::u32> skipped = 0;
+        std::atomic<KTX::u32> failed = 0;
+        std::atomic<KTX::u64> inputBytes = 0;
+        std::atomic<KTX::u64> outputBytes = 0;
+    };
+
+    // Caps the bytes held by files in flight. A file larger than the whole budget still goes through, on its own.
+    class MemoryBudget
+    {
+    public:
+        explicit MemoryBudget(const KTX::u64 budget) : budget(budget) {}
+
+        void Acquire(const KTX::u64 bytes)
+        {
+            std::unique_lock lock(mutex);
+            available.wait(lock, [&] { return used == 0 || used + bytes <= budget; });
+            used += bytes;
+        }
+
+        void Release(const KTX::u64 bytes)
+        {
+            {
+                std::lock_guard lock(mutex);
+                used -= bytes;
+            }
+            available.notify_all();
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable available;
+        KTX::u64 budget;
+        KTX::u64 used = 0;
+    };
+
+    bool ParseNumber(const std::string_view text, auto& value)
+    {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc() && end == text.data() + text.size();
+    }
+
+    bool ParseArguments(const int argc, char** argv, ConvertOptions& options)
+    {
+        std::vector<std::string_view> positional;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view argument = argv[i];
+            if (!argument.starts_with("--"))
+            {
+                positional.push_back(argument);
+                continue;
+            }
+            if (i + 1 >= argc)
+            {
+                return false;
+            }
+            const std::string_view value = argv[++i];
+            bool parsed = false;
+            if (argument == "--zstd" || argument == "--zlib")
+            {
+                options.writeOptions.superCompressionScheme = argument == "--zstd"
+                                                                      ? KTX::KtxSupercompressionScheme::eZstd
+                                                                      : KTX::KtxSupercompressionScheme::eZlib;
+                parsed = ParseNumber(value, options.writeOptions.compressionLevel);
+            }
+            else if (argument == "--threads")
+            {
+                parsed = ParseNumber(value, options.threadCount) && options.threadCount > 0;
+            }
+            else if (argument == "--align")
+            {
+                parsed = ParseNumber(value, options.writeOptions.levelAlignment);
+            }
+            else if (argument == "--memory")
+            {
+                parsed = ParseNumber(value, options.memoryBudget);
+                options.memoryBudget <<= 20;
+            }
+            if (!parsed)
+            {
+                return false;
+            }
+        }
+        if (positional.size() != 2)
+        {
+            return false;
+        }
+        options.inputDirectory = positional[0];
+        options.outputDirectory = positional[1];
+        return true;
+    }
+} // namespace
+
+int main(const int argc, char** argv)
+{
+    ConvertOptions options;
+    if (!ParseArguments(argc, argv, options))
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " <input dir> <output dir> [--zstd level] [--zlib level] [--threads n] [--align bytes]"
+                     " [--memory MiB]\n";
+        return 1;
+    }
+
+    // Outputs mirror the inputs, directories are created up front so the workers only write files
+    std::vector<fs::path> inputs;
+    std::vector<fs::path> outputs;
+    std::error_code error;
+    for (const auto& entry : fs::recursive_directory_iterator(options.inputDirectory, error))
+    {
+        if (!entry.is_regular_file() || entry.path().extension() != ".ktx")
+        {
+            continue;
+        }
+        auto output = options.outputDirectory / fs::relative(entry.path(), options.inputDirectory);
+        output.replace_extension(".ktx2");
+        if (std::error_code directoryError; !fs::create_directories(output.parent_path(), directoryError) &&
+                                            directoryError)
+        {
+            std::cerr << output.parent_path().string() << ": " << directoryError.message() << '\n';
+            return 1;
+        }
+        inputs.push_back(entry.path());
+        outputs.push_back(std::move(output));
+    }
+    if (error)
+    {
+        std::cerr << options.inputDirectory.string() << ": " << error.message() << '\n';
+        return 1;
+    }
+
+    // A file holds its image data and an unpadded copy, plus the compressed levels when supercompressing
+    const auto scheme = options.writeOptions.superCompressionScheme;
+    const KTX::u64 bytesPerInputByte = scheme == KTX::KtxSupercompressionScheme::eNone ? 2 : 3;
+    MemoryBudget budget(options.memoryBudget);
+    ConvertStats stats;
+    std::mutex logMutex;
+    KTX::KtxThreadPool pool(options.threadCount);
+    const auto start = Clock::now();
+    pool.ParallelFor(static_cast<KTX::u32>(inputs.size()),
+                     [&](const KTX::u32 index)
+                     {
+                         std::error_code sizeError;
+                         const KTX::u64 inputSize = fs::file_size(inputs[index], sizeError);
+                         const KTX::u64 charge = sizeError ? 0 : inputSize * bytesPerInputByte;
+                         budget.Acquire(charge);
+                         const auto result = KTX::ConvertKTXFile(inputs[index], outputs[index], options.writeOptions);
+                         budget.Release(charge);
+
+                         if (!result)
+                         {
+                             ++stats.failed;
+                             // Name the format so unsupported ones can be told apart from broken files
+                             const auto probed = result.error() == KTX::KtxResult::eUnsupportedFeature
+                                                         ? KTX::ProbeKTXFromFile(inputs[index].string())
+                                                         : std::unexpected(result.error());
+                             std::lock_guard lock(logMutex);
+                             std::cerr << inputs[index].string() << ": " << KTX::ToString(result.error());
+                             if (probed)
+                             {
+                                 std::cerr << " (glInternalFormat 0x" << std::hex << probed->glInternalFormat
+                                           << std::dec << ')';
+                             }
+                             std::cerr << '\n';
+                         }
+                         else if (*result == 0)
+                         {
+                             ++stats.skipped;
+                         }
+                         else
+                         {
+                             ++stats.converted;
+                             stats.inputBytes += inputSize;
+                             stats.outputBytes += *result;
+                         }
+                     });
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    const KTX::u64 inputBytes = stats.inputBytes;
+    const KTX::u64 outputBytes = stats.outputBytes;
+    const auto savedBytes = static_cast<KTX::i64>(inputBytes) - static_cast<KTX::i64>(outputBytes);
+    std::cout << stats.converted << " converted, " << stats.skipped << " skipped, " << stats.failed << " failed in "
+              << elapsed.count() << " s (" << stats.converted / elapsed.count() << " files/s converted)\n";
+    std::cout << inputBytes << " bytes in, " << outputBytes << " bytes out, " << savedBytes << " bytes saved";
+    if (inputBytes > 0)
+    {
+        std::cout << " (" << 100.0 * static_cast<double>(savedBytes) / static_cast<double>(inputBytes) << "%)";
+    }
+    std::cout << '\n';
+    return stats.failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <expected>
+#include <span>
+
+#include "KtxUtility.hpp"
+
+// CPU decoding of block compressed textures into plain texels, for tools that have no GPU to sample them with
+
+namespace KTX
+{
+    // Vulkan format of the decoded texels: R8G8B8A8 (UNORM, SRGB or SNORM after the block format) for LDR formats,
+    // R16G16B16A16 UNORM or SNORM for the 11 bit EAC formats and R16G16B16A16_SFLOAT for HDR ones, BC6H and the ASTC
+    // SFLOAT formats. VK_FORMAT_UNDEFINED when there is no decoder for the format.
+    [[nodiscard]] u32 GetDecodedVkFormat(u32 vkFormat);
+    // Size of one decoded width x height image, 0 when there is no decoder for the format
+    [[nodiscard]] u64 GetDecodedImageSize(u32 vkFormat, u32 width, u32 height);
+
+    // Decodes the block rows [firstRow, firstRow + rowCount) of a width x height image. blocks holds every block of the
+    // image and destination the whole decoded image, rows tightly packed, so row bands can be spread over threads.
+    KtxResult DecodeImageRows(u32 vkFormat, std::span<const u8> blocks, u32 width, u32 height, u32 firstRow,
+                              u32 rowCount, std::span<u8> destination);
+    // Decodes every level into a new texture in GetDecodedVkFormat, one pool task per band of block rows of every
+    // image. Fails with eUnsupportedFeature for formats without a decoder and for BasisLZ textures, which go through
+    // KtxTranscoder. Textures loaded without image data have their levels read first, which is not thread safe.
+    std::expected<KtxTexture, KtxResult> DecodeTexture(KtxThreadPool& pool, KtxTexture& texture);
+} // namespace KTX
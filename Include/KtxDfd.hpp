@@ -0,0 +1,134 @@
+#pragma once
+#include <array>
+#include <expected>
+#include <span>
+#include <vector>
+
+#include "KtxUtility.hpp"
+
+// Parsing of the Khronos data format descriptor that ktx2 files carry next to vkFormat (KDFS 1.3). Only the basic
+// descriptor block is decoded, other blocks are skipped.
+
+namespace KTX
+{
+    // khr_df_model_e, the block compressed models describe the format the blocks are in
+    enum class KtxDfdColorModel : u8
+    {
+        eUnspecified = 0,
+        eRgbsda = 1,
+        eYuvsda = 2,
+        eYiq = 3,
+        eLabsda = 4,
+        eCmyka = 5,
+        eXyzw = 6,
+        eHsvaAng = 7,
+        eHslaAng = 8,
+        eHsvaHex = 9,
+        eHslaHex = 10,
+        eYcgcoa = 11,
+        eYccbccrc = 12,
+        eIctcp = 13,
+        eCiexyz = 14,
+        eCiexyy = 15,
+        eBc1a = 128,
+        eBc2 = 129,
+        eBc3 = 130,
+        eBc4 = 131,
+        eBc5 = 132,
+        eBc6h = 133,
+        eBc7 = 134,
+        eEtc1 = 160,
+        eEtc2 = 161,
+        eAstc = 162,
+        eEtc1s = 163,
+        ePvrtc = 164,
+        ePvrtc2 = 165,
+        eUastc = 166,
+    };
+
+    // khr_df_primaries_e
+    enum class KtxDfdColorPrimaries : u8
+    {
+        eUnspecified = 0,
+        eBt709 = 1,
+        eBt601Ebu = 2,
+        eBt601Smpte = 3,
+        eBt2020 = 4,
+        eCiexyz = 5,
+        eAces = 6,
+        eAcescc = 7,
+        eNtsc1953 = 8,
+        ePal525 = 9,
+        eDisplayP3 = 10,
+        eAdobeRgb = 11,
+    };
+
+    // khr_df_transfer_e
+    enum class KtxDfdTransferFunction : u8
+    {
+        eUnspecified = 0,
+        eLinear = 1,
+        eSrgb = 2,
+        eItu = 3,
+        eNtsc = 4,
+        eSlog = 5,
+        eSlog2 = 6,
+        eBt1886 = 7,
+        eHlgOetf = 8,
+        eHlgEotf = 9,
+        ePqEotf = 10,
+        ePqOetf = 11,
+        eDcip3 = 12,
+        ePalOetf = 13,
+        ePal625Eotf = 14,
+        eSt240 = 15,
+        eAcescc = 16,
+        eAcescct = 17,
+        eAdobeRgb = 18,
+    };
+
+    // One sample of the basic block, a contiguous run of bits that holds (part of) a channel
+    struct KtxDfdSample
+    {
+        u16 bitOffset;
+        // Number of bits, 1 to 256
+        u16 bitLength;
+        // Channel id of the color model, e.g. 0 to 2 for RGB and 15 for alpha
+        u8 channelId;
+        // Qualifiers from the top bits of the channel type
+        bool isLinear; // Linear even though the descriptor has a non linear transfer function, alpha of sRGB formats
+        bool isExponent;
+        bool isSigned;
+        bool isFloat;
+        // Position of the sample within the texel block, as stored
+        std::array<u8, 4> samplePosition;
+        // Values that map to the bottom and top of the range, float32 bits for float samples
+        u32 sampleLower;
+        u32 sampleUpper;
+    };
+
+    // Basic descriptor block of a data format descriptor
+    struct KtxDataFormatDescriptor
+    {
+        u16 versionNumber;
+        KtxDfdColorModel colorModel;
+        KtxDfdColorPrimaries colorPrimaries;
+        KtxDfdTransferFunction transferFunction;
+        bool isPremultiplied;
+        // Texel block size in texels, 1x1x1x1 for uncompressed formats
+        std::array<u32, 4> texelBlockDimensions;
+        // 0 for supercompressed data which has no fixed number of bytes per block
+        std::array<u8, 8> bytesPlane;
+        std::vector<KtxDfdSample> samples;
+    };
+
+    // Parses the descriptor as stored in a ktx2 file, starting with dfdTotalSize. Fails with eFileDataError if the size
+    // fields are inconsistent and with eUnsupportedFeature if there is no basic descriptor block.
+    std::expected<KtxDataFormatDescriptor, KtxResult> ParseDataFormatDescriptor(std::span<const u8> dfd);
+    // Same as above but descriptors are parsed once per process and shared: the first call with a given sequence of
+    // bytes parses it into a cache keyed by the bytes, later calls only cost a hash lookup. Thread safe, the returned
+    // descriptor lives until the process exits. Returns nullptr where ParseDataFormatDescriptor fails, failures are
+    // not cached. The cache is bounded, descriptors over 1 KiB and new ones once it holds 4096 also give nullptr;
+    // ParseDataFormatDescriptor still handles those.
+    const KtxDataFormatDescriptor* InternDataFormatDescriptor(std::span<const u8> dfd);
+} // namespace KTX
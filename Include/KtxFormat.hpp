@@ -0,0 +1,949 @@
+#pragma once
+#include <array>
+
+#include "GL_Format.hpp"
+#include "KtxUtility.hpp"
+#include "VK_Format.hpp"
+
+// Format size tables. Every format is described exactly once in a constexpr list, lookups go through a perfect hash
+// (GL) or a dense array over the few contiguous VkFormat ranges (Vulkan) that is generated from that list at compile
+// time.
+
+namespace KTX
+{
+    struct KtxGlFormatDescriptor
+    {
+        u32 glInternalFormat;
+        KtxFormatSize formatSize;
+    };
+
+    struct KtxVkFormatDescriptor
+    {
+        KtxUtility_VkFormat vkFormat;
+        KtxFormatSize formatSize;
+    };
+
+    namespace Detail
+    {
+        constexpr Flags<KtxFormatSizeFlagBits> noFlags{};
+        constexpr Flags packed{KtxFormatSizeFlagBits::eKtxFormatSizePackedBit};
+        constexpr Flags compressed{KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit};
+        constexpr Flags palettized{KtxFormatSizeFlagBits::eKtxFormatSizePalettizedBit};
+        constexpr Flags depth{KtxFormatSizeFlagBits::eKtxFormatSizeDepthBit};
+        constexpr Flags stencil{KtxFormatSizeFlagBits::eKtxFormatSizeStencilBit};
+
+        // Same field order as the tables below, a 1x1x1 block of 0 bits
+        constexpr KtxFormatSize unknownFormatSize{noFlags, 0, 0, 1, 1, 1, 1, 1};
+
+        // Fields: flags, palette size, block size in bits, block width, height and depth, min blocks x and y
+        constexpr std::array glFormatDescriptors = std::to_array<KtxGlFormatDescriptor>({
+            // 8 bits per component
+            {GL_R8, {noFlags, 0, 1 * 8, 1, 1, 1, 1, 1}}, // 1-component, 8-bit unsigned normalized
+            {GL_R8_SNORM, {noFlags, 0, 1 * 8, 1, 1, 1, 1, 1}}, // 1-component, 8-bit signed normalized
+            {GL_R8UI, {noFlags, 0, 1 * 8, 1, 1, 1, 1, 1}}, // 1-component, 8-bit unsigned integer
+            {GL_R8I, {noFlags, 0, 1 * 8, 1, 1, 1, 1, 1}}, // 1-component, 8-bit signed integer
+            {GL_SR8, {noFlags, 0, 1 * 8, 1, 1, 1, 1, 1}}, // 1-component, 8-bit sRGB
+            {GL_RG8, {noFlags, 0, 2 * 8, 1, 1, 1, 1, 1}}, // 2-component, 8-bit unsigned normalized
+            {GL_RG8_SNORM, {noFlags, 0, 2 * 8, 1, 1, 1, 1, 1}}, // 2-component, 8-bit signed normalized
+            {GL_RG8UI, {noFlags, 0, 2 * 8, 1, 1, 1, 1, 1}}, // 2-component, 8-bit unsigned integer
+            {GL_RG8I, {noFlags, 0, 2 * 8, 1, 1, 1, 1, 1}}, // 2-component, 8-bit signed integer
+            {GL_SRG8, {noFlags, 0, 2 * 8, 1, 1, 1, 1, 1}}, // 2-component, 8-bit sRGB
+            {GL_RGB8, {noFlags, 0, 3 * 8, 1, 1, 1, 1, 1}}, // 3-component, 8-bit unsigned normalized
+            {GL_RGB8_SNORM, {noFlags, 0, 3 * 8, 1, 1, 1, 1, 1}}, // 3-component, 8-bit signed normalized
+            {GL_RGB8UI, {noFlags, 0, 3 * 8, 1, 1, 1, 1, 1}}, // 3-component, 8-bit unsigned integer
+            {GL_RGB8I, {noFlags, 0, 3 * 8, 1, 1, 1, 1, 1}}, // 3-component, 8-bit signed integer
+            {GL_SRGB8, {noFlags, 0, 3 * 8, 1, 1, 1, 1, 1}}, // 3-component, 8-bit sRGB
+            {GL_RGBA8, {noFlags, 0, 4 * 8, 1, 1, 1, 1, 1}}, // 4-component, 8-bit unsigned normalized
+            {GL_RGBA8_SNORM, {noFlags, 0, 4 * 8, 1, 1, 1, 1, 1}}, // 4-component, 8-bit signed normalized
+            {GL_RGBA8UI, {noFlags, 0, 4 * 8, 1, 1, 1, 1, 1}}, // 4-component, 8-bit unsigned integer
+            {GL_RGBA8I, {noFlags, 0, 4 * 8, 1, 1, 1, 1, 1}}, // 4-component, 8-bit signed integer
+            {GL_SRGB8_ALPHA8, {noFlags, 0, 4 * 8, 1, 1, 1, 1, 1}}, // 4-component, 8-bit sRGB
+
+            // 16 bits per component
+            {GL_R16, {noFlags, 0, 2 * 8, 1, 1, 1, 1, 1}}, // 1-component, 16-bit unsigned normalized
+            {GL_R16_SNORM, {noFlags, 0, 2 * 8, 1, 1, 1, 1, 1}}, // 1-component, 16-bit signed normalized
+            {GL_R16UI, {noFlags, 0, 2 * 8, 1, 1, 1, 1, 1}}, // 1-component, 16-bit unsigned integer
+            {GL_R16I, {noFlags, 0, 2 * 8, 1, 1, 1, 1, 1}}, // 1-component, 16-bit signed integer
+            {GL_R16F, {noFlags, 0, 2 * 8, 1, 1, 1, 1, 1}}, // 1-component, 16-bit floating-point
+            {GL_RG16, {noFlags, 0, 4 * 8, 1, 1, 1, 1, 1}}, // 2-component, 16-bit unsigned normalized
+            {GL_RG16_SNORM, {noFlags, 0, 4 * 8, 1, 1, 1, 1, 1}}, // 2-component, 16-bit signed normalized
+            {GL_RG16UI, {noFlags, 0, 4 * 8, 1, 1, 1, 1, 1}}, // 2-component, 16-bit unsigned integer
+            {GL_RG16I, {noFlags, 0, 4 * 8, 1, 1, 1, 1, 1}}, // 2-component, 16-bit signed integer
+            {GL_RG16F, {noFlags, 0, 4 * 8, 1, 1, 1, 1, 1}}, // 2-component, 16-bit floating-point
+            {GL_RGB16, {noFlags, 0, 6 * 8, 1, 1, 1, 1, 1}}, // 3-component, 16-bit unsigned normalized
+            {GL_RGB16_SNORM, {noFlags, 0, 6 * 8, 1, 1, 1, 1, 1}}, // 3-component, 16-bit signed normalized
+            {GL_RGB16UI, {noFlags, 0, 6 * 8, 1, 1, 1, 1, 1}}, // 3-component, 16-bit unsigned integer
+            {GL_RGB16I, {noFlags, 0, 6 * 8, 1, 1, 1, 1, 1}}, // 3-component, 16-bit signed integer
+            {GL_RGB16F, {noFlags, 0, 6 * 8, 1, 1, 1, 1, 1}}, // 3-component, 16-bit floating-point
+            {GL_RGBA16, {noFlags, 0, 8 * 8, 1, 1, 1, 1, 1}}, // 4-component, 16-bit unsigned normalized
+            {GL_RGBA16_SNORM, {noFlags, 0, 8 * 8, 1, 1, 1, 1, 1}}, // 4-component, 16-bit signed normalized
+            {GL_RGBA16UI, {noFlags, 0, 8 * 8, 1, 1, 1, 1, 1}}, // 4-component, 16-bit unsigned integer
+            {GL_RGBA16I, {noFlags, 0, 8 * 8, 1, 1, 1, 1, 1}}, // 4-component, 16-bit signed integer
+            {GL_RGBA16F, {noFlags, 0, 8 * 8, 1, 1, 1, 1, 1}}, // 4-component, 16-bit floating-point
+
+            // 32 bits per component
+            {GL_R32UI, {noFlags, 0, 4 * 8, 1, 1, 1, 1, 1}}, // 1-component, 32-bit unsigned integer
+            {GL_R32I, {noFlags, 0, 4 * 8, 1, 1, 1, 1, 1}}, // 1-component, 32-bit signed integer
+            {GL_R32F, {noFlags, 0, 4 * 8, 1, 1, 1, 1, 1}}, // 1-component, 32-bit floating-point
+            {GL_RG32UI, {noFlags, 0, 8 * 8, 1, 1, 1, 1, 1}}, // 2-component, 32-bit unsigned integer
+            {GL_RG32I, {noFlags, 0, 8 * 8, 1, 1, 1, 1, 1}}, // 2-component, 32-bit signed integer
+            {GL_RG32F, {noFlags, 0, 8 * 8, 1, 1, 1, 1, 1}}, // 2-component, 32-bit floating-point
+            {GL_RGB32UI, {noFlags, 0, 12 * 8, 1, 1, 1, 1, 1}}, // 3-component, 32-bit unsigned integer
+            {GL_RGB32I, {noFlags, 0, 12 * 8, 1, 1, 1, 1, 1}}, // 3-component, 32-bit signed integer
+            {GL_RGB32F, {noFlags, 0, 12 * 8, 1, 1, 1, 1, 1}}, // 3-component, 32-bit floating-point
+            {GL_RGBA32UI, {noFlags, 0, 16 * 8, 1, 1, 1, 1, 1}}, // 4-component, 32-bit unsigned integer
+            {GL_RGBA32I, {noFlags, 0, 16 * 8, 1, 1, 1, 1, 1}}, // 4-component, 32-bit signed integer
+            {GL_RGBA32F, {noFlags, 0, 16 * 8, 1, 1, 1, 1, 1}}, // 4-component, 32-bit floating-point
+
+            // Packed
+            {GL_R3_G3_B2, {packed, 0, 8, 1, 1, 1, 1, 1}}, // 3-component 3:3:2, unsigned normalized
+            {GL_RGB4, {packed, 0, 12, 1, 1, 1, 1, 1}}, // 3-component 4:4:4, unsigned normalized
+            {GL_RGB5, {packed, 0, 16, 1, 1, 1, 1, 1}}, // 3-component 5:5:5, unsigned normalized
+            {GL_RGB565, {packed, 0, 16, 1, 1, 1, 1, 1}}, // 3-component 5:6:5, unsigned normalized
+            {GL_RGB10, {packed, 0, 32, 1, 1, 1, 1, 1}}, // 3-component 10:10:10, unsigned normalized
+            {GL_RGB12, {packed, 0, 36, 1, 1, 1, 1, 1}}, // 3-component 12:12:12, unsigned normalized
+            {GL_RGBA2, {packed, 0, 8, 1, 1, 1, 1, 1}}, // 4-component 2:2:2:2, unsigned normalized
+            {GL_RGBA4, {packed, 0, 16, 1, 1, 1, 1, 1}}, // 4-component 4:4:4:4, unsigned normalized
+            {GL_RGBA12, {packed, 0, 48, 1, 1, 1, 1, 1}}, // 4-component 12:12:12:12, unsigned normalized
+            {GL_RGB5_A1, {packed, 0, 16, 1, 1, 1, 1, 1}}, // 4-component 5:5:5:1, unsigned normalized
+            {GL_RGB10_A2, {packed, 0, 32, 1, 1, 1, 1, 1}}, // 4-component 10:10:10:2, unsigned normalized
+            {GL_RGB10_A2UI, {packed, 0, 32, 1, 1, 1, 1, 1}}, // 4-component 10:10:10:2, unsigned integer
+            {GL_R11F_G11F_B10F, {packed, 0, 32, 1, 1, 1, 1, 1}}, // 3-component 11:11:10, floating-point
+            {GL_RGB9_E5, {packed, 0, 32, 1, 1, 1, 1, 1}}, // 3-component/exp 9:9:9/5, floating-point
+
+            // S3TC/DXT/BC
+            // line through 3D space, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGB_S3TC_DXT1_EXT, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // line through 3D space plus 1-bit alpha, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // line through 3D space, 4x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // line through 3D space plus 1-bit alpha, 4x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // line through 3D space plus line through 1D space, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // line through 3D space plus 4-bit alpha, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // line through 3D space plus line through 1D space, 4x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // line through 3D space plus 4-bit alpha, 4x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // line through 1D space, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_LUMINANCE_LATC1_EXT, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // line through 1D space, 4x4 blocks, signed normalized
+            {GL_COMPRESSED_SIGNED_LUMINANCE_LATC1_EXT, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // two lines through 1D space, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_LUMINANCE_ALPHA_LATC2_EXT, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // two lines through 1D space, 4x4 blocks, signed normalized
+            {GL_COMPRESSED_SIGNED_LUMINANCE_ALPHA_LATC2_EXT, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // line through 1D space, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RED_RGTC1, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // line through 1D space, 4x4 blocks, signed normalized
+            {GL_COMPRESSED_SIGNED_RED_RGTC1, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // two lines through 1D space, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RG_RGTC2, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // two lines through 1D space, 4x4 blocks, signed normalized
+            {GL_COMPRESSED_SIGNED_RG_RGTC2, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // 3-component, 4x4 blocks, unsigned floating-point
+            {GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // 3-component, 4x4 blocks, signed floating-point
+            {GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // 4-component, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_BPTC_UNORM, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, {compressed, 0, 128, 4, 4, 1, 1, 1}}, // 4-component, 4x4 blocks, sRGB
+
+            // ETC
+            // 3-component ETC1, 4x4 blocks, unsigned normalized" ),
+            {GL_ETC1_RGB8_OES, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // 3-component ETC2, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGB8_ETC2, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {GL_COMPRESSED_SRGB8_ETC2, {compressed, 0, 64, 4, 4, 1, 1, 1}}, // 3-component ETC2, 4x4 blocks, sRGB
+            // 4-component ETC2 with 1-bit alpha, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // 4-component ETC2 with 1-bit alpha, 4x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // 4-component ETC2, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA8_ETC2_EAC, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // 4-component ETC2, 4x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // 1-component ETC, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_R11_EAC, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // 1-component ETC, 4x4 blocks, signed normalized
+            {GL_COMPRESSED_SIGNED_R11_EAC, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // 2-component ETC, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RG11_EAC, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // 2-component ETC, 4x4 blocks, signed normalized
+            {GL_COMPRESSED_SIGNED_RG11_EAC, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+
+            // PVRTC
+            // 3-component PVRTC, 8x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG, {compressed, 0, 64, 8, 4, 1, 2, 2}},
+            // 3-component PVRTC, 8x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB_PVRTC_2BPPV1_EXT, {compressed, 0, 64, 8, 4, 1, 2, 2}},
+            // 4-component PVRTC, 8x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG, {compressed, 0, 64, 8, 4, 1, 2, 2}},
+            // 4-component PVRTC, 8x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB_ALPHA_PVRTC_2BPPV1_EXT, {compressed, 0, 64, 8, 4, 1, 2, 2}},
+            // 3-component PVRTC, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG, {compressed, 0, 64, 4, 4, 1, 2, 2}},
+            // 3-component PVRTC, 4x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB_PVRTC_4BPPV1_EXT, {compressed, 0, 64, 4, 4, 1, 2, 2}},
+            // 4-component PVRTC, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG, {compressed, 0, 64, 4, 4, 1, 2, 2}},
+            // 4-component PVRTC, 4x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB_ALPHA_PVRTC_4BPPV1_EXT, {compressed, 0, 64, 4, 4, 1, 2, 2}},
+            // 4-component PVRTC, 8x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_PVRTC_2BPPV2_IMG, {compressed, 0, 64, 8, 4, 1, 1, 1}},
+            // 4-component PVRTC, 8x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB_ALPHA_PVRTC_2BPPV2_IMG, {compressed, 0, 64, 8, 4, 1, 1, 1}},
+            // 4-component PVRTC, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_PVRTC_4BPPV2_IMG, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            // 4-component PVRTC, 4x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB_ALPHA_PVRTC_4BPPV2_IMG, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+
+            // ASTC
+            // 4-component ASTC, 4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_4x4_KHR, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // 4-component ASTC, 4x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // 4-component ASTC, 5x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_5x4_KHR, {compressed, 0, 128, 5, 4, 1, 1, 1}},
+            // 4-component ASTC, 5x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x4_KHR, {compressed, 0, 128, 5, 4, 1, 1, 1}},
+            // 4-component ASTC, 5x5 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_5x5_KHR, {compressed, 0, 128, 5, 5, 1, 1, 1}},
+            // 4-component ASTC, 5x5 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x5_KHR, {compressed, 0, 128, 5, 5, 1, 1, 1}},
+            // 4-component ASTC, 6x5 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_6x5_KHR, {compressed, 0, 128, 6, 5, 1, 1, 1}},
+            // 4-component ASTC, 6x5 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x5_KHR, {compressed, 0, 128, 6, 5, 1, 1, 1}},
+            // 4-component ASTC, 6x6 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_6x6_KHR, {compressed, 0, 128, 6, 6, 1, 1, 1}},
+            // 4-component ASTC, 6x6 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6_KHR, {compressed, 0, 128, 6, 6, 1, 1, 1}},
+            // 4-component ASTC, 8x5 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_8x5_KHR, {compressed, 0, 128, 8, 5, 1, 1, 1}},
+            // 4-component ASTC, 8x5 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x5_KHR, {compressed, 0, 128, 8, 5, 1, 1, 1}},
+            // 4-component ASTC, 8x6 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_8x6_KHR, {compressed, 0, 128, 8, 6, 1, 1, 1}},
+            // 4-component ASTC, 8x6 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x6_KHR, {compressed, 0, 128, 8, 6, 1, 1, 1}},
+            // 4-component ASTC, 8x8 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_8x8_KHR, {compressed, 0, 128, 8, 8, 1, 1, 1}},
+            // 4-component ASTC, 8x8 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x8_KHR, {compressed, 0, 128, 8, 8, 1, 1, 1}},
+            // 4-component ASTC, 10x5 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_10x5_KHR, {compressed, 0, 128, 10, 5, 1, 1, 1}},
+            // 4-component ASTC, 10x5 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x5_KHR, {compressed, 0, 128, 10, 5, 1, 1, 1}},
+            // 4-component ASTC, 10x6 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_10x6_KHR, {compressed, 0, 128, 10, 6, 1, 1, 1}},
+            // 4-component ASTC, 10x6 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x6_KHR, {compressed, 0, 128, 10, 6, 1, 1, 1}},
+            // 4-component ASTC, 10x8 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_10x8_KHR, {compressed, 0, 128, 10, 8, 1, 1, 1}},
+            // 4-component ASTC, 10x8 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x8_KHR, {compressed, 0, 128, 10, 8, 1, 1, 1}},
+            // 4-component ASTC, 10x10 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_10x10_KHR, {compressed, 0, 128, 10, 10, 1, 1, 1}},
+            // 4-component ASTC, 10x10 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x10_KHR, {compressed, 0, 128, 10, 10, 1, 1, 1}},
+            // 4-component ASTC, 12x10 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_12x10_KHR, {compressed, 0, 128, 12, 10, 1, 1, 1}},
+            // 4-component ASTC, 12x10 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x10_KHR, {compressed, 0, 128, 12, 10, 1, 1, 1}},
+            // 4-component ASTC, 12x12 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_12x12_KHR, {compressed, 0, 128, 12, 12, 1, 1, 1}},
+            // 4-component ASTC, 12x12 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12_KHR, {compressed, 0, 128, 12, 12, 1, 1, 1}},
+            // 4-component ASTC, 3x3x3 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_3x3x3_OES, {compressed, 0, 128, 3, 3, 3, 1, 1}},
+            // 4-component ASTC, 3x3x3 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_3x3x3_OES, {compressed, 0, 128, 3, 3, 3, 1, 1}},
+            // 4-component ASTC, 4x3x3 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_4x3x3_OES, {compressed, 0, 128, 4, 3, 3, 1, 1}},
+            // 4-component ASTC, 4x3x3 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x3x3_OES, {compressed, 0, 128, 4, 3, 3, 1, 1}},
+            // 4-component ASTC, 4x4x3 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_4x4x3_OES, {compressed, 0, 128, 4, 4, 3, 1, 1}},
+            // 4-component ASTC, 4x4x3 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4x3_OES, {compressed, 0, 128, 4, 4, 3, 1, 1}},
+            // 4-component ASTC, 4x4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_4x4x4_OES, {compressed, 0, 128, 4, 4, 4, 1, 1}},
+            // 4-component ASTC, 4x4x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4x4_OES, {compressed, 0, 128, 4, 4, 4, 1, 1}},
+            // 4-component ASTC, 5x4x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_5x4x4_OES, {compressed, 0, 128, 5, 4, 4, 1, 1}},
+            // 4-component ASTC, 5x4x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x4x4_OES, {compressed, 0, 128, 5, 4, 4, 1, 1}},
+            // 4-component ASTC, 5x5x4 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_5x5x4_OES, {compressed, 0, 128, 5, 5, 4, 1, 1}},
+            // 4-component ASTC, 5x5x4 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x5x4_OES, {compressed, 0, 128, 5, 5, 4, 1, 1}},
+            // 4-component ASTC, 5x5x5 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_5x5x5_OES, {compressed, 0, 128, 5, 5, 5, 1, 1}},
+            // 4-component ASTC, 5x5x5 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x5x5_OES, {compressed, 0, 128, 5, 5, 5, 1, 1}},
+            // 4-component ASTC, 6x5x5 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_6x5x5_OES, {compressed, 0, 128, 6, 5, 5, 1, 1}},
+            // 4-component ASTC, 6x5x5 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x5x5_OES, {compressed, 0, 128, 6, 5, 5, 1, 1}},
+            // 4-component ASTC, 6x6x5 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_6x6x5_OES, {compressed, 0, 128, 6, 6, 5, 1, 1}},
+            // 4-component ASTC, 6x6x5 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6x5_OES, {compressed, 0, 128, 6, 6, 5, 1, 1}},
+            // 4-component ASTC, 6x6x6 blocks, unsigned normalized
+            {GL_COMPRESSED_RGBA_ASTC_6x6x6_OES, {compressed, 0, 128, 6, 6, 6, 1, 1}},
+            // 4-component ASTC, 6x6x6 blocks, sRGB
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6x6_OES, {compressed, 0, 128, 6, 6, 6, 1, 1}},
+
+            // ATC
+            {GL_ATC_RGB_AMD, {compressed, 0, 64, 4, 4, 1, 1, 1}}, // 3-component, 4x4 blocks, unsigned normalized
+            // 4-component, 4x4 blocks, unsigned normalized
+            {GL_ATC_RGBA_EXPLICIT_ALPHA_AMD, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            // 4-component, 4x4 blocks, unsigned normalized
+            {GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+
+            // Palletized
+            // 3-component 8:8:8,   4-bit palette, unsigned normalized
+            {GL_PALETTE4_RGB8_OES, {palettized, 16 * 24, 4, 1, 1, 1, 1, 1}},
+            // 4-component 8:8:8:8, 4-bit palette, unsigned normalized
+            {GL_PALETTE4_RGBA8_OES, {palettized, 16 * 32, 4, 1, 1, 1, 1, 1}},
+            // 3-component 5:6:5,   4-bit palette, unsigned normalized
+            {GL_PALETTE4_R5_G6_B5_OES, {palettized, 16 * 16, 4, 1, 1, 1, 1, 1}},
+            // 4-component 4:4:4:4, 4-bit palette, unsigned normalized
+            {GL_PALETTE4_RGBA4_OES, {palettized, 16 * 16, 4, 1, 1, 1, 1, 1}},
+            // 4-component 5:5:5:1, 4-bit palette, unsigned normalized
+            {GL_PALETTE4_RGB5_A1_OES, {palettized, 16 * 16, 4, 1, 1, 1, 1, 1}},
+            // 3-component 8:8:8,   8-bit palette, unsigned normalized
+            {GL_PALETTE8_RGB8_OES, {palettized, 256 * 24, 8, 1, 1, 1, 1, 1}},
+            // 4-component 8:8:8:8, 8-bit palette, unsigned normalized
+            {GL_PALETTE8_RGBA8_OES, {palettized, 256 * 32, 8, 1, 1, 1, 1, 1}},
+            // 3-component 5:6:5,   8-bit palette, unsigned normalized
+            {GL_PALETTE8_R5_G6_B5_OES, {palettized, 256 * 16, 8, 1, 1, 1, 1, 1}},
+            // 4-component 4:4:4:4, 8-bit palette, unsigned normalized
+            {GL_PALETTE8_RGBA4_OES, {palettized, 256 * 16, 8, 1, 1, 1, 1, 1}},
+            // 4-component 5:5:5:1, 8-bit palette, unsigned normalized
+            {GL_PALETTE8_RGB5_A1_OES, {palettized, 256 * 16, 8, 1, 1, 1, 1, 1}},
+
+            // Depth/stencil
+            {GL_DEPTH_COMPONENT16, {depth, 0, 16, 1, 1, 1, 1, 1}},
+            {GL_DEPTH_COMPONENT24, {depth, 0, 32, 1, 1, 1, 1, 1}},
+            {GL_DEPTH_COMPONENT32, {depth, 0, 32, 1, 1, 1, 1, 1}},
+            {GL_DEPTH_COMPONENT32F, {depth, 0, 32, 1, 1, 1, 1, 1}},
+            {GL_DEPTH_COMPONENT32F_NV, {depth, 0, 32, 1, 1, 1, 1, 1}},
+            {GL_STENCIL_INDEX1, {stencil, 0, 1, 1, 1, 1, 1, 1}},
+            {GL_STENCIL_INDEX4, {stencil, 0, 4, 1, 1, 1, 1, 1}},
+            {GL_STENCIL_INDEX8, {stencil, 0, 8, 1, 1, 1, 1, 1}},
+            {GL_STENCIL_INDEX16, {stencil, 0, 16, 1, 1, 1, 1, 1}},
+            {GL_DEPTH24_STENCIL8, {depth | stencil, 0, 32, 1, 1, 1, 1, 1}},
+            {GL_DEPTH32F_STENCIL8, {depth | stencil, 0, 64, 1, 1, 1, 1, 1}},
+            {GL_DEPTH32F_STENCIL8_NV, {depth | stencil, 0, 64, 1, 1, 1, 1, 1}},
+        });
+
+        // Multiplicative hash into a table with a slot per possible result, the multiplier is searched at compile time
+        // until no two formats share a slot
+        constexpr u32 glHashBits = 11;
+        constexpr u8 emptySlot = 0xFF;
+        static_assert(glFormatDescriptors.size() < emptySlot);
+
+        constexpr u32 HashGlFormat(const u32 format, const u32 multiplier)
+        {
+            return (format * multiplier) >> (32 - glHashBits);
+        }
+
+        consteval u32 FindGlHashMultiplier()
+        {
+            for (u32 seed = 1;; ++seed)
+            {
+                const u32 multiplier = seed * 0x9E3779B1u;
+                std::array<bool, 1u << glHashBits> used{};
+                bool collision = false;
+                for (const auto& descriptor : glFormatDescriptors)
+                {
+                    auto& slot = used[HashGlFormat(descriptor.glInternalFormat, multiplier)];
+                    collision |= slot;
+                    slot = true;
+                }
+                if (!collision)
+                {
+                    return multiplier;
+                }
+            }
+        }
+
+        constexpr u32 glHashMultiplier = FindGlHashMultiplier();
+
+        constexpr auto glFormatSlots = []
+        {
+            std::array<u8, 1u << glHashBits> slots{};
+            slots.fill(emptySlot);
+            for (u32 i = 0; i < glFormatDescriptors.size(); ++i)
+            {
+                slots[HashGlFormat(glFormatDescriptors[i].glInternalFormat, glHashMultiplier)] = static_cast<u8>(i);
+            }
+            return slots;
+        }();
+
+        // Index into glFormatDescriptors, or its size if the format is unknown
+        constexpr u32 FindGlFormatIndex(const u32 glInternalFormat)
+        {
+            const u8 index = glFormatSlots[HashGlFormat(glInternalFormat, glHashMultiplier)];
+            if (index != emptySlot && glFormatDescriptors[index].glInternalFormat == glInternalFormat)
+            {
+                return index;
+            }
+            return glFormatDescriptors.size();
+        }
+
+        using enum KtxUtility_VkFormat;
+
+        // Same fields as above
+        constexpr std::array vkFormatDescriptors = std::to_array<KtxVkFormatDescriptor>({
+            // Core
+            {VK_FORMAT_R4G4_UNORM_PACK8, {packed, 0, 8, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R4G4B4A4_UNORM_PACK16, {packed, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B4G4R4A4_UNORM_PACK16, {packed, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R5G6B5_UNORM_PACK16, {packed, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B5G6R5_UNORM_PACK16, {packed, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R5G5B5A1_UNORM_PACK16, {packed, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B5G5R5A1_UNORM_PACK16, {packed, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A1R5G5B5_UNORM_PACK16, {packed, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8_UNORM, {noFlags, 0, 8, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8_SNORM, {noFlags, 0, 8, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8_USCALED, {noFlags, 0, 8, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8_SSCALED, {noFlags, 0, 8, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8_UINT, {noFlags, 0, 8, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8_SINT, {noFlags, 0, 8, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8_SRGB, {noFlags, 0, 8, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8_UNORM, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8_SNORM, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8_USCALED, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8_SSCALED, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8_UINT, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8_SINT, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8_SRGB, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8_UNORM, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8_SNORM, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8_USCALED, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8_SSCALED, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8_UINT, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8_SINT, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8_SRGB, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8_UNORM, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8_SNORM, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8_USCALED, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8_SSCALED, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8_UINT, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8_SINT, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8_SRGB, {noFlags, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8A8_UNORM, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8A8_SNORM, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8A8_USCALED, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8A8_SSCALED, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8A8_UINT, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8A8_SINT, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R8G8B8A8_SRGB, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8A8_UNORM, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8A8_SNORM, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8A8_USCALED, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8A8_SSCALED, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8A8_UINT, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8A8_SINT, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8A8_SRGB, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A8B8G8R8_UNORM_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A8B8G8R8_SNORM_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A8B8G8R8_USCALED_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A8B8G8R8_SSCALED_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A8B8G8R8_UINT_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A8B8G8R8_SINT_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A8B8G8R8_SRGB_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A2R10G10B10_UNORM_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A2R10G10B10_SNORM_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A2R10G10B10_USCALED_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A2R10G10B10_SSCALED_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A2R10G10B10_UINT_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A2R10G10B10_SINT_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A2B10G10R10_UNORM_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A2B10G10R10_SNORM_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A2B10G10R10_USCALED_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A2B10G10R10_SSCALED_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A2B10G10R10_UINT_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A2B10G10R10_SINT_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16_UNORM, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16_SNORM, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16_USCALED, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16_SSCALED, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16_UINT, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16_SINT, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16_SFLOAT, {noFlags, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16_UNORM, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16_SNORM, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16_USCALED, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16_SSCALED, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16_UINT, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16_SINT, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16_SFLOAT, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16_UNORM, {noFlags, 0, 48, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16_SNORM, {noFlags, 0, 48, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16_USCALED, {noFlags, 0, 48, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16_SSCALED, {noFlags, 0, 48, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16_UINT, {noFlags, 0, 48, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16_SINT, {noFlags, 0, 48, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16_SFLOAT, {noFlags, 0, 48, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16A16_UNORM, {noFlags, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16A16_SNORM, {noFlags, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16A16_USCALED, {noFlags, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16A16_SSCALED, {noFlags, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16A16_UINT, {noFlags, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16A16_SINT, {noFlags, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R16G16B16A16_SFLOAT, {noFlags, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R32_UINT, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R32_SINT, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R32_SFLOAT, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R32G32_UINT, {noFlags, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R32G32_SINT, {noFlags, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R32G32_SFLOAT, {noFlags, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R32G32B32_UINT, {noFlags, 0, 96, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R32G32B32_SINT, {noFlags, 0, 96, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R32G32B32_SFLOAT, {noFlags, 0, 96, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R32G32B32A32_UINT, {noFlags, 0, 128, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R32G32B32A32_SINT, {noFlags, 0, 128, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R32G32B32A32_SFLOAT, {noFlags, 0, 128, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R64_UINT, {noFlags, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R64_SINT, {noFlags, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R64_SFLOAT, {noFlags, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R64G64_UINT, {noFlags, 0, 128, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R64G64_SINT, {noFlags, 0, 128, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R64G64_SFLOAT, {noFlags, 0, 128, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R64G64B64_UINT, {noFlags, 0, 192, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R64G64B64_SINT, {noFlags, 0, 192, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R64G64B64_SFLOAT, {noFlags, 0, 192, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R64G64B64A64_UINT, {noFlags, 0, 256, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R64G64B64A64_SINT, {noFlags, 0, 256, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R64G64B64A64_SFLOAT, {noFlags, 0, 256, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_B10G11R11_UFLOAT_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_E5B9G9R9_UFLOAT_PACK32, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_D16_UNORM, {depth, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_X8_D24_UNORM_PACK32, {packed | depth, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_D32_SFLOAT, {depth, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_S8_UINT, {stencil, 0, 8, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_D16_UNORM_S8_UINT, {depth | stencil, 0, 24, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_D24_UNORM_S8_UINT, {depth | stencil, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_D32_SFLOAT_S8_UINT, {depth | stencil, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_BC1_RGB_UNORM_BLOCK, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC1_RGB_SRGB_BLOCK, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC1_RGBA_UNORM_BLOCK, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC1_RGBA_SRGB_BLOCK, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC2_UNORM_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC2_SRGB_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC3_UNORM_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC3_SRGB_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC4_UNORM_BLOCK, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC4_SNORM_BLOCK, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC5_UNORM_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC5_SNORM_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC6H_UFLOAT_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC6H_SFLOAT_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC7_UNORM_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_BC7_SRGB_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_EAC_R11_UNORM_BLOCK, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_EAC_R11_SNORM_BLOCK, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_EAC_R11G11_UNORM_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_EAC_R11G11_SNORM_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_ASTC_4x4_UNORM_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_ASTC_4x4_SRGB_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_ASTC_5x4_UNORM_BLOCK, {compressed, 0, 128, 5, 4, 1, 1, 1}},
+            {VK_FORMAT_ASTC_5x4_SRGB_BLOCK, {compressed, 0, 128, 5, 4, 1, 1, 1}},
+            {VK_FORMAT_ASTC_5x5_UNORM_BLOCK, {compressed, 0, 128, 5, 5, 1, 1, 1}},
+            {VK_FORMAT_ASTC_5x5_SRGB_BLOCK, {compressed, 0, 128, 5, 5, 1, 1, 1}},
+            {VK_FORMAT_ASTC_6x5_UNORM_BLOCK, {compressed, 0, 128, 6, 5, 1, 1, 1}},
+            {VK_FORMAT_ASTC_6x5_SRGB_BLOCK, {compressed, 0, 128, 6, 5, 1, 1, 1}},
+            {VK_FORMAT_ASTC_6x6_UNORM_BLOCK, {compressed, 0, 128, 6, 6, 1, 1, 1}},
+            {VK_FORMAT_ASTC_6x6_SRGB_BLOCK, {compressed, 0, 128, 6, 6, 1, 1, 1}},
+            {VK_FORMAT_ASTC_8x5_UNORM_BLOCK, {compressed, 0, 128, 8, 5, 1, 1, 1}},
+            {VK_FORMAT_ASTC_8x5_SRGB_BLOCK, {compressed, 0, 128, 8, 5, 1, 1, 1}},
+            {VK_FORMAT_ASTC_8x6_UNORM_BLOCK, {compressed, 0, 128, 8, 6, 1, 1, 1}},
+            {VK_FORMAT_ASTC_8x6_SRGB_BLOCK, {compressed, 0, 128, 8, 6, 1, 1, 1}},
+            {VK_FORMAT_ASTC_8x8_UNORM_BLOCK, {compressed, 0, 128, 8, 8, 1, 1, 1}},
+            {VK_FORMAT_ASTC_8x8_SRGB_BLOCK, {compressed, 0, 128, 8, 8, 1, 1, 1}},
+            {VK_FORMAT_ASTC_10x5_UNORM_BLOCK, {compressed, 0, 128, 10, 5, 1, 1, 1}},
+            {VK_FORMAT_ASTC_10x5_SRGB_BLOCK, {compressed, 0, 128, 10, 5, 1, 1, 1}},
+            {VK_FORMAT_ASTC_10x6_UNORM_BLOCK, {compressed, 0, 128, 10, 6, 1, 1, 1}},
+            {VK_FORMAT_ASTC_10x6_SRGB_BLOCK, {compressed, 0, 128, 10, 6, 1, 1, 1}},
+            {VK_FORMAT_ASTC_10x8_UNORM_BLOCK, {compressed, 0, 128, 10, 8, 1, 1, 1}},
+            {VK_FORMAT_ASTC_10x8_SRGB_BLOCK, {compressed, 0, 128, 10, 8, 1, 1, 1}},
+            {VK_FORMAT_ASTC_10x10_UNORM_BLOCK, {compressed, 0, 128, 10, 10, 1, 1, 1}},
+            {VK_FORMAT_ASTC_10x10_SRGB_BLOCK, {compressed, 0, 128, 10, 10, 1, 1, 1}},
+            {VK_FORMAT_ASTC_12x10_UNORM_BLOCK, {compressed, 0, 128, 12, 10, 1, 1, 1}},
+            {VK_FORMAT_ASTC_12x10_SRGB_BLOCK, {compressed, 0, 128, 12, 10, 1, 1, 1}},
+            {VK_FORMAT_ASTC_12x12_UNORM_BLOCK, {compressed, 0, 128, 12, 12, 1, 1, 1}},
+            {VK_FORMAT_ASTC_12x12_SRGB_BLOCK, {compressed, 0, 128, 12, 12, 1, 1, 1}},
+
+            // PVRTC
+            {VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG, {compressed, 0, 64, 8, 4, 1, 2, 2}},
+            {VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG, {compressed, 0, 64, 4, 4, 1, 2, 2}},
+            {VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG, {compressed, 0, 64, 8, 4, 1, 1, 1}},
+            {VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG, {compressed, 0, 64, 8, 4, 1, 2, 2}},
+            {VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG, {compressed, 0, 64, 4, 4, 1, 2, 2}},
+            {VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG, {compressed, 0, 64, 8, 4, 1, 1, 1}},
+            {VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG, {compressed, 0, 64, 4, 4, 1, 1, 1}},
+
+            // ASTC HDR
+            {VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK, {compressed, 0, 128, 4, 4, 1, 1, 1}},
+            {VK_FORMAT_ASTC_5x4_SFLOAT_BLOCK, {compressed, 0, 128, 5, 4, 1, 1, 1}},
+            {VK_FORMAT_ASTC_5x5_SFLOAT_BLOCK, {compressed, 0, 128, 5, 5, 1, 1, 1}},
+            {VK_FORMAT_ASTC_6x5_SFLOAT_BLOCK, {compressed, 0, 128, 6, 5, 1, 1, 1}},
+            {VK_FORMAT_ASTC_6x6_SFLOAT_BLOCK, {compressed, 0, 128, 6, 6, 1, 1, 1}},
+            {VK_FORMAT_ASTC_8x5_SFLOAT_BLOCK, {compressed, 0, 128, 8, 5, 1, 1, 1}},
+            {VK_FORMAT_ASTC_8x6_SFLOAT_BLOCK, {compressed, 0, 128, 8, 6, 1, 1, 1}},
+            {VK_FORMAT_ASTC_8x8_SFLOAT_BLOCK, {compressed, 0, 128, 8, 8, 1, 1, 1}},
+            {VK_FORMAT_ASTC_10x5_SFLOAT_BLOCK, {compressed, 0, 128, 10, 5, 1, 1, 1}},
+            {VK_FORMAT_ASTC_10x6_SFLOAT_BLOCK, {compressed, 0, 128, 10, 6, 1, 1, 1}},
+            {VK_FORMAT_ASTC_10x8_SFLOAT_BLOCK, {compressed, 0, 128, 10, 8, 1, 1, 1}},
+            {VK_FORMAT_ASTC_10x10_SFLOAT_BLOCK, {compressed, 0, 128, 10, 10, 1, 1, 1}},
+            {VK_FORMAT_ASTC_12x10_SFLOAT_BLOCK, {compressed, 0, 128, 12, 10, 1, 1, 1}},
+            {VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK, {compressed, 0, 128, 12, 12, 1, 1, 1}},
+
+            // YCbCr, multi-planar formats are left out as ktx2 doesn't allow them
+            {VK_FORMAT_G8B8G8R8_422_UNORM, {noFlags, 0, 32, 2, 1, 1, 1, 1}},
+            {VK_FORMAT_B8G8R8G8_422_UNORM, {noFlags, 0, 32, 2, 1, 1, 1, 1}},
+            {VK_FORMAT_R10X6_UNORM_PACK16, {packed, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R10X6G10X6_UNORM_2PACK16, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R10X6G10X6B10X6A10X6_UNORM_4PACK16, {packed, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_G10X6B10X6G10X6R10X6_422_UNORM_4PACK16, {packed, 0, 64, 2, 1, 1, 1, 1}},
+            {VK_FORMAT_B10X6G10X6R10X6G10X6_422_UNORM_4PACK16, {packed, 0, 64, 2, 1, 1, 1, 1}},
+            {VK_FORMAT_R12X4_UNORM_PACK16, {packed, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R12X4G12X4_UNORM_2PACK16, {packed, 0, 32, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_R12X4G12X4B12X4A12X4_UNORM_4PACK16, {packed, 0, 64, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_G12X4B12X4G12X4R12X4_422_UNORM_4PACK16, {packed, 0, 64, 2, 1, 1, 1, 1}},
+            {VK_FORMAT_B12X4G12X4R12X4G12X4_422_UNORM_4PACK16, {packed, 0, 64, 2, 1, 1, 1, 1}},
+            {VK_FORMAT_G16B16G16R16_422_UNORM, {noFlags, 0, 64, 2, 1, 1, 1, 1}},
+            {VK_FORMAT_B16G16R16G16_422_UNORM, {noFlags, 0, 64, 2, 1, 1, 1, 1}},
+
+            // 4444
+            {VK_FORMAT_A4R4G4B4_UNORM_PACK16, {packed, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A4B4G4R4_UNORM_PACK16, {packed, 0, 16, 1, 1, 1, 1, 1}},
+
+            // Fixed point
+            {VK_FORMAT_R16G16_SFIXED5_NV, {noFlags, 0, 32, 1, 1, 1, 1, 1}},
+
+            // Maintenance 5
+            {VK_FORMAT_A1B5G5R5_UNORM_PACK16_KHR, {packed, 0, 16, 1, 1, 1, 1, 1}},
+            {VK_FORMAT_A8_UNORM_KHR, {noFlags, 0, 8, 1, 1, 1, 1, 1}},
+        });
+
+        // The core formats and every extension block of VkFormat, back to back they index a dense table
+        struct VkFormatRange
+        {
+            u32 first;
+            u32 count;
+        };
+
+        constexpr std::array vkFormatRanges = std::to_array<VkFormatRange>({
+                {0, 185},
+                {1000054000, 8},
+                {1000066000, 14},
+                {1000156000, 34},
+                {1000330000, 4},
+                {1000340000, 2},
+                {1000464000, 1},
+                {1000470000, 2},
+        });
+
+        // Index into the dense table, or the table size if the format is outside every range
+        constexpr u32 GetVkFormatIndex(const u32 vkFormat)
+        {
+            u32 base = 0;
+            for (const auto& range : vkFormatRanges)
+            {
+                // Wraps for formats below the range
+                if (vkFormat - range.first < range.count)
+                {
+                    return base + vkFormat - range.first;
+                }
+                base += range.count;
+            }
+            return base;
+        }
+
+        constexpr u32 vkFormatCount = GetVkFormatIndex(~0u); // No range reaches the last value
+
+        constexpr auto vkFormatSizes = []
+        {
+            std::array<KtxFormatSize, vkFormatCount> sizes{};
+            sizes.fill(unknownFormatSize);
+            for (const auto& descriptor : vkFormatDescriptors)
+            {
+                // Fails to compile if a descriptor falls outside the ranges
+                sizes.at(GetVkFormatIndex(static_cast<u32>(descriptor.vkFormat))) = descriptor.formatSize;
+            }
+            return sizes;
+        }();
+
+        struct GlVkFormatPair
+        {
+            u32 glInternalFormat;
+            KtxUtility_VkFormat vkFormat;
+        };
+
+        // Formats with the same memory layout in both APIs. Translating either way picks the first pair that matches.
+        constexpr std::array glVkFormatPairs = std::to_array<GlVkFormatPair>({
+            // Packed
+            {GL_RGBA4, VK_FORMAT_R4G4B4A4_UNORM_PACK16},
+            {GL_RGB565, VK_FORMAT_R5G6B5_UNORM_PACK16},
+            {GL_RGB5_A1, VK_FORMAT_R5G5B5A1_UNORM_PACK16},
+            {GL_RGB10_A2, VK_FORMAT_A2B10G10R10_UNORM_PACK32},
+            {GL_RGB10_A2UI, VK_FORMAT_A2B10G10R10_UINT_PACK32},
+            {GL_R11F_G11F_B10F, VK_FORMAT_B10G11R11_UFLOAT_PACK32},
+            {GL_RGB9_E5, VK_FORMAT_E5B9G9R9_UFLOAT_PACK32},
+
+            // 8 bits per component
+            {GL_R8, VK_FORMAT_R8_UNORM},
+            {GL_R8_SNORM, VK_FORMAT_R8_SNORM},
+            {GL_R8UI, VK_FORMAT_R8_UINT},
+            {GL_R8I, VK_FORMAT_R8_SINT},
+            {GL_SR8, VK_FORMAT_R8_SRGB},
+            {GL_RG8, VK_FORMAT_R8G8_UNORM},
+            {GL_RG8_SNORM, VK_FORMAT_R8G8_SNORM},
+            {GL_RG8UI, VK_FORMAT_R8G8_UINT},
+            {GL_RG8I, VK_FORMAT_R8G8_SINT},
+            {GL_SRG8, VK_FORMAT_R8G8_SRGB},
+            {GL_RGB8, VK_FORMAT_R8G8B8_UNORM},
+            {GL_RGB8_SNORM, VK_FORMAT_R8G8B8_SNORM},
+            {GL_RGB8UI, VK_FORMAT_R8G8B8_UINT},
+            {GL_RGB8I, VK_FORMAT_R8G8B8_SINT},
+            {GL_SRGB8, VK_FORMAT_R8G8B8_SRGB},
+            {GL_RGBA8, VK_FORMAT_R8G8B8A8_UNORM},
+            {GL_RGBA8_SNORM, VK_FORMAT_R8G8B8A8_SNORM},
+            {GL_RGBA8UI, VK_FORMAT_R8G8B8A8_UINT},
+            {GL_RGBA8I, VK_FORMAT_R8G8B8A8_SINT},
+            {GL_SRGB8_ALPHA8, VK_FORMAT_R8G8B8A8_SRGB},
+
+            // 16 bits per component
+            {GL_R16, VK_FORMAT_R16_UNORM},
+            {GL_R16_SNORM, VK_FORMAT_R16_SNORM},
+            {GL_R16UI, VK_FORMAT_R16_UINT},
+            {GL_R16I, VK_FORMAT_R16_SINT},
+            {GL_R16F, VK_FORMAT_R16_SFLOAT},
+            {GL_RG16, VK_FORMAT_R16G16_UNORM},
+            {GL_RG16_SNORM, VK_FORMAT_R16G16_SNORM},
+            {GL_RG16UI, VK_FORMAT_R16G16_UINT},
+            {GL_RG16I, VK_FORMAT_R16G16_SINT},
+            {GL_RG16F, VK_FORMAT_R16G16_SFLOAT},
+            {GL_RGB16, VK_FORMAT_R16G16B16_UNORM},
+            {GL_RGB16_SNORM, VK_FORMAT_R16G16B16_SNORM},
+            {GL_RGB16UI, VK_FORMAT_R16G16B16_UINT},
+            {GL_RGB16I, VK_FORMAT_R16G16B16_SINT},
+            {GL_RGB16F, VK_FORMAT_R16G16B16_SFLOAT},
+            {GL_RGBA16, VK_FORMAT_R16G16B16A16_UNORM},
+            {GL_RGBA16_SNORM, VK_FORMAT_R16G16B16A16_SNORM},
+            {GL_RGBA16UI, VK_FORMAT_R16G16B16A16_UINT},
+            {GL_RGBA16I, VK_FORMAT_R16G16B16A16_SINT},
+            {GL_RGBA16F, VK_FORMAT_R16G16B16A16_SFLOAT},
+
+            // 32 bits per component
+            {GL_R32UI, VK_FORMAT_R32_UINT},
+            {GL_R32I, VK_FORMAT_R32_SINT},
+            {GL_R32F, VK_FORMAT_R32_SFLOAT},
+            {GL_RG32UI, VK_FORMAT_R32G32_UINT},
+            {GL_RG32I, VK_FORMAT_R32G32_SINT},
+            {GL_RG32F, VK_FORMAT_R32G32_SFLOAT},
+            {GL_RGB32UI, VK_FORMAT_R32G32B32_UINT},
+            {GL_RGB32I, VK_FORMAT_R32G32B32_SINT},
+            {GL_RGB32F, VK_FORMAT_R32G32B32_SFLOAT},
+            {GL_RGBA32UI, VK_FORMAT_R32G32B32A32_UINT},
+            {GL_RGBA32I, VK_FORMAT_R32G32B32A32_SINT},
+            {GL_RGBA32F, VK_FORMAT_R32G32B32A32_SFLOAT},
+
+            // Depth/stencil
+            {GL_DEPTH_COMPONENT16, VK_FORMAT_D16_UNORM},
+            {GL_DEPTH_COMPONENT24, VK_FORMAT_X8_D24_UNORM_PACK32},
+            {GL_DEPTH_COMPONENT32F, VK_FORMAT_D32_SFLOAT},
+            {GL_STENCIL_INDEX8, VK_FORMAT_S8_UINT},
+            {GL_DEPTH24_STENCIL8, VK_FORMAT_D24_UNORM_S8_UINT},
+            {GL_DEPTH32F_STENCIL8, VK_FORMAT_D32_SFLOAT_S8_UINT},
+
+            // S3TC/RGTC/BPTC
+            {GL_COMPRESSED_RGB_S3TC_DXT1_EXT, VK_FORMAT_BC1_RGB_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, VK_FORMAT_BC1_RGB_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, VK_FORMAT_BC1_RGBA_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, VK_FORMAT_BC1_RGBA_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, VK_FORMAT_BC2_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, VK_FORMAT_BC2_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, VK_FORMAT_BC3_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, VK_FORMAT_BC3_SRGB_BLOCK},
+            {GL_COMPRESSED_RED_RGTC1, VK_FORMAT_BC4_UNORM_BLOCK},
+            {GL_COMPRESSED_SIGNED_RED_RGTC1, VK_FORMAT_BC4_SNORM_BLOCK},
+            {GL_COMPRESSED_RG_RGTC2, VK_FORMAT_BC5_UNORM_BLOCK},
+            {GL_COMPRESSED_SIGNED_RG_RGTC2, VK_FORMAT_BC5_SNORM_BLOCK},
+            {GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, VK_FORMAT_BC6H_UFLOAT_BLOCK},
+            {GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, VK_FORMAT_BC6H_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_BPTC_UNORM, VK_FORMAT_BC7_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, VK_FORMAT_BC7_SRGB_BLOCK},
+
+            // ETC2/EAC
+            {GL_COMPRESSED_RGB8_ETC2, VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ETC2, VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK},
+            {GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2, VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA8_ETC2_EAC, VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC, VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK},
+            {GL_COMPRESSED_R11_EAC, VK_FORMAT_EAC_R11_UNORM_BLOCK},
+            {GL_COMPRESSED_SIGNED_R11_EAC, VK_FORMAT_EAC_R11_SNORM_BLOCK},
+            {GL_COMPRESSED_RG11_EAC, VK_FORMAT_EAC_R11G11_UNORM_BLOCK},
+            {GL_COMPRESSED_SIGNED_RG11_EAC, VK_FORMAT_EAC_R11G11_SNORM_BLOCK},
+
+            // ASTC
+            {GL_COMPRESSED_RGBA_ASTC_4x4_KHR, VK_FORMAT_ASTC_4x4_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR, VK_FORMAT_ASTC_4x4_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_5x4_KHR, VK_FORMAT_ASTC_5x4_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x4_KHR, VK_FORMAT_ASTC_5x4_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_5x5_KHR, VK_FORMAT_ASTC_5x5_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x5_KHR, VK_FORMAT_ASTC_5x5_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_6x5_KHR, VK_FORMAT_ASTC_6x5_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x5_KHR, VK_FORMAT_ASTC_6x5_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_6x6_KHR, VK_FORMAT_ASTC_6x6_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6_KHR, VK_FORMAT_ASTC_6x6_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_8x5_KHR, VK_FORMAT_ASTC_8x5_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x5_KHR, VK_FORMAT_ASTC_8x5_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_8x6_KHR, VK_FORMAT_ASTC_8x6_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x6_KHR, VK_FORMAT_ASTC_8x6_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_8x8_KHR, VK_FORMAT_ASTC_8x8_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x8_KHR, VK_FORMAT_ASTC_8x8_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_10x5_KHR, VK_FORMAT_ASTC_10x5_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x5_KHR, VK_FORMAT_ASTC_10x5_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_10x6_KHR, VK_FORMAT_ASTC_10x6_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x6_KHR, VK_FORMAT_ASTC_10x6_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_10x8_KHR, VK_FORMAT_ASTC_10x8_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x8_KHR, VK_FORMAT_ASTC_10x8_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_10x10_KHR, VK_FORMAT_ASTC_10x10_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x10_KHR, VK_FORMAT_ASTC_10x10_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_12x10_KHR, VK_FORMAT_ASTC_12x10_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x10_KHR, VK_FORMAT_ASTC_12x10_SRGB_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_12x12_KHR, VK_FORMAT_ASTC_12x12_UNORM_BLOCK},
+            {GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12_KHR, VK_FORMAT_ASTC_12x12_SRGB_BLOCK},
+
+            // PVRTC
+            {GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG, VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG},
+            {GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG, VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG},
+            {GL_COMPRESSED_RGBA_PVRTC_2BPPV2_IMG, VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG},
+            {GL_COMPRESSED_RGBA_PVRTC_4BPPV2_IMG, VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG},
+            {GL_COMPRESSED_SRGB_ALPHA_PVRTC_2BPPV1_EXT, VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG},
+            {GL_COMPRESSED_SRGB_ALPHA_PVRTC_4BPPV1_EXT, VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG},
+            {GL_COMPRESSED_SRGB_ALPHA_PVRTC_2BPPV2_IMG, VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG},
+            {GL_COMPRESSED_SRGB_ALPHA_PVRTC_4BPPV2_IMG, VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG},
+
+            // One way aliases, the canonical pair above wins in the other direction
+            {GL_ETC1_RGB8_OES, VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK},
+            {GL_DEPTH_COMPONENT32F_NV, VK_FORMAT_D32_SFLOAT},
+            {GL_DEPTH32F_STENCIL8_NV, VK_FORMAT_D32_SFLOAT_S8_UINT},
+            {GL_RGBA8, VK_FORMAT_A8B8G8R8_UNORM_PACK32},
+            {GL_RGBA8_SNORM, VK_FORMAT_A8B8G8R8_SNORM_PACK32},
+            {GL_RGBA8UI, VK_FORMAT_A8B8G8R8_UINT_PACK32},
+            {GL_RGBA8I, VK_FORMAT_A8B8G8R8_SINT_PACK32},
+            {GL_SRGB8_ALPHA8, VK_FORMAT_A8B8G8R8_SRGB_PACK32},
+            // GL has no separate HDR ASTC formats, the LDR ones decode HDR blocks as well
+            {GL_COMPRESSED_RGBA_ASTC_4x4_KHR, VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_5x4_KHR, VK_FORMAT_ASTC_5x4_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_5x5_KHR, VK_FORMAT_ASTC_5x5_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_6x5_KHR, VK_FORMAT_ASTC_6x5_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_6x6_KHR, VK_FORMAT_ASTC_6x6_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_8x5_KHR, VK_FORMAT_ASTC_8x5_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_8x6_KHR, VK_FORMAT_ASTC_8x6_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_8x8_KHR, VK_FORMAT_ASTC_8x8_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_10x5_KHR, VK_FORMAT_ASTC_10x5_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_10x6_KHR, VK_FORMAT_ASTC_10x6_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_10x8_KHR, VK_FORMAT_ASTC_10x8_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_10x10_KHR, VK_FORMAT_ASTC_10x10_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_12x10_KHR, VK_FORMAT_ASTC_12x10_SFLOAT_BLOCK},
+            {GL_COMPRESSED_RGBA_ASTC_12x12_KHR, VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK},
+        });
+
+        // Indexed like glFormatDescriptors and vkFormatSizes, so a translation costs the same single lookup as a size.
+        // The tables are filled back to front to let the first pair win, at() fails to compile for a pair whose format
+        // has no descriptor.
+        constexpr auto glToVkFormats = []
+        {
+            std::array<u32, glFormatDescriptors.size()> formats{};
+            for (auto pair = glVkFormatPairs.rbegin(); pair != glVkFormatPairs.rend(); ++pair)
+            {
+                formats.at(FindGlFormatIndex(pair->glInternalFormat)) = static_cast<u32>(pair->vkFormat);
+            }
+            return formats;
+        }();
+
+        constexpr auto vkToGlFormats = []
+        {
+            std::array<u32, vkFormatCount> formats{};
+            for (auto pair = glVkFormatPairs.rbegin(); pair != glVkFormatPairs.rend(); ++pair)
+            {
+                formats.at(GetVkFormatIndex(static_cast<u32>(pair->vkFormat))) = pair->glInternalFormat;
+            }
+            return formats;
+        }();
+    } // namespace Detail
+
+    // Unknown formats report a block size of 0
+    constexpr KtxFormatSize GetGlFormatSize(const u32 glInternalFormat)
+    {
+        const u32 index = Detail::FindGlFormatIndex(glInternalFormat);
+        return index < Detail::glFormatDescriptors.size() ? Detail::glFormatDescriptors[index].formatSize
+                                                          : Detail::unknownFormatSize;
+    }
+
+    // Unknown formats, including the multi-planar ones, report a block size of 0
+    constexpr KtxFormatSize GetVkFormatSize(const u32 vkFormat)
+    {
+        const u32 index = Detail::GetVkFormatIndex(vkFormat);
+        return index < Detail::vkFormatCount ? Detail::vkFormatSizes[index] : Detail::unknownFormatSize;
+    }
+
+    // VkFormat with the same layout as the GL internal format, 0 (VK_FORMAT_UNDEFINED) if Vulkan has none
+    constexpr u32 GetVkFormatFromGl(const u32 glInternalFormat)
+    {
+        const u32 index = Detail::FindGlFormatIndex(glInternalFormat);
+        return index < Detail::glToVkFormats.size() ? Detail::glToVkFormats[index] : 0;
+    }
+
+    // GL internal format with the same layout as the VkFormat, 0 if GL has none
+    constexpr u32 GetGlFormatFromVk(const u32 vkFormat)
+    {
+        const u32 index = Detail::GetVkFormatIndex(vkFormat);
+        return index < Detail::vkToGlFormats.size() ? Detail::vkToGlFormats[index] : 0;
+    }
+
+    // Compile time format information, e.g. FormatTraits<GL_COMPRESSED_RGBA_BPTC_UNORM>::blockSize
+    template<u32 GlInternalFormat>
+    struct FormatTraits
+    {
+    private:
+        static consteval KtxFormatSize Lookup()
+        {
+            return GetGlFormatSize(GlInternalFormat);
+        }
+
+    public:
+        static constexpr KtxFormatSize formatSize = Lookup();
+        static_assert(formatSize.blockSize != 0, "Unknown GL internal format");
+
+        // In bits, same as KtxFormatSize
+        static constexpr u32 blockSize = formatSize.blockSize;
+        static constexpr u32 blockWidth = formatSize.blockWidth;
+        static constexpr u32 blockHeight = formatSize.blockHeight;
+        static constexpr u32 blockDepth = formatSize.blockDepth;
+        static constexpr bool isCompressed = formatSize.flags & KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
+        static constexpr bool isPacked = formatSize.flags & KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
+        static constexpr bool hasDepth = formatSize.flags & KtxFormatSizeFlagBits::eKtxFormatSizeDepthBit;
+        static constexpr bool hasStencil = formatSize.flags & KtxFormatSizeFlagBits::eKtxFormatSizeStencilBit;
+    };
+} // namespace KTX
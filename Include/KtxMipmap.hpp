@@ -0,0 +1,33 @@
+#pragma once
+#include <expected>
+
+#include "KtxUtility.hpp"
+
+// CPU generation of mip chains for uncompressed textures, for files that leave the chain to the loader
+// (generateMipmaps) and for tools that build their own
+
+namespace KTX
+{
+    enum class KtxMipFilter
+    {
+        eBox, // Area average, a plain 2x2 average for even sizes
+        eKaiser, // Kaiser windowed sinc 3 texels wide, keeps more detail than box with a little ringing
+        eLanczos, // Lanczos 3, the sharpest of the three
+    };
+
+    struct KtxMipOptions
+    {
+        KtxMipFilter filter = KtxMipFilter::eBox;
+        // Levels in the result counting level 0, 0 for a full chain down to 1x1
+        u32 numLevels = 0;
+    };
+
+    // True for the plain 8, 16 and 32 bit UNORM, SNORM, SRGB and SFLOAT formats with 1 to 4 channels
+    [[nodiscard]] bool SupportsMipGeneration(u32 vkFormat);
+    // Builds a new texture whose levels are filtered down from level 0, each one from the level before it. sRGB formats
+    // are filtered in linear space with alpha kept linear, edges are clamped. Every image is split into bands of rows,
+    // one pool task each. Fails with eUnsupportedFeature for other formats and for 3D textures. Textures loaded without
+    // image data have level 0 read first, which is not thread safe.
+    std::expected<KtxTexture, KtxResult> GenerateMipmaps(KtxThreadPool& pool, KtxTexture& texture,
+                                                         const KtxMipOptions& options = {});
+} // namespace KTX
@@ -0,0 +1,63 @@
+#pragma once
+#include <expected>
+#include <memory>
+#include <span>
+
+#include "KtxUtility.hpp"
+
+// Transcoding of BasisLZ supercompressed (ETC1S) and UASTC ktx2 textures into block formats the GPU can sample directly
+
+namespace KTX
+{
+    enum class KtxTranscodeTarget
+    {
+        eRGBA8, // Uncompressed, 4 bytes per pixel
+        eBC1,
+        eBC3,
+        eBC4, // Red only
+        eBC5, // Red, and alpha in the second channel (green if the texture has no alpha)
+        eBC7,
+        eETC2RGB, // Written as ETC1 blocks, which every ETC2 decoder reads
+        eETC2RGBA,
+        eASTC4x4,
+    };
+
+    // Vulkan format of the transcoded data, the sRGB variant where the target has one and srgb is set
+    [[nodiscard]] u32 GetTranscodeTargetVkFormat(KtxTranscodeTarget target, bool srgb);
+
+    // Holds everything decoded from the supercompression global data of a texture: the endpoint and selector codebooks,
+    // the Huffman tables of the slices and the image descriptors. Decoding the codebooks is the expensive part, so it
+    // is done once per file and shared by every level, layer and face. The const members are safe to call from any
+    // number of threads. UASTC has no global data, its blocks are transcoded one by one.
+    class KtxTranscoder
+    {
+    public:
+        // Fails with eUnsupportedFeature unless the texture is BasisLZ supercompressed or UASTC (by the color model of
+        // its DFD). UASTC levels are read as the loader leaves them, after any Zstd or zlib supercompression is undone.
+        static std::expected<KtxTranscoder, KtxResult> Create(const KtxTexture& texture);
+
+        ~KtxTranscoder();
+        KtxTranscoder(KtxTranscoder&& other) noexcept;
+        KtxTranscoder& operator=(KtxTranscoder&& other) noexcept;
+
+        [[nodiscard]] bool HasAlpha() const;
+        [[nodiscard]] bool IsSrgb() const;
+        // Size of a transcoded level for all layers and faces, images are written back to back like the image data
+        [[nodiscard]] u64 GetTranscodedLevelSize(u32 level, KtxTranscodeTarget target) const;
+
+        // Transcodes one level, levelData is the level as stored (KtxTexture::GetLevel or KtxTexture::ReadLevel)
+        KtxResult TranscodeLevel(u32 level, std::span<const u8> levelData, KtxTranscodeTarget target,
+                                 std::span<u8> destination) const;
+        // Transcodes every level into a new texture in the target format, one pool task per image (per band of block
+        // rows for UASTC). Textures loaded without image data have their levels read first, which is not thread safe.
+        std::expected<KtxTexture, KtxResult> Transcode(KtxThreadPool& pool, KtxTexture& texture,
+                                                       KtxTranscodeTarget target) const;
+
+        struct Impl;
+
+    private:
+        explicit KtxTranscoder(std::unique_ptr<Impl> impl);
+
+        std::unique_ptr<Impl> impl;
+    };
+} // namespace KTX
@@ -1,15 +1,471 @@
 #pragma once
+#include <algorithm>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <future>
+#include <iosfwd>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "string_view"
 
 // Inspired From https://github.com/KhronosGroup/KTX-Software/
 
 namespace KTX
 {
+    using u8 = uint8_t;
+    using u16 = uint16_t;
+    using u32 = uint32_t;
+    using u64 = uint64_t;
+    using i8 = int8_t;
+    using i16 = int16_t;
+    using i32 = int32_t;
+    using i64 = int64_t;
+
     enum class KtxCreateFlags
     {
-        eNone = 0, // Only loads info about the ktx texture
-        eLoadImageData = 1 // Loads the entire image into memory
+        eNone = 0, // Only loads info and metadata, levels are read on demand. See ProbeKTXFromFile for just the info
+        // Loads the entire image into memory, supercompressed levels are decompressed except BasisLZ ones which are
+        // kept as stored for KtxTranscoder. Levels are decompressed one after another on the loading thread, load with
+        // eNone and use KtxTexture::ReadLevels to decompress them in parallel on a pool.
+        eLoadImageData = 1
+    };
+
+    enum class KtxResult
+    {
+        eSuccess = 0,
+        eFileOpenFailed, // The file could not be opened or mapped
+        eFileReadError, // The file ended early or a read failed
+        eUnknownFileFormat, // The identifier is neither ktx nor ktx2
+        eFileDataError, // The header or the layout of the file is inconsistent
+        eUnsupportedFeature, // Valid ktx data that this library can't handle yet
+        eFileWriteError, // Writing the file failed part way, the disk may be full
+    };
+
+    [[nodiscard]] std::string_view ToString(KtxResult result);
+
+    // Ktx2 supercompressionScheme values
+    enum class KtxSupercompressionScheme
+    {
+        eNone = 0,
+        eBasisLZ = 1,
+        eZstd = 2, // Needs KtxWithZstd
+        eZlib = 3, // Needs KtxWithZlib
+    };
+
+    // Gets decoded data piece by piece, return false to stop
+    using KtxChunkCallback = std::function<bool(std::span<const u8> chunk)>;
+
+    enum class KtxFormatSizeFlagBits
+    {
+        eKtxFormatSizePackedBit = 0x00000001,
+        eKtxFormatSizeCompressedBit = 0x00000002,
+        eKtxFormatSizePalettizedBit = 0x00000004,
+        eKtxFormatSizeDepthBit = 0x00000008,
+        eKtxFormatSizeStencilBit = 0x00000010,
+        eKtxFormatSizeYuvsdaBit = 0x00000020,
+    };
+
+    template<typename Enum>
+    class Flags
+    {
+    public:
+        constexpr Flags(Enum value = static_cast<Enum>(0)) : enumValue(value) {}
+
+        constexpr Flags& operator=(int intValue)
+        {
+            enumValue = static_cast<Enum>(intValue);
+            return *this;
+        }
+
+        constexpr Flags operator|(Flags other) const
+        {
+            return Flags(static_cast<Enum>(static_cast<int>(enumValue) | static_cast<int>(other.enumValue)));
+        }
+
+        constexpr bool operator&(Flags other) const
+        {
+            return static_cast<int>(enumValue) & static_cast<int>(other.enumValue);
+        }
+
+        constexpr Flags operator^(Flags other) const
+        {
+            return Flags(static_cast<Enum>(static_cast<int>(enumValue) ^ static_cast<int>(other.enumValue)));
+        }
+
+        constexpr Enum value() const { return enumValue; }
+
+    private:
+        Enum enumValue;
+    };
+
+    template<typename Enum>
+    constexpr Flags<Enum> operator|(Enum lhs, Enum rhs)
+    {
+        return Flags<Enum>(lhs) | Flags<Enum>(rhs);
+    }
+
+    template<typename Enum>
+    constexpr bool operator&(Enum lhs, Enum rhs)
+    {
+        return Flags<Enum>(lhs) & Flags<Enum>(rhs);
+    }
+
+    struct KtxFormatSize
+    {
+        Flags<KtxFormatSizeFlagBits> flags;
+        u32 palleteSize;
+        u32 blockSize;
+        u32 blockWidth;
+        u32 blockHeight;
+        u32 blockDepth;
+        u32 minBlocksX;
+        u32 minBlocksY;
+    };
+
+    enum class KtxOrientationX
+    {
+        eLeft = 'l',
+        eRight = 'r',
+    };
+
+    enum class KtxOrientationY
+    {
+        eUp = 'u',
+        eDown = 'd',
+    };
+
+    enum class KtxOrientationZ
+    {
+        eIn = 'i',
+        eOut = 'o'
+    };
+
+    struct KtxOrientation
+    {
+        KtxOrientationX x;
+        KtxOrientationY y;
+        KtxOrientationZ z;
     };
-    
-    void LoadKTXFromFile(std::string_view fileName, KtxCreateFlags flags = KtxCreateFlags::eNone);
+
+    // Everything that can be learned about a texture from its header and key/value data
+    struct KtxTextureInfo
+    {
+        KtxFormatSize formatSize;
+        u32 typeSize;
+        bool isKtx2;
+        bool isArray;
+        bool isCubeMap;
+        bool isCompressed;
+        // Only level 0 is stored and the rest is left to the reader, see GenerateMipmaps in KtxMipmap.hpp
+        bool generateMipmaps;
+        // Ktx1 file of the other endianness. Image data handed out by KtxTexture is already converted by glTypeSize.
+        bool needSwap;
+        u32 baseWidth;
+        u32 baseHeight;
+        u32 baseDepth;
+        u32 numDimensions;
+        u32 numLevels;
+        u32 numLayers;
+        u32 numFaces;
+        KtxOrientation orientation;
+        // Ktx1 only, except glInternalFormat which ktx2 textures get from vkFormat (0 if GL has no match)
+        u32 glFormat;
+        u32 glInternalFormat;
+        u32 glBaseInternalFormat;
+        u32 glType;
+        // Ktx2 only, except vkFormat which ktx1 textures get from glInternalFormat (0 if Vulkan has no match)
+        u32 vkFormat;
+        u32 superCompressionScheme;
+    };
+
+    // Location of a mip level (all layers and faces) inside the image data of a texture
+    struct KtxLevelRange
+    {
+        u64 byteOffset;
+        u64 byteLength;
+    };
+
+    // Level index entry, offsets are relative to the start of the file. Ktx1 files have no level index, so it is
+    // built by walking the imageSize fields and byteOffset points past them.
+    struct KtxLevelIndexEntry
+    {
+        u64 byteOffset;
+        u64 byteLength;
+        u64 uncompressedByteLength;
+    };
+
+    struct KtxKeyValue
+    {
+        std::string_view key;
+        // Raw value bytes, string values keep their terminator
+        std::span<const u8> value;
+    };
+
+    // Key/value data parsed into a flat array sorted by key. Entries point straight into the key/value block, which has
+    // to outlive the map; building it costs a single allocation no matter how many entries there are.
+    class KtxKeyValueMap
+    {
+    public:
+        KtxKeyValueMap() = default;
+        // Ktx1 files from a machine with the other endianness need swapLengths. Entries without a terminated key are
+        // skipped, parsing stops at the first entry that runs past the end of the block.
+        explicit KtxKeyValueMap(std::span<const u8> kvData, bool swapLengths = false);
+
+        [[nodiscard]] std::span<const KtxKeyValue> GetEntries() const { return entries; }
+        [[nodiscard]] bool IsEmpty() const { return entries.empty(); }
+        [[nodiscard]] const KtxKeyValue* Find(std::string_view key) const;
+        // Value without its terminator, empty if the key is missing
+        [[nodiscard]] std::string_view FindString(std::string_view key) const;
+
+    private:
+        std::vector<KtxKeyValue> entries;
+    };
+
+    // Random access source for the loaders, implement it to load straight out of archives or network caches
+    class KtxStream
+    {
+    public:
+        virtual ~KtxStream() = default;
+
+        // Reads exactly destination.size() bytes starting at offset, false if the source is too short or failed
+        virtual bool Read(u64 offset, std::span<u8> destination) = 0;
+        [[nodiscard]] virtual u64 GetSize() const = 0;
+        // Sources that already hold every byte in memory return them here so headers are decoded in place
+        [[nodiscard]] virtual std::span<const u8> GetData() const { return {}; }
+    };
+
+    class KtxFileStream final : public KtxStream
+    {
+    public:
+        explicit KtxFileStream(std::string_view fileName);
+        ~KtxFileStream() override;
+
+        [[nodiscard]] bool IsOpen() const;
+        bool Read(u64 offset, std::span<u8> destination) override;
+        [[nodiscard]] u64 GetSize() const override { return size; }
+
+    private:
+        std::unique_ptr<std::fstream> file;
+        u64 size = 0;
+    };
+
+    // Reads from a caller owned buffer, which has to outlive the stream and every texture that still reads from it
+    class KtxMemoryStream final : public KtxStream
+    {
+    public:
+        explicit KtxMemoryStream(std::span<const u8> data) : data(data) {}
+
+        bool Read(u64 offset, std::span<u8> destination) override;
+        [[nodiscard]] u64 GetSize() const override { return data.size(); }
+        [[nodiscard]] std::span<const u8> GetData() const override { return data; }
+
+    private:
+        std::span<const u8> data;
+    };
+
+    class KtxThreadPool;
+    struct KtxDataFormatDescriptor;
+
+    // Owning, move-only handle to a loaded texture. Moving it only moves the buffers, pixel data is never copied.
+    class KtxTexture
+    {
+    public:
+        KtxTexture() = default;
+        explicit KtxTexture(const KtxTextureInfo& info, std::vector<u8> keyValueData = {});
+        ~KtxTexture();
+
+        KtxTexture(const KtxTexture&) = delete;
+        KtxTexture& operator=(const KtxTexture&) = delete;
+        KtxTexture(KtxTexture&& other) noexcept;
+        KtxTexture& operator=(KtxTexture&& other) noexcept;
+
+        [[nodiscard]] const KtxTextureInfo& GetInfo() const { return info; }
+        [[nodiscard]] std::span<const u8> GetKeyValueData() const { return keyValueData; }
+        [[nodiscard]] const KtxKeyValueMap& GetKeyValues() const { return keyValues; }
+        [[nodiscard]] std::span<const u8> GetDataFormatDescriptor() const { return dataFormatDescriptor; }
+        // Parsed DFD from the process wide cache in KtxDfd.hpp, textures with the same DFD bytes share it. Null for
+        // ktx1 textures, for DFDs that don't parse and for those the bounded cache turns away.
+        [[nodiscard]] const KtxDataFormatDescriptor* GetFormatDescriptor() const { return formatDescriptor; }
+        [[nodiscard]] std::span<const u8> GetSuperCompressionGlobalData() const { return superCompressionGlobalData; }
+        [[nodiscard]] std::span<const KtxLevelIndexEntry> GetLevelIndex() const { return levelIndex; }
+
+        [[nodiscard]] u32 GetLevelWidth(u32 level) const { return std::max(info.baseWidth >> level, 1u); }
+        [[nodiscard]] u32 GetLevelHeight(u32 level) const { return std::max(info.baseHeight >> level, 1u); }
+        [[nodiscard]] u32 GetLevelDepth(u32 level) const { return std::max(info.baseDepth >> level, 1u); }
+        // Size of a level for all layers and faces as computed from the format, 0 if the format is unknown
+        [[nodiscard]] u64 GetLevelSize(u32 level) const;
+
+        // Sum of the uncompressed sizes in the level index (stored sizes for BasisLZ), the size ReadLevels needs
+        [[nodiscard]] u64 GetUncompressedSize() const;
+
+        // Reads a single level straight from the source through the level index, supercompressed levels are
+        // decompressed into the destination which needs room for uncompressedByteLength. Only available when the
+        // image data wasn't loaded up front, the source stays open for the lifetime of the texture. Not thread safe.
+        bool ReadLevel(u32 level, std::span<u8> destination);
+        // Decodes a level piece by piece without ever holding all of it, for levels too large to keep in memory. Each
+        // chunk handed to onChunk is at most buffer.size() bytes and is only valid during the call. Returns false if
+        // the level couldn't be read or decoded, or onChunk stopped early. Byte swapped ktx1 levels only use as much of
+        // the buffer as holds whole elements. Same requirements as ReadLevel.
+        bool StreamLevel(u32 level, std::span<u8> buffer, const KtxChunkCallback& onChunk);
+        // Reads every level into the destination, back to back starting with level 0 like the loaded image data. The
+        // compressed data is read with a single read and the levels are decompressed in parallel, one task per level.
+        // Same requirements as ReadLevel.
+        bool ReadLevels(KtxThreadPool& pool, std::span<u8> destination);
+
+        [[nodiscard]] bool HasImageData() const { return imageData != nullptr; }
+        [[nodiscard]] std::span<const u8> GetImageData() const { return {imageData.get(), imageSize}; }
+        [[nodiscard]] std::span<u8> GetImageData() { return {imageData.get(), imageSize}; }
+        [[nodiscard]] std::span<const KtxLevelRange> GetLevelRanges() const { return levels; }
+        // Image data of a mip level for all layers and faces, requires the image data to be loaded
+        [[nodiscard]] std::span<const u8> GetLevel(u32 level) const;
+
+        // Takes ownership of the image data, levels index into it
+        void SetImageData(std::unique_ptr<u8[]> data, u64 size, std::vector<KtxLevelRange> levelRanges);
+
+    private:
+        friend std::expected<KtxTexture, KtxResult> LoadKTXFromStream(std::unique_ptr<KtxStream> stream,
+                                                                      KtxCreateFlags flags);
+        friend std::vector<std::expected<KtxTexture, KtxResult>> LoadKTXBulk(std::span<const std::string> fileNames,
+                                                                             KtxCreateFlags flags);
+
+        KtxTextureInfo info{};
+        std::vector<u8> keyValueData;
+        KtxKeyValueMap keyValues;
+        std::vector<u8> dataFormatDescriptor;
+        const KtxDataFormatDescriptor* formatDescriptor = nullptr;
+        std::vector<u8> superCompressionGlobalData;
+        std::vector<KtxLevelIndexEntry> levelIndex;
+        std::unique_ptr<KtxStream> stream;
+        std::unique_ptr<u8[]> imageData;
+        u64 imageSize = 0;
+        std::vector<KtxLevelRange> levels;
+    };
+
+    // Streams the levels of a texture loaded with KtxCreateFlags::eNone one at a time, from the coarsest to the finest,
+    // into caller provided buffers. The texture must outlive the streamer.
+    class KtxMipStreamer
+    {
+    public:
+        explicit KtxMipStreamer(KtxTexture& texture) : texture(&texture), remainingLevels(texture.GetInfo().numLevels)
+        {
+        }
+
+        [[nodiscard]] bool HasNext() const { return remainingLevels > 0; }
+        [[nodiscard]] u32 GetNextLevel() const { return remainingLevels - 1; }
+        // Number of bytes StreamNext will write
+        [[nodiscard]] u64 GetNextLevelSize() const;
+        // Reads the next level into the destination and moves on to the next finer one
+        bool StreamNext(std::span<u8> destination);
+
+    private:
+        KtxTexture* texture;
+        u32 remainingLevels;
+    };
+
+    // Read-only view of a ktx/ktx2 file mapped into the address space. Every span points straight into the mapping
+    // and stays valid for as long as the object is alive; nothing is copied unless CopyLevel is called.
+    class KtxMappedFile
+    {
+    public:
+        KtxMappedFile() = default;
+        ~KtxMappedFile();
+
+        KtxMappedFile(const KtxMappedFile&) = delete;
+        KtxMappedFile& operator=(const KtxMappedFile&) = delete;
+        KtxMappedFile(KtxMappedFile&& other) noexcept;
+        KtxMappedFile& operator=(KtxMappedFile&& other) noexcept;
+
+        [[nodiscard]] bool IsOpen() const { return data != nullptr; }
+        [[nodiscard]] bool IsKtx2() const { return isKtx2; }
+        // Ktx1 only, the header returned by GetHeader and GetLevel are still in file order. CopyLevel swaps.
+        [[nodiscard]] bool NeedsEndianSwap() const { return needSwap; }
+
+        [[nodiscard]] std::span<const u8> GetFileData() const { return {data, size}; }
+        [[nodiscard]] std::span<const u8> GetHeader() const;
+        [[nodiscard]] std::span<const u8> GetKeyValueData() const { return keyValueData; }
+        // Parsed on every call, the entries point into the mapping
+        [[nodiscard]] KtxKeyValueMap GetKeyValues() const { return KtxKeyValueMap(keyValueData, needSwap); }
+        [[nodiscard]] u32 GetNumLevels() const { return static_cast<u32>(levels.size()); }
+        // Image data of a mip level for all layers and faces, without the ktx1 imageSize field or mip padding. Faces of
+        // ktx1 cube maps that aren't arrays keep the padding to 4 bytes after each face, which only shows up for
+        // uncompressed faces whose size isn't a multiple of 4.
+        [[nodiscard]] std::span<const u8> GetLevel(u32 level) const;
+        // Same data in native byte order, swapped during the copy when needed
+        [[nodiscard]] std::vector<u8> CopyLevel(u32 level) const;
+
+    private:
+        friend std::expected<KtxMappedFile, KtxResult> MapKTXFromFile(std::string_view fileName);
+        void Unmap();
+
+        const u8* data = nullptr;
+        size_t size = 0;
+        bool isKtx2 = false;
+        bool needSwap = false;
+        u32 typeSize = 1;
+        std::span<const u8> keyValueData;
+        std::vector<std::span<const u8>> levels;
+    };
+
+    // Work stealing thread pool used for batch loads and any other work the library splits across cores
+    class KtxThreadPool
+    {
+    public:
+        explicit KtxThreadPool(u32 threadCount = std::thread::hardware_concurrency());
+        ~KtxThreadPool();
+
+        KtxThreadPool(const KtxThreadPool&) = delete;
+        KtxThreadPool& operator=(const KtxThreadPool&) = delete;
+
+        [[nodiscard]] u32 GetThreadCount() const;
+        void Submit(std::function<void()> task);
+        // Runs one queued task on the calling thread, returns false if there was nothing to run
+        bool RunPendingTask();
+        // Blocks until every submitted task has finished, helping out with queued tasks in the meantime
+        void WaitIdle();
+        // Runs task(index) for every index and returns once all of them are done. The calling thread helps out with
+        // queued tasks while it waits, so this is safe to call from inside a pool task.
+        void ParallelFor(u32 count, const std::function<void(u32 index)>& task);
+
+        struct Impl;
+
+    private:
+        std::unique_ptr<Impl> impl;
+    };
+
+    using KtxLoadResult = std::expected<KtxTexture, KtxResult>;
+    // Called from a worker thread with the position of the file in the batch
+    using KtxLoadCallback = std::function<void(size_t index, KtxLoadResult result)>;
+
+    KtxLoadResult LoadKTXFromFile(std::string_view fileName, KtxCreateFlags flags = KtxCreateFlags::eNone);
+    // Without KtxCreateFlags::eLoadImageData the texture keeps the stream to read levels on demand
+    KtxLoadResult LoadKTXFromStream(std::unique_ptr<KtxStream> stream, KtxCreateFlags flags = KtxCreateFlags::eNone);
+    // Image data is copied with KtxCreateFlags::eLoadImageData, otherwise levels are read from the buffer on demand and
+    // it has to outlive the texture
+    KtxLoadResult LoadKTXFromMemory(std::span<const u8> data, KtxCreateFlags flags = KtxCreateFlags::eNone);
+    // Loads every file on the pool, one task per file. Errors are reported per file through the results.
+    std::vector<std::future<KtxLoadResult>> LoadKTXBatch(KtxThreadPool& pool, std::span<const std::string> fileNames,
+                                                         KtxCreateFlags flags = KtxCreateFlags::eNone);
+    // Same as above but hands every texture to the callback as soon as it's loaded, use KtxThreadPool::WaitIdle to
+    // wait for the whole batch
+    void LoadKTXBatch(KtxThreadPool& pool, std::span<const std::string> fileNames, KtxCreateFlags flags,
+                      KtxLoadCallback onLoaded);
+    // Loads many files from the calling thread while keeping the number of syscalls low: files are processed in groups,
+    // every read of a group is submitted together and the first read of a file covers its header and usually all of
+    // its metadata. Uses io_uring on Linux builds with KtxWithIoUring and pread elsewhere.
+    std::vector<KtxLoadResult> LoadKTXBulk(std::span<const std::string> fileNames,
+                                           KtxCreateFlags flags = KtxCreateFlags::eNone);
+    // Maps the file instead of streaming it
+    std::expected<KtxMappedFile, KtxResult> MapKTXFromFile(std::string_view fileName);
+    // Decodes and validates the ktx/ktx2 header at the start of the buffer, only the first 64/80 bytes are read
+    std::expected<KtxTextureInfo, KtxResult> DecodeKTXHeader(std::span<const u8> data);
+    // Fills in everything KtxTextureInfo offers, including the orientation, from the header and the key/value data in
+    // the first 4 KiB of the file. Uses a single read and no heap allocations, meant for indexing large libraries.
+    std::expected<KtxTextureInfo, KtxResult> ProbeKTXFromFile(std::string_view fileName);
+    // Same as above for a file that is already in memory
+    std::expected<KtxTextureInfo, KtxResult> ProbeKTXFromMemory(std::span<const u8> data);
 }
@@ -0,0 +1,64 @@
+#pragma once
+#include <expected>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "KtxUtility.hpp"
+
+// Serialization of textures into ktx2 files: header, level index, DFD, key/value data, global data and the levels
+
+namespace KTX
+{
+    // Level alignment that lets a mapped file hand the pages of a level straight to an upload path
+    constexpr u32 ktxPageAlignment = 4096;
+
+    struct KtxWriteOptions
+    {
+        // Every level starts at a multiple of this as well as of the alignment the spec asks for, the gap before a
+        // level is zero filled. 0 packs the levels as tightly as the spec allows.
+        u32 levelAlignment = 0;
+        // Supercompresses sources that are not supercompressed yet, Zstd needs KtxWithZstd and zlib KtxWithZlib.
+        // Sources that already are fail with eUnsupportedFeature unless this is eNone.
+        KtxSupercompressionScheme superCompressionScheme = KtxSupercompressionScheme::eNone;
+        // Handed to the compressor, 0 picks its default level
+        i32 compressionLevel = 0;
+    };
+
+    // A texture described piece by piece, for data that doesn't live in a KtxTexture
+    struct KtxWriteSource
+    {
+        // Only the ktx2 header fields are used: vkFormat, typeSize, the dimensions (numDimensions decides whether
+        // height and depth are written), numLevels, numLayers with isArray, numFaces, generateMipmaps and
+        // superCompressionScheme
+        KtxTextureInfo info;
+        // numLevels levels, level 0 first, each one holding every layer, face and depth slice. Supercompressed levels
+        // are written as they are, uncompressed ones have to match the size of the format.
+        std::span<const std::span<const u8>> levels;
+        // Size of every level once decompressed, only used for Zstd and zlib
+        std::span<const u64> uncompressedByteLengths{};
+        // Key/value data laid out as in a file, entries are written sorted by key and KTXwriter is added if missing
+        std::span<const u8> keyValueData{};
+        // Used instead of keyValueData when set, in any order
+        std::span<const KtxKeyValue> keyValues{};
+        // Written as is when set, otherwise built from vkFormat. Building it works for the plain 8, 16 and 32 bit
+        // formats, the BC, ETC2, EAC and ASTC formats and the packed and depth/stencil formats ktx1 files map to
+        // (4444, 565, 5551, 2_10_10_10, 11_11_10, 9E5, D16, X8_D24, D32F, S8 and the combined depth/stencil ones).
+        // Anything else fails with eUnsupportedFeature.
+        std::span<const u8> dataFormatDescriptor{};
+        std::span<const u8> superCompressionGlobalData{};
+    };
+
+    [[nodiscard]] std::expected<std::vector<u8>, KtxResult> WriteKTX2ToMemory(const KtxWriteSource& source,
+                                                                            const KtxWriteOptions& options = {});
+    // Writes the metadata and then every level straight from the source, only supercompressed levels are staged
+    KtxResult WriteKTX2ToFile(std::string_view fileName, const KtxWriteSource& source,
+                              const KtxWriteOptions& options = {});
+
+    // Same as above for a loaded texture, ktx1 ones included as long as their levels carry no row padding. Zstd and
+    // zlib levels are written decompressed, BasisLZ ones as stored along with the global data. Textures loaded without
+    // image data have their levels read first, which is not thread safe.
+    [[nodiscard]] std::expected<std::vector<u8>, KtxResult> WriteKTX2ToMemory(KtxTexture& texture,
+                                                                            const KtxWriteOptions& options = {});
+    KtxResult WriteKTX2ToFile(std::string_view fileName, KtxTexture& texture, const KtxWriteOptions& options = {});
+} // namespace KTX
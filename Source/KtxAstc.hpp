@@ -0,0 +1,350 @@
+#pragma once
+#include <array>
+#include <bit>
+
+#include "KtxUtility.hpp"
+
+// Integer sequence encoding, unquantization and partition tables of the ASTC format, shared by the UASTC transcoder
+// and the ASTC decoder
+
+namespace KTX::Astc
+{
+    struct IseRange
+    {
+        u8 bits;
+        u8 trits;
+        u8 quints;
+    };
+
+    // ASTC quantization ranges in order, weights use the first 12
+    inline constexpr std::array<IseRange, 21> iseRanges = {{
+            {1, 0, 0}, {0, 1, 0}, {2, 0, 0}, {0, 0, 1}, {1, 1, 0}, {3, 0, 0}, {1, 0, 1},
+            {2, 1, 0}, {4, 0, 0}, {2, 0, 1}, {3, 1, 0}, {5, 0, 0}, {3, 0, 1}, {4, 1, 0},
+            {6, 0, 0}, {4, 0, 1}, {5, 1, 0}, {7, 0, 0}, {5, 0, 1}, {6, 1, 0}, {8, 0, 0},
+    }};
+    inline constexpr u32 weightRangeCount = 12;
+
+    constexpr u32 GetIseBitCount(const u32 count, const IseRange& range)
+    {
+        return count * range.bits + (8 * count + 4) / 5 * range.trits + (7 * count + 2) / 3 * range.quints;
+    }
+
+    constexpr u32 GetIseLevels(const IseRange& range)
+    {
+        return (1u << range.bits) * (range.trits ? 3 : range.quints ? 5 : 1);
+    }
+
+    // Five trits from the 8 bits ASTC packs them into
+    constexpr std::array<u8, 5> DecodeTrits(const u32 packed)
+    {
+        const auto bit = [](const u32 value, const u32 index) { return (value >> index) & 1; };
+        u32 c;
+        std::array<u8, 5> trits{};
+        if (((packed >> 2) & 7) == 7)
+        {
+            c = ((packed >> 5) & 7) << 2 | (packed & 3);
+            trits[4] = 2;
+            trits[3] = 2;
+        } else
+        {
+            c = packed & 31;
+            if (((packed >> 5) & 3) == 3)
+            {
+                trits[4] = 2;
+                trits[3] = static_cast<u8>(bit(packed, 7));
+            } else
+            {
+                trits[4] = static_cast<u8>(bit(packed, 7));
+                trits[3] = static_cast<u8>((packed >> 5) & 3);
+            }
+        }
+        if ((c & 3) == 3)
+        {
+            trits[2] = 2;
+            trits[1] = static_cast<u8>(bit(c, 4));
+            trits[0] = static_cast<u8>(bit(c, 3) << 1 | (bit(c, 2) & ~bit(c, 3) & 1));
+        } else if (((c >> 2) & 3) == 3)
+        {
+            trits[2] = 2;
+            trits[1] = 2;
+            trits[0] = static_cast<u8>(c & 3);
+        } else
+        {
+            trits[2] = static_cast<u8>(bit(c, 4));
+            trits[1] = static_cast<u8>((c >> 2) & 3);
+            trits[0] = static_cast<u8>(bit(c, 1) << 1 | (bit(c, 0) & ~bit(c, 1) & 1));
+        }
+        return trits;
+    }
+
+    // Three quints from the 7 bits ASTC packs them into
+    constexpr std::array<u8, 3> DecodeQuints(const u32 packed)
+    {
+        const auto bit = [](const u32 value, const u32 index) { return (value >> index) & 1; };
+        std::array<u8, 3> quints{};
+        if (((packed >> 1) & 3) == 3 && ((packed >> 5) & 3) == 0)
+        {
+            const u32 low = bit(packed, 0);
+            quints[2] = static_cast<u8>(low << 2 | (bit(packed, 4) & ~low & 1) << 1 | (bit(packed, 3) & ~low & 1));
+            quints[1] = 4;
+            quints[0] = 4;
+            return quints;
+        }
+        u32 c;
+        if (((packed >> 1) & 3) == 3)
+        {
+            quints[2] = 4;
+            c = ((packed >> 3) & 3) << 3 | (~(packed >> 5) & 3) << 1 | bit(packed, 0);
+        } else
+        {
+            quints[2] = static_cast<u8>((packed >> 5) & 3);
+            c = packed & 31;
+        }
+        if ((c & 7) == 5)
+        {
+            quints[1] = 4;
+            quints[0] = static_cast<u8>((c >> 3) & 3);
+        } else
+        {
+            quints[1] = static_cast<u8>((c >> 3) & 3);
+            quints[0] = static_cast<u8>(c & 7);
+        }
+        return quints;
+    }
+
+    // Repeats the bits of value until count bits are filled, keeping the top ones
+    constexpr u32 ReplicateBits(const u32 value, const u32 bits, const u32 count)
+    {
+        u32 result = 0;
+        u32 filled = 0;
+        while (filled < count)
+        {
+            result = result << bits | value;
+            filled += bits;
+        }
+        return result >> (filled - count);
+    }
+
+    // ASTC color endpoint unquantization. Trit and quint ranges scramble the low bits so the decoded values spread
+    // evenly over 0..255.
+    constexpr u8 UnquantizeColor(const u32 range, const u32 value)
+    {
+        const auto& ise = iseRanges[range];
+        if (ise.trits == 0 && ise.quints == 0)
+        {
+            return static_cast<u8>(ReplicateBits(value, ise.bits, 8));
+        }
+        if (ise.bits == 0)
+        {
+            constexpr std::array<u8, 3> tritValues = {0, 128, 255};
+            constexpr std::array<u8, 5> quintValues = {0, 64, 128, 191, 255};
+            return ise.trits ? tritValues[value] : quintValues[value];
+        }
+
+        const u32 bits = value & ((1u << ise.bits) - 1);
+        const u32 digit = value >> ise.bits;
+        const u32 b = (bits >> 1) & 1;
+        const u32 c = (bits >> 2) & 1;
+        const u32 d = (bits >> 3) & 1;
+        const u32 e = (bits >> 4) & 1;
+        const u32 f = (bits >> 5) & 1;
+        u32 scale = 0;
+        u32 offset = 0;
+        if (ise.trits)
+        {
+            constexpr std::array<u32, 7> scales = {0, 204, 93, 44, 22, 11, 5};
+            scale = scales[ise.bits];
+            switch (ise.bits)
+            {
+                case 2:
+                    offset = b * 0b100010110;
+                    break;
+                case 3:
+                    offset = c * 0b100001010 + b * 0b010000101;
+                    break;
+                case 4:
+                    offset = d * 0b100000100 + c * 0b010000010 + b * 0b001000001;
+                    break;
+                case 5:
+                    offset = e * 0b100000010 + d * 0b010000001 + c * 0b001000000 + b * 0b000100000;
+                    break;
+                case 6:
+                    offset = f * 0b100000001 + e * 0b010000000 + d * 0b001000000 + c * 0b000100000 + b * 0b000010000;
+                    break;
+                default:
+                    break;
+            }
+        } else
+        {
+            constexpr std::array<u32, 6> scales = {0, 113, 54, 26, 13, 6};
+            scale = scales[ise.bits];
+            switch (ise.bits)
+            {
+                case 2:
+                    offset = b * 0b100001100;
+                    break;
+                case 3:
+                    offset = c * 0b100000101 + b * 0b010000010;
+                    break;
+                case 4:
+                    offset = d * 0b100000010 + c * 0b010000001 + b * 0b001000000;
+                    break;
+                case 5:
+                    offset = e * 0b100000001 + d * 0b010000000 + c * 0b001000000 + b * 0b000100000;
+                    break;
+                default:
+                    break;
+            }
+        }
+        const u32 mask = (bits & 1) ? 0x1FF : 0;
+        const u32 mixed = ((digit * scale + offset) ^ mask) & 0x1FF;
+        return static_cast<u8>((mask & 0x80) | (mixed >> 2));
+    }
+
+    // Weight unquantization to 0..64, the same scrambling on 7 bits. Weights above 32 move up by one so 64 is
+    // reachable.
+    constexpr u8 UnquantizeWeight(const u32 range, const u32 value)
+    {
+        const auto& ise = iseRanges[range];
+        u32 weight = 0;
+        if (ise.trits == 0 && ise.quints == 0)
+        {
+            weight = ReplicateBits(value, ise.bits, 6);
+        } else if (ise.bits == 0)
+        {
+            constexpr std::array<u8, 3> tritValues = {0, 32, 63};
+            constexpr std::array<u8, 5> quintValues = {0, 16, 32, 47, 63};
+            weight = ise.trits ? tritValues[value] : quintValues[value];
+        } else
+        {
+            const u32 bits = value & ((1u << ise.bits) - 1);
+            const u32 digit = value >> ise.bits;
+            const u32 b = (bits >> 1) & 1;
+            const u32 c = (bits >> 2) & 1;
+            u32 scale = 0;
+            u32 offset = 0;
+            if (ise.trits)
+            {
+                constexpr std::array<u32, 4> scales = {0, 50, 23, 11};
+                scale = scales[ise.bits];
+                offset = ise.bits == 2 ? b * 0b1000101 : ise.bits == 3 ? c * 0b1000010 + b * 0b0100001 : 0;
+            } else
+            {
+                constexpr std::array<u32, 3> scales = {0, 28, 13};
+                scale = scales[ise.bits];
+                offset = ise.bits == 2 ? b * 0b1000010 : 0;
+            }
+            const u32 mask = (bits & 1) ? 0x7F : 0;
+            const u32 mixed = ((digit * scale + offset) ^ mask) & 0x7F;
+            weight = (mask & 0x20) | (mixed >> 2);
+        }
+        return static_cast<u8>(weight > 32 ? weight + 1 : weight);
+    }
+
+    inline constexpr auto colorUnquantization = []
+    {
+        std::array<std::array<u8, 256>, iseRanges.size()> table{};
+        for (u32 range = 0; range < iseRanges.size(); ++range)
+        {
+            for (u32 value = 0; value < GetIseLevels(iseRanges[range]); ++value)
+            {
+                table[range][value] = UnquantizeColor(range, value);
+            }
+        }
+        return table;
+    }();
+
+    inline constexpr auto weightUnquantization = []
+    {
+        std::array<std::array<u8, 32>, weightRangeCount> table{};
+        for (u32 range = 0; range < weightRangeCount; ++range)
+        {
+            for (u32 value = 0; value < GetIseLevels(iseRanges[range]); ++value)
+            {
+                table[range][value] = UnquantizeWeight(range, value);
+            }
+        }
+        return table;
+    }();
+
+    // Weights are stored from the top of the block down, so they are read and written bit reversed
+    constexpr u64 ReverseBits(u64 value)
+    {
+        value = ((value >> 1) & 0x5555555555555555) | ((value & 0x5555555555555555) << 1);
+        value = ((value >> 2) & 0x3333333333333333) | ((value & 0x3333333333333333) << 2);
+        value = ((value >> 4) & 0x0F0F0F0F0F0F0F0F) | ((value & 0x0F0F0F0F0F0F0F0F) << 4);
+        return std::byteswap(value);
+    }
+
+    constexpr u32 Hash52(u32 p)
+    {
+        p ^= p >> 15;
+        p -= p << 17;
+        p += p << 7;
+        p += p << 4;
+        p ^= p >> 5;
+        p += p << 16;
+        p ^= p >> 7;
+        p ^= p >> 3;
+        p ^= p << 6;
+        p ^= p >> 17;
+        return p;
+    }
+
+    // The part of the ASTC partition function that only depends on the seed and the subset count
+    struct PartitionHash
+    {
+        // Squared and shifted, the other four only apply to 3D blocks
+        std::array<u32, 8> seeds;
+        u32 random;
+        u32 subsets;
+    };
+
+    constexpr PartitionHash HashPartitionSeed(u32 seed, const u32 subsets)
+    {
+        seed += (subsets - 1) * 1024;
+        const u32 random = Hash52(seed);
+        PartitionHash hash = {
+                .seeds = {random & 0xF, (random >> 4) & 0xF, (random >> 8) & 0xF, (random >> 12) & 0xF,
+                          (random >> 16) & 0xF, (random >> 20) & 0xF, (random >> 24) & 0xF, (random >> 28) & 0xF},
+                .random = random,
+                .subsets = subsets,
+        };
+
+        u32 shift1;
+        u32 shift2;
+        if (seed & 1)
+        {
+            shift1 = (seed & 2) ? 4 : 5;
+            shift2 = subsets == 3 ? 6 : 5;
+        } else
+        {
+            shift1 = subsets == 3 ? 6 : 5;
+            shift2 = (seed & 2) ? 4 : 5;
+        }
+        for (u32 i = 0; i < hash.seeds.size(); ++i)
+        {
+            hash.seeds[i] = hash.seeds[i] * hash.seeds[i] >> ((i & 1) ? shift2 : shift1);
+        }
+        return hash;
+    }
+
+    // Subset of the texel at x, y of a 2D block. Blocks of fewer than 31 texels pass doubled coordinates.
+    constexpr u32 SelectPartition(const PartitionHash& hash, const u32 x, const u32 y)
+    {
+        const auto& seeds = hash.seeds;
+        const u32 a = (seeds[0] * x + seeds[1] * y + (hash.random >> 14)) & 0x3F;
+        const u32 b = (seeds[2] * x + seeds[3] * y + (hash.random >> 10)) & 0x3F;
+        const u32 c = hash.subsets < 3 ? 0 : (seeds[4] * x + seeds[5] * y + (hash.random >> 6)) & 0x3F;
+        const u32 d = hash.subsets < 4 ? 0 : (seeds[6] * x + seeds[7] * y + (hash.random >> 2)) & 0x3F;
+        if (a >= b && a >= c && a >= d)
+        {
+            return 0;
+        }
+        if (b >= c && b >= d)
+        {
+            return 1;
+        }
+        return c >= d ? 2 : 3;
+    }
+} // namespace KTX::Astc
@@ -0,0 +1,932 @@
+#include "KtxBlockDecoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+#include "KtxAstc.hpp"
+#include "VK_Format.hpp"
+
+namespace
+{
+    using namespace KTX;
+    using Astc::IseRange;
+    using Astc::iseRanges;
+    using Decoders::BlockDecoder;
+    using Decoders::Load64;
+
+    // Variants of the ASTC formats after their decode profile
+    constexpr u32 astcLdr = 0;
+    constexpr u32 astcSrgb = 1;
+    constexpr u32 astcHdr = 2;
+
+    constexpr u32 maxWeights = 64;
+    constexpr u32 maxEndpointValues = 18;
+    // Opaque magenta as RGBA8 and as RGBA16F
+    constexpr u32 errorColor = 0xFFFF00FF;
+    constexpr u64 errorColorHalf = 0x3C003C0000003C00;
+
+    struct BlockMode
+    {
+        u8 gridWidth;
+        u8 gridHeight;
+        u8 weightRange;
+        // Integer sequence encoded size of every weight of the block
+        u8 weightBits;
+        bool isDualPlane;
+        // Reserved encodings and weight grids of more than 64 weights or outside of 24 to 96 bits are not
+        bool isValid;
+    };
+
+    // Weight grid layout of an 11 bit 2D block mode. The void extent encoding comes out invalid.
+    constexpr BlockMode DecodeBlockMode(const u32 mode)
+    {
+        u32 width = 0;
+        u32 height = 0;
+        u32 range = (mode >> 4) & 1;
+        bool isHighPrecision = (mode >> 9) & 1;
+        bool isDualPlane = (mode >> 10) & 1;
+        const u32 a = (mode >> 5) & 3;
+        if ((mode & 3) != 0)
+        {
+            range |= (mode & 3) << 1;
+            const u32 b = (mode >> 7) & 3;
+            switch ((mode >> 2) & 3)
+            {
+                case 0:
+                    width = b + 4;
+                    height = a + 2;
+                    break;
+                case 1:
+                    width = b + 8;
+                    height = a + 2;
+                    break;
+                case 2:
+                    width = a + 2;
+                    height = b + 8;
+                    break;
+                default:
+                    width = (mode & 0x100) ? (b & 1) + 2 : a + 2;
+                    height = (mode & 0x100) ? a + 2 : (b & 1) + 6;
+                    break;
+            }
+        } else
+        {
+            range |= ((mode >> 2) & 3) << 1;
+            if (((mode >> 2) & 3) == 0)
+            {
+                return {};
+            }
+            const u32 b = (mode >> 9) & 3;
+            switch ((mode >> 7) & 3)
+            {
+                case 0:
+                    width = 12;
+                    height = a + 2;
+                    break;
+                case 1:
+                    width = a + 2;
+                    height = 12;
+                    break;
+                case 2:
+                    // The high precision and dual plane bits are part of the grid height here
+                    width = a + 6;
+                    height = b + 6;
+                    isHighPrecision = false;
+                    isDualPlane = false;
+                    break;
+                default:
+                    if (a >= 2)
+                    {
+                        return {};
+                    }
+                    width = a == 0 ? 6 : 10;
+                    height = a == 0 ? 10 : 6;
+                    break;
+            }
+        }
+
+        // Ranges 2 to 7 of the 3 bit field map to the weight ranges 0 to 5, or 6 to 11 with the high precision bit
+        const u32 weightRange = range - 2 + (isHighPrecision ? 6 : 0);
+        const u32 weightCount = width * height * (isDualPlane ? 2 : 1);
+        const u32 weightBits = Astc::GetIseBitCount(weightCount, iseRanges[weightRange]);
+        return {.gridWidth = static_cast<u8>(width),
+                .gridHeight = static_cast<u8>(height),
+                .weightRange = static_cast<u8>(weightRange),
+                .weightBits = static_cast<u8>(weightBits),
+                .isDualPlane = isDualPlane,
+                .isValid = weightCount <= maxWeights && weightBits >= 24 && weightBits <= 96};
+    }
+
+    constexpr auto blockModes = []
+    {
+        std::array<BlockMode, 2048> table{};
+        for (u32 mode = 0; mode < table.size(); ++mode)
+        {
+            table[mode] = DecodeBlockMode(mode);
+        }
+        return table;
+    }();
+
+    // Largest endpoint range whose values fit the bits the block has left, indexed by the number of endpoint pairs
+    // and then the bits. 0xFF when not even the smallest range fits.
+    constexpr auto endpointRanges = []
+    {
+        std::array<std::array<u8, 128>, maxEndpointValues / 2 + 1> table{};
+        for (u32 pairs = 1; pairs < table.size(); ++pairs)
+        {
+            for (u32 bits = 0; bits < 128; ++bits)
+            {
+                table[pairs][bits] = 0xFF;
+                for (u32 range = iseRanges.size(); range-- > 0;)
+                {
+                    if (Astc::GetIseBitCount(pairs * 2, iseRanges[range]) <= bits)
+                    {
+                        table[pairs][bits] = static_cast<u8>(range);
+                        break;
+                    }
+                }
+            }
+        }
+        return table;
+    }();
+    // Ranges of fewer than 6 levels are not allowed for endpoints
+    constexpr u32 minEndpointRange = 4;
+
+    constexpr auto tritDigits = []
+    {
+        std::array<std::array<u8, 5>, 256> table{};
+        for (u32 packed = 0; packed < table.size(); ++packed)
+        {
+            table[packed] = Astc::DecodeTrits(packed);
+        }
+        return table;
+    }();
+
+    constexpr auto quintDigits = []
+    {
+        std::array<std::array<u8, 3>, 128> table{};
+        for (u32 packed = 0; packed < table.size(); ++packed)
+        {
+            table[packed] = Astc::DecodeQuints(packed);
+        }
+        return table;
+    }();
+
+    struct InfillStep
+    {
+        u8 index;
+        // Sixteenths of the way to the next grid point
+        u8 fraction;
+    };
+
+    // Weight grid positions of the texels along one axis, indexed by the block size, the grid size and the texel.
+    // The bilinear infill of a texel is the product of its two axes.
+    constexpr auto infillSteps = []
+    {
+        std::array<std::array<std::array<InfillStep, 12>, 13>, 13> table{};
+        for (u32 blockSize = 2; blockSize <= 12; ++blockSize)
+        {
+            const u32 scale = (1024 + blockSize / 2) / (blockSize - 1);
+            for (u32 gridSize = 2; gridSize <= blockSize; ++gridSize)
+            {
+                for (u32 texel = 0; texel < blockSize; ++texel)
+                {
+                    const u32 position = (scale * texel * (gridSize - 1) + 32) >> 6;
+                    table[blockSize][gridSize][texel] = {static_cast<u8>(position >> 4),
+                                                         static_cast<u8>(position & 0xF)};
+                }
+            }
+        }
+        return table;
+    }();
+
+    // LSB first reads from the 128 bits of a block, bits past the end read as 0
+    struct BlockBits
+    {
+        u64 low;
+        u64 high;
+
+        [[nodiscard]] u32 Get(const u32 position, const u32 count) const
+        {
+            if (count == 0 || position >= 128)
+            {
+                return 0;
+            }
+            u64 value;
+            if (position >= 64)
+            {
+                value = high >> (position - 64);
+            } else
+            {
+                value = position == 0 ? low : low >> position | high << (64 - position);
+            }
+            return static_cast<u32>(value & ((u64{1} << count) - 1));
+        }
+    };
+
+    // Integer sequence decoding of count values. Trits come in groups of 5 and quints in groups of 3, their packed
+    // bits spread between the plain bits of the values. Missing values of the last group leave their bits out.
+    void DecodeIse(const BlockBits& bits, u32 position, const u32 count, const IseRange& range, u8* values)
+    {
+        if (range.trits == 0 && range.quints == 0)
+        {
+            for (u32 i = 0; i < count; ++i, position += range.bits)
+            {
+                values[i] = static_cast<u8>(bits.Get(position, range.bits));
+            }
+            return;
+        }
+
+        constexpr std::array<u8, 5> tritBits = {2, 2, 1, 2, 1};
+        constexpr std::array<u8, 3> quintBits = {3, 2, 2};
+        const u32 groupSize = range.trits ? 5 : 3;
+        for (u32 first = 0; first < count; first += groupSize)
+        {
+            const u32 groupCount = std::min(count - first, groupSize);
+            u32 packed = 0;
+            u32 shift = 0;
+            for (u32 k = 0; k < groupCount; ++k)
+            {
+                const u32 packedBits = range.trits ? tritBits[k] : quintBits[k];
+                values[first + k] = static_cast<u8>(bits.Get(position, range.bits));
+                packed |= bits.Get(position + range.bits, packedBits) << shift;
+                position += range.bits + packedBits;
+                shift += packedBits;
+            }
+            for (u32 k = 0; k < groupCount; ++k)
+            {
+                const u32 digit = range.trits ? tritDigits[packed][k] : quintDigits[packed][k];
+                values[first + k] = static_cast<u8>(values[first + k] | digit << range.bits);
+            }
+        }
+    }
+
+    using Color = std::array<i32, 4>;
+
+    struct Endpoints
+    {
+        Color low;
+        Color high;
+        // HDR channels hold 12 bit pseudo-logarithmic values shifted to 16 bits, the others 8 bit values
+        bool isRgbHdr;
+        bool isAlphaHdr;
+    };
+
+    // Moves the top bit of a into b and leaves a as a signed 6 bit offset
+    void TransferBits(i32& a, i32& b)
+    {
+        b = (b >> 1) | (a & 0x80);
+        a = (a >> 1) & 0x3F;
+        if (a & 0x20)
+        {
+            a -= 0x40;
+        }
+    }
+
+    Color BlueContract(const Color& color)
+    {
+        return {(color[0] + color[2]) >> 1, (color[1] + color[2]) >> 1, color[2], color[3]};
+    }
+
+    Color ClampColor(const Color& color)
+    {
+        return {std::clamp(color[0], 0, 255), std::clamp(color[1], 0, 255), std::clamp(color[2], 0, 255),
+                std::clamp(color[3], 0, 255)};
+    }
+
+    // Color endpoint mode 7: a base color and a scale, 5 to 8 bits of each spread over the mode dependent bit
+    // positions of the four values
+    void DecodeHdrRgbScale(const u8* v, Endpoints& endpoints)
+    {
+        const u32 modeBits = (v[0] & 0xC0) >> 6 | (v[1] & 0x80) >> 5 | (v[2] & 0x80) >> 4;
+        u32 major;
+        u32 mode;
+        if ((modeBits & 0xC) != 0xC)
+        {
+            major = modeBits >> 2;
+            mode = modeBits & 3;
+        } else if (modeBits != 0xF)
+        {
+            major = modeBits & 3;
+            mode = 4;
+        } else
+        {
+            major = 0;
+            mode = 5;
+        }
+
+        i32 red = v[0] & 0x3F;
+        i32 green = v[1] & 0x1F;
+        i32 blue = v[2] & 0x1F;
+        i32 scale = v[3] & 0x1F;
+        const i32 x0 = (v[1] >> 6) & 1;
+        const i32 x1 = (v[1] >> 5) & 1;
+        const i32 x2 = (v[2] >> 6) & 1;
+        const i32 x3 = (v[2] >> 5) & 1;
+        const i32 x4 = (v[3] >> 7) & 1;
+        const i32 x5 = (v[3] >> 6) & 1;
+        const i32 x6 = (v[3] >> 5) & 1;
+        // One bit per mode, for the modes a variable bit applies to
+        const u32 modeMask = 1u << mode;
+        green |= (modeMask & 0x30 ? x0 << 6 : 0) | (modeMask & 0x3A ? x1 << 5 : 0);
+        blue |= (modeMask & 0x30 ? x2 << 6 : 0) | (modeMask & 0x3A ? x3 << 5 : 0);
+        scale |= (modeMask & 0x3D ? x6 << 5 : 0) | (modeMask & 0x2D ? x5 << 6 : 0) | (modeMask & 0x04 ? x4 << 7 : 0);
+        red |= (modeMask & 0x3B ? x4 << 6 : 0) | (modeMask & 0x04 ? x3 << 6 : 0);
+        red |= (modeMask & 0x10 ? x5 << 7 : 0) | (modeMask & 0x0F ? x2 << 7 : 0);
+        red |= (modeMask & 0x05 ? x1 << 8 : 0) | (modeMask & 0x0A ? x0 << 8 : 0);
+        red |= (modeMask & 0x05 ? x0 << 9 : 0) | (modeMask & 0x02 ? x6 << 9 : 0);
+        red |= (modeMask & 0x01 ? x3 << 10 : 0) | (modeMask & 0x02 ? x5 << 10 : 0);
+
+        constexpr std::array<i32, 6> shifts = {1, 1, 2, 3, 4, 5};
+        red <<= shifts[mode];
+        green <<= shifts[mode];
+        blue <<= shifts[mode];
+        scale <<= shifts[mode];
+        // Green and blue are differences to red in all but the last mode
+        if (mode != 5)
+        {
+            green = red - green;
+            blue = red - blue;
+        }
+        Color high = {red, green, blue, 0};
+        if (major != 0)
+        {
+            std::swap(high[0], high[major]);
+        }
+        for (u32 channel = 0; channel < 3; ++channel)
+        {
+            endpoints.low[channel] = std::max(high[channel] - scale, 0) << 4;
+            endpoints.high[channel] = std::max(high[channel], 0) << 4;
+        }
+    }
+
+    // Color endpoint mode 11: two colors as a base, its offsets and the offsets of the second color, with the bits
+    // of each depending on the mode
+    void DecodeHdrRgb(const u8* v, Endpoints& endpoints)
+    {
+        const u32 major = (v[4] & 0x80) >> 7 | (v[5] & 0x80) >> 6;
+        if (major == 3)
+        {
+            endpoints.low = {v[0] << 8, v[2] << 8, (v[4] & 0x7F) << 9, 0};
+            endpoints.high = {v[1] << 8, v[3] << 8, (v[5] & 0x7F) << 9, 0};
+            return;
+        }
+
+        const u32 mode = (v[1] & 0x80) >> 7 | (v[2] & 0x80) >> 6 | (v[3] & 0x80) >> 5;
+        i32 a = v[0] | (v[1] & 0x40) << 2;
+        i32 b0 = v[2] & 0x3F;
+        i32 b1 = v[3] & 0x3F;
+        i32 c = v[1] & 0x3F;
+        i32 d0 = v[4] & 0x1F;
+        i32 d1 = v[5] & 0x1F;
+        const i32 x0 = (v[2] >> 6) & 1;
+        const i32 x1 = (v[3] >> 6) & 1;
+        const i32 x2 = (v[4] >> 6) & 1;
+        const i32 x3 = (v[5] >> 6) & 1;
+        const i32 x4 = (v[4] >> 5) & 1;
+        const i32 x5 = (v[5] >> 5) & 1;
+        const u32 modeMask = 1u << mode;
+        a |= (modeMask & 0xA4 ? x0 << 9 : 0) | (modeMask & 0x08 ? x2 << 9 : 0) | (modeMask & 0x50 ? x4 << 9 : 0);
+        a |= (modeMask & 0x50 ? x5 << 10 : 0) | (modeMask & 0xA0 ? x1 << 10 : 0) | (modeMask & 0xC0 ? x2 << 11 : 0);
+        c |= (modeMask & 0x04 ? x1 << 6 : 0) | (modeMask & 0xE8 ? x3 << 6 : 0) | (modeMask & 0x20 ? x2 << 7 : 0);
+        if (modeMask & 0x5B)
+        {
+            b0 |= x0 << 6;
+            b1 |= x1 << 6;
+        }
+        if (modeMask & 0x12)
+        {
+            b0 |= x2 << 7;
+            b1 |= x3 << 7;
+        }
+        if (modeMask & 0xAF)
+        {
+            d0 |= x4 << 5;
+            d1 |= x5 << 5;
+        }
+        if (modeMask & 0x05)
+        {
+            d0 |= x2 << 6;
+            d1 |= x3 << 6;
+        }
+
+        // The second color offsets are signed, with 5 to 7 bits depending on the mode
+        constexpr std::array<i32, 8> offsetBits = {7, 6, 7, 6, 5, 6, 5, 6};
+        const i32 signShift = 32 - offsetBits[mode];
+        d0 = static_cast<i32>(static_cast<u32>(d0) << signShift) >> signShift;
+        d1 = static_cast<i32>(static_cast<u32>(d1) << signShift) >> signShift;
+        // Everything is scaled up to 12 bits
+        const i32 shift = static_cast<i32>((mode >> 1) ^ 3);
+        a <<= shift;
+        b0 <<= shift;
+        b1 <<= shift;
+        c <<= shift;
+        d0 *= 1 << shift;
+        d1 *= 1 << shift;
+
+        Color high = {a, a - b0, a - b1, 0};
+        Color low = {a - c, a - b0 - c - d0, a - b1 - c - d1, 0};
+        if (major != 0)
+        {
+            std::swap(high[0], high[major]);
+            std::swap(low[0], low[major]);
+        }
+        for (u32 channel = 0; channel < 3; ++channel)
+        {
+            endpoints.low[channel] = std::clamp(low[channel], 0, 0xFFF) << 4;
+            endpoints.high[channel] = std::clamp(high[channel], 0, 0xFFF) << 4;
+        }
+    }
+
+    // HDR alpha of color endpoint mode 15, a base and an offset or two plain values
+    void DecodeHdrAlpha(const u8* v, Endpoints& endpoints)
+    {
+        const u32 mode = ((v[0] >> 7) & 1) | ((v[1] >> 6) & 2);
+        i32 low = v[0] & 0x7F;
+        i32 high = v[1] & 0x7F;
+        if (mode == 3)
+        {
+            low <<= 5;
+            high <<= 5;
+        } else
+        {
+            low |= (high << (mode + 1)) & 0x780;
+            high &= 0x3F >> mode;
+            high ^= 0x20 >> mode;
+            high -= 0x20 >> mode;
+            low <<= 4 - mode;
+            high = std::clamp(low + high * (1 << (4 - mode)), 0, 0xFFF);
+        }
+        endpoints.low[3] = low << 4;
+        endpoints.high[3] = high << 4;
+    }
+
+    // Unquantized endpoint values of one subset into its two colors
+    Endpoints DecodeEndpoints(const u32 endpointMode, const u8* values)
+    {
+        Endpoints endpoints{};
+        Color v{};
+        for (u32 i = 0; i < 4; ++i)
+        {
+            v[i] = values[i];
+        }
+        switch (endpointMode)
+        {
+            case 0:
+                endpoints.low = {v[0], v[0], v[0], 255};
+                endpoints.high = {v[1], v[1], v[1], 255};
+                break;
+            case 1:
+            {
+                const i32 low = v[0] >> 2 | (v[1] & 0xC0);
+                const i32 high = std::min(low + (v[1] & 0x3F), 255);
+                endpoints.low = {low, low, low, 255};
+                endpoints.high = {high, high, high, 255};
+                break;
+            }
+            case 2:
+            {
+                const i32 low = v[1] >= v[0] ? v[0] << 4 : (v[1] << 4) + 8;
+                const i32 high = v[1] >= v[0] ? v[1] << 4 : (v[0] << 4) - 8;
+                endpoints.low = {low << 4, low << 4, low << 4, 0x7800};
+                endpoints.high = {high << 4, high << 4, high << 4, 0x7800};
+                endpoints.isRgbHdr = true;
+                endpoints.isAlphaHdr = true;
+                break;
+            }
+            case 3:
+            {
+                const bool isWide = v[0] & 0x80;
+                const i32 low =
+                        isWide ? (v[1] & 0xE0) << 4 | (v[0] & 0x7F) << 2 : (v[1] & 0xF0) << 4 | (v[0] & 0x7F) << 1;
+                const i32 offset = isWide ? (v[1] & 0x1F) << 2 : (v[1] & 0x0F) << 1;
+                const i32 high = std::min(low + offset, 0xFFF);
+                endpoints.low = {low << 4, low << 4, low << 4, 0x7800};
+                endpoints.high = {high << 4, high << 4, high << 4, 0x7800};
+                endpoints.isRgbHdr = true;
+                endpoints.isAlphaHdr = true;
+                break;
+            }
+            case 4:
+                endpoints.low = {v[0], v[0], v[0], v[2]};
+                endpoints.high = {v[1], v[1], v[1], v[3]};
+                break;
+            case 5:
+                TransferBits(v[1], v[0]);
+                TransferBits(v[3], v[2]);
+                endpoints.low = {v[0], v[0], v[0], v[2]};
+                endpoints.high = ClampColor({v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3]});
+                break;
+            case 6:
+                endpoints.low = {v[0] * v[3] >> 8, v[1] * v[3] >> 8, v[2] * v[3] >> 8, 255};
+                endpoints.high = {v[0], v[1], v[2], 255};
+                break;
+            case 7:
+                DecodeHdrRgbScale(values, endpoints);
+                endpoints.low[3] = 0x7800;
+                endpoints.high[3] = 0x7800;
+                endpoints.isRgbHdr = true;
+                endpoints.isAlphaHdr = true;
+                break;
+            case 8:
+            case 12:
+            {
+                const Color low = {values[0], values[2], values[4], endpointMode == 12 ? values[6] : 255};
+                const Color high = {values[1], values[3], values[5], endpointMode == 12 ? values[7] : 255};
+                // A second color darker than the first one marks blue contracted colors, stored in reverse order
+                if (high[0] + high[1] + high[2] >= low[0] + low[1] + low[2])
+                {
+                    endpoints.low = low;
+                    endpoints.high = high;
+                } else
+                {
+                    endpoints.low = BlueContract(high);
+                    endpoints.high = BlueContract(low);
+                }
+                break;
+            }
+            case 9:
+            case 13:
+            {
+                Color low = {values[0], values[2], values[4], endpointMode == 13 ? values[6] : 255};
+                Color offset = {values[1], values[3], values[5], endpointMode == 13 ? values[7] : 0};
+                for (u32 channel = 0; channel < (endpointMode == 13 ? 4u : 3u); ++channel)
+                {
+                    TransferBits(offset[channel], low[channel]);
+                }
+                const Color high = {low[0] + offset[0], low[1] + offset[1], low[2] + offset[2], low[3] + offset[3]};
+                // Negative offsets mark blue contracted colors, stored in reverse order
+                if (offset[0] + offset[1] + offset[2] >= 0)
+                {
+                    endpoints.low = ClampColor(low);
+                    endpoints.high = ClampColor(high);
+                } else
+                {
+                    endpoints.low = ClampColor(BlueContract(high));
+                    endpoints.high = ClampColor(BlueContract(low));
+                }
+                break;
+            }
+            case 10:
+                endpoints.low = {v[0] * v[3] >> 8, v[1] * v[3] >> 8, v[2] * v[3] >> 8, values[4]};
+                endpoints.high = {v[0], v[1], v[2], values[5]};
+                break;
+            case 11:
+                DecodeHdrRgb(values, endpoints);
+                endpoints.low[3] = 0x7800;
+                endpoints.high[3] = 0x7800;
+                endpoints.isRgbHdr = true;
+                endpoints.isAlphaHdr = true;
+                break;
+            case 14:
+                DecodeHdrRgb(values, endpoints);
+                endpoints.low[3] = values[6];
+                endpoints.high[3] = values[7];
+                endpoints.isRgbHdr = true;
+                break;
+            default:
+                DecodeHdrRgb(values, endpoints);
+                DecodeHdrAlpha(values + 6, endpoints);
+                endpoints.isRgbHdr = true;
+                endpoints.isAlphaHdr = true;
+                break;
+        }
+        return endpoints;
+    }
+
+    // Pseudo-logarithmic HDR values to half floats, the mantissa is bent to approximate the float curve
+    u16 LnsToHalf(const u32 value)
+    {
+        const u32 mantissa = value & 0x7FF;
+        const u32 exponent = value >> 11;
+        const u32 bent = mantissa < 512 ? mantissa * 3 : mantissa < 1536 ? mantissa * 4 - 512 : mantissa * 5 - 2048;
+        return static_cast<u16>(std::min(exponent << 10 | bent >> 3, 0x7BFFu));
+    }
+
+    // LDR values of HDR blocks are UNORM16, truncated to half floats
+    u16 Unorm16ToHalf(const u32 value)
+    {
+        if (value == 0xFFFF)
+        {
+            return 0x3C00;
+        }
+        if (value < 4)
+        {
+            return static_cast<u16>(value << 8);
+        }
+        const u32 leadingZeros = std::countl_zero(value) - 16;
+        const u32 mantissa = (value << (leadingZeros + 1)) & 0xFFFF;
+        return static_cast<u16>((14 - leadingZeros) << 10 | mantissa >> 6);
+    }
+
+    void WriteErrorColor(const BlockDecoder& decoder, u8* texels)
+    {
+        const u32 texelCount = decoder.blockWidth * decoder.blockHeight;
+        for (u32 texel = 0; texel < texelCount; ++texel)
+        {
+            if (decoder.variant == astcHdr)
+            {
+                std::memcpy(texels + texel * 8, &errorColorHalf, sizeof(errorColorHalf));
+            } else
+            {
+                std::memcpy(texels + texel * 4, &errorColor, sizeof(errorColor));
+            }
+        }
+    }
+
+    // Single color blocks, UNORM16 or half float. The extent of the color over the image is only an optimization
+    // hint, but has to be well formed.
+    bool DecodeVoidExtent(const BlockDecoder& decoder, const BlockBits& bits, u8* texels)
+    {
+        const bool isHdr = bits.Get(9, 1);
+        if (bits.Get(10, 2) != 3 || (isHdr && decoder.variant != astcHdr))
+        {
+            return false;
+        }
+        const u32 minS = bits.Get(12, 13);
+        const u32 maxS = bits.Get(25, 13);
+        const u32 minT = bits.Get(38, 13);
+        const u32 maxT = bits.Get(51, 13);
+        const bool isUnbounded = minS == 0x1FFF && maxS == 0x1FFF && minT == 0x1FFF && maxT == 0x1FFF;
+        if (!isUnbounded && (minS >= maxS || minT >= maxT))
+        {
+            return false;
+        }
+
+        const u32 texelCount = decoder.blockWidth * decoder.blockHeight;
+        if (decoder.variant == astcHdr)
+        {
+            std::array<u16, 4> color{};
+            for (u32 channel = 0; channel < 4; ++channel)
+            {
+                const u32 value = bits.Get(64 + channel * 16, 16);
+                color[channel] = isHdr ? static_cast<u16>(value) : Unorm16ToHalf(value);
+            }
+            for (u32 texel = 0; texel < texelCount; ++texel)
+            {
+                std::memcpy(texels + texel * 8, color.data(), sizeof(color));
+            }
+            return true;
+        }
+        // The top byte of every channel
+        const u64 color = bits.high;
+        const u32 packed = static_cast<u32>((color >> 8 & 0xFF) | (color >> 16 & 0xFF00) | (color >> 24 & 0xFF0000) |
+                                            (color >> 32 & 0xFF000000));
+        for (u32 texel = 0; texel < texelCount; ++texel)
+        {
+            std::memcpy(texels + texel * 4, &packed, sizeof(packed));
+        }
+        return true;
+    }
+
+    bool DecodeBlock(const BlockDecoder& decoder, const BlockBits& bits, u8* texels)
+    {
+        const u32 modeBits = bits.Get(0, 11);
+        if ((modeBits & 0x1FF) == 0x1FC)
+        {
+            return DecodeVoidExtent(decoder, bits, texels);
+        }
+        const auto& mode = blockModes[modeBits];
+        const u32 subsets = bits.Get(11, 2) + 1;
+        if (!mode.isValid || mode.gridWidth > decoder.blockWidth || mode.gridHeight > decoder.blockHeight ||
+            (subsets == 4 && mode.isDualPlane))
+        {
+            return false;
+        }
+
+        // The weights fill the block from the top, below them are the extra color endpoint mode bits and the ccs
+        u32 belowWeights = 128 - mode.weightBits;
+        std::array<u32, 4> endpointModes{};
+        u32 endpointStart = 17;
+        u32 partitionSeed = 0;
+        if (subsets == 1)
+        {
+            endpointModes[0] = bits.Get(13, 4);
+        } else
+        {
+            endpointStart = 29;
+            partitionSeed = bits.Get(13, 10);
+            const u32 modeField = bits.Get(23, 6);
+            if ((modeField & 3) == 0)
+            {
+                endpointModes.fill(modeField >> 2);
+            } else
+            {
+                // A mode class per block, every subset picks it or the next one and its own 2 bit mode within
+                const u32 extraBits = 3 * subsets - 4;
+                belowWeights -= extraBits;
+                const u32 field = modeField | bits.Get(belowWeights, extraBits) << 6;
+                const u32 baseClass = (field & 3) - 1;
+                for (u32 subset = 0; subset < subsets; ++subset)
+                {
+                    const u32 modeClass = baseClass + ((field >> (2 + subset)) & 1);
+                    endpointModes[subset] = modeClass << 2 | ((field >> (2 + subsets + subset * 2)) & 3);
+                }
+            }
+        }
+        u32 ccs = 0;
+        if (mode.isDualPlane)
+        {
+            belowWeights -= 2;
+            ccs = bits.Get(belowWeights, 2);
+        }
+
+        u32 valueCount = 0;
+        for (u32 subset = 0; subset < subsets; ++subset)
+        {
+            valueCount += ((endpointModes[subset] >> 2) + 1) * 2;
+        }
+        if (valueCount > maxEndpointValues || belowWeights < endpointStart)
+        {
+            return false;
+        }
+        const u32 endpointRange = endpointRanges[valueCount / 2][belowWeights - endpointStart];
+        if (endpointRange == 0xFF || endpointRange < minEndpointRange)
+        {
+            return false;
+        }
+        std::array<u8, maxEndpointValues> values{};
+        DecodeIse(bits, endpointStart, valueCount, iseRanges[endpointRange], values.data());
+        for (u32 i = 0; i < valueCount; ++i)
+        {
+            values[i] = Astc::colorUnquantization[endpointRange][values[i]];
+        }
+
+        // Endpoints expanded to 16 bits: LDR values are replicated, sRGB ones get 0x80 below the color channels. HDR
+        // endpoints in LDR formats decode to the error color.
+        const bool isHdrProfile = decoder.variant == astcHdr;
+        std::array<std::array<u32, 4>, 4> lows{};
+        std::array<std::array<u32, 4>, 4> highs{};
+        std::array<std::array<bool, 4>, 4> isLns{};
+        for (u32 subset = 0, offset = 0; subset < subsets; offset += ((endpointModes[subset] >> 2) + 1) * 2, ++subset)
+        {
+            auto endpoints = DecodeEndpoints(endpointModes[subset], values.data() + offset);
+            if (!isHdrProfile && (endpoints.isRgbHdr || endpoints.isAlphaHdr))
+            {
+                endpoints = {.low = {255, 0, 255, 255},
+                             .high = {255, 0, 255, 255},
+                             .isRgbHdr = false,
+                             .isAlphaHdr = false};
+            }
+            for (u32 channel = 0; channel < 4; ++channel)
+            {
+                const bool isHdr = channel < 3 ? endpoints.isRgbHdr : endpoints.isAlphaHdr;
+                const auto low = static_cast<u32>(endpoints.low[channel]);
+                const auto high = static_cast<u32>(endpoints.high[channel]);
+                isLns[subset][channel] = isHdr;
+                if (isHdr)
+                {
+                    lows[subset][channel] = low;
+                    highs[subset][channel] = high;
+                } else if (decoder.variant == astcSrgb && channel < 3)
+                {
+                    lows[subset][channel] = low << 8 | 0x80;
+                    highs[subset][channel] = high << 8 | 0x80;
+                } else
+                {
+                    lows[subset][channel] = low * 257;
+                    highs[subset][channel] = high * 257;
+                }
+            }
+        }
+
+        // Weights of the grid, padded for the infill of the last row and column which reads one past them
+        const u32 gridWidth = mode.gridWidth;
+        const u32 planes = mode.isDualPlane ? 2 : 1;
+        const u32 weightCount = gridWidth * mode.gridHeight * planes;
+        std::array<u8, maxWeights> encoded{};
+        const BlockBits reversed = {Astc::ReverseBits(bits.high), Astc::ReverseBits(bits.low)};
+        DecodeIse(reversed, 0, weightCount, iseRanges[mode.weightRange], encoded.data());
+        std::array<std::array<u8, maxWeights + 16>, 2> gridWeights{};
+        const auto& unquantize = Astc::weightUnquantization[mode.weightRange];
+        for (u32 i = 0; i < weightCount; ++i)
+        {
+            gridWeights[i % planes][i / planes] = unquantize[encoded[i]];
+        }
+
+        const Astc::PartitionHash hash = Astc::HashPartitionSeed(partitionSeed, subsets);
+        const u32 width = decoder.blockWidth;
+        const u32 height = decoder.blockHeight;
+        const u32 coordinateShift = width * height < 31 ? 1 : 0;
+        const auto& stepsX = infillSteps[width][gridWidth];
+        const auto& stepsY = infillSteps[height][mode.gridHeight];
+        for (u32 y = 0; y < height; ++y)
+        {
+            for (u32 x = 0; x < width; ++x)
+            {
+                const u32 subset =
+                        subsets == 1 ? 0 : Astc::SelectPartition(hash, x << coordinateShift, y << coordinateShift);
+                // Bilinear infill of the grid weights, in sixteenths
+                const u32 fractionX = stepsX[x].fraction;
+                const u32 fractionY = stepsY[y].fraction;
+                const u32 base = stepsY[y].index * gridWidth + stepsX[x].index;
+                const u32 w11 = (fractionX * fractionY + 8) >> 4;
+                const u32 w10 = fractionY - w11;
+                const u32 w01 = fractionX - w11;
+                const u32 w00 = 16 - fractionX - fractionY + w11;
+                std::array<u32, 4> weights{};
+                for (u32 plane = 0; plane < planes; ++plane)
+                {
+                    const auto& grid = gridWeights[plane];
+                    const u32 weight = (grid[base] * w00 + grid[base + 1] * w01 + grid[base + gridWidth] * w10 +
+                                        grid[base + gridWidth + 1] * w11 + 8) >>
+                                       4;
+                    // The second plane only weights the ccs channel
+                    if (plane == 0)
+                    {
+                        weights.fill(weight);
+                    } else
+                    {
+                        weights[ccs] = weight;
+                    }
+                }
+
+                const u32 texel = y * width + x;
+                std::array<u32, 4> color{};
+                for (u32 channel = 0; channel < 4; ++channel)
+                {
+                    const u32 weight = weights[channel];
+                    color[channel] =
+                            (lows[subset][channel] * (64 - weight) + highs[subset][channel] * weight + 32) >> 6;
+                }
+                if (isHdrProfile)
+                {
+                    std::array<u16, 4> half{};
+                    for (u32 channel = 0; channel < 4; ++channel)
+                    {
+                        half[channel] = isLns[subset][channel] ? LnsToHalf(color[channel])
+                                                               : Unorm16ToHalf(color[channel]);
+                    }
+                    std::memcpy(texels + texel * 8, half.data(), sizeof(half));
+                } else
+                {
+                    const u32 packed = color[0] >> 8 | (color[1] >> 8) << 8 | (color[2] >> 8) << 16 |
+                                       (color[3] >> 8) << 24;
+                    std::memcpy(texels + texel * 4, &packed, sizeof(packed));
+                }
+            }
+        }
+        return true;
+    }
+
+    void DecodeAstc(const BlockDecoder& decoder, const u8* block, u8* texels)
+    {
+        if (!DecodeBlock(decoder, {Load64(block), Load64(block + 8)}, texels))
+        {
+            WriteErrorColor(decoder, texels);
+        }
+    }
+} // namespace
+
+bool KTX::Decoders::GetAstcDecoder(const u32 vkFormat, BlockDecoder& decoder)
+{
+    using enum KtxUtility_VkFormat;
+    // Footprints in the order of the formats
+    constexpr std::array<std::array<u8, 2>, 14> footprints = {{
+            {4, 4},
+            {5, 4},
+            {5, 5},
+            {6, 5},
+            {6, 6},
+            {8, 5},
+            {8, 6},
+            {8, 8},
+            {10, 5},
+            {10, 6},
+            {10, 8},
+            {10, 10},
+            {12, 10},
+            {12, 12},
+    }};
+    constexpr auto firstLdr = static_cast<u32>(VK_FORMAT_ASTC_4x4_UNORM_BLOCK);
+    constexpr auto firstHdr = static_cast<u32>(VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK);
+    u32 footprint;
+    u32 variant;
+    if (vkFormat >= firstLdr && vkFormat <= static_cast<u32>(VK_FORMAT_ASTC_12x12_SRGB_BLOCK))
+    {
+        // UNORM and SRGB alternate
+        footprint = (vkFormat - firstLdr) / 2;
+        variant = (vkFormat - firstLdr) % 2 ? astcSrgb : astcLdr;
+    } else if (vkFormat >= firstHdr && vkFormat <= static_cast<u32>(VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK))
+    {
+        footprint = vkFormat - firstHdr;
+        variant = astcHdr;
+    } else
+    {
+        return false;
+    }
+
+    const auto decodedFormat = variant == astcHdr    ? VK_FORMAT_R16G16B16A16_SFLOAT
+                               : variant == astcSrgb ? VK_FORMAT_R8G8B8A8_SRGB
+                                                     : VK_FORMAT_R8G8B8A8_UNORM;
+    decoder = {.blockWidth = footprints[footprint][0],
+               .blockHeight = footprints[footprint][1],
+               .blockSize = 16,
+               .texelSize = variant == astcHdr ? 8u : 4u,
+               .decodedVkFormat = static_cast<u32>(decodedFormat),
+               .variant = variant,
+               .decode = DecodeAstc};
+    return true;
+}
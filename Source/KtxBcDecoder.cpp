@@ -0,0 +1,679 @@
+#include "KtxBlockDecoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+#include "KtxBc7.hpp"
+#include "VK_Format.hpp"
+
+namespace
+{
+    using namespace KTX;
+    using Decoders::BlockDecoder;
+    using Decoders::Load32;
+    using Decoders::Load64;
+    using Decoders::LookupTexels;
+    using Decoders::Palette;
+
+    // Variants, the same value means punch-through alpha for BC1 and signed values for BC4, BC5 and BC6H
+    constexpr u32 bcUnsigned = 0;
+    constexpr u32 bcSigned = 1;
+    constexpr u32 bc1Opaque = 0;
+    constexpr u32 bc1PunchThrough = 1;
+
+    // Colors of the RGB half of BC1, BC2 and BC3 blocks, alpha goes in the top byte. Only BC1 has the three color
+    // mode, where the fourth color is black and transparent with punch-through alpha.
+    void GetColorPalette(const u8* block, const bool isBc1, const bool hasPunchThrough, const u32 alpha,
+                         Palette& palette)
+    {
+        const u32 color0 = block[0] | block[1] << 8;
+        const u32 color1 = block[2] | block[3] << 8;
+        const auto expand = [](const u32 color) -> std::array<u32, 3>
+        {
+            const u32 red = color >> 11;
+            const u32 green = color >> 5 & 0x3F;
+            const u32 blue = color & 0x1F;
+            return {red << 3 | red >> 2, green << 2 | green >> 4, blue << 3 | blue >> 2};
+        };
+        const auto endpoint0 = expand(color0);
+        const auto endpoint1 = expand(color1);
+        const auto mix = [&](const u32 weight0, const u32 weight1)
+        {
+            const u32 total = weight0 + weight1;
+            u32 value = alpha << 24;
+            for (u32 channel = 0; channel < 3; ++channel)
+            {
+                value |= (endpoint0[channel] * weight0 + endpoint1[channel] * weight1 + total / 2) / total
+                         << (channel * 8);
+            }
+            return value;
+        };
+        palette[0] = mix(1, 0);
+        palette[1] = mix(0, 1);
+        if (!isBc1 || color0 > color1)
+        {
+            palette[2] = mix(2, 1);
+            palette[3] = mix(1, 2);
+            return;
+        }
+        palette[2] = mix(1, 1);
+        palette[3] = hasPunchThrough ? 0 : alpha << 24;
+    }
+
+    // Values of a BC4 block (the alpha of BC3, each channel of BC5) shifted into place, snorm ones as two's complement
+    void GetChannelPalette(const u8* block, const bool isSigned, const u32 shift, Palette& palette)
+    {
+        std::array<i32, 8> values{};
+        if (isSigned)
+        {
+            // -128 and -127 both mean -1
+            values[0] = std::max<i32>(static_cast<i8>(block[0]), -127);
+            values[1] = std::max<i32>(static_cast<i8>(block[1]), -127);
+        }
+        else
+        {
+            values[0] = block[0];
+            values[1] = block[1];
+        }
+        // Rounds half away from zero, the same for both signs
+        const auto mix = [&](const i32 weight0, const i32 weight1)
+        {
+            const i32 total = weight0 + weight1;
+            const i32 sum = values[0] * weight0 + values[1] * weight1;
+            return (sum + (sum < 0 ? -total / 2 : total / 2)) / total;
+        };
+        if (values[0] > values[1])
+        {
+            for (i32 index = 1; index < 7; ++index)
+            {
+                values[index + 1] = mix(7 - index, index);
+            }
+        }
+        else
+        {
+            for (i32 index = 1; index < 5; ++index)
+            {
+                values[index + 1] = mix(5 - index, index);
+            }
+            values[6] = isSigned ? -127 : 0;
+            values[7] = isSigned ? 127 : 255;
+        }
+        for (u32 index = 0; index < 8; ++index)
+        {
+            palette[index] = (static_cast<u32>(values[index]) & 0xFF) << shift;
+        }
+    }
+
+    void DecodeBc1(const BlockDecoder& decoder, const u8* block, u8* texels)
+    {
+        Palette palette{};
+        GetColorPalette(block, true, decoder.variant == bc1PunchThrough, 0xFF, palette);
+        LookupTexels<2, false>(palette, Load32(block + 4), texels);
+    }
+
+    void DecodeBc2(const BlockDecoder&, const u8* block, u8* texels)
+    {
+        Palette palette{};
+        GetColorPalette(block + 8, false, false, 0, palette);
+        LookupTexels<2, false>(palette, Load32(block + 12), texels);
+        const u64 alphas = Load64(block);
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            texels[texel * 4 + 3] = static_cast<u8>((alphas >> (texel * 4) & 0xF) * 0x11);
+        }
+    }
+
+    void DecodeBc3(const BlockDecoder&, const u8* block, u8* texels)
+    {
+        Palette alphaPalette{};
+        GetChannelPalette(block, false, 24, alphaPalette);
+        LookupTexels<3, false>(alphaPalette, Load64(block) >> 16, texels);
+        Palette colorPalette{};
+        GetColorPalette(block + 8, false, false, 0, colorPalette);
+        LookupTexels<2, true>(colorPalette, Load32(block + 12), texels);
+    }
+
+    // Red only, blue is 0 and alpha 1 (127 for snorm)
+    void DecodeBc4(const BlockDecoder& decoder, const u8* block, u8* texels)
+    {
+        const bool isSigned = decoder.variant == bcSigned;
+        Palette palette{};
+        GetChannelPalette(block, isSigned, 0, palette);
+        const u32 alpha = (isSigned ? 0x7Fu : 0xFFu) << 24;
+        for (auto& value : palette)
+        {
+            value |= alpha;
+        }
+        LookupTexels<3, false>(palette, Load64(block) >> 16, texels);
+    }
+
+    void DecodeBc5(const BlockDecoder& decoder, const u8* block, u8* texels)
+    {
+        DecodeBc4(decoder, block, texels);
+        Palette palette{};
+        GetChannelPalette(block + 8, decoder.variant == bcSigned, 8, palette);
+        LookupTexels<3, true>(palette, Load64(block + 8) >> 16, texels);
+    }
+
+    // Reads a 128 bit block from the lowest bit up
+    class BlockBits
+    {
+    public:
+        explicit BlockBits(const u8* block) : low(Load64(block)), high(Load64(block + 8)) {}
+
+        u32 Get(const u32 count)
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+            const auto value = static_cast<u32>(low & ((1ull << count) - 1));
+            low = low >> count | high << (64 - count);
+            high >>= count;
+            return value;
+        }
+
+    private:
+        u64 low;
+        u64 high;
+    };
+
+    struct Bc7ModeInfo
+    {
+        u8 subsets;
+        u8 partitionBits;
+        u8 rotationBits;
+        u8 indexSelectionBits;
+        u8 colorBits;
+        // 0 for opaque modes
+        u8 alphaBits;
+        // One p-bit per endpoint, or one shared by the two endpoints of a subset
+        bool hasEndpointPBits;
+        bool hasSharedPBits;
+        u8 indexBits;
+        // Second set of indices for alpha (or color, by the index selection bit), 0 when there is none
+        u8 secondaryIndexBits;
+    };
+    constexpr std::array<Bc7ModeInfo, 8> bc7Modes = {{
+            {3, 4, 0, 0, 4, 0, true, false, 3, 0},
+            {2, 6, 0, 0, 6, 0, false, true, 3, 0},
+            {3, 6, 0, 0, 5, 0, false, false, 2, 0},
+            {2, 6, 0, 0, 7, 0, true, false, 2, 0},
+            {1, 0, 2, 1, 5, 6, false, false, 2, 3},
+            {1, 0, 2, 0, 7, 8, false, false, 2, 2},
+            {1, 0, 0, 0, 7, 7, true, false, 4, 0},
+            {2, 6, 0, 0, 5, 5, true, false, 2, 0},
+    }};
+
+    void DecodeBc7(const BlockDecoder&, const u8* block, u8* texels)
+    {
+        // The mode is the position of the lowest set bit, blocks without one are reserved
+        const u32 mode = std::countr_zero(static_cast<u32>(block[0]));
+        if (mode >= bc7Modes.size())
+        {
+            std::memset(texels, 0, 64);
+            return;
+        }
+        const auto& info = bc7Modes[mode];
+        BlockBits bits(block);
+        bits.Get(mode + 1);
+        const u32 partition = bits.Get(info.partitionBits);
+        const u32 rotation = bits.Get(info.rotationBits);
+        const u32 indexSelection = bits.Get(info.indexSelectionBits);
+
+        // Endpoints of each subset next to each other, stored channel by channel
+        const u32 endpointCount = info.subsets * 2u;
+        std::array<std::array<u32, 4>, 6> endpoints{};
+        const u32 channels = info.alphaBits > 0 ? 4 : 3;
+        for (u32 channel = 0; channel < channels; ++channel)
+        {
+            for (u32 endpoint = 0; endpoint < endpointCount; ++endpoint)
+            {
+                endpoints[endpoint][channel] = bits.Get(channel < 3 ? info.colorBits : info.alphaBits);
+            }
+        }
+        u32 colorBits = info.colorBits;
+        u32 alphaBits = info.alphaBits;
+        if (info.hasEndpointPBits || info.hasSharedPBits)
+        {
+            std::array<u32, 6> pBits{};
+            for (u32 endpoint = 0; endpoint < endpointCount; ++endpoint)
+            {
+                pBits[endpoint] = info.hasSharedPBits && endpoint % 2 == 1 ? pBits[endpoint - 1] : bits.Get(1);
+            }
+            for (u32 endpoint = 0; endpoint < endpointCount; ++endpoint)
+            {
+                for (u32 channel = 0; channel < channels; ++channel)
+                {
+                    endpoints[endpoint][channel] = endpoints[endpoint][channel] << 1 | pBits[endpoint];
+                }
+            }
+            ++colorBits;
+            alphaBits += alphaBits > 0 ? 1 : 0;
+        }
+        for (u32 endpoint = 0; endpoint < endpointCount; ++endpoint)
+        {
+            for (u32 channel = 0; channel < 4; ++channel)
+            {
+                const u32 precision = channel < 3 ? colorBits : alphaBits;
+                auto& value = endpoints[endpoint][channel];
+                value = precision == 0 ? 0xFF : value << (8 - precision) | value >> (2 * precision - 8);
+            }
+        }
+
+        const auto getSubset = [&](const u32 texel) -> u32
+        {
+            switch (info.subsets)
+            {
+                case 1:
+                    return 0;
+                case 2:
+                    return Bc7::partitions2[partition] >> texel & 1;
+                default:
+                    return Bc7::partitions3[partition] >> (texel * 2) & 3;
+            }
+        };
+        const auto isAnchor = [&](const u32 texel)
+        {
+            switch (info.subsets)
+            {
+                case 1:
+                    return texel == 0;
+                case 2:
+                    return texel == 0 || texel == Bc7::anchors2[partition];
+                default:
+                    return texel == 0 || texel == Bc7::anchors3Second[partition] ||
+                           texel == Bc7::anchors3Third[partition];
+            }
+        };
+        std::array<u8, 16> indices{};
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            indices[texel] = static_cast<u8>(bits.Get(info.indexBits - (isAnchor(texel) ? 1 : 0)));
+        }
+        std::array<u8, 16> secondaryIndices{};
+        if (info.secondaryIndexBits > 0)
+        {
+            for (u32 texel = 0; texel < 16; ++texel)
+            {
+                secondaryIndices[texel] = static_cast<u8>(bits.Get(info.secondaryIndexBits - (texel == 0 ? 1 : 0)));
+            }
+        }
+
+        // Without secondary indices alpha uses the color ones, the index selection bit swaps the two sets
+        const bool hasSecondary = info.secondaryIndexBits > 0;
+        const bool colorUsesSecondary = indexSelection == 1;
+        const bool alphaUsesSecondary = hasSecondary && !colorUsesSecondary;
+        const auto& colorWeights = Bc7::weights[(colorUsesSecondary ? info.secondaryIndexBits : info.indexBits) - 2];
+        const auto& alphaWeights = Bc7::weights[(alphaUsesSecondary ? info.secondaryIndexBits : info.indexBits) - 2];
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            const u32 subset = getSubset(texel);
+            const auto& low = endpoints[subset * 2];
+            const auto& high = endpoints[subset * 2 + 1];
+            const u32 colorWeight = colorWeights[colorUsesSecondary ? secondaryIndices[texel] : indices[texel]];
+            const u32 alphaWeight = alphaWeights[alphaUsesSecondary ? secondaryIndices[texel] : indices[texel]];
+            std::array<u8, 4> color{};
+            for (u32 channel = 0; channel < 4; ++channel)
+            {
+                const u32 weight = channel < 3 ? colorWeight : alphaWeight;
+                color[channel] = static_cast<u8>((low[channel] * (64 - weight) + high[channel] * weight + 32) >> 6);
+            }
+            // Rotation swaps alpha with one of the color channels
+            if (rotation > 0)
+            {
+                std::swap(color[rotation - 1], color[3]);
+            }
+            std::memcpy(texels + texel * 4, color.data(), 4);
+        }
+    }
+
+    // BC6H header fields, in the order of Bc6hSegment::value: base endpoint (w), then the second endpoint (x) and the
+    // endpoints of the second subset (y, z), which are deltas from w in transformed modes, and the partition
+    enum Bc6hValue : u8
+    {
+        eRw,
+        eGw,
+        eBw,
+        eRx,
+        eGx,
+        eBx,
+        eRy,
+        eGy,
+        eBy,
+        eRz,
+        eGz,
+        eBz,
+        eD,
+    };
+
+    // count bits of the block go to the bits starting at shift of value, lowest first
+    struct Bc6hSegment
+    {
+        u8 value;
+        u8 shift;
+        u8 count;
+    };
+
+    struct Bc6hMode
+    {
+        u8 code;
+        u8 codeBits;
+        u8 subsets;
+        u8 endpointBits;
+        // Bits of x, y and z per channel, endpointBits when not transformed
+        std::array<u8, 3> deltaBits;
+        bool isTransformed;
+        // Header fields in block order, ends at the first segment of count 0
+        std::array<Bc6hSegment, 24> layout;
+    };
+
+    // Modes 1 to 14 of the BC6H specification. The fields of each mode are scattered over the header, some bits
+    // (the high bits of w in modes 13 and 14) even in reverse order.
+    constexpr std::array<Bc6hMode, 14> bc6hModes = {{
+            {0x00, 2, 2, 10, {5, 5, 5}, true,
+             {{{eGy, 4, 1}, {eBy, 4, 1}, {eBz, 4, 1}, {eRw, 0, 10}, {eGw, 0, 10}, {eBw, 0, 10}, {eRx, 0, 5},
+               {eGz, 4, 1}, {eGy, 0, 4}, {eGx, 0, 5}, {eBz, 0, 1}, {eGz, 0, 4}, {eBx, 0, 5}, {eBz, 1, 1},
+               {eBy, 0, 4}, {eRy, 0, 5}, {eBz, 2, 1}, {eRz, 0, 5}, {eBz, 3, 1}, {eD, 0, 5}}}},
+            {0x01, 2, 2, 7, {6, 6, 6}, true,
+             {{{eGy, 5, 1}, {eGz, 4, 1}, {eGz, 5, 1}, {eRw, 0, 7}, {eBz, 0, 1}, {eBz, 1, 1}, {eBy, 4, 1},
+               {eGw, 0, 7}, {eBy, 5, 1}, {eBz, 2, 1}, {eGy, 4, 1}, {eBw, 0, 7}, {eBz, 3, 1}, {eBz, 5, 1},
+               {eBz, 4, 1}, {eRx, 0, 6}, {eGy, 0, 4}, {eGx, 0, 6}, {eGz, 0, 4}, {eBx, 0, 6}, {eBy, 0, 4},
+               {eRy, 0, 6}, {eRz, 0, 6}, {eD, 0, 5}}}},
+            {0x02, 5, 2, 11, {5, 4, 4}, true,
+             {{{eRw, 0, 10}, {eGw, 0, 10}, {eBw, 0, 10}, {eRx, 0, 5}, {eRw, 10, 1}, {eGy, 0, 4}, {eGx, 0, 4},
+               {eGw, 10, 1}, {eBz, 0, 1}, {eGz, 0, 4}, {eBx, 0, 4}, {eBw, 10, 1}, {eBz, 1, 1}, {eBy, 0, 4},
+               {eRy, 0, 5}, {eBz, 2, 1}, {eRz, 0, 5}, {eBz, 3, 1}, {eD, 0, 5}}}},
+            {0x06, 5, 2, 11, {4, 5, 4}, true,
+             {{{eRw, 0, 10}, {eGw, 0, 10}, {eBw, 0, 10}, {eRx, 0, 4}, {eRw, 10, 1}, {eGz, 4, 1}, {eGy, 0, 4},
+               {eGx, 0, 5}, {eGw, 10, 1}, {eGz, 0, 4}, {eBx, 0, 4}, {eBw, 10, 1}, {eBz, 1, 1}, {eBy, 0, 4},
+               {eRy, 0, 4}, {eBz, 0, 1}, {eBz, 2, 1}, {eRz, 0, 4}, {eGy, 4, 1}, {eBz, 3, 1}, {eD, 0, 5}}}},
+            {0x0A, 5, 2, 11, {4, 4, 5}, true,
+             {{{eRw, 0, 10}, {eGw, 0, 10}, {eBw, 0, 10}, {eRx, 0, 4}, {eRw, 10, 1}, {eBy, 4, 1}, {eGy, 0, 4},
+               {eGx, 0, 4}, {eGw, 10, 1}, {eBz, 0, 1}, {eGz, 0, 4}, {eBx, 0, 5}, {eBw, 10, 1}, {eBy, 0, 4},
+               {eRy, 0, 4}, {eBz, 1, 1}, {eBz, 2, 1}, {eRz, 0, 4}, {eBz, 4, 1}, {eBz, 3, 1}, {eD, 0, 5}}}},
+            {0x0E, 5, 2, 9, {5, 5, 5}, true,
+             {{{eRw, 0, 9}, {eBy, 4, 1}, {eGw, 0, 9}, {eGy, 4, 1}, {eBw, 0, 9}, {eBz, 4, 1}, {eRx, 0, 5},
+               {eGz, 4, 1}, {eGy, 0, 4}, {eGx, 0, 5}, {eBz, 0, 1}, {eGz, 0, 4}, {eBx, 0, 5}, {eBz, 1, 1},
+               {eBy, 0, 4}, {eRy, 0, 5}, {eBz, 2, 1}, {eRz, 0, 5}, {eBz, 3, 1}, {eD, 0, 5}}}},
+            {0x12, 5, 2, 8, {6, 5, 5}, true,
+             {{{eRw, 0, 8}, {eGz, 4, 1}, {eBy, 4, 1}, {eGw, 0, 8}, {eBz, 2, 1}, {eGy, 4, 1}, {eBw, 0, 8},
+               {eBz, 3, 1}, {eBz, 4, 1}, {eRx, 0, 6}, {eGy, 0, 4}, {eGx, 0, 5}, {eBz, 0, 1}, {eGz, 0, 4},
+               {eBx, 0, 5}, {eBz, 1, 1}, {eBy, 0, 4}, {eRy, 0, 6}, {eRz, 0, 6}, {eD, 0, 5}}}},
+            {0x16, 5, 2, 8, {5, 6, 5}, true,
+             {{{eRw, 0, 8}, {eBz, 0, 1}, {eBy, 4, 1}, {eGw, 0, 8}, {eGy, 5, 1}, {eGy, 4, 1}, {eBw, 0, 8},
+               {eGz, 5, 1}, {eBz, 4, 1}, {eRx, 0, 5}, {eGz, 4, 1}, {eGy, 0, 4}, {eGx, 0, 6}, {eGz, 0, 4},
+               {eBx, 0, 5}, {eBz, 1, 1}, {eBy, 0, 4}, {eRy, 0, 5}, {eBz, 2, 1}, {eRz, 0, 5}, {eBz, 3, 1},
+               {eD, 0, 5}}}},
+            {0x1A, 5, 2, 8, {5, 5, 6}, true,
+             {{{eRw, 0, 8}, {eBz, 1, 1}, {eBy, 4, 1}, {eGw, 0, 8}, {eBy, 5, 1}, {eGy, 4, 1}, {eBw, 0, 8},
+               {eBz, 5, 1}, {eBz, 4, 1}, {eRx, 0, 5}, {eGz, 4, 1}, {eGy, 0, 4}, {eGx, 0, 5}, {eBz, 0, 1},
+               {eGz, 0, 4}, {eBx, 0, 6}, {eBy, 0, 4}, {eRy, 0, 5}, {eBz, 2, 1}, {eRz, 0, 5}, {eBz, 3, 1},
+               {eD, 0, 5}}}},
+            {0x1E, 5, 2, 6, {6, 6, 6}, false,
+             {{{eRw, 0, 6}, {eGz, 4, 1}, {eBz, 0, 1}, {eBz, 1, 1}, {eBy, 4, 1}, {eGw, 0, 6}, {eGy, 5, 1},
+               {eBy, 5, 1}, {eBz, 2, 1}, {eGy, 4, 1}, {eBw, 0, 6}, {eGz, 5, 1}, {eBz, 3, 1}, {eBz, 5, 1},
+               {eBz, 4, 1}, {eRx, 0, 6}, {eGy, 0, 4}, {eGx, 0, 6}, {eGz, 0, 4}, {eBx, 0, 6}, {eBy, 0, 4},
+               {eRy, 0, 6}, {eRz, 0, 6}, {eD, 0, 5}}}},
+            {0x03, 5, 1, 10, {10, 10, 10}, false,
+             {{{eRw, 0, 10}, {eGw, 0, 10}, {eBw, 0, 10}, {eRx, 0, 10}, {eGx, 0, 10}, {eBx, 0, 10}}}},
+            {0x07, 5, 1, 11, {9, 9, 9}, true,
+             {{{eRw, 0, 10}, {eGw, 0, 10}, {eBw, 0, 10}, {eRx, 0, 9}, {eRw, 10, 1}, {eGx, 0, 9}, {eGw, 10, 1},
+               {eBx, 0, 9}, {eBw, 10, 1}}}},
+            {0x0B, 5, 1, 12, {8, 8, 8}, true,
+             {{{eRw, 0, 10}, {eGw, 0, 10}, {eBw, 0, 10}, {eRx, 0, 8}, {eRw, 11, 1}, {eRw, 10, 1}, {eGx, 0, 8},
+               {eGw, 11, 1}, {eGw, 10, 1}, {eBx, 0, 8}, {eBw, 11, 1}, {eBw, 10, 1}}}},
+            {0x0F, 5, 1, 16, {4, 4, 4}, true,
+             {{{eRw, 0, 10}, {eGw, 0, 10}, {eBw, 0, 10}, {eRx, 0, 4}, {eRw, 15, 1}, {eRw, 14, 1}, {eRw, 13, 1},
+               {eRw, 12, 1}, {eRw, 11, 1}, {eRw, 10, 1}, {eGx, 0, 4}, {eGw, 15, 1}, {eGw, 14, 1}, {eGw, 13, 1},
+               {eGw, 12, 1}, {eGw, 11, 1}, {eGw, 10, 1}, {eBx, 0, 4}, {eBw, 15, 1}, {eBw, 14, 1}, {eBw, 13, 1},
+               {eBw, 12, 1}, {eBw, 11, 1}, {eBw, 10, 1}}}},
+    }};
+
+    // Every mode has to fill each of its fields exactly once, and leave exactly the room of its indices
+    constexpr bool AreBc6hLayoutsValid()
+    {
+        for (const auto& mode : bc6hModes)
+        {
+            std::array<u32, 13> filled{};
+            u32 headerBits = mode.codeBits;
+            for (const auto& segment : mode.layout)
+            {
+                const u32 bits = ((1u << segment.count) - 1) << segment.shift;
+                if (filled[segment.value] & bits)
+                {
+                    return false;
+                }
+                filled[segment.value] |= bits;
+                headerBits += segment.count;
+            }
+            for (u32 value = 0; value < filled.size(); ++value)
+            {
+                // The partition takes 5 bits, only two subset modes have one
+                const u32 endpoint = value / 3;
+                u32 expectedBits = mode.subsets == 2 ? 5 : 0;
+                if (value != eD)
+                {
+                    expectedBits = endpoint == 0 ? mode.endpointBits : mode.deltaBits[value % 3];
+                    expectedBits = endpoint < mode.subsets * 2u ? expectedBits : 0;
+                }
+                if (filled[value] != (1u << expectedBits) - 1)
+                {
+                    return false;
+                }
+            }
+            const u32 indexBits = mode.subsets == 2 ? 16 * 3 - 2 : 16 * 4 - 1;
+            if (headerBits + indexBits != 128)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    static_assert(AreBc6hLayoutsValid());
+
+    // Mode of every value of the low 5 bits of a block, 0xFF for the reserved ones
+    constexpr auto bc6hModeLookup = []
+    {
+        std::array<u8, 32> lookup{};
+        lookup.fill(0xFF);
+        for (u32 code = 0; code < 32; ++code)
+        {
+            for (u32 mode = 0; mode < bc6hModes.size(); ++mode)
+            {
+                const u32 codeMask = (1u << bc6hModes[mode].codeBits) - 1;
+                if ((code & codeMask) == bc6hModes[mode].code)
+                {
+                    lookup[code] = static_cast<u8>(mode);
+                }
+            }
+        }
+        return lookup;
+    }();
+
+    i32 SignExtend(const u32 value, const u32 bits)
+    {
+        const u32 shift = 32 - bits;
+        return static_cast<i32>(value << shift) >> shift;
+    }
+
+    // Scales an endpoint of endpointBits up to 16 bits (15 and a sign when signed)
+    i32 UnquantizeBc6h(const i32 value, const u32 endpointBits, const bool isSigned)
+    {
+        if (!isSigned)
+        {
+            if (endpointBits >= 15 || value == 0)
+            {
+                return value;
+            }
+            if (value == (1 << endpointBits) - 1)
+            {
+                return 0xFFFF;
+            }
+            return ((value << 16) + 0x8000) >> endpointBits;
+        }
+        if (endpointBits >= 16)
+        {
+            return value;
+        }
+        const i32 magnitude = value < 0 ? -value : value;
+        i32 unquantized = 0;
+        if (magnitude >= (1 << (endpointBits - 1)) - 1)
+        {
+            unquantized = 0x7FFF;
+        }
+        else if (magnitude > 0)
+        {
+            unquantized = ((magnitude << 15) + 0x4000) >> (endpointBits - 1);
+        }
+        return value < 0 ? -unquantized : unquantized;
+    }
+
+    // Maps an interpolated value onto the half float bit pattern, 31/64 of the range keeps it below infinity
+    u16 FinishBc6h(const i32 value, const bool isSigned)
+    {
+        if (!isSigned)
+        {
+            return static_cast<u16>(value * 31 >> 6);
+        }
+        if (value < 0)
+        {
+            return static_cast<u16>((-value * 31 >> 5) | 0x8000);
+        }
+        return static_cast<u16>(value * 31 >> 5);
+    }
+
+    void DecodeBc6h(const BlockDecoder& decoder, const u8* block, u8* texels)
+    {
+        constexpr u16 halfOne = 0x3C00;
+        const u8 modeIndex = bc6hModeLookup[block[0] & 0x1F];
+        if (modeIndex == 0xFF)
+        {
+            for (u32 texel = 0; texel < 16; ++texel)
+            {
+                const std::array<u16, 4> color = {0, 0, 0, halfOne};
+                std::memcpy(texels + texel * 8, color.data(), 8);
+            }
+            return;
+        }
+        const auto& mode = bc6hModes[modeIndex];
+        const bool isSigned = decoder.variant == bcSigned;
+        BlockBits bits(block);
+        bits.Get(mode.codeBits);
+        std::array<u32, 13> values{};
+        for (const auto& segment : mode.layout)
+        {
+            if (segment.count == 0)
+            {
+                break;
+            }
+            values[segment.value] |= bits.Get(segment.count) << segment.shift;
+        }
+
+        // Four endpoints for two subsets, two for one
+        const u32 endpointCount = mode.subsets * 2u;
+        const u32 endpointMask = (1u << mode.endpointBits) - 1;
+        std::array<std::array<i32, 3>, 4> endpoints{};
+        for (u32 channel = 0; channel < 3; ++channel)
+        {
+            const u32 base = values[channel];
+            endpoints[0][channel] = isSigned ? SignExtend(base, mode.endpointBits) : static_cast<i32>(base);
+            for (u32 endpoint = 1; endpoint < endpointCount; ++endpoint)
+            {
+                u32 value = values[endpoint * 3 + channel];
+                if (mode.isTransformed)
+                {
+                    value = (base + SignExtend(value, mode.deltaBits[channel])) & endpointMask;
+                }
+                endpoints[endpoint][channel] =
+                        isSigned ? SignExtend(value, mode.endpointBits) : static_cast<i32>(value);
+            }
+            for (u32 endpoint = 0; endpoint < endpointCount; ++endpoint)
+            {
+                auto& value = endpoints[endpoint][channel];
+                value = UnquantizeBc6h(value, mode.endpointBits, isSigned);
+            }
+        }
+
+        const u32 partition = values[eD];
+        const u32 indexBits = mode.subsets == 2 ? 3 : 4;
+        const auto& weights = Bc7::weights[indexBits - 2];
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            u32 subset = 0;
+            bool isAnchor = texel == 0;
+            if (mode.subsets == 2)
+            {
+                subset = Bc7::partitions2[partition] >> texel & 1;
+                isAnchor = isAnchor || texel == Bc7::anchors2[partition];
+            }
+            const i32 weight = weights[bits.Get(indexBits - (isAnchor ? 1 : 0))];
+            const auto& low = endpoints[subset * 2];
+            const auto& high = endpoints[subset * 2 + 1];
+            std::array<u16, 4> color = {0, 0, 0, halfOne};
+            for (u32 channel = 0; channel < 3; ++channel)
+            {
+                const i32 value = (low[channel] * (64 - weight) + high[channel] * weight + 32) >> 6;
+                color[channel] = FinishBc6h(value, isSigned);
+            }
+            std::memcpy(texels + texel * 8, color.data(), 8);
+        }
+    }
+} // namespace
+
+bool KTX::Decoders::GetBcDecoder(const u32 vkFormat, BlockDecoder& decoder)
+{
+    using enum KtxUtility_VkFormat;
+    const auto set = [&](const u32 blockSize, const KtxUtility_VkFormat decodedFormat, const u32 variant,
+                         void (*decode)(const BlockDecoder&, const u8*, u8*))
+    {
+        const u32 texelSize = decodedFormat == VK_FORMAT_R16G16B16A16_SFLOAT ? 8 : 4;
+        decoder = {.blockWidth = 4,
+                   .blockHeight = 4,
+                   .blockSize = blockSize,
+                   .texelSize = texelSize,
+                   .decodedVkFormat = static_cast<u32>(decodedFormat),
+                   .variant = variant,
+                   .decode = decode};
+        return true;
+    };
+    switch (static_cast<KtxUtility_VkFormat>(vkFormat))
+    {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            return set(8, VK_FORMAT_R8G8B8A8_UNORM, bc1Opaque, DecodeBc1);
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            return set(8, VK_FORMAT_R8G8B8A8_SRGB, bc1Opaque, DecodeBc1);
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            return set(8, VK_FORMAT_R8G8B8A8_UNORM, bc1PunchThrough, DecodeBc1);
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            return set(8, VK_FORMAT_R8G8B8A8_SRGB, bc1PunchThrough, DecodeBc1);
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+            return set(16, VK_FORMAT_R8G8B8A8_UNORM, 0, DecodeBc2);
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+            return set(16, VK_FORMAT_R8G8B8A8_SRGB, 0, DecodeBc2);
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+            return set(16, VK_FORMAT_R8G8B8A8_UNORM, 0, DecodeBc3);
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+            return set(16, VK_FORMAT_R8G8B8A8_SRGB, 0, DecodeBc3);
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+            return set(8, VK_FORMAT_R8G8B8A8_UNORM, bcUnsigned, DecodeBc4);
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+            return set(8, VK_FORMAT_R8G8B8A8_SNORM, bcSigned, DecodeBc4);
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+            return set(16, VK_FORMAT_R8G8B8A8_UNORM, bcUnsigned, DecodeBc5);
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+            return set(16, VK_FORMAT_R8G8B8A8_SNORM, bcSigned, DecodeBc5);
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+            return set(16, VK_FORMAT_R16G16B16A16_SFLOAT, bcUnsigned, DecodeBc6h);
+        case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+            return set(16, VK_FORMAT_R16G16B16A16_SFLOAT, bcSigned, DecodeBc6h);
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+            return set(16, VK_FORMAT_R8G8B8A8_UNORM, 0, DecodeBc7);
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            return set(16, VK_FORMAT_R8G8B8A8_SRGB, 0, DecodeBc7);
+        default:
+            return false;
+    }
+}
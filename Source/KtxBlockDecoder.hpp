@@ -0,0 +1,111 @@
+#pragma once
+#include <array>
+#include <cstring>
+
+#include "KtxUtility.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Block decoders behind KtxDecoder.hpp, one getter per family of block formats
+
+namespace KTX::Decoders
+{
+    struct BlockDecoder
+    {
+        u32 blockWidth;
+        u32 blockHeight;
+        u32 blockSize;
+        // 4 for RGBA8 and 8 for 16 bit channels
+        u32 texelSize;
+        u32 decodedVkFormat;
+        // Picks between the formats sharing a decode function, meaning is up to the family
+        u32 variant;
+        // Writes blockWidth x blockHeight texels in raster order, malformed blocks decode to a fixed color
+        void (*decode)(const BlockDecoder& decoder, const u8* block, u8* texels);
+    };
+
+    // BC1 to BC7, false for any other format
+    bool GetBcDecoder(u32 vkFormat, BlockDecoder& decoder);
+    // ETC2 RGB (and so ETC1), RGBA and punch-through alpha, EAC R11 and RG11
+    bool GetEtcDecoder(u32 vkFormat, BlockDecoder& decoder);
+    // ASTC LDR, sRGB and HDR in every 2D footprint
+    bool GetAstcDecoder(u32 vkFormat, BlockDecoder& decoder);
+
+    // One RGBA8 value per index, red in the low byte
+    using Palette = std::array<u32, 8>;
+
+    inline u32 Load32(const u8* data)
+    {
+        u32 value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    inline u64 Load64(const u8* data)
+    {
+        u64 value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    // Writes palette[index] for 16 RGBA8 texels, whose IndexBits wide indices are packed in indices in raster order,
+    // ORed into the texels already there when Accumulate is set. Palette based formats spend most of their time here,
+    // so it is done 8 (or 4) texels at a time.
+    template <u32 IndexBits, bool Accumulate>
+    void LookupTexels(const Palette& palette, const u64 indices, u8* texels)
+    {
+        constexpr u32 mask = (1u << IndexBits) - 1;
+#if defined(__AVX2__)
+        const __m256i table = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(palette.data()));
+        const __m256i shifts = _mm256_setr_epi32(0, IndexBits, IndexBits * 2, IndexBits * 3, IndexBits * 4,
+                                                 IndexBits * 5, IndexBits * 6, IndexBits * 7);
+        for (u32 half = 0; half < 2; ++half)
+        {
+            const auto packed = static_cast<i32>(static_cast<u32>(indices >> (half * 8 * IndexBits)));
+            const __m256i index =
+                    _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(packed), shifts), _mm256_set1_epi32(mask));
+            auto* destination = reinterpret_cast<__m256i*>(texels + half * 32);
+            __m256i result = _mm256_permutevar8x32_epi32(table, index);
+            if constexpr (Accumulate)
+            {
+                result = _mm256_or_si256(result, _mm256_loadu_si256(destination));
+            }
+            _mm256_storeu_si256(destination, result);
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        const auto* bytes = reinterpret_cast<const u8*>(palette.data());
+        const uint8x16x2_t table = {vld1q_u8(bytes), vld1q_u8(bytes + 16)};
+        // Negative counts shift right
+        constexpr std::array<i32, 4> shiftCounts = {0, -static_cast<i32>(IndexBits), -static_cast<i32>(IndexBits) * 2,
+                                                    -static_cast<i32>(IndexBits) * 3};
+        const int32x4_t shifts = vld1q_s32(shiftCounts.data());
+        for (u32 quarter = 0; quarter < 4; ++quarter)
+        {
+            const auto packed = static_cast<u32>(indices >> (quarter * 4 * IndexBits));
+            const uint32x4_t index = vandq_u32(vshlq_u32(vdupq_n_u32(packed), shifts), vdupq_n_u32(mask));
+            // Byte offsets of the four bytes of every texel in the table
+            const uint32x4_t offsets = vmlaq_n_u32(vdupq_n_u32(0x03020100), index, 0x04040404);
+            uint8x16_t result = vqtbl2q_u8(table, vreinterpretq_u8_u32(offsets));
+            if constexpr (Accumulate)
+            {
+                result = vorrq_u8(result, vld1q_u8(texels + quarter * 16));
+            }
+            vst1q_u8(texels + quarter * 16, result);
+        }
+#else
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            u32 value = palette[(indices >> (texel * IndexBits)) & mask];
+            if constexpr (Accumulate)
+            {
+                value |= Load32(texels + texel * 4);
+            }
+            std::memcpy(texels + texel * 4, &value, sizeof(value));
+        }
+#endif
+    }
+} // namespace KTX::Decoders
@@ -0,0 +1,192 @@
+#include "KtxDecoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include "KtxBlockDecoder.hpp"
+#include "KtxFormat.hpp"
+
+namespace
+{
+    using namespace KTX;
+    using Decoders::BlockDecoder;
+
+    // Blocks per pool task, small images get a single task
+    constexpr u32 bandBlocks = 4096;
+    // Texels of the largest block footprint any decoder has
+    constexpr u32 maxBlockTexels = 12 * 12;
+
+    bool GetDecoder(const u32 vkFormat, BlockDecoder& decoder)
+    {
+        return Decoders::GetBcDecoder(vkFormat, decoder) || Decoders::GetEtcDecoder(vkFormat, decoder) ||
+               Decoders::GetAstcDecoder(vkFormat, decoder);
+    }
+} // namespace
+
+KTX::u32 KTX::GetDecodedVkFormat(const u32 vkFormat)
+{
+    BlockDecoder decoder{};
+    return GetDecoder(vkFormat, decoder) ? decoder.decodedVkFormat
+                                         : static_cast<u32>(KtxUtility_VkFormat::VK_FORMAT_UNDEFINED);
+}
+
+KTX::u64 KTX::GetDecodedImageSize(const u32 vkFormat, const u32 width, const u32 height)
+{
+    BlockDecoder decoder{};
+    return GetDecoder(vkFormat, decoder) ? static_cast<u64>(width) * height * decoder.texelSize : 0;
+}
+
+KTX::KtxResult KTX::DecodeImageRows(const u32 vkFormat, const std::span<const u8> blocks, const u32 width,
+                                    const u32 height, const u32 firstRow, const u32 rowCount,
+                                    const std::span<u8> destination)
+{
+    BlockDecoder decoder{};
+    if (!GetDecoder(vkFormat, decoder))
+    {
+        return KtxResult::eUnsupportedFeature;
+    }
+    const u32 blocksX = (width + decoder.blockWidth - 1) / decoder.blockWidth;
+    const u32 blocksY = (height + decoder.blockHeight - 1) / decoder.blockHeight;
+    assert(firstRow + rowCount <= blocksY && "Block rows out of range");
+    assert(destination.size() >= static_cast<u64>(width) * height * decoder.texelSize && "Destination is too small");
+    if (blocks.size() < static_cast<u64>(blocksX) * blocksY * decoder.blockSize)
+    {
+        return KtxResult::eFileDataError;
+    }
+
+    const u64 rowPitch = static_cast<u64>(width) * decoder.texelSize;
+    const u32 blockPitch = decoder.blockWidth * decoder.texelSize;
+    alignas(32) std::array<u8, maxBlockTexels * 8> texels;
+    for (u32 row = firstRow; row < firstRow + rowCount; ++row)
+    {
+        const u32 y = row * decoder.blockHeight;
+        const u32 texelRows = std::min(decoder.blockHeight, height - y);
+        const u8* block = blocks.data() + static_cast<u64>(row) * blocksX * decoder.blockSize;
+        u8* rowStart = destination.data() + y * rowPitch;
+        for (u32 column = 0; column < blocksX; ++column, block += decoder.blockSize)
+        {
+            decoder.decode(decoder, block, texels.data());
+            // Blocks on the right and bottom edges are clipped to the image
+            const u32 x = column * decoder.blockWidth;
+            const u32 copySize = std::min(decoder.blockWidth, width - x) * decoder.texelSize;
+            for (u32 texelRow = 0; texelRow < texelRows; ++texelRow)
+            {
+                std::memcpy(rowStart + texelRow * rowPitch + x * decoder.texelSize,
+                            texels.data() + texelRow * blockPitch, copySize);
+            }
+        }
+    }
+    return KtxResult::eSuccess;
+}
+
+std::expected<KTX::KtxTexture, KTX::KtxResult> KTX::DecodeTexture(KtxThreadPool& pool, KtxTexture& texture)
+{
+    const auto& info = texture.GetInfo();
+    BlockDecoder decoder{};
+    if (info.superCompressionScheme == static_cast<u32>(KtxSupercompressionScheme::eBasisLZ) ||
+        !GetDecoder(info.vkFormat, decoder))
+    {
+        return std::unexpected(KtxResult::eUnsupportedFeature);
+    }
+
+    // Stored levels, read up front unless the image data is loaded. Zstd and zlib levels come out of ReadLevel decoded.
+    std::vector<std::vector<u8>> readLevels;
+    readLevels.reserve(info.numLevels);
+    std::vector<std::span<const u8>> levelData(info.numLevels);
+    for (u32 level = 0; level < info.numLevels; ++level)
+    {
+        if (texture.HasImageData())
+        {
+            levelData[level] = texture.GetLevel(level);
+            continue;
+        }
+        const auto& entry = texture.GetLevelIndex()[level];
+        const bool isDecoded = info.superCompressionScheme == static_cast<u32>(KtxSupercompressionScheme::eZstd) ||
+                               info.superCompressionScheme == static_cast<u32>(KtxSupercompressionScheme::eZlib);
+        auto& stored = readLevels.emplace_back(isDecoded ? entry.uncompressedByteLength : entry.byteLength);
+        if (!texture.ReadLevel(level, stored))
+        {
+            return std::unexpected(KtxResult::eFileReadError);
+        }
+        levelData[level] = stored;
+    }
+
+    struct BandTask
+    {
+        u32 level;
+        u64 sourceOffset;
+        u64 destinationOffset;
+        u32 firstRow;
+        u32 rowCount;
+    };
+    std::vector<BandTask> tasks;
+    std::vector<KtxLevelRange> levels;
+    u64 dataSize = 0;
+    for (u32 level = 0; level < info.numLevels; ++level)
+    {
+        const u32 width = texture.GetLevelWidth(level);
+        const u32 height = texture.GetLevelHeight(level);
+        const u32 blocksX = (width + decoder.blockWidth - 1) / decoder.blockWidth;
+        const u32 blocksY = (height + decoder.blockHeight - 1) / decoder.blockHeight;
+        const u64 blockImageSize = static_cast<u64>(blocksX) * blocksY * decoder.blockSize;
+        const u64 imageSize = static_cast<u64>(width) * height * decoder.texelSize;
+        const u32 imageCount = info.numLayers * info.numFaces * texture.GetLevelDepth(level);
+        if (levelData[level].size() < blockImageSize * imageCount)
+        {
+            return std::unexpected(KtxResult::eFileDataError);
+        }
+        const u32 bandRows = std::max(bandBlocks / blocksX, 1u);
+        for (u32 image = 0; image < imageCount; ++image)
+        {
+            for (u32 row = 0; row < blocksY; row += bandRows)
+            {
+                tasks.push_back({.level = level,
+                                 .sourceOffset = image * blockImageSize,
+                                 .destinationOffset = dataSize + image * imageSize,
+                                 .firstRow = row,
+                                 .rowCount = std::min(bandRows, blocksY - row)});
+            }
+        }
+        levels.push_back({.byteOffset = dataSize, .byteLength = imageSize * imageCount});
+        dataSize += levels.back().byteLength;
+    }
+
+    // Bands only write their own rows, level 0 comes first so the largest levels start early
+    auto data = std::make_unique_for_overwrite<u8[]>(dataSize);
+    std::vector results(tasks.size(), KtxResult::eSuccess);
+    pool.ParallelFor(static_cast<u32>(tasks.size()),
+                     [&](const u32 index)
+                     {
+                         const auto& task = tasks[index];
+                         const u32 width = texture.GetLevelWidth(task.level);
+                         const u32 height = texture.GetLevelHeight(task.level);
+                         const std::span destination(data.get() + task.destinationOffset,
+                                                     static_cast<u64>(width) * height * decoder.texelSize);
+                         const auto blocks = levelData[task.level].subspan(task.sourceOffset);
+                         results[index] = DecodeImageRows(info.vkFormat, blocks, width, height, task.firstRow,
+                                                          task.rowCount, destination);
+                     });
+    for (const auto result : results)
+    {
+        if (result != KtxResult::eSuccess)
+        {
+            return std::unexpected(result);
+        }
+    }
+
+    KtxTextureInfo decodedInfo = info;
+    decodedInfo.vkFormat = decoder.decodedVkFormat;
+    decodedInfo.formatSize = GetVkFormatSize(decodedInfo.vkFormat);
+    decodedInfo.isCompressed = false;
+    decodedInfo.glInternalFormat = GetGlFormatFromVk(decodedInfo.vkFormat);
+    decodedInfo.typeSize = decoder.texelSize / 4;
+    decodedInfo.superCompressionScheme = static_cast<u32>(KtxSupercompressionScheme::eNone);
+
+    const auto keyValueData = texture.GetKeyValueData();
+    KtxTexture decoded(decodedInfo, std::vector<u8>(keyValueData.begin(), keyValueData.end()));
+    decoded.SetImageData(std::move(data), dataSize, std::move(levels));
+    return decoded;
+}
@@ -0,0 +1,163 @@
+#include "KtxDfd.hpp"
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+    using namespace KTX;
+
+    // Every block starts with the vendor and type word followed by the version and size word
+    constexpr u32 dfdBlockPrefixSize = 8;
+    constexpr u32 dfdBasicBlockHeaderSize = 24;
+    constexpr u32 dfdSampleSize = 16;
+    constexpr u32 dfdVendorKhronos = 0;
+    constexpr u32 dfdTypeBasic = 0;
+    constexpr u8 dfdFlagAlphaPremultiplied = 1;
+    // Qualifiers in the top bits of a sample's channel type
+    constexpr u8 dfdQualifierLinear = 0x10;
+    constexpr u8 dfdQualifierExponent = 0x20;
+    constexpr u8 dfdQualifierSigned = 0x40;
+    constexpr u8 dfdQualifierFloat = 0x80;
+    // Bounds for the interned cache, files can hand in any bytes they like. A basic block with 4 samples is 92 bytes
+    // and a library holds a few dozen distinct descriptors, so real files never get near either limit.
+    constexpr u64 maxInternedSize = 1024;
+    constexpr size_t maxInternedCount = 4096;
+
+    u32 ReadU32(const std::span<const u8> data, const u32 offset)
+    {
+        u32 value;
+        std::memcpy(&value, data.data() + offset, sizeof(value));
+        return value;
+    }
+
+    std::expected<KtxDataFormatDescriptor, KtxResult> ParseBasicBlock(const std::span<const u8> block)
+    {
+        if (block.size() < dfdBasicBlockHeaderSize || (block.size() - dfdBasicBlockHeaderSize) % dfdSampleSize != 0)
+        {
+            return std::unexpected(KtxResult::eFileDataError);
+        }
+
+        KtxDataFormatDescriptor descriptor{};
+        descriptor.versionNumber = static_cast<u16>(ReadU32(block, 4));
+        const u32 model = ReadU32(block, 8);
+        descriptor.colorModel = static_cast<KtxDfdColorModel>(model & 0xFF);
+        descriptor.colorPrimaries = static_cast<KtxDfdColorPrimaries>(model >> 8 & 0xFF);
+        descriptor.transferFunction = static_cast<KtxDfdTransferFunction>(model >> 16 & 0xFF);
+        descriptor.isPremultiplied = (model >> 24 & dfdFlagAlphaPremultiplied) != 0;
+        // Dimensions are stored minus one
+        for (u32 i = 0; i < 4; ++i)
+        {
+            descriptor.texelBlockDimensions[i] = block[12 + i] + 1u;
+        }
+        std::memcpy(descriptor.bytesPlane.data(), block.data() + 16, descriptor.bytesPlane.size());
+
+        descriptor.samples.resize((block.size() - dfdBasicBlockHeaderSize) / dfdSampleSize);
+        for (u32 i = 0; i < descriptor.samples.size(); ++i)
+        {
+            const u32 offset = dfdBasicBlockHeaderSize + i * dfdSampleSize;
+            const u32 bits = ReadU32(block, offset);
+            const auto channelType = static_cast<u8>(bits >> 24);
+            auto& sample = descriptor.samples[i];
+            sample.bitOffset = static_cast<u16>(bits);
+            sample.bitLength = static_cast<u16>((bits >> 16 & 0xFF) + 1);
+            sample.channelId = channelType & 0xF;
+            sample.isLinear = (channelType & dfdQualifierLinear) != 0;
+            sample.isExponent = (channelType & dfdQualifierExponent) != 0;
+            sample.isSigned = (channelType & dfdQualifierSigned) != 0;
+            sample.isFloat = (channelType & dfdQualifierFloat) != 0;
+            std::memcpy(sample.samplePosition.data(), block.data() + offset + 4, sample.samplePosition.size());
+            sample.sampleLower = ReadU32(block, offset + 8);
+            sample.sampleUpper = ReadU32(block, offset + 12);
+        }
+        return descriptor;
+    }
+
+    // The key views the bytes stored next to the descriptor, so a lookup never copies the caller's bytes
+    struct InternedDescriptor
+    {
+        std::vector<u8> bytes;
+        KtxDataFormatDescriptor descriptor;
+    };
+
+    struct DescriptorCache
+    {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string_view, std::unique_ptr<const InternedDescriptor>> entries;
+    };
+
+    DescriptorCache& GetDescriptorCache()
+    {
+        // Never destroyed, textures destroyed during static destruction may still point into it
+        static auto* cache = new DescriptorCache;
+        return *cache;
+    }
+} // namespace
+
+std::expected<KTX::KtxDataFormatDescriptor, KTX::KtxResult>
+KTX::ParseDataFormatDescriptor(const std::span<const u8> dfd)
+{
+    if (dfd.size() < sizeof(u32))
+    {
+        return std::unexpected(KtxResult::eFileDataError);
+    }
+    const u32 totalSize = ReadU32(dfd, 0);
+    if (totalSize < sizeof(u32) || totalSize > dfd.size())
+    {
+        return std::unexpected(KtxResult::eFileDataError);
+    }
+
+    // Vendor blocks may come first, the basic block is looked up by vendor and type
+    u32 offset = sizeof(u32);
+    while (totalSize - offset >= dfdBlockPrefixSize)
+    {
+        const u32 vendorAndType = ReadU32(dfd, offset);
+        const u32 blockSize = ReadU32(dfd, offset + 4) >> 16;
+        if (blockSize < dfdBlockPrefixSize || blockSize > totalSize - offset)
+        {
+            return std::unexpected(KtxResult::eFileDataError);
+        }
+        if ((vendorAndType & 0x1FFFF) == dfdVendorKhronos && vendorAndType >> 17 == dfdTypeBasic)
+        {
+            return ParseBasicBlock(dfd.subspan(offset, blockSize));
+        }
+        offset += blockSize;
+    }
+    return std::unexpected(KtxResult::eUnsupportedFeature);
+}
+
+const KTX::KtxDataFormatDescriptor* KTX::InternDataFormatDescriptor(const std::span<const u8> dfd)
+{
+    if (dfd.size() > maxInternedSize)
+    {
+        return nullptr;
+    }
+    auto& cache = GetDescriptorCache();
+    const std::string_view key(reinterpret_cast<const char*>(dfd.data()), dfd.size());
+    {
+        std::shared_lock lock(cache.mutex);
+        if (const auto entry = cache.entries.find(key); entry != cache.entries.end())
+        {
+            return &entry->second->descriptor;
+        }
+    }
+
+    // Parsed without the lock, a thread that got here first for the same bytes wins and this copy is dropped
+    auto descriptor = ParseDataFormatDescriptor(dfd);
+    if (!descriptor)
+    {
+        return nullptr;
+    }
+    auto interned = std::make_unique<InternedDescriptor>(std::vector(dfd.begin(), dfd.end()), std::move(*descriptor));
+    const std::string_view internedKey(reinterpret_cast<const char*>(interned->bytes.data()), interned->bytes.size());
+    std::unique_lock lock(cache.mutex);
+    if (cache.entries.size() >= maxInternedCount && !cache.entries.contains(internedKey))
+    {
+        return nullptr;
+    }
+    return &cache.entries.try_emplace(internedKey, std::move(interned)).first->second->descriptor;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <array>
+
+#include "KtxUtility.hpp"
+
+// Tables of the ETC1, ETC2 and EAC formats, shared by the transcoders and the ETC decoder
+
+namespace KTX::Etc
+{
+    // ETC1 intensity modifiers in the order of the 2 bit pixel indices
+    inline constexpr std::array<std::array<i32, 4>, 8> modifiers = {{
+            {2, 8, -2, -8},
+            {5, 17, -5, -17},
+            {9, 29, -9, -29},
+            {13, 42, -13, -42},
+            {18, 60, -18, -60},
+            {24, 80, -24, -80},
+            {33, 106, -33, -106},
+            {47, 183, -47, -183},
+    }};
+    // EAC modifiers of the 16 tables, in the order of the 3 bit pixel indices
+    inline constexpr std::array<std::array<i32, 8>, 16> eacModifiers = {{
+            {-3, -6, -9, -15, 2, 5, 8, 14},
+            {-3, -7, -10, -13, 2, 6, 9, 12},
+            {-2, -5, -8, -13, 1, 4, 7, 12},
+            {-2, -4, -6, -13, 1, 3, 5, 12},
+            {-3, -6, -8, -12, 2, 5, 7, 11},
+            {-3, -7, -9, -11, 2, 6, 8, 10},
+            {-4, -7, -8, -11, 3, 6, 7, 10},
+            {-3, -5, -8, -11, 2, 4, 7, 10},
+            {-2, -6, -8, -10, 1, 5, 7, 9},
+            {-2, -5, -8, -10, 1, 4, 7, 9},
+            {-2, -4, -8, -10, 1, 3, 7, 9},
+            {-2, -5, -7, -10, 1, 4, 6, 9},
+            {-3, -4, -7, -10, 2, 3, 6, 9},
+            {-1, -2, -3, -10, 0, 1, 2, 9},
+            {-4, -6, -8, -9, 3, 5, 7, 8},
+            {-3, -5, -7, -9, 2, 4, 6, 8},
+    }};
+    // Distances between the paint colors of ETC2 T and H blocks
+    inline constexpr std::array<i32, 8> distances = {3, 6, 11, 16, 20, 23, 27, 32};
+} // namespace KTX::Etc
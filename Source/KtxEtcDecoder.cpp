@@ -0,0 +1,366 @@
+#include "KtxBlockDecoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "KtxEtc.hpp"
+#include "VK_Format.hpp"
+
+namespace
+{
+    using namespace KTX;
+    using Decoders::BlockDecoder;
+    using Decoders::LookupTexels;
+    using Decoders::Palette;
+
+    // Variants of ETC2 color blocks, alone, with punch-through alpha or after an EAC alpha block
+    constexpr u32 etcOpaque = 0;
+    constexpr u32 etcPunchThrough = 1;
+    constexpr u32 etcAlpha = 2;
+    // Variants of EAC R11 and RG11
+    constexpr u32 eacUnsigned = 0;
+    constexpr u32 eacSigned = 1;
+
+    // ETC and EAC blocks are big endian 64 bit words
+    u64 LoadBlock(const u8* data)
+    {
+        u64 value = 0;
+        for (u32 i = 0; i < 8; ++i)
+        {
+            value = value << 8 | data[i];
+        }
+        return value;
+    }
+
+    i32 SignExtend3(const u32 value)
+    {
+        return value >= 4 ? static_cast<i32>(value) - 8 : static_cast<i32>(value);
+    }
+
+    u32 Expand4(const u32 value)
+    {
+        return value * 0x11;
+    }
+
+    u32 Expand5(const u32 value)
+    {
+        return value << 3 | value >> 2;
+    }
+
+    u32 ClampToByte(const i32 value)
+    {
+        return static_cast<u32>(std::clamp(value, 0, 255));
+    }
+
+    using Color = std::array<i32, 3>;
+
+    u32 PackColor(const Color& color, const i32 offset)
+    {
+        return ClampToByte(color[0] + offset) | ClampToByte(color[1] + offset) << 8 |
+               ClampToByte(color[2] + offset) << 16 | 0xFF000000;
+    }
+
+    // Pixel indices are stored column by column with the most significant bits in the upper half. Returns them in
+    // raster order, 3 bits per texel with the 2 bit index in the low bits, so the top bit can pick a sub-block.
+    u64 GetRasterIndices(const u32 indexBits)
+    {
+        u64 indices = 0;
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            const u32 column = (texel & 3) * 4 + (texel >> 2);
+            const u32 index = (indexBits >> (column + 16) & 1) << 1 | (indexBits >> column & 1);
+            indices |= static_cast<u64>(index) << (texel * 3);
+        }
+        return indices;
+    }
+
+    // Top index bit of the texels of the second sub-block, for 2x4 halves side by side and for flipped 4x2 halves
+    constexpr auto subBlockBits = []
+    {
+        std::array<u64, 2> bits{};
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            bits[0] |= static_cast<u64>((texel & 3) >= 2 ? 4 : 0) << (texel * 3);
+            bits[1] |= static_cast<u64>(texel >= 8 ? 4 : 0) << (texel * 3);
+        }
+        return bits;
+    }();
+
+    // Gradient over the block from three colors, in ETC2 RGB23 (RGB676) precision
+    void DecodePlanar(const u64 bits, u8* texels)
+    {
+        const auto expand6 = [](const u64 value) { return static_cast<i32>(value << 2 | value >> 4); };
+        const auto expand7 = [](const u64 value) { return static_cast<i32>(value << 1 | value >> 6); };
+        const Color origin = {expand6(bits >> 57 & 0x3F), expand7((bits >> 56 & 1) << 6 | (bits >> 49 & 0x3F)),
+                              expand6((bits >> 48 & 1) << 5 | (bits >> 43 & 3) << 3 | (bits >> 39 & 7))};
+        const Color horizontal = {expand6((bits >> 34 & 0x1F) << 1 | (bits >> 32 & 1)), expand7(bits >> 25 & 0x7F),
+                                  expand6(bits >> 19 & 0x3F)};
+        const Color vertical = {expand6(bits >> 13 & 0x3F), expand7(bits >> 6 & 0x7F), expand6(bits & 0x3F)};
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            const i32 x = static_cast<i32>(texel & 3);
+            const i32 y = static_cast<i32>(texel >> 2);
+            for (u32 channel = 0; channel < 3; ++channel)
+            {
+                const i32 value = x * (horizontal[channel] - origin[channel]) +
+                                  y * (vertical[channel] - origin[channel]) + 4 * origin[channel] + 2;
+                texels[texel * 4 + channel] = static_cast<u8>(ClampToByte(value >> 2));
+            }
+            texels[texel * 4 + 3] = 0xFF;
+        }
+    }
+
+    // Decodes an ETC2 RGB block, ETC1 blocks included. With punch-through alpha the differential bit says whether the
+    // block is opaque, and transparent blocks turn index 2 into transparent black.
+    void DecodeColorBlock(const u8* block, const bool hasPunchThrough, u8* texels)
+    {
+        const u64 bits = LoadBlock(block);
+        const auto high = static_cast<u32>(bits >> 32);
+        const u64 indices = GetRasterIndices(static_cast<u32>(bits));
+        const bool isDifferential = (high >> 1 & 1) == 1;
+        const bool isTransparent = hasPunchThrough && !isDifferential;
+        Palette palette{};
+        // T and H blocks use a single set of four colors
+        bool hasSubBlocks = true;
+
+        if (!hasPunchThrough && !isDifferential)
+        {
+            // Individual mode, two 4 bit colors
+            std::array<Color, 2> colors{};
+            for (u32 channel = 0; channel < 3; ++channel)
+            {
+                colors[0][channel] = static_cast<i32>(Expand4(high >> (28 - channel * 8) & 0xF));
+                colors[1][channel] = static_cast<i32>(Expand4(high >> (24 - channel * 8) & 0xF));
+            }
+            for (u32 subBlock = 0; subBlock < 2; ++subBlock)
+            {
+                const auto& modifiers = Etc::modifiers[high >> (5 - subBlock * 3) & 7];
+                for (u32 index = 0; index < 4; ++index)
+                {
+                    palette[subBlock * 4 + index] = PackColor(colors[subBlock], modifiers[index]);
+                }
+            }
+        }
+        else
+        {
+            // A 5 bit color and a 3 bit delta per channel, a delta leaving the range picks one of the ETC2 modes
+            std::array<i32, 3> first{};
+            std::array<i32, 3> second{};
+            u32 overflow = 3;
+            for (u32 channel = 0; channel < 3; ++channel)
+            {
+                first[channel] = static_cast<i32>(high >> (27 - channel * 8) & 0x1F);
+                second[channel] = first[channel] + SignExtend3(high >> (24 - channel * 8) & 7);
+                if (overflow == 3 && (second[channel] < 0 || second[channel] > 31))
+                {
+                    overflow = channel;
+                }
+            }
+
+            if (overflow == 0)
+            {
+                // T mode, a single color and a pair of colors around the other one
+                const Color color0 = {static_cast<i32>(Expand4((high >> 27 & 3) << 2 | (high >> 24 & 3))),
+                                      static_cast<i32>(Expand4(high >> 20 & 0xF)),
+                                      static_cast<i32>(Expand4(high >> 16 & 0xF))};
+                const Color color1 = {static_cast<i32>(Expand4(high >> 12 & 0xF)),
+                                      static_cast<i32>(Expand4(high >> 8 & 0xF)),
+                                      static_cast<i32>(Expand4(high >> 4 & 0xF))};
+                const i32 distance = Etc::distances[(high >> 2 & 3) << 1 | (high & 1)];
+                palette[0] = PackColor(color0, 0);
+                palette[1] = PackColor(color1, distance);
+                palette[2] = PackColor(color1, 0);
+                palette[3] = PackColor(color1, -distance);
+                hasSubBlocks = false;
+            }
+            else if (overflow == 1)
+            {
+                // H mode, two pairs of colors, the order of the base colors holds the last bit of the distance
+                const std::array<u32, 3> packed0 = {high >> 27 & 0xF, (high >> 24 & 7) << 1 | (high >> 20 & 1),
+                                                    (high >> 19 & 1) << 3 | (high >> 15 & 7)};
+                const std::array<u32, 3> packed1 = {high >> 11 & 0xF, high >> 7 & 0xF, high >> 3 & 0xF};
+                const u32 value0 = packed0[0] << 8 | packed0[1] << 4 | packed0[2];
+                const u32 value1 = packed1[0] << 8 | packed1[1] << 4 | packed1[2];
+                const i32 distance =
+                        Etc::distances[(high >> 2 & 1) << 2 | (high & 1) << 1 | (value0 >= value1 ? 1 : 0)];
+                Color color0{};
+                Color color1{};
+                for (u32 channel = 0; channel < 3; ++channel)
+                {
+                    color0[channel] = static_cast<i32>(Expand4(packed0[channel]));
+                    color1[channel] = static_cast<i32>(Expand4(packed1[channel]));
+                }
+                palette[0] = PackColor(color0, distance);
+                palette[1] = PackColor(color0, -distance);
+                palette[2] = PackColor(color1, distance);
+                palette[3] = PackColor(color1, -distance);
+                hasSubBlocks = false;
+            }
+            else if (overflow == 2)
+            {
+                // Planar mode has no indices and ignores the punch-through bit
+                DecodePlanar(bits, texels);
+                return;
+            }
+            else
+            {
+                std::array<Color, 2> colors{};
+                for (u32 channel = 0; channel < 3; ++channel)
+                {
+                    colors[0][channel] = static_cast<i32>(Expand5(static_cast<u32>(first[channel])));
+                    colors[1][channel] = static_cast<i32>(Expand5(static_cast<u32>(second[channel])));
+                }
+                for (u32 subBlock = 0; subBlock < 2; ++subBlock)
+                {
+                    const auto& modifiers = Etc::modifiers[high >> (5 - subBlock * 3) & 7];
+                    for (u32 index = 0; index < 4; ++index)
+                    {
+                        // Transparent blocks lose the small modifiers, index 0 is the base color itself
+                        const i32 modifier = isTransparent && index == 0 ? 0 : modifiers[index];
+                        palette[subBlock * 4 + index] = PackColor(colors[subBlock], modifier);
+                    }
+                }
+            }
+        }
+        if (isTransparent)
+        {
+            palette[2] = 0;
+            palette[6] = 0;
+        }
+        const u64 subBlocks = hasSubBlocks ? subBlockBits[high & 1] : 0;
+        LookupTexels<3, false>(palette, indices | subBlocks, texels);
+    }
+
+    // EAC values before scaling, in the order of the 3 bit indices: base + modifier * multiplier
+    struct EacBlock
+    {
+        i32 base;
+        i32 multiplier;
+        const std::array<i32, 8>* modifiers;
+        // Raster order, 3 bits per texel
+        u64 indices;
+    };
+
+    EacBlock ReadEacBlock(const u8* block)
+    {
+        const u64 bits = LoadBlock(block);
+        EacBlock eac{.base = block[0],
+                     .multiplier = block[1] >> 4,
+                     .modifiers = &Etc::eacModifiers[block[1] & 0xF],
+                     .indices = 0};
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            const u32 column = (texel & 3) * 4 + (texel >> 2);
+            eac.indices |= (bits >> (45 - column * 3) & 7) << (texel * 3);
+        }
+        return eac;
+    }
+
+    void DecodeEtc2(const BlockDecoder& decoder, const u8* block, u8* texels)
+    {
+        if (decoder.variant != etcAlpha)
+        {
+            DecodeColorBlock(block, decoder.variant == etcPunchThrough, texels);
+            return;
+        }
+        DecodeColorBlock(block + 8, false, texels);
+        const EacBlock alpha = ReadEacBlock(block);
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            const i32 modifier = (*alpha.modifiers)[alpha.indices >> (texel * 3) & 7];
+            texels[texel * 4 + 3] = static_cast<u8>(ClampToByte(alpha.base + modifier * alpha.multiplier));
+        }
+    }
+
+    // Writes one 11 bit channel of 16 texels scaled to 16 bits, 8 bytes apart
+    void DecodeEac11(const u8* block, const bool isSigned, u8* texels)
+    {
+        EacBlock eac = ReadEacBlock(block);
+        if (isSigned)
+        {
+            // -128 and -127 both mean -1
+            eac.base = std::max<i32>(static_cast<i8>(block[0]), -127);
+        }
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            const i32 modifier = (*eac.modifiers)[eac.indices >> (texel * 3) & 7];
+            // A multiplier of 0 still moves the value by the modifier, at 1/8 of the step of a multiplier of 1
+            const i32 offset = eac.multiplier == 0 ? modifier : modifier * eac.multiplier * 8;
+            u16 value = 0;
+            if (isSigned)
+            {
+                const i32 signedValue = std::clamp(eac.base * 8 + offset, -1023, 1023);
+                const i32 magnitude = signedValue < 0 ? -signedValue : signedValue;
+                const i32 scaled = magnitude << 5 | magnitude >> 5;
+                value = static_cast<u16>(signedValue < 0 ? -scaled : scaled);
+            }
+            else
+            {
+                const auto unsignedValue = static_cast<u32>(std::clamp(eac.base * 8 + 4 + offset, 0, 2047));
+                value = static_cast<u16>(unsignedValue << 5 | unsignedValue >> 6);
+            }
+            std::memcpy(texels + texel * 8, &value, sizeof(value));
+        }
+    }
+
+    // R11 and RG11 into RGBA16, blue is 0 and alpha 1
+    void DecodeEac(const BlockDecoder& decoder, const u8* block, u8* texels)
+    {
+        const bool isSigned = decoder.variant == eacSigned;
+        const std::array<u16, 4> fill = {0, 0, 0, static_cast<u16>(isSigned ? 0x7FFF : 0xFFFF)};
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            std::memcpy(texels + texel * 8, fill.data(), sizeof(fill));
+        }
+        DecodeEac11(block, isSigned, texels);
+        if (decoder.blockSize == 16)
+        {
+            DecodeEac11(block + 8, isSigned, texels + 2);
+        }
+    }
+} // namespace
+
+bool KTX::Decoders::GetEtcDecoder(const u32 vkFormat, BlockDecoder& decoder)
+{
+    using enum KtxUtility_VkFormat;
+    const auto set = [&](const u32 blockSize, const KtxUtility_VkFormat decodedFormat, const u32 variant,
+                         void (*decode)(const BlockDecoder&, const u8*, u8*))
+    {
+        const bool isWide =
+                decodedFormat == VK_FORMAT_R16G16B16A16_UNORM || decodedFormat == VK_FORMAT_R16G16B16A16_SNORM;
+        decoder = {.blockWidth = 4,
+                   .blockHeight = 4,
+                   .blockSize = blockSize,
+                   .texelSize = isWide ? 8u : 4u,
+                   .decodedVkFormat = static_cast<u32>(decodedFormat),
+                   .variant = variant,
+                   .decode = decode};
+        return true;
+    };
+    switch (static_cast<KtxUtility_VkFormat>(vkFormat))
+    {
+        case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+            return set(8, VK_FORMAT_R8G8B8A8_UNORM, etcOpaque, DecodeEtc2);
+        case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+            return set(8, VK_FORMAT_R8G8B8A8_SRGB, etcOpaque, DecodeEtc2);
+        case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+            return set(8, VK_FORMAT_R8G8B8A8_UNORM, etcPunchThrough, DecodeEtc2);
+        case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+            return set(8, VK_FORMAT_R8G8B8A8_SRGB, etcPunchThrough, DecodeEtc2);
+        case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+            return set(16, VK_FORMAT_R8G8B8A8_UNORM, etcAlpha, DecodeEtc2);
+        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+            return set(16, VK_FORMAT_R8G8B8A8_SRGB, etcAlpha, DecodeEtc2);
+        case VK_FORMAT_EAC_R11_UNORM_BLOCK:
+            return set(8, VK_FORMAT_R16G16B16A16_UNORM, eacUnsigned, DecodeEac);
+        case VK_FORMAT_EAC_R11_SNORM_BLOCK:
+            return set(8, VK_FORMAT_R16G16B16A16_SNORM, eacSigned, DecodeEac);
+        case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
+            return set(16, VK_FORMAT_R16G16B16A16_UNORM, eacUnsigned, DecodeEac);
+        case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
+            return set(16, VK_FORMAT_R16G16B16A16_SNORM, eacSigned, DecodeEac);
+        default:
+            return false;
+    }
+}
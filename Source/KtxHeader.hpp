@@ -0,0 +1,42 @@
+#pragma once
+#include <array>
+
+#include "KtxUtility.hpp"
+
+// On-disk layout of the ktx2 header, read by the loaders and written by KtxWriter
+
+namespace KTX::Detail
+{
+    constexpr std::array<u8, 12> ktx2Identifier{0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    constexpr u32 ktx2HeaderSize = 80;
+
+    struct Ktx2IndexEntry32
+    {
+        u32 byteOffset;
+        u32 byteLength;
+    };
+
+    struct Ktx2IndexEntry64
+    {
+        u64 byteOffset;
+        u64 byteLength;
+    };
+
+    struct Ktx2Header
+    {
+        std::array<u8, 12> identifier;
+        u32 vkFormat;
+        u32 typeSize;
+        u32 pixelWidth;
+        u32 pixelHeight;
+        u32 pixelDepth;
+        u32 layerCount;
+        u32 faceCount;
+        u32 levelCount;
+        u32 superCompressionScheme;
+        Ktx2IndexEntry32 dataFormatDescriptor;
+        Ktx2IndexEntry32 keyValueData;
+        Ktx2IndexEntry64 superCompressionGlobalData;
+    };
+    static_assert(sizeof(Ktx2Header) == ktx2HeaderSize);
+} // namespace KTX::Detail
@@ -0,0 +1,363 @@
+#include "KtxIo.hpp"
+
+#if !defined(_WIN32)
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <sched.h>
+#include <unistd.h>
+
+#if defined(KTX_WITH_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+KTX::Io::Backend::Backend(const u32 slotCount, const u32 slotSize) :
+    slotCount(slotCount), slotSize(slotSize),
+    staging(std::make_unique_for_overwrite<u8[]>(static_cast<size_t>(slotCount) * slotSize))
+{
+}
+
+namespace
+{
+    using namespace KTX;
+
+    u8* GetDestination(const Io::Backend& backend, const Io::ReadRequest& request)
+    {
+        return request.destination != nullptr ? request.destination
+                                              : backend.GetStagingSlot(request.stagingSlot).data();
+    }
+
+    class PreadBackend final : public Io::Backend
+    {
+    public:
+        PreadBackend(const u32 slotCount, const u32 slotSize) : Backend(slotCount, slotSize) {}
+
+        void Read(const std::span<Io::ReadRequest> requests) override
+        {
+            for (auto& request : requests)
+            {
+                u8* destination = GetDestination(*this, request);
+                u64 done = 0;
+                request.result = 0;
+                while (done < request.length)
+                {
+                    const auto bytesRead = pread(request.file, destination + done, request.length - done,
+                                                 static_cast<off_t>(request.offset + done));
+                    if (bytesRead < 0)
+                    {
+                        if (errno == EINTR)
+                        {
+                            continue;
+                        }
+                        request.result = -errno;
+                        break;
+                    }
+                    if (bytesRead == 0)
+                    {
+                        break;
+                    }
+                    done += bytesRead;
+                }
+                if (request.result == 0)
+                {
+                    request.result = static_cast<i64>(done);
+                }
+            }
+        }
+    };
+
+#if defined(KTX_WITH_IO_URING)
+    // Talks to the kernel ABI directly so the only requirement is a kernel with io_uring, no liburing
+    class IoUringBackend final : public Io::Backend
+    {
+    public:
+        static std::unique_ptr<IoUringBackend> Create(const u32 slotCount, const u32 slotSize)
+        {
+            auto backend = std::unique_ptr<IoUringBackend>(new IoUringBackend(slotCount, slotSize));
+            return backend->Setup() ? std::move(backend) : nullptr;
+        }
+
+        ~IoUringBackend() override
+        {
+            if (sqes != nullptr)
+            {
+                munmap(sqes, sqesSize);
+            }
+            if (cqRing != nullptr && cqRing != sqRing)
+            {
+                munmap(cqRing, cqRingSize);
+            }
+            if (sqRing != nullptr)
+            {
+                munmap(sqRing, sqRingSize);
+            }
+            if (ring >= 0)
+            {
+                close(ring);
+            }
+        }
+
+        [[nodiscard]] bool IsIoUring() const override { return true; }
+
+        void Read(const std::span<Io::ReadRequest> requests) override
+        {
+            if (broken)
+            {
+                fallback.Read(requests);
+                return;
+            }
+
+            std::vector<u64> done(requests.size(), 0);
+            std::vector<bool> finished(requests.size(), false);
+            std::vector<u32> pending(requests.size());
+            for (u32 i = 0; i < requests.size(); ++i)
+            {
+                requests[i].result = 0;
+                pending[i] = static_cast<u32>(requests.size()) - 1 - i;
+            }
+
+            size_t completed = 0;
+            u32 inFlight = 0;
+            while (completed < requests.size())
+            {
+                u32 tail = *sqTail;
+                const u32 head = std::atomic_ref(*sqHead).load(std::memory_order_acquire);
+                while (!pending.empty() && inFlight < cqEntries && tail - head < sqEntries)
+                {
+                    const u32 index = pending.back();
+                    pending.pop_back();
+                    auto& request = requests[index];
+
+                    const u32 slot = tail & sqMask;
+                    auto& sqe = sqes[slot];
+                    std::memset(&sqe, 0, sizeof(sqe));
+                    if (request.destination == nullptr && buffersRegistered)
+                    {
+                        sqe.opcode = IORING_OP_READ_FIXED;
+                        sqe.buf_index = static_cast<u16>(request.stagingSlot);
+                    } else
+                    {
+                        sqe.opcode = IORING_OP_READ;
+                    }
+                    sqe.fd = request.file;
+                    sqe.off = request.offset + done[index];
+                    sqe.addr = reinterpret_cast<u64>(GetDestination(*this, request) + done[index]);
+                    sqe.len = static_cast<u32>(std::min<u64>(request.length - done[index], 1u << 30));
+                    sqe.user_data = index;
+                    sqArray[slot] = slot;
+                    ++tail;
+                    ++inFlight;
+                }
+                std::atomic_ref(*sqTail).store(tail, std::memory_order_release);
+
+                const u32 toSubmit = tail - std::atomic_ref(*sqHead).load(std::memory_order_acquire);
+                if (syscall(__NR_io_uring_enter, ring, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                    errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                {
+                    // The ring is unusable, finish what is left with pread and stay on pread from now on. Reads the
+                    // kernel already took still write into the destinations, so they have to finish first.
+                    broken = true;
+                    const u32 headAfter = std::atomic_ref(*sqHead).load(std::memory_order_acquire);
+                    std::atomic_ref(*sqTail).store(headAfter, std::memory_order_release);
+                    Drain(inFlight - (tail - headAfter));
+                    for (u32 i = 0; i < requests.size(); ++i)
+                    {
+                        if (finished[i])
+                        {
+                            continue;
+                        }
+                        Io::ReadRequest rest{
+                                .file = requests[i].file,
+                                .offset = requests[i].offset + done[i],
+                                .length = requests[i].length - done[i],
+                                .destination = GetDestination(*this, requests[i]) + done[i],
+                                .stagingSlot = 0,
+                                .result = 0,
+                        };
+                        fallback.Read({&rest, 1});
+                        requests[i].result = rest.result < 0 ? rest.result : static_cast<i64>(done[i]) + rest.result;
+                    }
+                    return;
+                }
+
+                u32 cqHeadValue = *cqHead;
+                const u32 cqTailValue = std::atomic_ref(*cqTail).load(std::memory_order_acquire);
+                for (; cqHeadValue != cqTailValue; ++cqHeadValue)
+                {
+                    const auto& cqe = cqes[cqHeadValue & cqMask];
+                    const auto index = static_cast<u32>(cqe.user_data);
+                    auto& request = requests[index];
+                    --inFlight;
+
+                    if (cqe.res == -EAGAIN || cqe.res == -EINTR)
+                    {
+                        pending.push_back(index);
+                    } else if (cqe.res < 0)
+                    {
+                        request.result = cqe.res;
+                        finished[index] = true;
+                        ++completed;
+                    } else
+                    {
+                        done[index] += static_cast<u64>(cqe.res);
+                        if (cqe.res == 0 || done[index] == request.length)
+                        {
+                            request.result = static_cast<i64>(done[index]);
+                            finished[index] = true;
+                            ++completed;
+                        } else
+                        {
+                            // Short read, queue the rest
+                            pending.push_back(index);
+                        }
+                    }
+                }
+                std::atomic_ref(*cqHead).store(cqHeadValue, std::memory_order_release);
+            }
+        }
+
+    private:
+        // Waits for the given number of submitted reads and drops their completions, the caller redoes whatever they
+        // did not report yet
+        void Drain(u32 inFlight)
+        {
+            while (inFlight > 0)
+            {
+                const u32 cqHeadValue = *cqHead;
+                const u32 cqTailValue = std::atomic_ref(*cqTail).load(std::memory_order_acquire);
+                inFlight -= std::min(cqTailValue - cqHeadValue, inFlight);
+                std::atomic_ref(*cqHead).store(cqTailValue, std::memory_order_release);
+                if (inFlight > 0 && syscall(__NR_io_uring_enter, ring, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                    errno != EINTR)
+                {
+                    // Completions are still posted from task work, which runs on the way back from any syscall
+                    sched_yield();
+                }
+            }
+        }
+
+        IoUringBackend(const u32 slotCount, const u32 slotSize) :
+            Backend(slotCount, slotSize), fallback(0, 0)
+        {
+        }
+
+        bool Setup()
+        {
+            io_uring_params params{};
+            ring = static_cast<int>(syscall(__NR_io_uring_setup, std::max(slotCount, 1u), &params));
+            if (ring < 0 || !SupportsReads())
+            {
+                return false;
+            }
+
+            sqRingSize = params.sq_off.array + params.sq_entries * sizeof(u32);
+            cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (singleMap)
+            {
+                sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+            }
+
+            sqRing = Map(sqRingSize, IORING_OFF_SQ_RING);
+            cqRing = singleMap ? sqRing : Map(cqRingSize, IORING_OFF_CQ_RING);
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe*>(Map(sqesSize, IORING_OFF_SQES));
+            if (sqRing == nullptr || cqRing == nullptr || sqes == nullptr)
+            {
+                return false;
+            }
+
+            auto* sq = static_cast<u8*>(sqRing);
+            sqHead = reinterpret_cast<u32*>(sq + params.sq_off.head);
+            sqTail = reinterpret_cast<u32*>(sq + params.sq_off.tail);
+            sqMask = *reinterpret_cast<u32*>(sq + params.sq_off.ring_mask);
+            sqArray = reinterpret_cast<u32*>(sq + params.sq_off.array);
+            sqEntries = params.sq_entries;
+
+            auto* cq = static_cast<u8*>(cqRing);
+            cqHead = reinterpret_cast<u32*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<u32*>(cq + params.cq_off.tail);
+            cqMask = *reinterpret_cast<u32*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            cqEntries = params.cq_entries;
+
+            // Registering pins the staging slots so metadata reads skip the per-request page lookups. It can fail
+            // under a tight RLIMIT_MEMLOCK, in which case the slots are read with plain IORING_OP_READ.
+            std::vector<iovec> buffers(slotCount);
+            for (u32 slot = 0; slot < slotCount; ++slot)
+            {
+                const auto slotData = GetStagingSlot(slot);
+                buffers[slot] = {slotData.data(), slotData.size()};
+            }
+            buffersRegistered = slotCount > 0 && syscall(__NR_io_uring_register, ring, IORING_REGISTER_BUFFERS,
+                                                         buffers.data(), slotCount) == 0;
+            return true;
+        }
+
+        // IORING_OP_READ came with 5.6, older kernels set the ring up fine and then fail every read with EINVAL.
+        // The probe came with 5.6 as well, so a kernel that can't answer it can't read either.
+        [[nodiscard]] bool SupportsReads() const
+        {
+            constexpr u32 probeOpCount = 256;
+            std::vector<u8> buffer(sizeof(io_uring_probe) + probeOpCount * sizeof(io_uring_probe_op));
+            auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+            if (syscall(__NR_io_uring_register, ring, IORING_REGISTER_PROBE, probe, probeOpCount) < 0)
+            {
+                return false;
+            }
+            const auto isSupported = [&](const u32 opcode)
+            { return opcode < probe->ops_len && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0; };
+            return isSupported(IORING_OP_READ) && isSupported(IORING_OP_READ_FIXED);
+        }
+
+        void* Map(const size_t length, const off_t offset) const
+        {
+            void* mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, offset);
+            return mapping == MAP_FAILED ? nullptr : mapping;
+        }
+
+        int ring = -1;
+        bool buffersRegistered = false;
+        bool broken = false;
+        PreadBackend fallback;
+
+        void* sqRing = nullptr;
+        size_t sqRingSize = 0;
+        void* cqRing = nullptr;
+        size_t cqRingSize = 0;
+        io_uring_sqe* sqes = nullptr;
+        size_t sqesSize = 0;
+
+        u32* sqHead = nullptr;
+        u32* sqTail = nullptr;
+        u32 sqMask = 0;
+        u32* sqArray = nullptr;
+        u32 sqEntries = 0;
+        u32* cqHead = nullptr;
+        u32* cqTail = nullptr;
+        u32 cqMask = 0;
+        io_uring_cqe* cqes = nullptr;
+        u32 cqEntries = 0;
+    };
+#endif
+} // namespace
+
+std::unique_ptr<KTX::Io::Backend> KTX::Io::CreateBackend(const u32 slotCount, const u32 slotSize)
+{
+#if defined(KTX_WITH_IO_URING)
+    if (auto backend = IoUringBackend::Create(slotCount, slotSize))
+    {
+        return backend;
+    }
+#endif
+    return std::make_unique<PreadBackend>(slotCount, slotSize);
+}
+
+#endif
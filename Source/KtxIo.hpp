@@ -0,0 +1,50 @@
+#pragma once
+#include <memory>
+#include <span>
+
+#include "KtxUtility.hpp"
+
+// Batched positional reads for the bulk loader. On Linux builds with KtxWithIoUring every batch goes through a single
+// io_uring, everywhere else (or when the kernel refuses to set up a ring) each request is a plain pread.
+
+namespace KTX::Io
+{
+    struct ReadRequest
+    {
+        int file;
+        u64 offset;
+        u64 length;
+        // Either a caller owned destination, or nullptr to read into the staging slot with the same index
+        u8* destination;
+        u32 stagingSlot;
+        // Bytes read, less than length only if the file ended early, or a negative errno
+        i64 result;
+    };
+
+    class Backend
+    {
+    public:
+        virtual ~Backend() = default;
+
+        // Issues every read and blocks until all of them completed, short reads are retried internally
+        virtual void Read(std::span<ReadRequest> requests) = 0;
+
+        [[nodiscard]] std::span<u8> GetStagingSlot(const u32 slot) const
+        {
+            return {staging.get() + static_cast<size_t>(slot) * slotSize, slotSize};
+        }
+        [[nodiscard]] u32 GetSlotCount() const { return slotCount; }
+        [[nodiscard]] virtual bool IsIoUring() const { return false; }
+
+    protected:
+        Backend(u32 slotCount, u32 slotSize);
+
+        u32 slotCount;
+        u32 slotSize;
+        std::unique_ptr<u8[]> staging;
+    };
+
+    // Staging slots are small fixed buffers that the io_uring backend registers with the kernel, they are meant for
+    // the header and metadata reads issued once per file
+    std::unique_ptr<Backend> CreateBackend(u32 slotCount, u32 slotSize);
+} // namespace KTX::Io
@@ -0,0 +1,750 @@
+#include "KtxMipmap.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <vector>
+
+#include "VK_Format.hpp"
+
+#if defined(__AVX__) || defined(__F16C__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    using namespace KTX;
+    using enum KtxUtility_VkFormat;
+
+    // Output texels per pool task, bands never get shorter than minBandRows so the rows a band filters on top of its
+    // own stay a small share of its work
+    constexpr u32 bandTexels = 1u << 18;
+    constexpr u32 minBandRows = 16;
+
+    enum class SampleType
+    {
+        eUnorm8,
+        eSnorm8,
+        eSrgb8,
+        eUnorm16,
+        eSnorm16,
+        eFloat16,
+        eFloat32,
+    };
+
+    struct MipFormat
+    {
+        KtxUtility_VkFormat vkFormat;
+        SampleType type;
+        u32 channels;
+    };
+
+    using enum SampleType;
+    constexpr std::array mipFormats{
+            MipFormat{VK_FORMAT_R8_UNORM, eUnorm8, 1},
+            MipFormat{VK_FORMAT_R8_SNORM, eSnorm8, 1},
+            MipFormat{VK_FORMAT_R8_SRGB, eSrgb8, 1},
+            MipFormat{VK_FORMAT_R8G8_UNORM, eUnorm8, 2},
+            MipFormat{VK_FORMAT_R8G8_SNORM, eSnorm8, 2},
+            MipFormat{VK_FORMAT_R8G8_SRGB, eSrgb8, 2},
+            MipFormat{VK_FORMAT_R8G8B8_UNORM, eUnorm8, 3},
+            MipFormat{VK_FORMAT_R8G8B8_SNORM, eSnorm8, 3},
+            MipFormat{VK_FORMAT_R8G8B8_SRGB, eSrgb8, 3},
+            MipFormat{VK_FORMAT_B8G8R8_UNORM, eUnorm8, 3},
+            MipFormat{VK_FORMAT_B8G8R8_SNORM, eSnorm8, 3},
+            MipFormat{VK_FORMAT_B8G8R8_SRGB, eSrgb8, 3},
+            MipFormat{VK_FORMAT_R8G8B8A8_UNORM, eUnorm8, 4},
+            MipFormat{VK_FORMAT_R8G8B8A8_SNORM, eSnorm8, 4},
+            MipFormat{VK_FORMAT_R8G8B8A8_SRGB, eSrgb8, 4},
+            MipFormat{VK_FORMAT_B8G8R8A8_UNORM, eUnorm8, 4},
+            MipFormat{VK_FORMAT_B8G8R8A8_SNORM, eSnorm8, 4},
+            MipFormat{VK_FORMAT_B8G8R8A8_SRGB, eSrgb8, 4},
+            MipFormat{VK_FORMAT_R16_UNORM, eUnorm16, 1},
+            MipFormat{VK_FORMAT_R16_SNORM, eSnorm16, 1},
+            MipFormat{VK_FORMAT_R16_SFLOAT, eFloat16, 1},
+            MipFormat{VK_FORMAT_R16G16_UNORM, eUnorm16, 2},
+            MipFormat{VK_FORMAT_R16G16_SNORM, eSnorm16, 2},
+            MipFormat{VK_FORMAT_R16G16_SFLOAT, eFloat16, 2},
+            MipFormat{VK_FORMAT_R16G16B16_UNORM, eUnorm16, 3},
+            MipFormat{VK_FORMAT_R16G16B16_SNORM, eSnorm16, 3},
+            MipFormat{VK_FORMAT_R16G16B16_SFLOAT, eFloat16, 3},
+            MipFormat{VK_FORMAT_R16G16B16A16_UNORM, eUnorm16, 4},
+            MipFormat{VK_FORMAT_R16G16B16A16_SNORM, eSnorm16, 4},
+            MipFormat{VK_FORMAT_R16G16B16A16_SFLOAT, eFloat16, 4},
+            MipFormat{VK_FORMAT_R32_SFLOAT, eFloat32, 1},
+            MipFormat{VK_FORMAT_R32G32_SFLOAT, eFloat32, 2},
+            MipFormat{VK_FORMAT_R32G32B32_SFLOAT, eFloat32, 3},
+            MipFormat{VK_FORMAT_R32G32B32A32_SFLOAT, eFloat32, 4},
+    };
+
+    const MipFormat* FindMipFormat(const u32 vkFormat)
+    {
+        const auto it = std::ranges::find(mipFormats, static_cast<KtxUtility_VkFormat>(vkFormat), &MipFormat::vkFormat);
+        return it == mipFormats.end() ? nullptr : &*it;
+    }
+
+    u32 GetSampleSize(const SampleType type)
+    {
+        switch (type)
+        {
+            case eUnorm8:
+            case eSnorm8:
+            case eSrgb8:
+                return 1;
+            case eUnorm16:
+            case eSnorm16:
+            case eFloat16:
+                return 2;
+            case eFloat32:
+                return 4;
+        }
+        return 0;
+    }
+
+    // Floats from 2^-13 up to 1 encode through a table indexed by their top 11 mantissa bits, which gives the value at
+    // the bottom of the range of floats sharing the entry. A range never spans more than one rounding threshold, so a
+    // single compare against the threshold above makes the result exact. Anything below 2^-13 encodes to 0.
+    constexpr u32 srgbEncodeMinBits = (127 - 13) << 23;
+    constexpr u32 srgbEncodeShift = 12;
+
+    struct SrgbTables
+    {
+        std::array<float, 256> toLinear;
+        std::vector<u8> fromLinear;
+        // Smallest linear value that encodes to index + 1
+        std::array<float, 255> thresholds;
+    };
+
+    const SrgbTables& GetSrgbTables()
+    {
+        static const SrgbTables tables = []
+        {
+            const auto toLinear = [](const double srgb)
+            { return srgb <= 0.04045 ? srgb / 12.92 : std::pow((srgb + 0.055) / 1.055, 2.4); };
+            SrgbTables built{};
+            for (u32 value = 0; value < built.toLinear.size(); ++value)
+            {
+                built.toLinear[value] = static_cast<float>(toLinear(value / 255.0));
+            }
+            for (u32 value = 0; value < built.thresholds.size(); ++value)
+            {
+                // Rounded up so every float at or above the threshold really does encode to value + 1
+                const auto threshold = static_cast<float>(toLinear((value + 0.5) / 255));
+                built.thresholds[value] = toLinear((value + 0.5) / 255) > threshold
+                                                  ? std::nextafter(threshold, 1.0f)
+                                                  : threshold;
+            }
+            constexpr u32 oneBits = 127 << 23;
+            built.fromLinear.resize((oneBits - srgbEncodeMinBits) >> srgbEncodeShift);
+            u8 encoded = 0;
+            for (u32 index = 0; index < built.fromLinear.size(); ++index)
+            {
+                const float linear = std::bit_cast<float>(srgbEncodeMinBits + (index << srgbEncodeShift));
+                while (encoded < built.thresholds.size() && linear >= built.thresholds[encoded])
+                {
+                    ++encoded;
+                }
+                built.fromLinear[index] = encoded;
+            }
+            return built;
+        }();
+        return tables;
+    }
+
+    u8 LinearToSrgb8(const SrgbTables& tables, const float value)
+    {
+        // Also catches NaN
+        if (!(value > std::bit_cast<float>(srgbEncodeMinBits)))
+        {
+            return 0;
+        }
+        if (value >= 1.0f)
+        {
+            return 255;
+        }
+        const u8 encoded = tables.fromLinear[(std::bit_cast<u32>(value) - srgbEncodeMinBits) >> srgbEncodeShift];
+        return encoded + (encoded < tables.thresholds.size() && value >= tables.thresholds[encoded]);
+    }
+
+    float HalfToFloat(const u16 half)
+    {
+        const u32 sign = static_cast<u32>(half & 0x8000) << 16;
+        const u32 exponent = (half >> 10) & 0x1F;
+        const u32 mantissa = half & 0x3FF;
+        if (exponent == 0)
+        {
+            const float value = std::ldexp(static_cast<float>(mantissa), -24);
+            return sign != 0 ? -value : value;
+        }
+        if (exponent == 0x1F)
+        {
+            return std::bit_cast<float>(sign | 0x7F800000 | mantissa << 13);
+        }
+        return std::bit_cast<float>(sign | (exponent + 112) << 23 | mantissa << 13);
+    }
+
+    // Rounds to nearest even, values past the half range become infinity
+    u16 FloatToHalf(const float value)
+    {
+        const u32 bits = std::bit_cast<u32>(value);
+        const u32 sign = (bits >> 16) & 0x8000;
+        const u32 magnitude = bits & 0x7FFFFFFF;
+        if (magnitude > 0x7F800000)
+        {
+            return static_cast<u16>(sign | 0x7E00);
+        }
+        if (magnitude >= 0x477FF000)
+        {
+            return static_cast<u16>(sign | 0x7C00);
+        }
+        if (magnitude < 0x38800000)
+        {
+            // Subnormal half, anything up to 2^-25 rounds to zero
+            if (magnitude <= 0x33000000)
+            {
+                return static_cast<u16>(sign);
+            }
+            const u32 shift = 126 - (magnitude >> 23);
+            const u32 mantissa = (magnitude & 0x7FFFFF) | 0x800000;
+            const u32 result = mantissa >> shift;
+            const u32 remainder = mantissa & ((1u << shift) - 1);
+            const u32 halfway = 1u << (shift - 1);
+            return static_cast<u16>(sign | (result + (remainder > halfway || (remainder == halfway && (result & 1)))));
+        }
+        const u32 result = (magnitude - 0x38000000) >> 13;
+        const u32 remainder = magnitude & 0x1FFF;
+        return static_cast<u16>(sign | (result + (remainder > 0x1000 || (remainder == 0x1000 && (result & 1)))));
+    }
+
+    template<typename T>
+    T LoadSample(const u8* source, const u32 index)
+    {
+        T value;
+        std::memcpy(&value, source + index * sizeof(T), sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    void StoreSample(u8* destination, const u32 index, const T value)
+    {
+        std::memcpy(destination + index * sizeof(T), &value, sizeof(T));
+    }
+
+    // Only the fourth channel of an sRGB format is alpha, one and two channel sRGB formats encode every channel
+    u32 GetSrgbChannels(const MipFormat& format)
+    {
+        return format.channels == 4 ? 3 : format.channels;
+    }
+
+    void DecodeRow(const MipFormat& format, const u8* source, const u32 width, float* destination)
+    {
+        const u32 count = width * format.channels;
+        switch (format.type)
+        {
+            case eUnorm8:
+                for (u32 i = 0; i < count; ++i)
+                {
+                    destination[i] = source[i] * (1.0f / 255);
+                }
+                break;
+            case eSnorm8:
+                for (u32 i = 0; i < count; ++i)
+                {
+                    destination[i] = std::max(static_cast<i8>(source[i]) * (1.0f / 127), -1.0f);
+                }
+                break;
+            case eSrgb8:
+            {
+                const auto& toLinear = GetSrgbTables().toLinear;
+                const u32 srgbChannels = GetSrgbChannels(format);
+                for (u32 i = 0; i < count; i += format.channels)
+                {
+                    for (u32 channel = 0; channel < srgbChannels; ++channel)
+                    {
+                        destination[i + channel] = toLinear[source[i + channel]];
+                    }
+                    if (srgbChannels != format.channels)
+                    {
+                        destination[i + 3] = source[i + 3] * (1.0f / 255);
+                    }
+                }
+                break;
+            }
+            case eUnorm16:
+                for (u32 i = 0; i < count; ++i)
+                {
+                    destination[i] = LoadSample<u16>(source, i) * (1.0f / 65535);
+                }
+                break;
+            case eSnorm16:
+                for (u32 i = 0; i < count; ++i)
+                {
+                    destination[i] = std::max(LoadSample<i16>(source, i) * (1.0f / 32767), -1.0f);
+                }
+                break;
+            case eFloat16:
+            {
+                u32 i = 0;
+#if defined(__F16C__)
+                for (; i + 8 <= count; i += 8)
+                {
+                    const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 2));
+                    _mm256_storeu_ps(destination + i, _mm256_cvtph_ps(halves));
+                }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+                for (; i + 4 <= count; i += 4)
+                {
+                    vst1q_f32(destination + i, vcvt_f32_f16(vreinterpret_f16_u8(vld1_u8(source + i * 2))));
+                }
+#endif
+                for (; i < count; ++i)
+                {
+                    destination[i] = HalfToFloat(LoadSample<u16>(source, i));
+                }
+                break;
+            }
+            case eFloat32:
+                std::memcpy(destination, source, count * sizeof(float));
+                break;
+        }
+    }
+
+    void EncodeRow(const MipFormat& format, const float* source, const u32 width, u8* destination)
+    {
+        const u32 count = width * format.channels;
+        // Both round half away from zero like lround, without the library call
+        const auto quantizeUnorm = [](const float value, const float scale)
+        { return static_cast<i32>(std::clamp(value, 0.0f, 1.0f) * scale + 0.5f); };
+        const auto quantizeSnorm = [](const float value, const float scale)
+        {
+            const float scaled = std::clamp(value, -1.0f, 1.0f) * scale;
+            return static_cast<i32>(scaled + (scaled < 0.0f ? -0.5f : 0.5f));
+        };
+        switch (format.type)
+        {
+            case eUnorm8:
+                for (u32 i = 0; i < count; ++i)
+                {
+                    destination[i] = static_cast<u8>(quantizeUnorm(source[i], 255));
+                }
+                break;
+            case eSnorm8:
+                for (u32 i = 0; i < count; ++i)
+                {
+                    destination[i] = static_cast<u8>(static_cast<i8>(quantizeSnorm(source[i], 127)));
+                }
+                break;
+            case eSrgb8:
+            {
+                const auto& tables = GetSrgbTables();
+                const u32 srgbChannels = GetSrgbChannels(format);
+                for (u32 i = 0; i < count; i += format.channels)
+                {
+                    for (u32 channel = 0; channel < srgbChannels; ++channel)
+                    {
+                        destination[i + channel] = LinearToSrgb8(tables, source[i + channel]);
+                    }
+                    if (srgbChannels != format.channels)
+                    {
+                        destination[i + 3] = static_cast<u8>(quantizeUnorm(source[i + 3], 255));
+                    }
+                }
+                break;
+            }
+            case eUnorm16:
+                for (u32 i = 0; i < count; ++i)
+                {
+                    StoreSample(destination, i, static_cast<u16>(quantizeUnorm(source[i], 65535)));
+                }
+                break;
+            case eSnorm16:
+                for (u32 i = 0; i < count; ++i)
+                {
+                    StoreSample(destination, i, static_cast<i16>(quantizeSnorm(source[i], 32767)));
+                }
+                break;
+            case eFloat16:
+            {
+                u32 i = 0;
+#if defined(__F16C__)
+                for (; i + 8 <= count; i += 8)
+                {
+                    const __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 2), halves);
+                }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+                for (; i + 4 <= count; i += 4)
+                {
+                    vst1_u8(destination + i * 2, vreinterpret_u8_f16(vcvt_f16_f32(vld1q_f32(source + i))));
+                }
+#endif
+                for (; i < count; ++i)
+                {
+                    StoreSample(destination, i, FloatToHalf(source[i]));
+                }
+                break;
+            }
+            case eFloat32:
+                std::memcpy(destination, source, count * sizeof(float));
+                break;
+        }
+    }
+
+    // Taps of one output texel along one axis, texels [first, first + count) with weights summing to 1
+    struct Taps
+    {
+        u32 first;
+        u32 count;
+        u32 weightOffset;
+    };
+
+    struct AxisFilter
+    {
+        std::vector<Taps> taps;
+        std::vector<float> weights;
+        u32 maxTaps = 0;
+    };
+
+    double Sinc(const double x)
+    {
+        if (std::abs(x) < 1e-9)
+        {
+            return 1.0;
+        }
+        return std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+    }
+
+    // Zeroth order modified Bessel function of the first kind, by its power series
+    double BesselI0(const double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (u32 k = 1; term > sum * 1e-12; ++k)
+        {
+            term *= (x / (2 * k)) * (x / (2 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // Half width in source texels at a scale of 1
+    double GetFilterRadius(const KtxMipFilter filter)
+    {
+        return filter == KtxMipFilter::eBox ? 0.5 : 3.0;
+    }
+
+    double EvaluateFilter(const KtxMipFilter filter, const double x)
+    {
+        constexpr double radius = 3.0;
+        constexpr double kaiserAlpha = 4.0;
+        if (std::abs(x) >= radius)
+        {
+            return 0.0;
+        }
+        if (filter == KtxMipFilter::eKaiser)
+        {
+            const double t = x / radius;
+            return Sinc(x) * BesselI0(kaiserAlpha * std::sqrt(1 - t * t)) / BesselI0(kaiserAlpha);
+        }
+        return Sinc(x) * Sinc(x / radius);
+    }
+
+    AxisFilter BuildAxisFilter(const KtxMipFilter filter, const u32 sourceSize, const u32 destinationSize)
+    {
+        AxisFilter axis;
+        axis.taps.resize(destinationSize);
+        const double scale = static_cast<double>(sourceSize) / destinationSize;
+        const double radius = GetFilterRadius(filter) * scale;
+        std::vector<double> weights;
+        for (u32 texel = 0; texel < destinationSize; ++texel)
+        {
+            const double center = (texel + 0.5) * scale;
+            const auto low = static_cast<i64>(std::floor(center - radius));
+            const auto high = static_cast<i64>(std::ceil(center + radius));
+            // Taps past an edge land on the edge texel
+            const i64 first = std::max<i64>(low, 0);
+            const i64 last = std::min<i64>(high, sourceSize - 1);
+            weights.assign(last - first + 1, 0.0);
+            double sum = 0.0;
+            for (i64 source = low; source <= high; ++source)
+            {
+                double weight;
+                if (filter == KtxMipFilter::eBox)
+                {
+                    weight = std::max(std::min<double>(source + 1, center + radius) -
+                                              std::max<double>(source, center - radius),
+                                      0.0);
+                }
+                else
+                {
+                    weight = EvaluateFilter(filter, (source + 0.5 - center) / scale);
+                }
+                weights[std::clamp(source, first, last) - first] += weight;
+                sum += weight;
+            }
+
+            // Zero weights at the ends, such as sinc zeros at whole texels, would only cost time
+            u32 begin = 0;
+            u32 end = static_cast<u32>(weights.size());
+            while (end - begin > 1 && std::abs(weights[begin]) < 1e-7 * sum)
+            {
+                ++begin;
+            }
+            while (end - begin > 1 && std::abs(weights[end - 1]) < 1e-7 * sum)
+            {
+                --end;
+            }
+            axis.taps[texel] = {.first = static_cast<u32>(first) + begin,
+                                .count = end - begin,
+                                .weightOffset = static_cast<u32>(axis.weights.size())};
+            for (u32 i = begin; i < end; ++i)
+            {
+                axis.weights.push_back(static_cast<float>(weights[i] / sum));
+            }
+            axis.maxTaps = std::max(axis.maxTaps, end - begin);
+        }
+        return axis;
+    }
+
+    // destination[i] += source[i] * weight
+    void AccumulateRow(float* destination, const float* source, const float weight, const size_t count)
+    {
+        size_t i = 0;
+#if defined(__AVX__)
+        const __m256 weights = _mm256_set1_ps(weight);
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 product = _mm256_mul_ps(_mm256_loadu_ps(source + i), weights);
+            _mm256_storeu_ps(destination + i, _mm256_add_ps(_mm256_loadu_ps(destination + i), product));
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        const __m128 weights = _mm_set1_ps(weight);
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 product = _mm_mul_ps(_mm_loadu_ps(source + i), weights);
+            _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), product));
+        }
+#elif defined(__ARM_NEON)
+        for (; i + 4 <= count; i += 4)
+        {
+            vst1q_f32(destination + i, vmlaq_n_f32(vld1q_f32(destination + i), vld1q_f32(source + i), weight));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            destination[i] += source[i] * weight;
+        }
+    }
+
+    void FilterRowHorizontal(const float* source, const u32 channels, const AxisFilter& axis, float* destination)
+    {
+        const u32 width = static_cast<u32>(axis.taps.size());
+        if (channels == 4)
+        {
+            // One texel per vector
+            for (u32 x = 0; x < width; ++x)
+            {
+                const auto& taps = axis.taps[x];
+                const float* weights = axis.weights.data() + taps.weightOffset;
+                const float* texels = source + taps.first * 4;
+#if defined(__SSE2__) || defined(_M_X64)
+                __m128 sum = _mm_setzero_ps();
+                for (u32 tap = 0; tap < taps.count; ++tap)
+                {
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(texels + tap * 4), _mm_set1_ps(weights[tap])));
+                }
+                _mm_storeu_ps(destination + x * 4, sum);
+#elif defined(__ARM_NEON)
+                float32x4_t sum = vdupq_n_f32(0.0f);
+                for (u32 tap = 0; tap < taps.count; ++tap)
+                {
+                    sum = vmlaq_n_f32(sum, vld1q_f32(texels + tap * 4), weights[tap]);
+                }
+                vst1q_f32(destination + x * 4, sum);
+#else
+                float sum[4] = {};
+                for (u32 tap = 0; tap < taps.count; ++tap)
+                {
+                    for (u32 channel = 0; channel < 4; ++channel)
+                    {
+                        sum[channel] += texels[tap * 4 + channel] * weights[tap];
+                    }
+                }
+                std::memcpy(destination + x * 4, sum, sizeof(sum));
+#endif
+            }
+            return;
+        }
+
+        for (u32 x = 0; x < width; ++x)
+        {
+            const auto& taps = axis.taps[x];
+            const float* weights = axis.weights.data() + taps.weightOffset;
+            const float* texels = source + taps.first * channels;
+            for (u32 channel = 0; channel < channels; ++channel)
+            {
+                float sum = 0.0f;
+                for (u32 tap = 0; tap < taps.count; ++tap)
+                {
+                    sum += texels[tap * channels + channel] * weights[tap];
+                }
+                destination[x * channels + channel] = sum;
+            }
+        }
+    }
+
+    // One image of a level, ktx1 rows are padded to 4 bytes
+    struct ImageView
+    {
+        u8* data;
+        u32 width;
+        u32 height;
+        u64 rowPitch;
+    };
+
+    u64 GetRowPitch(const KtxTextureInfo& info, const MipFormat& format, const u32 width)
+    {
+        const u64 rowSize = static_cast<u64>(width) * format.channels * GetSampleSize(format.type);
+        return info.isKtx2 ? rowSize : (rowSize + 3) & ~u64{3};
+    }
+
+    // Filters the output rows [firstRow, firstRow + rowCount) of destination. Source rows go through the horizontal
+    // filter once each into a ring of float rows just deep enough for the vertical taps, so it stays in cache.
+    void FilterBand(const MipFormat& format, const ImageView& source, const ImageView& destination,
+                    const AxisFilter& horizontal, const AxisFilter& vertical, const u32 firstRow, const u32 rowCount)
+    {
+        thread_local std::vector<float> sourceRow;
+        thread_local std::vector<float> ring;
+        thread_local std::vector<float> destinationRow;
+
+        const u32 channels = format.channels;
+        const u64 rowFloats = static_cast<u64>(destination.width) * channels;
+        const u32 ringRows = vertical.maxTaps;
+        sourceRow.resize(static_cast<u64>(source.width) * channels);
+        ring.resize(rowFloats * ringRows);
+        destinationRow.resize(rowFloats);
+
+        // Taps only ever move down, a row is overwritten once no later output row can need it
+        u32 nextRow = vertical.taps[firstRow].first;
+        for (u32 y = firstRow; y < firstRow + rowCount; ++y)
+        {
+            const auto& taps = vertical.taps[y];
+            for (; nextRow < taps.first + taps.count; ++nextRow)
+            {
+                DecodeRow(format, source.data + nextRow * source.rowPitch, source.width, sourceRow.data());
+                FilterRowHorizontal(sourceRow.data(), channels, horizontal,
+                                    ring.data() + nextRow % ringRows * rowFloats);
+            }
+            const float* weights = vertical.weights.data() + taps.weightOffset;
+            std::ranges::fill(destinationRow, 0.0f);
+            for (u32 tap = 0; tap < taps.count; ++tap)
+            {
+                AccumulateRow(destinationRow.data(), ring.data() + (taps.first + tap) % ringRows * rowFloats,
+                              weights[tap], rowFloats);
+            }
+            EncodeRow(format, destinationRow.data(), destination.width, destination.data + y * destination.rowPitch);
+        }
+    }
+} // namespace
+
+bool KTX::SupportsMipGeneration(const u32 vkFormat)
+{
+    return FindMipFormat(vkFormat) != nullptr;
+}
+
+std::expected<KTX::KtxTexture, KTX::KtxResult> KTX::GenerateMipmaps(KtxThreadPool& pool, KtxTexture& texture,
+                                                                     const KtxMipOptions& options)
+{
+    const auto& info = texture.GetInfo();
+    const MipFormat* format = FindMipFormat(info.vkFormat);
+    if (format == nullptr || info.baseDepth > 1 ||
+        info.superCompressionScheme == static_cast<u32>(KtxSupercompressionScheme::eBasisLZ))
+    {
+        return std::unexpected(KtxResult::eUnsupportedFeature);
+    }
+
+    // Level 0, read up front unless the image data is loaded. Zstd and zlib levels come out of ReadLevel decoded.
+    std::vector<u8> readLevel;
+    std::span<const u8> baseLevel;
+    if (texture.HasImageData())
+    {
+        baseLevel = texture.GetLevel(0);
+    }
+    else
+    {
+        const auto& entry = texture.GetLevelIndex()[0];
+        const bool isDecoded = info.superCompressionScheme == static_cast<u32>(KtxSupercompressionScheme::eZstd) ||
+                               info.superCompressionScheme == static_cast<u32>(KtxSupercompressionScheme::eZlib);
+        readLevel.resize(isDecoded ? entry.uncompressedByteLength : entry.byteLength);
+        if (!texture.ReadLevel(0, readLevel))
+        {
+            return std::unexpected(KtxResult::eFileReadError);
+        }
+        baseLevel = readLevel;
+    }
+
+    const u32 fullLevelCount = std::bit_width(std::max(info.baseWidth, info.baseHeight));
+    const u32 levelCount = options.numLevels == 0 ? fullLevelCount : std::min(options.numLevels, fullLevelCount);
+    const u32 imageCount = info.numLayers * info.numFaces;
+    std::vector<KtxLevelRange> levels;
+    u64 dataSize = 0;
+    for (u32 level = 0; level < levelCount; ++level)
+    {
+        const u64 imageSize = GetRowPitch(info, *format, texture.GetLevelWidth(level)) * texture.GetLevelHeight(level);
+        levels.push_back({.byteOffset = dataSize, .byteLength = imageSize * imageCount});
+        dataSize += levels.back().byteLength;
+    }
+    if (baseLevel.size() < levels[0].byteLength)
+    {
+        return std::unexpected(KtxResult::eFileDataError);
+    }
+
+    auto data = std::make_unique_for_overwrite<u8[]>(dataSize);
+    std::memcpy(data.get(), baseLevel.data(), levels[0].byteLength);
+    const auto getImage = [&](const u32 level, const u32 image)
+    {
+        const u32 width = texture.GetLevelWidth(level);
+        const u32 height = texture.GetLevelHeight(level);
+        const u64 rowPitch = GetRowPitch(info, *format, width);
+        return ImageView{.data = data.get() + levels[level].byteOffset + image * rowPitch * height,
+                         .width = width,
+                         .height = height,
+                         .rowPitch = rowPitch};
+    };
+
+    // Each level is filtered from the one before it, so the levels go one after the other with their bands in parallel
+    for (u32 level = 1; level < levelCount; ++level)
+    {
+        const u32 width = texture.GetLevelWidth(level);
+        const u32 height = texture.GetLevelHeight(level);
+        const auto horizontal = BuildAxisFilter(options.filter, texture.GetLevelWidth(level - 1), width);
+        const auto vertical = BuildAxisFilter(options.filter, texture.GetLevelHeight(level - 1), height);
+        const u32 bandRows = std::min(std::max(bandTexels / width, minBandRows), height);
+        const u32 bandCount = (height + bandRows - 1) / bandRows;
+        pool.ParallelFor(imageCount * bandCount,
+                         [&](const u32 index)
+                         {
+                             const u32 image = index / bandCount;
+                             const u32 firstRow = index % bandCount * bandRows;
+                             FilterBand(*format, getImage(level - 1, image), getImage(level, image), horizontal,
+                                        vertical, firstRow, std::min(bandRows, height - firstRow));
+                         });
+    }
+
+    KtxTextureInfo mipInfo = info;
+    mipInfo.numLevels = levelCount;
+    mipInfo.generateMipmaps = false;
+    mipInfo.superCompressionScheme = static_cast<u32>(KtxSupercompressionScheme::eNone);
+
+    const auto keyValueData = texture.GetKeyValueData();
+    KtxTexture mipmapped(mipInfo, std::vector<u8>(keyValueData.begin(), keyValueData.end()));
+    mipmapped.SetImageData(std::move(data), dataSize, std::move(levels));
+    return mipmapped;
+}
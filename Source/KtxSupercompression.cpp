@@ -0,0 +1,428 @@
+#include "KtxSupercompression.hpp"
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#if defined(KTX_WITH_ZSTD)
+#include <zstd.h>
+#endif
+
+#if defined(KTX_WITH_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(KTX_WITH_LIBDEFLATE)
+#include <libdeflate.h>
+#endif
+
+namespace
+{
+    using namespace KTX;
+
+#if defined(KTX_WITH_ZSTD) || defined(KTX_WITH_ZLIB)
+    // Streaming decoders pull their input in pieces of this size
+    constexpr u64 streamInputSize = 64 * 1024;
+
+    std::span<u8> GetStreamInput()
+    {
+        thread_local std::vector<u8> input(streamInputSize);
+        return input;
+    }
+#endif
+
+    KtxResult CopyLevelStreaming(const u64 storedSize, const u64 uncompressedSize,
+                                 const Supercompression::ReadFunction& read, const std::span<u8> buffer,
+                                 const KtxChunkCallback& onChunk)
+    {
+        if (storedSize != uncompressedSize)
+        {
+            return KtxResult::eFileDataError;
+        }
+        for (u64 offset = 0; offset < storedSize; offset += buffer.size())
+        {
+            const auto chunk = buffer.first(std::min<u64>(buffer.size(), storedSize - offset));
+            if (!read(offset, chunk))
+            {
+                return KtxResult::eFileReadError;
+            }
+            if (!onChunk(chunk))
+            {
+                break;
+            }
+        }
+        return KtxResult::eSuccess;
+    }
+
+#if defined(KTX_WITH_ZSTD)
+    struct ZstdContextDeleter
+    {
+        void operator()(ZSTD_DCtx* context) const { ZSTD_freeDCtx(context); }
+    };
+
+    // One context per thread, so pool workers decode level after level without reallocating the window
+    ZSTD_DCtx* GetZstdContext()
+    {
+        thread_local std::unique_ptr<ZSTD_DCtx, ZstdContextDeleter> context(ZSTD_createDCtx());
+        return context.get();
+    }
+
+    KtxResult DecompressZstd(const std::span<const u8> source, const std::span<u8> destination)
+    {
+        ZSTD_DCtx* context = GetZstdContext();
+        if (context == nullptr)
+        {
+            return KtxResult::eUnsupportedFeature;
+        }
+        const size_t size =
+                ZSTD_decompressDCtx(context, destination.data(), destination.size(), source.data(), source.size());
+        if (ZSTD_isError(size) || size != destination.size())
+        {
+            return KtxResult::eFileDataError;
+        }
+        return KtxResult::eSuccess;
+    }
+
+    KtxResult DecompressZstdStreaming(const u64 storedSize, const u64 uncompressedSize,
+                                      const Supercompression::ReadFunction& read, const std::span<u8> buffer,
+                                      const KtxChunkCallback& onChunk)
+    {
+        ZSTD_DCtx* context = GetZstdContext();
+        if (context == nullptr)
+        {
+            return KtxResult::eUnsupportedFeature;
+        }
+        ZSTD_DCtx_reset(context, ZSTD_reset_session_only);
+
+        const auto input = GetStreamInput();
+        ZSTD_inBuffer in{input.data(), 0, 0};
+        ZSTD_outBuffer out{buffer.data(), buffer.size(), 0};
+        u64 readOffset = 0;
+        u64 produced = 0;
+        while (true)
+        {
+            if (in.pos == in.size && readOffset < storedSize)
+            {
+                const auto piece = input.first(std::min(input.size(), storedSize - readOffset));
+                if (!read(readOffset, piece))
+                {
+                    return KtxResult::eFileReadError;
+                }
+                readOffset += piece.size();
+                in = {piece.data(), piece.size(), 0};
+            }
+
+            const size_t status = ZSTD_decompressStream(context, &out, &in);
+            if (ZSTD_isError(status))
+            {
+                return KtxResult::eFileDataError;
+            }
+            // A level may hold several frames, it only ends once all of the input is used up
+            const bool inputDone = in.pos == in.size && readOffset == storedSize;
+            const bool finished = status == 0 && inputDone;
+            if (!finished && inputDone && out.pos < out.size)
+            {
+                // The decoder had room to write but no input left to finish the frame
+                return KtxResult::eFileDataError;
+            }
+
+            if (finished || out.pos == out.size)
+            {
+                produced += out.pos;
+                if (produced > uncompressedSize)
+                {
+                    return KtxResult::eFileDataError;
+                }
+                if (out.pos > 0 && !onChunk(buffer.first(out.pos)))
+                {
+                    return KtxResult::eSuccess;
+                }
+                out.pos = 0;
+            }
+            if (finished)
+            {
+                break;
+            }
+        }
+        return produced == uncompressedSize ? KtxResult::eSuccess : KtxResult::eFileDataError;
+    }
+
+    struct ZstdCompressContextDeleter
+    {
+        void operator()(ZSTD_CCtx* context) const { ZSTD_freeCCtx(context); }
+    };
+
+    KtxResult CompressZstd(const std::span<const u8> source, const i32 compressionLevel, std::vector<u8>& destination)
+    {
+        thread_local std::unique_ptr<ZSTD_CCtx, ZstdCompressContextDeleter> context(ZSTD_createCCtx());
+        if (context == nullptr)
+        {
+            return KtxResult::eUnsupportedFeature;
+        }
+        destination.resize(ZSTD_compressBound(source.size()));
+        const size_t size = ZSTD_compressCCtx(context.get(), destination.data(), destination.size(), source.data(),
+                                              source.size(), compressionLevel);
+        if (ZSTD_isError(size))
+        {
+            return KtxResult::eUnsupportedFeature;
+        }
+        destination.resize(size);
+        return KtxResult::eSuccess;
+    }
+#endif
+
+#if defined(KTX_WITH_ZLIB)
+    // zlib counts in 32 bits, larger levels are fed in slices
+    constexpr u64 zlibSliceSize = 1u << 30;
+
+    struct ZlibStream
+    {
+        ZlibStream() { initialized = inflateInit(&stream) == Z_OK; }
+        ~ZlibStream()
+        {
+            if (initialized)
+            {
+                inflateEnd(&stream);
+            }
+        }
+
+        z_stream stream{};
+        bool initialized = false;
+    };
+
+    // One inflate state per thread, reset for every level
+    z_stream* GetZlibStream()
+    {
+        thread_local ZlibStream zlib;
+        if (!zlib.initialized || inflateReset(&zlib.stream) != Z_OK)
+        {
+            return nullptr;
+        }
+        return &zlib.stream;
+    }
+
+    KtxResult DecompressZlib(const std::span<const u8> source, const std::span<u8> destination)
+    {
+#if defined(KTX_WITH_LIBDEFLATE)
+        // The level index tells the exact size, so the whole level can go through libdeflate in one call
+        struct DecompressorDeleter
+        {
+            void operator()(libdeflate_decompressor* decompressor) const
+            {
+                libdeflate_free_decompressor(decompressor);
+            }
+        };
+        thread_local std::unique_ptr<libdeflate_decompressor, DecompressorDeleter> decompressor(
+                libdeflate_alloc_decompressor());
+        if (decompressor != nullptr)
+        {
+            size_t size = 0;
+            const auto status = libdeflate_zlib_decompress(decompressor.get(), source.data(), source.size(),
+                                                           destination.data(), destination.size(), &size);
+            return status == LIBDEFLATE_SUCCESS && size == destination.size() ? KtxResult::eSuccess
+                                                                              : KtxResult::eFileDataError;
+        }
+#endif
+        z_stream* stream = GetZlibStream();
+        if (stream == nullptr)
+        {
+            return KtxResult::eUnsupportedFeature;
+        }
+
+        stream->next_in = const_cast<Bytef*>(source.data());
+        stream->avail_in = 0;
+        stream->next_out = destination.data();
+        stream->avail_out = 0;
+        u64 inputLeft = source.size();
+        u64 outputLeft = destination.size();
+        while (true)
+        {
+            if (stream->avail_in == 0)
+            {
+                stream->avail_in = static_cast<uInt>(std::min(inputLeft, zlibSliceSize));
+                inputLeft -= stream->avail_in;
+            }
+            if (stream->avail_out == 0)
+            {
+                stream->avail_out = static_cast<uInt>(std::min(outputLeft, zlibSliceSize));
+                outputLeft -= stream->avail_out;
+            }
+
+            const int status = inflate(stream, Z_NO_FLUSH);
+            if (status == Z_STREAM_END)
+            {
+                break;
+            }
+            if (status != Z_OK)
+            {
+                // Z_BUF_ERROR means the input ran out or the level is larger than the index says
+                return KtxResult::eFileDataError;
+            }
+        }
+        return stream->avail_out == 0 && outputLeft == 0 ? KtxResult::eSuccess : KtxResult::eFileDataError;
+    }
+
+    KtxResult DecompressZlibStreaming(const u64 storedSize, const u64 uncompressedSize,
+                                      const Supercompression::ReadFunction& read, const std::span<u8> buffer,
+                                      const KtxChunkCallback& onChunk)
+    {
+        z_stream* stream = GetZlibStream();
+        if (stream == nullptr)
+        {
+            return KtxResult::eUnsupportedFeature;
+        }
+
+        const auto input = GetStreamInput();
+        const auto output = buffer.first(std::min<u64>(buffer.size(), zlibSliceSize));
+        stream->avail_in = 0;
+        stream->next_out = output.data();
+        stream->avail_out = static_cast<uInt>(output.size());
+        u64 readOffset = 0;
+        u64 produced = 0;
+        while (true)
+        {
+            if (stream->avail_in == 0 && readOffset < storedSize)
+            {
+                const auto piece = input.first(std::min(input.size(), storedSize - readOffset));
+                if (!read(readOffset, piece))
+                {
+                    return KtxResult::eFileReadError;
+                }
+                readOffset += piece.size();
+                stream->next_in = piece.data();
+                stream->avail_in = static_cast<uInt>(piece.size());
+            }
+
+            const int status = inflate(stream, Z_NO_FLUSH);
+            if (status != Z_OK && status != Z_STREAM_END)
+            {
+                return KtxResult::eFileDataError;
+            }
+
+            if (status == Z_STREAM_END || stream->avail_out == 0)
+            {
+                const u64 filled = output.size() - stream->avail_out;
+                produced += filled;
+                if (produced > uncompressedSize)
+                {
+                    return KtxResult::eFileDataError;
+                }
+                if (filled > 0 && !onChunk(output.first(filled)))
+                {
+                    return KtxResult::eSuccess;
+                }
+                stream->next_out = output.data();
+                stream->avail_out = static_cast<uInt>(output.size());
+            }
+            if (status == Z_STREAM_END)
+            {
+                break;
+            }
+        }
+        return produced == uncompressedSize ? KtxResult::eSuccess : KtxResult::eFileDataError;
+    }
+
+    KtxResult CompressZlib(const std::span<const u8> source, const i32 compressionLevel, std::vector<u8>& destination)
+    {
+        uLongf size = compressBound(static_cast<uLong>(source.size()));
+        destination.resize(size);
+        if (compress2(destination.data(), &size, source.data(), static_cast<uLong>(source.size()),
+                      compressionLevel == 0 ? Z_DEFAULT_COMPRESSION : compressionLevel) != Z_OK)
+        {
+            return KtxResult::eUnsupportedFeature;
+        }
+        destination.resize(size);
+        return KtxResult::eSuccess;
+    }
+#endif
+} // namespace
+
+bool KTX::Supercompression::IsSupported(const KtxSupercompressionScheme scheme)
+{
+    switch (scheme)
+    {
+        case KtxSupercompressionScheme::eNone:
+            return true;
+#if defined(KTX_WITH_ZSTD)
+        case KtxSupercompressionScheme::eZstd:
+            return true;
+#endif
+#if defined(KTX_WITH_ZLIB)
+        case KtxSupercompressionScheme::eZlib:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+KTX::KtxResult KTX::Supercompression::DecompressLevel(const KtxSupercompressionScheme scheme,
+                                                      const std::span<const u8> source, const std::span<u8> destination)
+{
+    switch (scheme)
+    {
+        case KtxSupercompressionScheme::eNone:
+            if (source.size() != destination.size())
+            {
+                return KtxResult::eFileDataError;
+            }
+            std::ranges::copy(source, destination.begin());
+            return KtxResult::eSuccess;
+#if defined(KTX_WITH_ZSTD)
+        case KtxSupercompressionScheme::eZstd:
+            return DecompressZstd(source, destination);
+#endif
+#if defined(KTX_WITH_ZLIB)
+        case KtxSupercompressionScheme::eZlib:
+            return DecompressZlib(source, destination);
+#endif
+        default:
+            return KtxResult::eUnsupportedFeature;
+    }
+}
+
+KTX::KtxResult KTX::Supercompression::DecompressLevelStreaming(const KtxSupercompressionScheme scheme,
+                                                               const u64 storedSize, const u64 uncompressedSize,
+                                                               const ReadFunction& read, const std::span<u8> buffer,
+                                                               const KtxChunkCallback& onChunk)
+{
+    assert(!buffer.empty() && "Empty chunk buffer");
+    switch (scheme)
+    {
+        case KtxSupercompressionScheme::eNone:
+            return CopyLevelStreaming(storedSize, uncompressedSize, read, buffer, onChunk);
+#if defined(KTX_WITH_ZSTD)
+        case KtxSupercompressionScheme::eZstd:
+            return DecompressZstdStreaming(storedSize, uncompressedSize, read, buffer, onChunk);
+#endif
+#if defined(KTX_WITH_ZLIB)
+        case KtxSupercompressionScheme::eZlib:
+            return DecompressZlibStreaming(storedSize, uncompressedSize, read, buffer, onChunk);
+#endif
+        default:
+            return KtxResult::eUnsupportedFeature;
+    }
+}
+
+KTX::KtxResult KTX::Supercompression::CompressLevel(const KtxSupercompressionScheme scheme,
+                                                    const std::span<const u8> source,
+                                                    [[maybe_unused]] const i32 compressionLevel,
+                                                    std::vector<u8>& destination)
+{
+    switch (scheme)
+    {
+        case KtxSupercompressionScheme::eNone:
+            destination.assign(source.begin(), source.end());
+            return KtxResult::eSuccess;
+#if defined(KTX_WITH_ZSTD)
+        case KtxSupercompressionScheme::eZstd:
+            return CompressZstd(source, compressionLevel, destination);
+#endif
+#if defined(KTX_WITH_ZLIB)
+        case KtxSupercompressionScheme::eZlib:
+            return CompressZlib(source, compressionLevel, destination);
+#endif
+        default:
+            return KtxResult::eUnsupportedFeature;
+    }
+}
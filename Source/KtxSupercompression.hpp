@@ -0,0 +1,32 @@
+#pragma once
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "KtxUtility.hpp"
+
+// Level decoders and encoders for the ktx2 supercompression schemes that wrap a general purpose compressor. Which
+// schemes are available depends on the build options, e.g. Zstd needs KtxWithZstd and zlib needs KtxWithZlib.
+
+namespace KTX::Supercompression
+{
+    // Reads the stored level starting at offset, relative to the start of the level
+    using ReadFunction = std::function<bool(u64 offset, std::span<u8> destination)>;
+
+    [[nodiscard]] bool IsSupported(KtxSupercompressionScheme scheme);
+
+    // Decodes a whole level and fails unless it fills the destination exactly. Safe to call from any number of threads,
+    // every thread keeps its own decoder state and reuses it across calls.
+    KtxResult DecompressLevel(KtxSupercompressionScheme scheme, std::span<const u8> source, std::span<u8> destination);
+
+    // Decodes a level of storedSize bytes without holding all of it: input is pulled through read in small pieces and
+    // output is handed to onChunk every time the buffer fills up. Returning false from onChunk stops early with
+    // eSuccess. Same threading rules as above.
+    KtxResult DecompressLevelStreaming(KtxSupercompressionScheme scheme, u64 storedSize, u64 uncompressedSize,
+                                       const ReadFunction& read, std::span<u8> buffer, const KtxChunkCallback& onChunk);
+
+    // Encodes a whole level, destination is resized to the encoded size. compressionLevel goes straight to the
+    // compressor (Zstd 1 to 22, zlib 1 to 9), 0 picks its default. Same threading rules as above.
+    KtxResult CompressLevel(KtxSupercompressionScheme scheme, std::span<const u8> source, i32 compressionLevel,
+                            std::vector<u8>& destination);
+} // namespace KTX::Supercompression
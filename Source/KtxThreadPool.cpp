@@ -0,0 +1,212 @@
+#include "KtxUtility.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <latch>
+#include <mutex>
+#include <thread>
+
+#include "cassert"
+
+struct KTX::KtxThreadPool::Impl
+{
+    // Each worker owns a queue. It pops its own work from the back and steals from the front of the others when it
+    // runs dry, so batches of small tasks submitted from one thread spread across every core.
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::jthread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::condition_variable idle;
+    std::atomic<u64> queuedTasks = 0;
+    std::atomic<u64> unfinishedTasks = 0;
+    std::atomic<u32> nextQueue = 0;
+    bool stopping = false;
+
+    bool TryPop(u32 first, std::function<void()>& task);
+    void Run(std::function<void()>& task);
+    void WorkerLoop(u32 index);
+};
+
+namespace
+{
+    // Lets tasks submitted from a worker land on that worker's own queue
+    thread_local const KTX::KtxThreadPool::Impl* currentPool = nullptr;
+    thread_local KTX::u32 currentWorker = 0;
+} // namespace
+
+bool KTX::KtxThreadPool::Impl::TryPop(const u32 first, std::function<void()>& task)
+{
+    {
+        auto& own = *queues[first];
+        std::scoped_lock lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            --queuedTasks;
+            return true;
+        }
+    }
+
+    for (u32 offset = 1; offset < queues.size(); ++offset)
+    {
+        auto& victim = *queues[(first + offset) % queues.size()];
+        std::scoped_lock lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --queuedTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+void KTX::KtxThreadPool::Impl::Run(std::function<void()>& task)
+{
+    task();
+    task = nullptr;
+    if (--unfinishedTasks == 0)
+    {
+        std::scoped_lock lock(sleepMutex);
+        idle.notify_all();
+    }
+}
+
+void KTX::KtxThreadPool::Impl::WorkerLoop(const u32 index)
+{
+    currentPool = this;
+    currentWorker = index;
+
+    std::function<void()> task;
+    while (true)
+    {
+        if (TryPop(index, task))
+        {
+            Run(task);
+            continue;
+        }
+
+        std::unique_lock lock(sleepMutex);
+        wakeUp.wait(lock, [this] { return stopping || queuedTasks > 0; });
+        if (stopping && queuedTasks == 0)
+        {
+            return;
+        }
+    }
+}
+
+KTX::KtxThreadPool::KtxThreadPool(u32 threadCount) : impl(std::make_unique<Impl>())
+{
+    threadCount = std::max(threadCount, 1u);
+    impl->queues.reserve(threadCount);
+    for (u32 i = 0; i < threadCount; ++i)
+    {
+        impl->queues.emplace_back(std::make_unique<Impl::WorkerQueue>());
+    }
+
+    impl->workers.reserve(threadCount);
+    for (u32 i = 0; i < threadCount; ++i)
+    {
+        impl->workers.emplace_back([this, i] { impl->WorkerLoop(i); });
+    }
+}
+
+KTX::KtxThreadPool::~KtxThreadPool()
+{
+    {
+        std::scoped_lock lock(impl->sleepMutex);
+        impl->stopping = true;
+    }
+    impl->wakeUp.notify_all();
+    impl->workers.clear();
+}
+
+KTX::u32 KTX::KtxThreadPool::GetThreadCount() const
+{
+    return static_cast<u32>(impl->workers.size());
+}
+
+void KTX::KtxThreadPool::Submit(std::function<void()> task)
+{
+    assert(task && "Empty task");
+    const u32 queue = currentPool == impl.get() ? currentWorker : impl->nextQueue++ % impl->queues.size();
+
+    ++impl->unfinishedTasks;
+    {
+        auto& target = *impl->queues[queue];
+        std::scoped_lock lock(target.mutex);
+        target.tasks.push_back(std::move(task));
+    }
+    ++impl->queuedTasks;
+
+    {
+        std::scoped_lock lock(impl->sleepMutex);
+    }
+    impl->wakeUp.notify_one();
+}
+
+bool KTX::KtxThreadPool::RunPendingTask()
+{
+    std::function<void()> task;
+    const u32 first = currentPool == impl.get() ? currentWorker : 0;
+    if (!impl->TryPop(first, task))
+    {
+        return false;
+    }
+    impl->Run(task);
+    return true;
+}
+
+void KTX::KtxThreadPool::WaitIdle()
+{
+    while (impl->unfinishedTasks > 0)
+    {
+        if (RunPendingTask())
+        {
+            continue;
+        }
+
+        std::unique_lock lock(impl->sleepMutex);
+        impl->idle.wait(lock, [this] { return impl->unfinishedTasks == 0 || impl->queuedTasks > 0; });
+    }
+}
+
+void KTX::KtxThreadPool::ParallelFor(const u32 count, const std::function<void(u32 index)>& task)
+{
+    if (count < 2)
+    {
+        for (u32 index = 0; index < count; ++index)
+        {
+            task(index);
+        }
+        return;
+    }
+
+    std::latch done(count);
+    for (u32 index = 0; index < count; ++index)
+    {
+        Submit(
+                [&task, &done, index]
+                {
+                    task(index);
+                    done.count_down();
+                });
+    }
+    while (!done.try_wait())
+    {
+        if (!RunPendingTask())
+        {
+            done.wait();
+        }
+    }
+}
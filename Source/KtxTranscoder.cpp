@@ -0,0 +1,1508 @@
+#include "KtxTranscoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include "KtxEtc.hpp"
+#include "KtxFormat.hpp"
+#include "KtxUastc.hpp"
+
+namespace
+{
+    using namespace KTX;
+
+    // Start of the BasisLZ global data, followed by one image descriptor per image and then the codebooks and tables
+    struct BasisLZGlobalHeader
+    {
+        u16 endpointCount;
+        u16 selectorCount;
+        u32 endpointsByteLength;
+        u32 selectorsByteLength;
+        u32 tablesByteLength;
+        u32 extendedByteLength;
+    };
+    static_assert(sizeof(BasisLZGlobalHeader) == 20);
+
+    // Slice offsets are relative to the start of the level
+    struct BasisLZImageDesc
+    {
+        u32 imageFlags;
+        u32 rgbSliceByteOffset;
+        u32 rgbSliceByteLength;
+        u32 alphaSliceByteOffset;
+        u32 alphaSliceByteLength;
+    };
+    static_assert(sizeof(BasisLZImageDesc) == 20);
+
+    // P-frames of animations predict from the previous frame, they need video transcoding state
+    constexpr u32 pFrameFlag = 0x02;
+
+    // DFD color model of UASTC, and the channel ids of its first sample that carry alpha (RGBA and RRRG)
+    constexpr u8 uastcColorModel = 166;
+    constexpr u8 uastcRgbaChannel = 3;
+    constexpr u8 uastcRrrgChannel = 5;
+    // UASTC images are split into bands of about this many blocks so large levels spread over the pool
+    constexpr u32 uastcBandBlocks = 4096;
+
+    constexpr u32 huffmanMaxCodeSize = 16;
+    constexpr u32 huffmanMaxSymbolsLog2 = 14;
+    constexpr u32 huffmanFastBits = 10;
+    // Sizes of the code length codes are sent in this order, the ones most likely to be 0 go last
+    constexpr std::array<u8, 21> codeLengthOrder = {17, 18, 19, 20, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15, 16};
+    constexpr u32 smallZeroRunCode = 17;
+    constexpr u32 bigZeroRunCode = 18;
+    constexpr u32 smallRepeatCode = 19;
+
+    // Endpoint color deltas use one of three models depending on the previous value
+    constexpr u32 color5Model0PreviousMax = 9;
+    constexpr u32 color5Model1PreviousMax = 21;
+
+    // Symbol of the endpoint predictor model that repeats the previous 2x2 group of predictors
+    constexpr u32 endpointPredictorRepeatSymbol = 256;
+    constexpr u32 endpointPredictorRepeatBits = 4;
+    constexpr u32 endpointPredictorMinRepeat = 3;
+    constexpr u32 selectorRunMin = 3;
+    constexpr u32 selectorRunLongSymbol = 63;
+    constexpr u32 selectorRunLongBits = 7;
+
+    constexpr std::array<std::array<i32, 4>, 8> etc1Modifiers = {{
+            {-8, -2, 2, 8},
+            {-17, -5, 5, 17},
+            {-29, -9, 9, 29},
+            {-42, -13, 13, 42},
+            {-60, -18, 18, 60},
+            {-80, -24, 24, 80},
+            {-106, -33, 33, 106},
+            {-183, -47, 47, 183},
+    }};
+    // Selectors go from the darkest to the brightest color, ETC1 numbers its modifiers differently
+    constexpr std::array<u32, 4> selectorToEtc1 = {3, 2, 0, 1};
+
+    bool IsInRange(const std::span<const u8> data, const u64 offset, const u64 length)
+    {
+        return offset <= data.size() && length <= data.size() - offset;
+    }
+
+    u8 ClampToByte(const i32 value)
+    {
+        return static_cast<u8>(std::clamp(value, 0, 255));
+    }
+
+    u32 Expand5(const u32 value)
+    {
+        return (value << 3) | (value >> 2);
+    }
+
+    // Canonical Huffman code. Codes are sent most significant bit first, which in the LSB first bit stream means the
+    // fast table is indexed with bit reversed codes.
+    struct HuffmanTable
+    {
+        bool Init(const std::span<const u8> codeSizes)
+        {
+            std::array<u32, huffmanMaxCodeSize + 1> counts{};
+            for (const u8 size : codeSizes)
+            {
+                if (size > huffmanMaxCodeSize)
+                {
+                    return false;
+                }
+                ++counts[size];
+            }
+            counts[0] = 0;
+
+            u32 code = 0;
+            u32 symbolOffset = 0;
+            for (u32 length = 1; length <= huffmanMaxCodeSize; ++length)
+            {
+                code = (code + counts[length - 1]) << 1;
+                if (code + counts[length] > 1u << length)
+                {
+                    // Over-subscribed, more codes than fit in this many bits
+                    return false;
+                }
+                firstCode[length] = code;
+                firstSymbol[length] = symbolOffset;
+                lengthCounts[length] = counts[length];
+                symbolOffset += counts[length];
+            }
+
+            symbols.resize(symbolOffset);
+            fast.assign(1u << huffmanFastBits, 0);
+            std::array<u32, huffmanMaxCodeSize + 1> nextIndex{};
+            for (u32 symbol = 0; symbol < codeSizes.size(); ++symbol)
+            {
+                const u32 length = codeSizes[symbol];
+                if (length == 0)
+                {
+                    continue;
+                }
+                const u32 rank = nextIndex[length]++;
+                symbols[firstSymbol[length] + rank] = static_cast<u16>(symbol);
+                if (length <= huffmanFastBits)
+                {
+                    const u32 symbolCode = firstCode[length] + rank;
+                    u32 reversed = 0;
+                    for (u32 bit = 0; bit < length; ++bit)
+                    {
+                        reversed |= ((symbolCode >> bit) & 1) << (length - 1 - bit);
+                    }
+                    for (u32 index = reversed; index < fast.size(); index += 1u << length)
+                    {
+                        fast[index] = symbol << 5 | length;
+                    }
+                }
+            }
+            return true;
+        }
+
+        [[nodiscard]] bool IsEmpty() const { return symbols.empty(); }
+
+        // Symbol << 5 | code length for codes up to huffmanFastBits long, 0 for the longer ones
+        std::vector<u32> fast;
+        std::vector<u16> symbols;
+        std::array<u32, huffmanMaxCodeSize + 1> firstCode{};
+        std::array<u32, huffmanMaxCodeSize + 1> firstSymbol{};
+        std::array<u32, huffmanMaxCodeSize + 1> lengthCounts{};
+    };
+
+    // LSB first bit reader. Reads past the end return zeros and mark the reader as failed, so the decoders only check
+    // once at the end.
+    class BitReader
+    {
+    public:
+        explicit BitReader(const std::span<const u8> data) : data(data) {}
+
+        u32 GetBits(const u32 count)
+        {
+            assert(count <= 32 && "Too many bits");
+            if (count == 0)
+            {
+                return 0;
+            }
+            if (bitCount < count)
+            {
+                Refill();
+            }
+            const auto value = static_cast<u32>(buffer & ((u64{1} << count) - 1));
+            Consume(count);
+            return value;
+        }
+
+        // Variable length value in chunks of chunkBits, every chunk is followed by a bit telling if another one follows
+        u32 DecodeVlc(const u32 chunkBits)
+        {
+            const u32 chunkSize = 1u << chunkBits;
+            u32 value = 0;
+            for (u32 shift = 0; shift < 32; shift += chunkBits)
+            {
+                const u32 chunk = GetBits(chunkBits + 1);
+                value |= (chunk & (chunkSize - 1)) << shift;
+                if ((chunk & chunkSize) == 0)
+                {
+                    break;
+                }
+            }
+            return value;
+        }
+
+        u32 Decode(const HuffmanTable& table)
+        {
+            if (bitCount < huffmanMaxCodeSize)
+            {
+                Refill();
+            }
+            if (table.IsEmpty())
+            {
+                failed = true;
+                return 0;
+            }
+            if (const u32 entry = table.fast[buffer & ((1u << huffmanFastBits) - 1)]; entry != 0)
+            {
+                Consume(entry & 31);
+                return entry >> 5;
+            }
+
+            u32 code = 0;
+            for (u32 length = 1; length <= huffmanMaxCodeSize; ++length)
+            {
+                code = code << 1 | static_cast<u32>((buffer >> (length - 1)) & 1);
+                if (code - table.firstCode[length] < table.lengthCounts[length])
+                {
+                    Consume(length);
+                    return table.symbols[table.firstSymbol[length] + code - table.firstCode[length]];
+                }
+            }
+            failed = true;
+            return 0;
+        }
+
+        // True if a code didn't decode or more bits were used than the data holds
+        [[nodiscard]] bool HasFailed() const { return failed || position * 8 - bitCount > data.size() * 8; }
+
+    private:
+        void Refill()
+        {
+            while (bitCount <= 56)
+            {
+                const u64 byte = position < data.size() ? data[position] : 0;
+                buffer |= byte << bitCount;
+                bitCount += 8;
+                ++position;
+            }
+        }
+
+        void Consume(const u32 count)
+        {
+            buffer >>= count;
+            bitCount -= count;
+        }
+
+        std::span<const u8> data;
+        u64 position = 0;
+        u64 buffer = 0;
+        u32 bitCount = 0;
+        bool failed = false;
+    };
+
+    // Code sizes are themselves Huffman coded, with codes for runs of zeros and for repeating the previous size
+    bool ReadHuffmanTable(BitReader& reader, HuffmanTable& table)
+    {
+        const u32 symbolCount = reader.GetBits(huffmanMaxSymbolsLog2);
+        if (symbolCount == 0)
+        {
+            table = {};
+            return true;
+        }
+
+        const u32 codeLengthCount = reader.GetBits(5);
+        if (codeLengthCount < 1 || codeLengthCount > codeLengthOrder.size())
+        {
+            return false;
+        }
+        std::array<u8, codeLengthOrder.size()> codeLengthSizes{};
+        for (u32 i = 0; i < codeLengthCount; ++i)
+        {
+            codeLengthSizes[codeLengthOrder[i]] = static_cast<u8>(reader.GetBits(3));
+        }
+        HuffmanTable codeLengthTable;
+        if (!codeLengthTable.Init(codeLengthSizes) || codeLengthTable.IsEmpty())
+        {
+            return false;
+        }
+
+        std::vector<u8> codeSizes(symbolCount);
+        u32 symbol = 0;
+        while (symbol < symbolCount)
+        {
+            const u32 code = reader.Decode(codeLengthTable);
+            if (reader.HasFailed())
+            {
+                return false;
+            }
+            if (code <= huffmanMaxCodeSize)
+            {
+                codeSizes[symbol++] = static_cast<u8>(code);
+            } else if (code == smallZeroRunCode)
+            {
+                symbol += reader.GetBits(3) + 3;
+            } else if (code == bigZeroRunCode)
+            {
+                symbol += reader.GetBits(7) + 11;
+            } else
+            {
+                const u32 count = code == smallRepeatCode ? reader.GetBits(2) + 3 : reader.GetBits(6) + 7;
+                if (symbol == 0 || codeSizes[symbol - 1] == 0 || count > symbolCount - symbol)
+                {
+                    return false;
+                }
+                std::fill_n(codeSizes.begin() + symbol, count, codeSizes[symbol - 1]);
+                symbol += count;
+            }
+        }
+        return symbol == symbolCount && table.Init(codeSizes);
+    }
+
+    using Color = std::array<u8, 4>;
+
+    // ETC1S blocks are ETC1 blocks with a single base color and modifier table for both halves
+    struct Endpoint
+    {
+        std::array<Color, 4> colors;
+        // The first four bytes of the ETC1 block
+        std::array<u8, 4> etc1Header;
+        // Green 5 bit value and modifier table, the key of single channel encodings
+        u8 value5;
+        u8 intensity;
+    };
+
+    struct Selector
+    {
+        // 2 bits per pixel in row order
+        u32 bits;
+        // The last four bytes of the ETC1 block
+        std::array<u8, 4> etc1Indices;
+        // Range of selectors the block uses, encoders only have to fit the colors in between
+        u8 low;
+        u8 high;
+
+        [[nodiscard]] u32 Get(const u32 pixel) const { return (bits >> (pixel * 2)) & 3; }
+    };
+
+    Endpoint MakeEndpoint(const std::array<u8, 3>& color5, const u32 intensity)
+    {
+        Endpoint endpoint{};
+        for (u32 selector = 0; selector < 4; ++selector)
+        {
+            for (u32 channel = 0; channel < 3; ++channel)
+            {
+                endpoint.colors[selector][channel] =
+                        ClampToByte(static_cast<i32>(Expand5(color5[channel])) + etc1Modifiers[intensity][selector]);
+            }
+            endpoint.colors[selector][3] = 255;
+        }
+        // Differential mode with zero deltas, no flip
+        endpoint.etc1Header = {static_cast<u8>(color5[0] << 3), static_cast<u8>(color5[1] << 3),
+                               static_cast<u8>(color5[2] << 3), static_cast<u8>(intensity << 5 | intensity << 2 | 2)};
+        endpoint.value5 = color5[1];
+        endpoint.intensity = static_cast<u8>(intensity);
+        return endpoint;
+    }
+
+    Selector MakeSelector(const std::array<u8, 4>& rows)
+    {
+        Selector selector{};
+        selector.low = 3;
+        u32 etc1Bits = 0;
+        for (u32 y = 0; y < 4; ++y)
+        {
+            selector.bits |= static_cast<u32>(rows[y]) << (y * 8);
+            for (u32 x = 0; x < 4; ++x)
+            {
+                const u32 value = (rows[y] >> (x * 2)) & 3;
+                selector.low = std::min(selector.low, static_cast<u8>(value));
+                selector.high = std::max(selector.high, static_cast<u8>(value));
+                // ETC1 stores the pixels column by column, most significant bits in the upper half
+                const u32 index = selectorToEtc1[value];
+                etc1Bits |= (index >> 1) << (x * 4 + y + 16) | (index & 1) << (x * 4 + y);
+            }
+        }
+        selector.etc1Indices = {static_cast<u8>(etc1Bits >> 24), static_cast<u8>(etc1Bits >> 16),
+                                static_cast<u8>(etc1Bits >> 8), static_cast<u8>(etc1Bits)};
+        return selector;
+    }
+
+    // Everything decoded from the global data, shared by every slice of the file
+    struct BasisLZCodebooks
+    {
+        std::vector<Endpoint> endpoints;
+        std::vector<Selector> selectors;
+        HuffmanTable endpointPredictorModel;
+        HuffmanTable deltaEndpointModel;
+        HuffmanTable selectorModel;
+        HuffmanTable selectorRunModel;
+        u32 selectorHistorySize = 0;
+        std::vector<BasisLZImageDesc> imageDescs;
+    };
+
+    bool DecodeEndpoints(const std::span<const u8> data, const u32 count, BasisLZCodebooks& codebooks)
+    {
+        BitReader reader(data);
+        std::array<HuffmanTable, 3> colorModels;
+        HuffmanTable intensityModel;
+        for (auto& model : colorModels)
+        {
+            if (!ReadHuffmanTable(reader, model))
+            {
+                return false;
+            }
+        }
+        if (!ReadHuffmanTable(reader, intensityModel))
+        {
+            return false;
+        }
+        const bool grayscale = reader.GetBits(1) != 0;
+
+        // Colors and modifier tables are delta coded against the previous endpoint
+        std::array<u8, 3> color5 = {16, 16, 16};
+        u32 intensity = 0;
+        codebooks.endpoints.resize(count);
+        for (auto& endpoint : codebooks.endpoints)
+        {
+            intensity = (intensity + reader.Decode(intensityModel)) & 7;
+            for (u32 channel = 0; channel < (grayscale ? 1u : 3u); ++channel)
+            {
+                const u32 model = color5[channel] <= color5Model0PreviousMax   ? 0
+                                  : color5[channel] <= color5Model1PreviousMax ? 1
+                                                                               : 2;
+                color5[channel] = static_cast<u8>((color5[channel] + reader.Decode(colorModels[model])) & 31);
+            }
+            if (grayscale)
+            {
+                color5[1] = color5[2] = color5[0];
+            }
+            endpoint = MakeEndpoint(color5, intensity);
+        }
+        return !reader.HasFailed();
+    }
+
+    bool DecodeSelectors(const std::span<const u8> data, const u32 count, BasisLZCodebooks& codebooks)
+    {
+        BitReader reader(data);
+        // Global and hybrid selector codebooks were dropped from the format before ktx2 adopted it
+        const bool globalCodebook = reader.GetBits(1) != 0;
+        const bool hybridCodebook = !globalCodebook && reader.GetBits(1) != 0;
+        if (globalCodebook || hybridCodebook)
+        {
+            return false;
+        }
+
+        codebooks.selectors.resize(count);
+        if (reader.GetBits(1) != 0)
+        {
+            // Raw, one byte per row
+            for (auto& selector : codebooks.selectors)
+            {
+                std::array<u8, 4> rows{};
+                for (auto& row : rows)
+                {
+                    row = static_cast<u8>(reader.GetBits(8));
+                }
+                selector = MakeSelector(rows);
+            }
+            return !reader.HasFailed();
+        }
+
+        // Every row after the first selector is XORed with the same row of the previous one
+        HuffmanTable deltaModel;
+        if (!ReadHuffmanTable(reader, deltaModel) || (count > 1 && deltaModel.IsEmpty()))
+        {
+            return false;
+        }
+        std::array<u8, 4> rows{};
+        for (u32 index = 0; index < count; ++index)
+        {
+            for (auto& row : rows)
+            {
+                row = static_cast<u8>(index == 0 ? reader.GetBits(8) : reader.Decode(deltaModel) ^ row);
+            }
+            codebooks.selectors[index] = MakeSelector(rows);
+        }
+        return !reader.HasFailed();
+    }
+
+    bool DecodeTables(const std::span<const u8> data, BasisLZCodebooks& codebooks)
+    {
+        BitReader reader(data);
+        if (!ReadHuffmanTable(reader, codebooks.endpointPredictorModel) ||
+            !ReadHuffmanTable(reader, codebooks.deltaEndpointModel) ||
+            !ReadHuffmanTable(reader, codebooks.selectorModel) || !ReadHuffmanTable(reader, codebooks.selectorRunModel))
+        {
+            return false;
+        }
+        codebooks.selectorHistorySize = reader.GetBits(13);
+        return !codebooks.endpointPredictorModel.IsEmpty() && !reader.HasFailed();
+    }
+
+    KtxResult DecodeGlobalData(const std::span<const u8> globalData, const u32 imageCount, BasisLZCodebooks& codebooks)
+    {
+        BasisLZGlobalHeader header;
+        if (globalData.size() < sizeof(header))
+        {
+            return KtxResult::eFileDataError;
+        }
+        std::memcpy(&header, globalData.data(), sizeof(header));
+
+        u64 offset = sizeof(header);
+        const u64 imageDescsSize = static_cast<u64>(imageCount) * sizeof(BasisLZImageDesc);
+        if (!IsInRange(globalData, offset, imageDescsSize))
+        {
+            return KtxResult::eFileDataError;
+        }
+        codebooks.imageDescs.resize(imageCount);
+        std::memcpy(codebooks.imageDescs.data(), globalData.data() + offset, imageDescsSize);
+        offset += imageDescsSize;
+
+        const auto next = [&](const u32 length) -> std::span<const u8>
+        {
+            if (!IsInRange(globalData, offset, length))
+            {
+                return {};
+            }
+            offset += length;
+            return globalData.subspan(offset - length, length);
+        };
+        const auto endpointsData = next(header.endpointsByteLength);
+        const auto selectorsData = next(header.selectorsByteLength);
+        const auto tablesData = next(header.tablesByteLength);
+        if (endpointsData.empty() || selectorsData.empty() || tablesData.empty() || header.endpointCount == 0 ||
+            header.selectorCount == 0)
+        {
+            return KtxResult::eFileDataError;
+        }
+
+        if (!DecodeEndpoints(endpointsData, header.endpointCount, codebooks) ||
+            !DecodeSelectors(selectorsData, header.selectorCount, codebooks) || !DecodeTables(tablesData, codebooks))
+        {
+            return KtxResult::eFileDataError;
+        }
+        return KtxResult::eSuccess;
+    }
+
+    struct BlockIndices
+    {
+        u16 endpoint;
+        u16 selector;
+    };
+
+    // Decodes the codebook indices of every block of a slice. Endpoints are predicted from the left, upper or upper
+    // left block, the predictors of a 2x2 group share a symbol. Selectors come either straight from the codebook or
+    // from a small history of recently used ones, with run lengths for repeats.
+    bool DecodeSlice(const BasisLZCodebooks& codebooks, const std::span<const u8> data, const u32 blocksX,
+                     const u32 blocksY, const std::span<BlockIndices> blocks)
+    {
+        struct PredictorEntry
+        {
+            u16 endpoint;
+            u8 predictors;
+        };
+        // Two rows, the previous one and the current one
+        thread_local std::vector<PredictorEntry> rows;
+        thread_local std::vector<u16> history;
+        rows.assign(static_cast<size_t>(blocksX) * 2, {});
+        history.assign(codebooks.selectorHistorySize, 0);
+
+        const auto endpointCount = static_cast<u32>(codebooks.endpoints.size());
+        const auto selectorCount = static_cast<u32>(codebooks.selectors.size());
+        const u32 historySize = codebooks.selectorHistorySize;
+        const u32 selectorRunSymbol = selectorCount + historySize;
+        const u64 blockCount = static_cast<u64>(blocksX) * blocksY;
+
+        BitReader reader(data);
+        u32 predictors = 0;
+        u32 previousPredictors = 0;
+        u32 predictorRepeat = 0;
+        u32 previousEndpoint = 0;
+        u32 selectorRun = 0;
+        u32 historyInsert = 0;
+        for (u32 y = 0; y < blocksY; ++y)
+        {
+            PredictorEntry* current = rows.data() + (y & 1) * blocksX;
+            PredictorEntry* upper = rows.data() + ((y & 1) ^ 1) * blocksX;
+            for (u32 x = 0; x < blocksX; ++x)
+            {
+                if ((x & 1) == 0)
+                {
+                    if ((y & 1) == 0)
+                    {
+                        if (predictorRepeat > 0)
+                        {
+                            --predictorRepeat;
+                            predictors = previousPredictors;
+                        } else
+                        {
+                            predictors = reader.Decode(codebooks.endpointPredictorModel);
+                            if (predictors == endpointPredictorRepeatSymbol)
+                            {
+                                predictorRepeat =
+                                        reader.DecodeVlc(endpointPredictorRepeatBits) + endpointPredictorMinRepeat - 1;
+                                predictors = previousPredictors;
+                            } else
+                            {
+                                previousPredictors = predictors;
+                            }
+                        }
+                        // The upper half of the symbol belongs to the two blocks below, which is the next row
+                        upper[x].predictors = static_cast<u8>(predictors >> 4);
+                    } else
+                    {
+                        predictors = current[x].predictors;
+                    }
+                }
+
+                u32 endpoint = previousEndpoint;
+                switch (predictors & 3)
+                {
+                    case 0:
+                        if (x == 0)
+                        {
+                            return false;
+                        }
+                        break;
+                    case 1:
+                        if (y == 0)
+                        {
+                            return false;
+                        }
+                        endpoint = upper[x].endpoint;
+                        break;
+                    case 2:
+                        if (x == 0 || y == 0)
+                        {
+                            return false;
+                        }
+                        endpoint = upper[x - 1].endpoint;
+                        break;
+                    default:
+                        endpoint += reader.Decode(codebooks.deltaEndpointModel);
+                        if (endpoint >= endpointCount)
+                        {
+                            endpoint -= endpointCount;
+                        }
+                        break;
+                }
+                predictors >>= 2;
+                if (endpoint >= endpointCount)
+                {
+                    return false;
+                }
+                current[x].endpoint = static_cast<u16>(endpoint);
+                previousEndpoint = endpoint;
+
+                u32 symbol = selectorCount;
+                if (selectorRun > 0)
+                {
+                    --selectorRun;
+                } else
+                {
+                    symbol = reader.Decode(codebooks.selectorModel);
+                    if (symbol == selectorRunSymbol)
+                    {
+                        const u32 run = reader.Decode(codebooks.selectorRunModel);
+                        selectorRun = run == selectorRunLongSymbol ? reader.DecodeVlc(selectorRunLongBits) + selectorRunMin
+                                                                   : run + selectorRunMin;
+                        if (selectorRun > blockCount)
+                        {
+                            return false;
+                        }
+                        symbol = selectorCount;
+                        --selectorRun;
+                    }
+                }
+
+                u32 selector;
+                if (symbol >= selectorCount)
+                {
+                    // History entries move halfway to the front every time they are used
+                    const u32 index = symbol - selectorCount;
+                    if (index >= historySize)
+                    {
+                        return false;
+                    }
+                    selector = history[index];
+                    std::swap(history[index / 2], history[index]);
+                } else
+                {
+                    selector = symbol;
+                    if (historySize > 0)
+                    {
+                        history[historyInsert++] = static_cast<u16>(selector);
+                        if (historyInsert == historySize)
+                        {
+                            historyInsert = historySize / 2;
+                        }
+                    }
+                }
+                blocks[static_cast<size_t>(y) * blocksX + x] = {static_cast<u16>(endpoint), static_cast<u16>(selector)};
+            }
+        }
+        return !reader.HasFailed();
+    }
+
+    bool UsesAlpha(const KtxTranscodeTarget target)
+    {
+        return target == KtxTranscodeTarget::eRGBA8 || target == KtxTranscodeTarget::eBC3 ||
+               target == KtxTranscodeTarget::eBC5 || target == KtxTranscodeTarget::eBC7 ||
+               target == KtxTranscodeTarget::eETC2RGBA || target == KtxTranscodeTarget::eASTC4x4;
+    }
+
+    u32 GetBlockSize(const KtxTranscodeTarget target)
+    {
+        switch (target)
+        {
+            case KtxTranscodeTarget::eBC1:
+            case KtxTranscodeTarget::eBC4:
+            case KtxTranscodeTarget::eETC2RGB:
+                return 8;
+            default:
+                return 16;
+        }
+    }
+
+    u64 GetImageSize(const u32 width, const u32 height, const KtxTranscodeTarget target)
+    {
+        if (target == KtxTranscodeTarget::eRGBA8)
+        {
+            return static_cast<u64>(width) * height * 4;
+        }
+        return static_cast<u64>((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(target);
+    }
+
+    // Picks the entry of the palette closest to every color the selectors in [low, high] stand for
+    template<u32 Channels>
+    std::array<u32, 4> MapToPalette(const std::array<Color, 4>& colors, const std::span<const Color> palette,
+                                    const u32 low, const u32 high)
+    {
+        std::array<u32, 4> map{};
+        for (u32 selector = low; selector <= high; ++selector)
+        {
+            u32 bestError = ~0u;
+            for (u32 entry = 0; entry < palette.size(); ++entry)
+            {
+                u32 error = 0;
+                for (u32 channel = 0; channel < Channels; ++channel)
+                {
+                    const i32 difference = colors[selector][channel] - palette[entry][channel];
+                    error += static_cast<u32>(difference * difference);
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    map[selector] = entry;
+                }
+            }
+        }
+        return map;
+    }
+
+    std::array<Color, 4> GetChannel(const std::array<Color, 4>& colors, const u32 channel)
+    {
+        std::array<Color, 4> values{};
+        for (u32 selector = 0; selector < 4; ++selector)
+        {
+            values[selector][0] = colors[selector][channel];
+        }
+        return values;
+    }
+
+    void WriteLittleEndian(u8* destination, const u64 value, const u32 byteCount)
+    {
+        for (u32 i = 0; i < byteCount; ++i)
+        {
+            destination[i] = static_cast<u8>(value >> (i * 8));
+        }
+    }
+
+    // BC1 color block between the darkest and brightest color the block uses. BC3 reads the same layout, always with
+    // four colors, so only equal endpoints fall back to a single color.
+    void EncodeBc1(const std::array<Color, 4>& colors, const Selector& selector, u8* destination)
+    {
+        const auto to565 = [](const Color& color)
+        {
+            return static_cast<u16>((color[0] * 31 + 127) / 255 << 11 | (color[1] * 63 + 127) / 255 << 5 |
+                                    (color[2] * 31 + 127) / 255);
+        };
+        const auto expand565 = [](const u16 value)
+        {
+            const u32 r = value >> 11;
+            const u32 g = (value >> 5) & 63;
+            const u32 b = value & 31;
+            return Color{static_cast<u8>(r << 3 | r >> 2), static_cast<u8>(g << 2 | g >> 4),
+                         static_cast<u8>(b << 3 | b >> 2), 255};
+        };
+
+        u16 color0 = to565(colors[selector.high]);
+        u16 color1 = to565(colors[selector.low]);
+        if (color0 < color1)
+        {
+            std::swap(color0, color1);
+        }
+
+        u32 indices = 0;
+        if (color0 != color1)
+        {
+            std::array<Color, 4> palette = {expand565(color0), expand565(color1)};
+            for (u32 channel = 0; channel < 3; ++channel)
+            {
+                palette[2][channel] = static_cast<u8>((2 * palette[0][channel] + palette[1][channel]) / 3);
+                palette[3][channel] = static_cast<u8>((palette[0][channel] + 2 * palette[1][channel]) / 3);
+            }
+            const auto map = MapToPalette<3>(colors, palette, selector.low, selector.high);
+            for (u32 pixel = 0; pixel < 16; ++pixel)
+            {
+                indices |= map[selector.Get(pixel)] << (pixel * 2);
+            }
+        }
+        WriteLittleEndian(destination, color0, 2);
+        WriteLittleEndian(destination + 2, color1, 2);
+        WriteLittleEndian(destination + 4, indices, 4);
+    }
+
+    // Single channel BC4 block (also the alpha half of BC3), values holds the channel in the first component
+    void EncodeBc4(const std::array<Color, 4>& values, const Selector& selector, u8* destination)
+    {
+        const u8 high = values[selector.high][0];
+        const u8 low = values[selector.low][0];
+        u64 indices = 0;
+        if (high != low)
+        {
+            std::array<Color, 8> palette = {Color{high}, Color{low}};
+            for (u32 entry = 2; entry < 8; ++entry)
+            {
+                palette[entry][0] = static_cast<u8>(((8 - entry) * high + (entry - 1) * low) / 7);
+            }
+            const auto map = MapToPalette<1>(values, palette, selector.low, selector.high);
+            for (u32 pixel = 0; pixel < 16; ++pixel)
+            {
+                indices |= static_cast<u64>(map[selector.Get(pixel)]) << (pixel * 3);
+            }
+        }
+        destination[0] = high;
+        destination[1] = low;
+        WriteLittleEndian(destination + 2, indices, 6);
+    }
+
+    // Fills a 128 bit block from the least significant bit up
+    struct BlockWriter
+    {
+        void Put(const u64 value, const u32 count)
+        {
+            for (u32 bit = 0; bit < count; ++bit, ++position)
+            {
+                words[position / 64] |= ((value >> bit) & 1) << (position % 64);
+            }
+        }
+
+        std::array<u64, 2> words{};
+        u32 position = 0;
+    };
+
+    // Two endpoints and 2 bit indices for one channel group of a BC7 mode 5 block. The index of the first pixel loses
+    // its top bit, so the endpoints are swapped whenever it would need it.
+    template<u32 Channels>
+    void FitBc7Mode5(const std::array<Color, 4>& colors, const Selector& selector, const u32 bits,
+                     std::array<u32, Channels * 2>& endpoints, std::array<u32, 16>& indices)
+    {
+        constexpr std::array<u32, 4> weights = {0, 21, 43, 64};
+        std::array<Color, 4> palette{};
+        for (u32 channel = 0; channel < Channels; ++channel)
+        {
+            const u32 maxValue = (1u << bits) - 1;
+            const u32 low = (colors[selector.low][channel] * maxValue + 127) / 255;
+            const u32 high = (colors[selector.high][channel] * maxValue + 127) / 255;
+            endpoints[channel * 2] = low;
+            endpoints[channel * 2 + 1] = high;
+            const u32 lowValue = bits == 8 ? low : low << (8 - bits) | low >> (2 * bits - 8);
+            const u32 highValue = bits == 8 ? high : high << (8 - bits) | high >> (2 * bits - 8);
+            for (u32 entry = 0; entry < 4; ++entry)
+            {
+                palette[entry][channel] =
+                        static_cast<u8>(((64 - weights[entry]) * lowValue + weights[entry] * highValue + 32) >> 6);
+            }
+        }
+
+        const auto map = MapToPalette<Channels>(colors, palette, selector.low, selector.high);
+        const bool swap = map[selector.Get(0)] >= 2;
+        for (u32 pixel = 0; pixel < 16; ++pixel)
+        {
+            const u32 index = map[selector.Get(pixel)];
+            indices[pixel] = swap ? 3 - index : index;
+        }
+        if (swap)
+        {
+            for (u32 channel = 0; channel < Channels; ++channel)
+            {
+                std::swap(endpoints[channel * 2], endpoints[channel * 2 + 1]);
+            }
+        }
+    }
+
+    // BC7 mode 5 keeps color and alpha apart, each with its own indices, like the two slices of ETC1S. alpha holds the
+    // alpha values in the first component, or is nullptr for opaque blocks.
+    void EncodeBc7(const std::array<Color, 4>& colors, const Selector& selector, const std::array<Color, 4>* alpha,
+                   const Selector* alphaSelector, u8* destination)
+    {
+        std::array<u32, 6> colorEndpoints{};
+        std::array<u32, 16> colorIndices{};
+        FitBc7Mode5<3>(colors, selector, 7, colorEndpoints, colorIndices);
+
+        std::array<u32, 2> alphaEndpoints = {255, 255};
+        std::array<u32, 16> alphaIndices{};
+        if (alpha != nullptr)
+        {
+            FitBc7Mode5<1>(*alpha, *alphaSelector, 8, alphaEndpoints, alphaIndices);
+        }
+
+        BlockWriter writer;
+        writer.Put(1u << 5, 6);
+        writer.Put(0, 2);
+        for (const u32 endpoint : colorEndpoints)
+        {
+            writer.Put(endpoint, 7);
+        }
+        for (const u32 endpoint : alphaEndpoints)
+        {
+            writer.Put(endpoint, 8);
+        }
+        for (u32 pixel = 0; pixel < 16; ++pixel)
+        {
+            writer.Put(colorIndices[pixel], pixel == 0 ? 1 : 2);
+        }
+        for (u32 pixel = 0; pixel < 16; ++pixel)
+        {
+            writer.Put(alphaIndices[pixel], pixel == 0 ? 1 : 2);
+        }
+        WriteLittleEndian(destination, writer.words[0], 8);
+        WriteLittleEndian(destination + 8, writer.words[1], 8);
+    }
+
+    // ASTC endpoints of one channel group between the darkest and brightest color the block uses, and the 2 bit weight
+    // of every pixel. endpoints is in ASTC order, the two values of every channel next to each other.
+    template<u32 Channels>
+    void FitAstcEndpoints(const std::array<Color, 4>& colors, const Selector& selector, const u32 range, u8* endpoints,
+                          std::array<u32, 16>& weights)
+    {
+        constexpr std::array<u32, 4> weightValues = {0, 21, 43, 64};
+        std::array<Color, 4> palette{};
+        for (u32 channel = 0; channel < Channels; ++channel)
+        {
+            endpoints[channel * 2] = Uastc::QuantizeEndpoint(range, colors[selector.low][channel]);
+            endpoints[channel * 2 + 1] = Uastc::QuantizeEndpoint(range, colors[selector.high][channel]);
+            const u32 lowValue = Uastc::UnquantizeEndpoint(range, endpoints[channel * 2]);
+            const u32 highValue = Uastc::UnquantizeEndpoint(range, endpoints[channel * 2 + 1]);
+            for (u32 entry = 0; entry < 4; ++entry)
+            {
+                palette[entry][channel] = static_cast<u8>(
+                        ((64 - weightValues[entry]) * lowValue + weightValues[entry] * highValue + 32) >> 6);
+            }
+        }
+
+        const auto map = MapToPalette<Channels>(colors, palette, selector.low, selector.high);
+        for (u32 pixel = 0; pixel < 16; ++pixel)
+        {
+            weights[pixel] = map[selector.Get(pixel)];
+        }
+    }
+
+    // A single subset ASTC 4x4 block with 2 bit weights, alpha goes into a second plane of weights like the second
+    // slice of ETC1S. alpha holds the alpha values in the first component, or is nullptr for opaque blocks.
+    void EncodeAstc(const std::array<Color, 4>& colors, const Selector& selector, const std::array<Color, 4>* alpha,
+                    const Selector* alphaSelector, u8* destination)
+    {
+        Uastc::AstcBlock block{};
+        block.components = alpha != nullptr ? 4 : 3;
+        block.subsets = 1;
+        block.isDualPlane = alpha != nullptr;
+        block.ccs = 3;
+        block.weightRange = 2; // 4 levels, stored in 2 bits
+        block.endpointRange = static_cast<u8>(
+                Uastc::GetEndpointRange(block.subsets, block.components, block.isDualPlane, block.weightRange));
+
+        std::array<u32, 16> colorWeights{};
+        FitAstcEndpoints<3>(colors, selector, block.endpointRange, block.endpoints.data(), colorWeights);
+        std::array<u32, 16> alphaWeights{};
+        if (alpha != nullptr)
+        {
+            FitAstcEndpoints<1>(*alpha, *alphaSelector, block.endpointRange, block.endpoints.data() + 6, alphaWeights);
+        }
+        for (u32 pixel = 0; pixel < 16; ++pixel)
+        {
+            if (block.isDualPlane)
+            {
+                block.weights[pixel * 2] = static_cast<u8>(colorWeights[pixel]);
+                block.weights[pixel * 2 + 1] = static_cast<u8>(alphaWeights[pixel]);
+            } else
+            {
+                block.weights[pixel] = static_cast<u8>(colorWeights[pixel]);
+            }
+        }
+        Uastc::PackAstcBlock(block, destination);
+    }
+
+    struct EacBlock
+    {
+        u8 base;
+        u8 multiplierAndTable;
+        // EAC index for every selector
+        std::array<u8, 4> map;
+    };
+
+    EacBlock FitEacBlock(const std::array<i32, 4>& values, const u32 low, const u32 high)
+    {
+        EacBlock best{};
+        u32 bestError = ~0u;
+        for (u32 table = 0; table < Etc::eacModifiers.size(); ++table)
+        {
+            const auto& modifiers = Etc::eacModifiers[table];
+            const i32 span = modifiers[7] - modifiers[3];
+            const i32 guess = std::clamp((values[high] - values[low] + span / 2) / span, 1, 15);
+            for (i32 multiplier = std::max(guess - 1, 1); multiplier <= std::min(guess + 1, 15); ++multiplier)
+            {
+                const i32 base = ClampToByte(
+                        (values[low] + values[high] - (modifiers[3] + modifiers[7]) * multiplier + 1) / 2);
+                EacBlock block{static_cast<u8>(base), static_cast<u8>(multiplier << 4 | table), {}};
+                u32 error = 0;
+                for (u32 selector = low; selector <= high; ++selector)
+                {
+                    u32 selectorError = ~0u;
+                    for (u32 index = 0; index < 8; ++index)
+                    {
+                        const i32 difference = ClampToByte(base + modifiers[index] * multiplier) - values[selector];
+                        if (static_cast<u32>(difference * difference) < selectorError)
+                        {
+                            selectorError = static_cast<u32>(difference * difference);
+                            block.map[selector] = static_cast<u8>(index);
+                        }
+                    }
+                    error += selectorError;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best = block;
+                }
+            }
+        }
+        return best;
+    }
+
+    // The values of a single channel ETC1S block only depend on its 5 bit value and modifier table, so the best EAC
+    // block for every combination and selector range is searched once per process
+    const EacBlock& GetEacBlock(const Endpoint& endpoint, const Selector& selector)
+    {
+        static const std::vector<EacBlock> blocks = []
+        {
+            std::vector<EacBlock> table(32 * 8 * 16);
+            for (u32 value5 = 0; value5 < 32; ++value5)
+            {
+                for (u32 intensity = 0; intensity < 8; ++intensity)
+                {
+                    std::array<i32, 4> values{};
+                    for (u32 selector = 0; selector < 4; ++selector)
+                    {
+                        values[selector] = ClampToByte(static_cast<i32>(Expand5(value5)) +
+                                                       etc1Modifiers[intensity][selector]);
+                    }
+                    for (u32 low = 0; low < 4; ++low)
+                    {
+                        for (u32 high = low; high < 4; ++high)
+                        {
+                            table[(value5 * 8 + intensity) * 16 + low * 4 + high] = FitEacBlock(values, low, high);
+                        }
+                    }
+                }
+            }
+            return table;
+        }();
+        return blocks[(endpoint.value5 * 8u + endpoint.intensity) * 16 + selector.low * 4u + selector.high];
+    }
+
+    void EncodeEacAlpha(const Endpoint* endpoint, const Selector* selector, u8* destination)
+    {
+        // Without alpha every pixel is 255 plus the 0 modifier of table 13
+        const EacBlock opaque{255, 1 << 4 | 13, {4, 4, 4, 4}};
+        const EacBlock& block = endpoint != nullptr ? GetEacBlock(*endpoint, *selector) : opaque;
+        u64 indices = 0;
+        for (u32 x = 0; x < 4; ++x)
+        {
+            for (u32 y = 0; y < 4; ++y)
+            {
+                const u32 value = selector != nullptr ? selector->Get(y * 4 + x) : 0;
+                indices |= static_cast<u64>(block.map[value]) << (45 - (x * 4 + y) * 3);
+            }
+        }
+        destination[0] = block.base;
+        destination[1] = block.multiplierAndTable;
+        for (u32 i = 0; i < 6; ++i)
+        {
+            destination[2 + i] = static_cast<u8>(indices >> (40 - i * 8));
+        }
+    }
+
+    // Transcodes one image (a layer, face or z slice of a level), destination is exactly GetImageSize bytes
+    KtxResult TranscodeImage(const BasisLZCodebooks& codebooks, const BasisLZImageDesc& desc,
+                             const std::span<const u8> levelData, const u32 width, const u32 height,
+                             const KtxTranscodeTarget target, const std::span<u8> destination)
+    {
+        if (desc.imageFlags & pFrameFlag)
+        {
+            return KtxResult::eUnsupportedFeature;
+        }
+        const u32 blocksX = (width + 3) / 4;
+        const u32 blocksY = (height + 3) / 4;
+        const size_t blockCount = static_cast<size_t>(blocksX) * blocksY;
+
+        // Reused by every image this thread transcodes
+        thread_local std::vector<BlockIndices> colorBlocks;
+        thread_local std::vector<BlockIndices> alphaBlocks;
+        colorBlocks.resize(blockCount);
+        if (!IsInRange(levelData, desc.rgbSliceByteOffset, desc.rgbSliceByteLength) ||
+            !DecodeSlice(codebooks, levelData.subspan(desc.rgbSliceByteOffset, desc.rgbSliceByteLength), blocksX,
+                         blocksY, colorBlocks))
+        {
+            return KtxResult::eFileDataError;
+        }
+        const bool hasAlpha = desc.alphaSliceByteLength > 0 && UsesAlpha(target);
+        if (hasAlpha)
+        {
+            alphaBlocks.resize(blockCount);
+            if (!IsInRange(levelData, desc.alphaSliceByteOffset, desc.alphaSliceByteLength) ||
+                !DecodeSlice(codebooks, levelData.subspan(desc.alphaSliceByteOffset, desc.alphaSliceByteLength),
+                             blocksX, blocksY, alphaBlocks))
+            {
+                return KtxResult::eFileDataError;
+            }
+        }
+
+        const u32 blockSize = GetBlockSize(target);
+        for (u32 blockY = 0; blockY < blocksY; ++blockY)
+        {
+            for (u32 blockX = 0; blockX < blocksX; ++blockX)
+            {
+                const size_t block = static_cast<size_t>(blockY) * blocksX + blockX;
+                const Endpoint& endpoint = codebooks.endpoints[colorBlocks[block].endpoint];
+                const Selector& selector = codebooks.selectors[colorBlocks[block].selector];
+                const Endpoint* alphaEndpoint = hasAlpha ? &codebooks.endpoints[alphaBlocks[block].endpoint] : nullptr;
+                const Selector* alphaSelector = hasAlpha ? &codebooks.selectors[alphaBlocks[block].selector] : nullptr;
+                u8* output = destination.data() + block * blockSize;
+
+                switch (target)
+                {
+                    case KtxTranscodeTarget::eRGBA8:
+                        for (u32 y = 0; y < 4 && blockY * 4 + y < height; ++y)
+                        {
+                            u8* row = destination.data() + ((static_cast<size_t>(blockY) * 4 + y) * width + blockX * 4) * 4;
+                            for (u32 x = 0; x < 4 && blockX * 4 + x < width; ++x)
+                            {
+                                std::memcpy(row + x * 4, endpoint.colors[selector.Get(y * 4 + x)].data(), 4);
+                                if (hasAlpha)
+                                {
+                                    row[x * 4 + 3] = alphaEndpoint->colors[alphaSelector->Get(y * 4 + x)][1];
+                                }
+                            }
+                        }
+                        break;
+                    case KtxTranscodeTarget::eBC1:
+                        EncodeBc1(endpoint.colors, selector, output);
+                        break;
+                    case KtxTranscodeTarget::eBC3:
+                        if (hasAlpha)
+                        {
+                            EncodeBc4(GetChannel(alphaEndpoint->colors, 1), *alphaSelector, output);
+                        } else
+                        {
+                            std::memcpy(output, std::array<u8, 8>{255, 255}.data(), 8);
+                        }
+                        EncodeBc1(endpoint.colors, selector, output + 8);
+                        break;
+                    case KtxTranscodeTarget::eBC4:
+                        EncodeBc4(GetChannel(endpoint.colors, 0), selector, output);
+                        break;
+                    case KtxTranscodeTarget::eBC5:
+                        EncodeBc4(GetChannel(endpoint.colors, 0), selector, output);
+                        if (hasAlpha)
+                        {
+                            EncodeBc4(GetChannel(alphaEndpoint->colors, 1), *alphaSelector, output + 8);
+                        } else
+                        {
+                            EncodeBc4(GetChannel(endpoint.colors, 1), selector, output + 8);
+                        }
+                        break;
+                    case KtxTranscodeTarget::eBC7:
+                        if (hasAlpha)
+                        {
+                            const auto alpha = GetChannel(alphaEndpoint->colors, 1);
+                            EncodeBc7(endpoint.colors, selector, &alpha, alphaSelector, output);
+                        } else
+                        {
+                            EncodeBc7(endpoint.colors, selector, nullptr, nullptr, output);
+                        }
+                        break;
+                    case KtxTranscodeTarget::eASTC4x4:
+                        if (hasAlpha)
+                        {
+                            const auto alpha = GetChannel(alphaEndpoint->colors, 1);
+                            EncodeAstc(endpoint.colors, selector, &alpha, alphaSelector, output);
+                        } else
+                        {
+                            EncodeAstc(endpoint.colors, selector, nullptr, nullptr, output);
+                        }
+                        break;
+                    case KtxTranscodeTarget::eETC2RGB:
+                        std::memcpy(output, endpoint.etc1Header.data(), 4);
+                        std::memcpy(output + 4, selector.etc1Indices.data(), 4);
+                        break;
+                    case KtxTranscodeTarget::eETC2RGBA:
+                        EncodeEacAlpha(alphaEndpoint, alphaSelector, output);
+                        std::memcpy(output + 8, endpoint.etc1Header.data(), 4);
+                        std::memcpy(output + 12, selector.etc1Indices.data(), 4);
+                        break;
+                }
+            }
+        }
+        return KtxResult::eSuccess;
+    }
+} // namespace
+
+struct KTX::KtxTranscoder::Impl
+{
+    KtxTextureInfo info;
+    BasisLZCodebooks codebooks;
+    // Index of the first image descriptor of every level
+    std::vector<u32> firstImages;
+    bool srgb;
+    // UASTC textures leave the codebooks empty, alpha comes from the DFD instead of the slices
+    bool isUastc;
+    bool hasAlpha;
+
+    [[nodiscard]] u32 GetImageCount(const u32 level) const
+    {
+        return info.numLayers * info.numFaces * std::max(info.baseDepth >> level, 1u);
+    }
+    [[nodiscard]] u32 GetWidth(const u32 level) const { return std::max(info.baseWidth >> level, 1u); }
+    [[nodiscard]] u32 GetHeight(const u32 level) const { return std::max(info.baseHeight >> level, 1u); }
+
+    // UASTC images are 16 bytes per block like ASTC 4x4, destination is the whole transcoded image
+    [[nodiscard]] KtxResult TranscodeUastcRows(const u32 level, const u32 image, const std::span<const u8> levelData,
+                                               const KtxTranscodeTarget target, const u32 firstRow,
+                                               const u32 rowCount, const std::span<u8> destination) const
+    {
+        const u64 imageSize = GetImageSize(GetWidth(level), GetHeight(level), KtxTranscodeTarget::eASTC4x4);
+        if (!IsInRange(levelData, image * imageSize, imageSize))
+        {
+            return KtxResult::eFileDataError;
+        }
+        return Uastc::TranscodeRows(levelData.subspan(image * imageSize, imageSize), GetWidth(level), GetHeight(level),
+                                    firstRow, rowCount, target, srgb, hasAlpha, destination);
+    }
+};
+
+KTX::u32 KTX::GetTranscodeTargetVkFormat(const KtxTranscodeTarget target, const bool srgb)
+{
+    using enum KtxUtility_VkFormat;
+    KtxUtility_VkFormat format = VK_FORMAT_UNDEFINED;
+    switch (target)
+    {
+        case KtxTranscodeTarget::eRGBA8:
+            format = srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+            break;
+        case KtxTranscodeTarget::eBC1:
+            format = srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+            break;
+        case KtxTranscodeTarget::eBC3:
+            format = srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+            break;
+        case KtxTranscodeTarget::eBC4:
+            format = VK_FORMAT_BC4_UNORM_BLOCK;
+            break;
+        case KtxTranscodeTarget::eBC5:
+            format = VK_FORMAT_BC5_UNORM_BLOCK;
+            break;
+        case KtxTranscodeTarget::eBC7:
+            format = srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+            break;
+        case KtxTranscodeTarget::eETC2RGB:
+            format = srgb ? VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK : VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+            break;
+        case KtxTranscodeTarget::eETC2RGBA:
+            format = srgb ? VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK : VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+            break;
+        case KtxTranscodeTarget::eASTC4x4:
+            format = srgb ? VK_FORMAT_ASTC_4x4_SRGB_BLOCK : VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+            break;
+    }
+    return static_cast<u32>(format);
+}
+
+KTX::KtxTranscoder::KtxTranscoder(std::unique_ptr<Impl> impl) : impl(std::move(impl)) {}
+
+KTX::KtxTranscoder::~KtxTranscoder() = default;
+
+KTX::KtxTranscoder::KtxTranscoder(KtxTranscoder&& other) noexcept = default;
+
+KTX::KtxTranscoder& KTX::KtxTranscoder::operator=(KtxTranscoder&& other) noexcept = default;
+
+std::expected<KTX::KtxTranscoder, KTX::KtxResult> KTX::KtxTranscoder::Create(const KtxTexture& texture)
+{
+    const auto& info = texture.GetInfo();
+    // Color model of the basic descriptor block
+    const auto dfd = texture.GetDataFormatDescriptor();
+    const bool isUastc = info.isKtx2 && dfd.size() > 12 && dfd[12] == uastcColorModel;
+    if (!info.isKtx2 ||
+        (!isUastc && info.superCompressionScheme != static_cast<u32>(KtxSupercompressionScheme::eBasisLZ)))
+    {
+        return std::unexpected(KtxResult::eUnsupportedFeature);
+    }
+
+    auto impl = std::make_unique<Impl>();
+    impl->info = info;
+    impl->isUastc = isUastc;
+    u32 imageCount = 0;
+    for (u32 level = 0; level < info.numLevels; ++level)
+    {
+        impl->firstImages.push_back(imageCount);
+        imageCount += impl->GetImageCount(level);
+    }
+    if (!isUastc)
+    {
+        if (const auto result = DecodeGlobalData(texture.GetSuperCompressionGlobalData(), imageCount, impl->codebooks);
+            result != KtxResult::eSuccess)
+        {
+            return std::unexpected(result);
+        }
+    }
+
+    // Transfer function of the basic descriptor block, 2 is sRGB
+    impl->srgb = dfd.size() > 14 && dfd[14] == 2;
+    // Channel id of the first sample
+    const u8 channel = dfd.size() > 31 ? dfd[31] & 0xF : 0;
+    impl->hasAlpha = isUastc && (channel == uastcRgbaChannel || channel == uastcRrrgChannel);
+    return KtxTranscoder(std::move(impl));
+}
+
+bool KTX::KtxTranscoder::HasAlpha() const
+{
+    if (impl->isUastc)
+    {
+        return impl->hasAlpha;
+    }
+    const auto& imageDescs = impl->codebooks.imageDescs;
+    return !imageDescs.empty() && imageDescs.front().alphaSliceByteLength > 0;
+}
+
+bool KTX::KtxTranscoder::IsSrgb() const
+{
+    return impl->srgb;
+}
+
+KTX::u64 KTX::KtxTranscoder::GetTranscodedLevelSize(const u32 level, const KtxTranscodeTarget target) const
+{
+    assert(level < impl->info.numLevels && "Level out of range");
+    return GetImageSize(impl->GetWidth(level), impl->GetHeight(level), target) * impl->GetImageCount(level);
+}
+
+KTX::KtxResult KTX::KtxTranscoder::TranscodeLevel(const u32 level, const std::span<const u8> levelData,
+                                                  const KtxTranscodeTarget target, const std::span<u8> destination) const
+{
+    assert(destination.size() >= GetTranscodedLevelSize(level, target) && "Destination is too small");
+    const u64 imageSize = GetImageSize(impl->GetWidth(level), impl->GetHeight(level), target);
+    for (u32 image = 0; image < impl->GetImageCount(level); ++image)
+    {
+        if (impl->isUastc)
+        {
+            if (const auto result =
+                        impl->TranscodeUastcRows(level, image, levelData, target, 0, (impl->GetHeight(level) + 3) / 4,
+                                                 destination.subspan(image * imageSize, imageSize));
+                result != KtxResult::eSuccess)
+            {
+                return result;
+            }
+            continue;
+        }
+        const auto& desc = impl->codebooks.imageDescs[impl->firstImages[level] + image];
+        if (const auto result = TranscodeImage(impl->codebooks, desc, levelData, impl->GetWidth(level),
+                                               impl->GetHeight(level), target,
+                                               destination.subspan(image * imageSize, imageSize));
+            result != KtxResult::eSuccess)
+        {
+            return result;
+        }
+    }
+    return KtxResult::eSuccess;
+}
+
+std::expected<KTX::KtxTexture, KTX::KtxResult> KTX::KtxTranscoder::Transcode(KtxThreadPool& pool, KtxTexture& texture,
+                                                                           const KtxTranscodeTarget target) const
+{
+    const auto& info = impl->info;
+    // Stored levels, read up front unless the image data is loaded
+    std::vector<std::vector<u8>> readLevels;
+    readLevels.reserve(info.numLevels);
+    std::vector<std::span<const u8>> levelData(info.numLevels);
+    for (u32 level = 0; level < info.numLevels; ++level)
+    {
+        if (texture.HasImageData())
+        {
+            levelData[level] = texture.GetLevel(level);
+            continue;
+        }
+        // Zstd and zlib levels come out of ReadLevel decoded, BasisLZ ones as stored
+        const auto& entry = texture.GetLevelIndex()[level];
+        const bool isDecoded = info.superCompressionScheme == static_cast<u32>(KtxSupercompressionScheme::eZstd) ||
+                               info.superCompressionScheme == static_cast<u32>(KtxSupercompressionScheme::eZlib);
+        auto& stored = readLevels.emplace_back(isDecoded ? entry.uncompressedByteLength : entry.byteLength);
+        if (!texture.ReadLevel(level, stored))
+        {
+            return std::unexpected(KtxResult::eFileReadError);
+        }
+        levelData[level] = stored;
+    }
+
+    struct ImageTask
+    {
+        u32 level;
+        u32 image;
+        u64 destinationOffset;
+        // Band of block rows, UASTC only
+        u32 firstRow;
+        u32 rowCount;
+    };
+    std::vector<ImageTask> tasks;
+    std::vector<KtxLevelRange> levels;
+    u64 dataSize = 0;
+    for (u32 level = 0; level < info.numLevels; ++level)
+    {
+        const u64 imageSize = GetImageSize(impl->GetWidth(level), impl->GetHeight(level), target);
+        const u32 blocksX = (impl->GetWidth(level) + 3) / 4;
+        const u32 blocksY = (impl->GetHeight(level) + 3) / 4;
+        const u32 bandRows = impl->isUastc ? std::max(uastcBandBlocks / blocksX, 1u) : blocksY;
+        for (u32 image = 0; image < impl->GetImageCount(level); ++image)
+        {
+            for (u32 row = 0; row < blocksY; row += bandRows)
+            {
+                tasks.push_back({.level = level,
+                                 .image = image,
+                                 .destinationOffset = dataSize + image * imageSize,
+                                 .firstRow = row,
+                                 .rowCount = std::min(bandRows, blocksY - row)});
+            }
+        }
+        levels.push_back({.byteOffset = dataSize, .byteLength = GetTranscodedLevelSize(level, target)});
+        dataSize += levels.back().byteLength;
+    }
+
+    // Every image (or UASTC band) is independent, level 0 comes first so the largest tasks start early
+    auto data = std::make_unique_for_overwrite<u8[]>(dataSize);
+    std::vector results(tasks.size(), KtxResult::eSuccess);
+    pool.ParallelFor(static_cast<u32>(tasks.size()),
+                     [&](const u32 index)
+                     {
+                         const auto& task = tasks[index];
+                         const u32 width = impl->GetWidth(task.level);
+                         const u32 height = impl->GetHeight(task.level);
+                         const std::span destination(data.get() + task.destinationOffset,
+                                                     GetImageSize(width, height, target));
+                         if (impl->isUastc)
+                         {
+                             results[index] = impl->TranscodeUastcRows(task.level, task.image, levelData[task.level],
+                                                                       target, task.firstRow, task.rowCount,
+                                                                       destination);
+                             return;
+                         }
+                         results[index] = TranscodeImage(
+                                 impl->codebooks, impl->codebooks.imageDescs[impl->firstImages[task.level] + task.image],
+                                 levelData[task.level], width, height, target, destination);
+                     });
+    for (const auto result : results)
+    {
+        if (result != KtxResult::eSuccess)
+        {
+            return std::unexpected(result);
+        }
+    }
+
+    KtxTextureInfo transcodedInfo = info;
+    transcodedInfo.vkFormat = GetTranscodeTargetVkFormat(target, impl->srgb);
+    transcodedInfo.formatSize = GetVkFormatSize(transcodedInfo.vkFormat);
+    transcodedInfo.isCompressed = transcodedInfo.formatSize.flags & KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
+    transcodedInfo.glInternalFormat = GetGlFormatFromVk(transcodedInfo.vkFormat);
+    transcodedInfo.typeSize = 1;
+    transcodedInfo.superCompressionScheme = static_cast<u32>(KtxSupercompressionScheme::eNone);
+
+    const auto keyValueData = texture.GetKeyValueData();
+    KtxTexture transcoded(transcodedInfo, std::vector<u8>(keyValueData.begin(), keyValueData.end()));
+    transcoded.SetImageData(std::move(data), dataSize, std::move(levels));
+    return transcoded;
+}
@@ -0,0 +1,1493 @@
+#include "KtxUastc.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#include "KtxAstc.hpp"
+#include "KtxBc7.hpp"
+#include "KtxEtc.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+    using namespace KTX;
+    using Uastc::AstcBlock;
+    using Astc::colorUnquantization;
+    using Astc::DecodeQuints;
+    using Astc::DecodeTrits;
+    using Astc::GetIseBitCount;
+    using Astc::IseRange;
+    using Astc::iseRanges;
+    using Astc::ReverseBits;
+    using Astc::weightRangeCount;
+    using Astc::weightUnquantization;
+    using Color = std::array<u8, 4>;
+    using Pixels = std::array<Color, 16>;
+    using EndpointPair = std::array<Color, 2>;
+
+    struct ModeDesc
+    {
+        u8 code;
+        u8 codeLength;
+        // Transcoding hints between the mode and the partition pattern, skipped as every target is built from the
+        // ASTC form of the block
+        u8 hintBits;
+        // Partition patterns the mode picks from, 0 for single subset modes
+        u8 patternCount;
+        u8 subsets;
+        u8 components;
+        bool isDualPlane;
+        u8 endpointRange;
+        u8 weightBits;
+    };
+
+    // The mode is prefix coded in the lowest bits of the block. The code 0x45 (7 bits) is reserved for future use.
+    constexpr std::array<ModeDesc, 19> modes = {{
+            {0x01, 4, 15, 0, 1, 3, false, 19, 4},
+            {0x35, 6, 15, 0, 1, 3, false, 20, 2},
+            {0x1D, 5, 15, 30, 2, 3, false, 8, 3},
+            {0x03, 5, 15, 11, 3, 3, false, 7, 2},
+            {0x13, 5, 15, 30, 2, 3, false, 12, 2},
+            {0x0B, 5, 15, 0, 1, 3, false, 20, 3},
+            {0x1B, 5, 15, 0, 1, 3, true, 18, 2},
+            {0x07, 5, 15, 19, 2, 3, false, 12, 2},
+            {0x17, 5, 0, 0, 1, 4, false, 0, 0},
+            {0x0F, 5, 23, 30, 2, 4, false, 8, 2},
+            {0x02, 3, 17, 0, 1, 4, false, 13, 4},
+            {0x00, 2, 17, 0, 1, 4, true, 13, 2},
+            {0x06, 3, 17, 0, 1, 4, false, 19, 3},
+            {0x1F, 5, 23, 0, 1, 4, true, 20, 1},
+            {0x0D, 5, 23, 0, 1, 2, false, 20, 2},
+            {0x05, 7, 23, 0, 1, 2, false, 20, 4},
+            {0x15, 6, 23, 30, 2, 2, false, 20, 2},
+            {0x25, 6, 23, 0, 1, 2, true, 20, 2},
+            {0x09, 4, 15, 0, 1, 3, false, 11, 5},
+    }};
+    constexpr u32 solidMode = 8;
+    // The only dual plane mode without a ccs field, its second plane is always alpha
+    constexpr u32 luminanceAlphaDualPlaneMode = 17;
+
+    constexpr std::array<u8, 128> modeLookup = []
+    {
+        std::array<u8, 128> lookup{};
+        for (u32 bits = 0; bits < lookup.size(); ++bits)
+        {
+            lookup[bits] = static_cast<u8>(modes.size());
+            for (u32 mode = 0; mode < modes.size(); ++mode)
+            {
+                if ((bits & ((1u << modes[mode].codeLength) - 1)) == modes[mode].code)
+                {
+                    lookup[bits] = static_cast<u8>(mode);
+                }
+            }
+        }
+        return lookup;
+    }();
+
+    // ASTC partition seeds of the patterns UASTC shares with BC7, indexed by the pattern field of the block
+    constexpr std::array<u16, 30> partitionSeeds2 = {28,  20,  16,  29,  91,  9,   107, 72,  149, 204,
+                                                     50,  114, 496, 17,  78,  39,  252, 828, 43,  156,
+                                                     116, 210, 476, 273, 684, 359, 246, 195, 694, 524};
+    constexpr std::array<u16, 11> partitionSeeds3 = {260, 74, 32, 156, 183, 15, 745, 0, 335, 902, 254};
+    // Mode 7 uses two subset ASTC patterns that are BC7 three subset patterns with two subsets merged
+    constexpr std::array<u16, 19> partitionSeeds7 = {36,  48,  61,  137, 161, 183, 226, 281, 302, 307,
+                                                     479, 495, 593, 594, 605, 799, 812, 988, 993};
+
+    // Weight range of a power of two number of levels
+    constexpr u32 GetWeightRange(const u32 bits)
+    {
+        for (u32 range = 0; range < weightRangeCount; ++range)
+        {
+            if (iseRanges[range].bits == bits && iseRanges[range].trits == 0 && iseRanges[range].quints == 0)
+            {
+                return range;
+            }
+        }
+        return 0;
+    }
+
+    // Inverses of DecodeTrits and DecodeQuints, indexed by t0 + 3 t1 + 9 t2 + 27 t3 + 81 t4 and q0 + 5 q1 + 25 q2. The
+    // smallest encoding wins, which keeps the top bits clear when the trailing digits are 0, as truncated groups need.
+    constexpr auto tritEncodings = []
+    {
+        std::array<u8, 243> encodings{};
+        std::array<bool, 243> isSet{};
+        for (u32 packed = 0; packed < 256; ++packed)
+        {
+            const auto trits = DecodeTrits(packed);
+            const u32 index = trits[0] + 3 * trits[1] + 9 * trits[2] + 27 * trits[3] + 81 * trits[4];
+            if (!isSet[index])
+            {
+                encodings[index] = static_cast<u8>(packed);
+                isSet[index] = true;
+            }
+        }
+        return encodings;
+    }();
+    constexpr auto quintEncodings = []
+    {
+        std::array<u8, 125> encodings{};
+        std::array<bool, 125> isSet{};
+        for (u32 packed = 0; packed < 128; ++packed)
+        {
+            const auto quints = DecodeQuints(packed);
+            const u32 index = quints[0] + 5 * quints[1] + 25 * quints[2];
+            if (!isSet[index])
+            {
+                encodings[index] = static_cast<u8>(packed);
+                isSet[index] = true;
+            }
+        }
+        return encodings;
+    }();
+
+    struct Partition
+    {
+        // Subset of every texel, 2 bits each
+        u32 texels;
+        // The first texel of every subset, whose weight is stored with one bit less
+        u16 anchors;
+    };
+
+    const Partition& GetPartition(const u32 subsets, const u32 seed)
+    {
+        static const std::vector<Partition> partitions = []
+        {
+            std::vector<Partition> table(2 * 1024);
+            for (u32 subsetCount = 2; subsetCount <= 3; ++subsetCount)
+            {
+                for (u32 seedIndex = 0; seedIndex < 1024; ++seedIndex)
+                {
+                    auto& partition = table[(subsetCount - 2) * 1024 + seedIndex];
+                    const auto hash = Astc::HashPartitionSeed(seedIndex, subsetCount);
+                    u32 seen = 0;
+                    for (u32 texel = 0; texel < 16; ++texel)
+                    {
+                        // 4x4 blocks are small enough for doubled coordinates
+                        const u32 subset = Astc::SelectPartition(hash, texel % 4 * 2, texel / 4 * 2);
+                        partition.texels |= subset << (texel * 2);
+                        if ((seen & (1u << subset)) == 0)
+                        {
+                            seen |= 1u << subset;
+                            partition.anchors |= static_cast<u16>(1u << texel);
+                        }
+                    }
+                }
+            }
+            return table;
+        }();
+        static constexpr Partition singleSubset = {0, 1};
+        return subsets == 1 ? singleSubset : partitions[(subsets - 2) * 1024 + seed];
+    }
+
+    // LSB first reader over the 128 bits of a block
+    class BlockReader
+    {
+    public:
+        explicit BlockReader(const u8* data) { std::memcpy(words.data(), data, sizeof(words)); }
+
+        u32 Get(const u32 count)
+        {
+            assert(count <= 32 && position + count <= 128 && "Read past the end of the block");
+            if (count == 0)
+            {
+                return 0;
+            }
+            const u32 shift = position % 64;
+            u64 value = words[position / 64] >> shift;
+            if (shift + count > 64)
+            {
+                value |= words[1] << (64 - shift);
+            }
+            position += count;
+            return static_cast<u32>(value & ((u64{1} << count) - 1));
+        }
+
+        void Skip(const u32 count) { position += count; }
+
+    private:
+        std::array<u64, 2> words{};
+        u32 position = 0;
+    };
+
+    // LSB first writer into the 128 bits of a block
+    struct BlockWriter
+    {
+        void Put(const u32 value, const u32 count)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+            const u64 masked = value & ((u64{1} << count) - 1);
+            const u32 shift = position % 64;
+            words[position / 64] |= masked << shift;
+            if (shift + count > 64)
+            {
+                words[1] |= masked >> (64 - shift);
+            }
+            position += count;
+        }
+
+        void Store(u8* destination) const { std::memcpy(destination, words.data(), sizeof(words)); }
+
+        std::array<u64, 2> words{};
+        u32 position = 0;
+    };
+
+    // ASTC integer sequence encoding: trits go in groups of 5 and quints in groups of 3, with their packed bits spread
+    // between the plain bits of the values
+    void PutIse(BlockWriter& writer, const u8* values, const u32 count, const IseRange& range)
+    {
+        const u32 bitMask = (1u << range.bits) - 1;
+        if (range.trits == 0 && range.quints == 0)
+        {
+            for (u32 i = 0; i < count; ++i)
+            {
+                writer.Put(values[i], range.bits);
+            }
+            return;
+        }
+
+        constexpr std::array<u8, 5> tritBits = {2, 2, 1, 2, 1};
+        constexpr std::array<u8, 3> quintBits = {3, 2, 2};
+        const u32 groupSize = range.trits ? 5 : 3;
+        const u32 base = range.trits ? 3 : 5;
+        for (u32 first = 0; first < count; first += groupSize)
+        {
+            const u32 groupCount = std::min(count - first, groupSize);
+            u32 index = 0;
+            for (u32 k = groupCount; k-- > 0;)
+            {
+                index = index * base + (values[first + k] >> range.bits);
+            }
+            const u32 packed = range.trits ? tritEncodings[index] : quintEncodings[index];
+            u32 shift = 0;
+            for (u32 k = 0; k < groupCount; ++k)
+            {
+                const u32 packedBits = range.trits ? tritBits[k] : quintBits[k];
+                writer.Put(values[first + k] & bitMask, range.bits);
+                writer.Put(packed >> shift, packedBits);
+                shift += packedBits;
+            }
+        }
+    }
+
+    // 11 bit ASTC block mode of a 4x4 weight grid
+    u32 GetBlockMode(const u32 weightRange, const bool isDualPlane)
+    {
+        // The range is split into a high bit and a 3 bit value from 2 to 7
+        const u32 high = weightRange >= 6 ? 1 : 0;
+        const u32 r = weightRange % 6 + 2;
+        constexpr u32 gridA = 2; // Height - 2
+        constexpr u32 gridB = 0; // Width - 4
+        return (r >> 1) | (r & 1) << 4 | gridA << 5 | gridB << 7 | high << 9 | (isDualPlane ? 1u : 0u) << 10;
+    }
+
+    std::array<EndpointPair, 3> GetEndpoints(const AstcBlock& block)
+    {
+        const auto& table = colorUnquantization[block.endpointRange];
+        std::array<EndpointPair, 3> endpoints{};
+        for (u32 subset = 0; subset < block.subsets; ++subset)
+        {
+            const u8* values = block.endpoints.data() + subset * block.components * 2;
+            for (u32 end = 0; end < 2; ++end)
+            {
+                auto& color = endpoints[subset][end];
+                switch (block.components)
+                {
+                    case 2:
+                        color = {table[values[end]], table[values[end]], table[values[end]], table[values[2 + end]]};
+                        break;
+                    case 3:
+                        color = {table[values[end]], table[values[2 + end]], table[values[4 + end]], 255};
+                        break;
+                    default:
+                        color = {table[values[end]], table[values[2 + end]], table[values[4 + end]],
+                                 table[values[6 + end]]};
+                        break;
+                }
+            }
+        }
+        return endpoints;
+    }
+
+    // Unquantized weight (0..64) of a texel, plane 1 is the one the ccs channel uses
+    u8 GetWeight(const AstcBlock& block, const u32 texel, const u32 plane)
+    {
+        return weightUnquantization[block.weightRange][block.weights[block.isDualPlane ? texel * 2 + plane : texel]];
+    }
+
+    // ASTC LDR interpolation of the 64 channels of a block: ((low * (64 - weight) + high * weight + 32) >> 6) >> 8.
+    // Endpoints come expanded to 16 bits, so the products need 32 bit lanes.
+    void Interpolate(const u32* low, const u32* high, const u32* weights, u8* out)
+    {
+        u32 i = 0;
+#if defined(__AVX2__)
+        const __m256i sixtyFour = _mm256_set1_epi32(64);
+        const __m256i round = _mm256_set1_epi32(32);
+        const auto lerp = [&](const u32 offset)
+        {
+            const __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(low + offset));
+            const __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(high + offset));
+            const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + offset));
+            const __m256i sum = _mm256_add_epi32(_mm256_mullo_epi32(l, _mm256_sub_epi32(sixtyFour, w)),
+                                                 _mm256_mullo_epi32(h, w));
+            return _mm256_srli_epi32(_mm256_add_epi32(sum, round), 14);
+        };
+        for (; i < 64; i += 16)
+        {
+            // The 256 bit pack works per 128 bit lane, the permute puts the 16 bit results back in order
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(lerp(i), lerp(i + 8)), 0xD8);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                             _mm_packus_epi16(_mm256_castsi256_si128(packed), _mm256_extracti128_si256(packed, 1)));
+        }
+#elif defined(__SSE4_1__)
+        const __m128i sixtyFour = _mm_set1_epi32(64);
+        const __m128i round = _mm_set1_epi32(32);
+        const auto lerp = [&](const u32 offset)
+        {
+            const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(low + offset));
+            const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(high + offset));
+            const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + offset));
+            const __m128i sum = _mm_add_epi32(_mm_mullo_epi32(l, _mm_sub_epi32(sixtyFour, w)), _mm_mullo_epi32(h, w));
+            return _mm_srli_epi32(_mm_add_epi32(sum, round), 14);
+        };
+        for (; i < 64; i += 16)
+        {
+            const __m128i first = _mm_packus_epi32(lerp(i), lerp(i + 4));
+            const __m128i second = _mm_packus_epi32(lerp(i + 8), lerp(i + 12));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(first, second));
+        }
+#elif defined(__ARM_NEON)
+        const uint32x4_t sixtyFour = vdupq_n_u32(64);
+        const auto lerp = [&](const u32 offset)
+        {
+            const uint32x4_t l = vld1q_u32(low + offset);
+            const uint32x4_t h = vld1q_u32(high + offset);
+            const uint32x4_t w = vld1q_u32(weights + offset);
+            const uint32x4_t sum = vmlaq_u32(vmulq_u32(l, vsubq_u32(sixtyFour, w)), h, w);
+            return vmovn_u32(vshrq_n_u32(vrshrq_n_u32(sum, 6), 8));
+        };
+        for (; i < 64; i += 8)
+        {
+            vst1_u8(out + i, vmovn_u16(vcombine_u16(lerp(i), lerp(i + 4))));
+        }
+#endif
+        for (; i < 64; ++i)
+        {
+            out[i] = static_cast<u8>((low[i] * (64 - weights[i]) + high[i] * weights[i] + 32) >> 14);
+        }
+    }
+
+    void DecodeBlock(const AstcBlock& block, const bool srgb, Pixels& pixels)
+    {
+        if (block.isSolid)
+        {
+            pixels.fill(block.solidColor);
+            return;
+        }
+
+        const auto endpoints = GetEndpoints(block);
+        const u32 texels = GetPartition(block.subsets, block.partitionSeed).texels;
+        alignas(32) std::array<u32, 64> low;
+        alignas(32) std::array<u32, 64> high;
+        alignas(32) std::array<u32, 64> weights;
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            const auto& pair = endpoints[(texels >> (texel * 2)) & 3];
+            for (u32 channel = 0; channel < 4; ++channel)
+            {
+                // sRGB endpoints are expanded with 0x80 instead of being replicated, alpha stays linear
+                const bool isSrgb = srgb && channel < 3;
+                const u32 index = texel * 4 + channel;
+                low[index] = pair[0][channel] << 8 | (isSrgb ? 0x80 : pair[0][channel]);
+                high[index] = pair[1][channel] << 8 | (isSrgb ? 0x80 : pair[1][channel]);
+                weights[index] = GetWeight(block, texel, block.isDualPlane && channel == block.ccs ? 1 : 0);
+            }
+        }
+        Interpolate(low.data(), high.data(), weights.data(), reinterpret_cast<u8*>(pixels.data()));
+    }
+
+    // BC7 index closest to every ASTC weight, for 2, 3 and 4 bit indices
+    constexpr auto bc7IndexLookup = []
+    {
+        std::array<std::array<u8, 65>, 3> lookup{};
+        for (u32 table = 0; table < 3; ++table)
+        {
+            const u32 count = 4u << table;
+            for (u32 weight = 0; weight <= 64; ++weight)
+            {
+                const auto distance = [&](const u32 entry)
+                {
+                    const u32 value = Bc7::weights[table][entry];
+                    return value > weight ? value - weight : weight - value;
+                };
+                u32 best = 0;
+                for (u32 index = 1; index < count; ++index)
+                {
+                    if (distance(index) < distance(best))
+                    {
+                        best = index;
+                    }
+                }
+                lookup[table][weight] = static_cast<u8>(best);
+            }
+        }
+        return lookup;
+    }();
+
+    struct Bc7Mode
+    {
+        u8 mode;
+        u8 subsets;
+        u8 colorBits;
+        // 0 for modes without alpha endpoints
+        u8 alphaBits;
+        // 0 without p-bits, 1 for one per subset and 2 for one per endpoint
+        u8 pBits;
+        u8 indexBits;
+    };
+    constexpr Bc7Mode bc7Mode1 = {1, 2, 6, 0, 1, 3};
+    constexpr Bc7Mode bc7Mode2 = {2, 3, 5, 0, 0, 2};
+    constexpr Bc7Mode bc7Mode3 = {3, 2, 7, 0, 2, 2};
+    constexpr Bc7Mode bc7Mode6 = {6, 1, 7, 7, 2, 4};
+    constexpr Bc7Mode bc7Mode7 = {7, 2, 5, 5, 2, 2};
+
+    // BC7 pattern with the same texel groups as an ASTC partition, and the ASTC subset of every BC7 subset
+    struct Bc7Partition
+    {
+        bool isValid;
+        bool isThreeSubsets;
+        u8 pattern;
+        std::array<u8, 3> astcSubsets;
+    };
+
+    // Two subset ASTC patterns prefer two subset BC7 patterns, then three subset ones with two subsets sharing
+    // endpoints. Only the patterns UASTC uses are guaranteed to have a match.
+    const Bc7Partition& GetBc7Partition(const u32 subsets, const u32 seed)
+    {
+        static const std::vector<Bc7Partition> partitions = []
+        {
+            const auto match = [](const u32 astcTexels, const u32 bc7Subsets, const u32 pattern, Bc7Partition& result)
+            {
+                std::array<u8, 3> mapping = {0xFF, 0xFF, 0xFF};
+                for (u32 texel = 0; texel < 16; ++texel)
+                {
+                    const u32 bc7Subset = bc7Subsets == 2 ? (Bc7::partitions2[pattern] >> texel) & 1
+                                                          : (Bc7::partitions3[pattern] >> (texel * 2)) & 3;
+                    const u32 astcSubset = (astcTexels >> (texel * 2)) & 3;
+                    if (mapping[bc7Subset] == 0xFF)
+                    {
+                        mapping[bc7Subset] = static_cast<u8>(astcSubset);
+                    } else if (mapping[bc7Subset] != astcSubset)
+                    {
+                        return false;
+                    }
+                }
+                result = {.isValid = true, .isThreeSubsets = bc7Subsets == 3, .pattern = static_cast<u8>(pattern),
+                          .astcSubsets = mapping};
+                return true;
+            };
+
+            std::vector<Bc7Partition> table(2 * 1024);
+            for (u32 subsetCount = 2; subsetCount <= 3; ++subsetCount)
+            {
+                for (u32 seedIndex = 0; seedIndex < 1024; ++seedIndex)
+                {
+                    const u32 texels = GetPartition(subsetCount, seedIndex).texels;
+                    auto& result = table[(subsetCount - 2) * 1024 + seedIndex];
+                    for (u32 bc7Subsets = subsetCount; bc7Subsets <= 3 && !result.isValid; ++bc7Subsets)
+                    {
+                        for (u32 pattern = 0; pattern < 64 && !match(texels, bc7Subsets, pattern, result); ++pattern)
+                        {
+                        }
+                    }
+                }
+            }
+            return table;
+        }();
+        return partitions[(subsets - 2) * 1024 + seed];
+    }
+
+    // Channel value of bits bits, counting the p-bit, expanded to 8 bits
+    u32 ExpandBc7(const u32 value, const u32 bits)
+    {
+        return (value << (8 - bits) | value >> (2 * bits - 8)) & 0xFF;
+    }
+
+    // Closest value of valueBits bits, with the p-bit appended as the lowest bit unless pBit is negative
+    u32 QuantizeBc7Channel(const u8 value, const u32 valueBits, const i32 pBit, u32& error)
+    {
+        const u32 totalBits = valueBits + (pBit >= 0 ? 1 : 0);
+        const i32 maxValue = (1 << valueBits) - 1;
+        const i32 guess = static_cast<i32>((value * ((1u << totalBits) - 1) + 127) / 255 >> (pBit >= 0 ? 1 : 0));
+        u32 best = 0;
+        u32 bestError = ~0u;
+        for (i32 candidate = std::max(guess - 1, 0); candidate <= std::min(guess + 1, maxValue); ++candidate)
+        {
+            const u32 bits = pBit >= 0 ? static_cast<u32>(candidate) << 1 | static_cast<u32>(pBit) : candidate;
+            const i32 difference = static_cast<i32>(ExpandBc7(bits, totalBits)) - value;
+            if (static_cast<u32>(difference * difference) < bestError)
+            {
+                bestError = static_cast<u32>(difference * difference);
+                best = static_cast<u32>(candidate);
+            }
+        }
+        error += bestError;
+        return best;
+    }
+
+    // Writes a BC7 block of one of the modes with a single set of indices. endpoints holds the colors of every BC7
+    // subset and indices are already in the index range of the mode.
+    void WriteBc7(const Bc7Mode& mode, const u32 pattern, std::array<EndpointPair, 3> endpoints,
+                  std::array<u8, 16> indices, u8* destination)
+    {
+        const auto getSubset = [&](const u32 texel) -> u32
+        {
+            switch (mode.subsets)
+            {
+                case 1:
+                    return 0;
+                case 2:
+                    return (Bc7::partitions2[pattern] >> texel) & 1;
+                default:
+                    return (Bc7::partitions3[pattern] >> (texel * 2)) & 3;
+            }
+        };
+        const u32 secondAnchor = mode.subsets == 2 ? Bc7::anchors2[pattern] : Bc7::anchors3Second[pattern];
+        const std::array<u32, 3> anchors = {0, secondAnchor, Bc7::anchors3Third[pattern]};
+
+        // The anchor of every subset drops the top bit of its index, swapping the endpoints brings it into range
+        const u32 maxIndex = (1u << mode.indexBits) - 1;
+        for (u32 subset = 0; subset < mode.subsets; ++subset)
+        {
+            if (indices[anchors[subset]] <= maxIndex / 2)
+            {
+                continue;
+            }
+            std::swap(endpoints[subset][0], endpoints[subset][1]);
+            for (u32 texel = 0; texel < 16; ++texel)
+            {
+                if (getSubset(texel) == subset)
+                {
+                    indices[texel] = static_cast<u8>(maxIndex - indices[texel]);
+                }
+            }
+        }
+
+        const u32 channels = mode.alphaBits > 0 ? 4 : 3;
+        std::array<std::array<u32, 4>, 6> quantized{};
+        std::array<u32, 6> pBits{};
+        for (u32 subset = 0; subset < mode.subsets; ++subset)
+        {
+            const auto quantize = [&](const u32 end, const i32 pBit)
+            {
+                u32 error = 0;
+                for (u32 channel = 0; channel < channels; ++channel)
+                {
+                    const u32 bits = channel == 3 ? mode.alphaBits : mode.colorBits;
+                    quantized[subset * 2 + end][channel] =
+                            QuantizeBc7Channel(endpoints[subset][end][channel], bits, pBit, error);
+                }
+                return error;
+            };
+            const auto pickPBit = [&](const std::span<const u32> ends)
+            {
+                // Try both p-bits and keep the better one, quantizing again for the winner
+                u32 errors[2] = {};
+                for (u32 pBit = 0; pBit < 2; ++pBit)
+                {
+                    for (const u32 end : ends)
+                    {
+                        errors[pBit] += quantize(end, static_cast<i32>(pBit));
+                    }
+                }
+                const u32 pBit = errors[1] < errors[0] ? 1 : 0;
+                for (const u32 end : ends)
+                {
+                    quantize(end, static_cast<i32>(pBit));
+                }
+                return pBit;
+            };
+
+            switch (mode.pBits)
+            {
+                case 0:
+                    quantize(0, -1);
+                    quantize(1, -1);
+                    break;
+                case 1:
+                {
+                    constexpr std::array<u32, 2> bothEnds = {0, 1};
+                    pBits[subset] = pickPBit(bothEnds);
+                    break;
+                }
+                default:
+                    for (u32 end = 0; end < 2; ++end)
+                    {
+                        pBits[subset * 2 + end] = pickPBit(std::span(&end, 1));
+                    }
+                    break;
+            }
+        }
+
+        BlockWriter writer;
+        writer.Put(1u << mode.mode, mode.mode + 1);
+        if (mode.subsets > 1)
+        {
+            writer.Put(pattern, 6);
+        }
+        for (u32 channel = 0; channel < channels; ++channel)
+        {
+            for (u32 end = 0; end < mode.subsets * 2u; ++end)
+            {
+                writer.Put(quantized[end][channel], channel == 3 ? mode.alphaBits : mode.colorBits);
+            }
+        }
+        const u32 pBitCount = mode.pBits == 2 ? mode.subsets * 2u : mode.pBits == 1 ? mode.subsets : 0u;
+        for (u32 i = 0; i < pBitCount; ++i)
+        {
+            writer.Put(pBits[i], 1);
+        }
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            const bool isAnchor = std::find(anchors.begin(), anchors.begin() + mode.subsets, texel) !=
+                                  anchors.begin() + mode.subsets;
+            writer.Put(indices[texel], mode.indexBits - (isAnchor ? 1 : 0));
+        }
+        writer.Store(destination);
+    }
+
+    // BC7 mode 5 has separate indices for alpha, with a rotation that swaps alpha and one of the color channels after
+    // decoding. That is exactly an ASTC dual plane block.
+    void WriteBc7Mode5(EndpointPair color, std::array<u8, 2> alpha, std::array<u8, 16> colorIndices,
+                       std::array<u8, 16> alphaIndices, const u32 rotation, u8* destination)
+    {
+        if (colorIndices[0] >= 2)
+        {
+            std::swap(color[0], color[1]);
+            for (auto& index : colorIndices)
+            {
+                index = static_cast<u8>(3 - index);
+            }
+        }
+        if (alphaIndices[0] >= 2)
+        {
+            std::swap(alpha[0], alpha[1]);
+            for (auto& index : alphaIndices)
+            {
+                index = static_cast<u8>(3 - index);
+            }
+        }
+
+        BlockWriter writer;
+        writer.Put(1u << 5, 6);
+        writer.Put(rotation, 2);
+        for (u32 channel = 0; channel < 3; ++channel)
+        {
+            for (u32 end = 0; end < 2; ++end)
+            {
+                u32 error = 0;
+                writer.Put(QuantizeBc7Channel(color[end][channel], 7, -1, error), 7);
+            }
+        }
+        writer.Put(alpha[0], 8);
+        writer.Put(alpha[1], 8);
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            writer.Put(colorIndices[texel], texel == 0 ? 1 : 2);
+        }
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            writer.Put(alphaIndices[texel], texel == 0 ? 1 : 2);
+        }
+        writer.Store(destination);
+    }
+
+    // Pair of 7 bit endpoints whose index 1 of mode 5 lands closest to every 8 bit value, for solid color blocks
+    const std::array<std::array<u8, 2>, 256>& GetBc7SingleColorTable()
+    {
+        static const auto table = []
+        {
+            std::array<std::array<u8, 2>, 256> entries{};
+            std::array<u32, 256> errors;
+            errors.fill(~0u);
+            for (u32 low = 0; low < 128; ++low)
+            {
+                for (u32 high = 0; high < 128; ++high)
+                {
+                    const u32 value = ((64 - 21) * ExpandBc7(low, 7) + 21 * ExpandBc7(high, 7) + 32) >> 6;
+                    const u32 error = (low > high ? low - high : high - low);
+                    if (error < errors[value])
+                    {
+                        errors[value] = error;
+                        entries[value] = {static_cast<u8>(low), static_cast<u8>(high)};
+                    }
+                }
+            }
+            // Values no pair hits exactly take the pair of the closest one that is hit
+            for (u32 value = 0; value < 256; ++value)
+            {
+                for (u32 distance = 1; errors[value] == ~0u && distance < 256; ++distance)
+                {
+                    for (const i32 other : {static_cast<i32>(value - distance), static_cast<i32>(value + distance)})
+                    {
+                        if (other >= 0 && other < 256 && errors[other] != ~0u && errors[value] == ~0u)
+                        {
+                            entries[value] = entries[other];
+                            errors[value] = errors[other];
+                        }
+                    }
+                }
+            }
+            return entries;
+        }();
+        return table;
+    }
+
+    // Endpoints for a block of pixels: the corners of the bounding box, with channels that fall while the widest one
+    // rises swapped so the diagonal follows the colors
+    EndpointPair FitEndpoints(const Pixels& pixels, const u32 channels)
+    {
+        Color low = pixels[0];
+        Color high = pixels[0];
+        std::array<u32, 4> sums{};
+        for (const auto& pixel : pixels)
+        {
+            for (u32 channel = 0; channel < channels; ++channel)
+            {
+                low[channel] = std::min(low[channel], pixel[channel]);
+                high[channel] = std::max(high[channel], pixel[channel]);
+                sums[channel] += pixel[channel];
+            }
+        }
+        u32 widest = 0;
+        for (u32 channel = 1; channel < channels; ++channel)
+        {
+            if (high[channel] - low[channel] > high[widest] - low[widest])
+            {
+                widest = channel;
+            }
+        }
+        for (u32 channel = 0; channel < channels; ++channel)
+        {
+            i32 covariance = 0;
+            for (const auto& pixel : pixels)
+            {
+                covariance += (pixel[widest] * 16 - static_cast<i32>(sums[widest])) *
+                              (pixel[channel] * 16 - static_cast<i32>(sums[channel])) / 256;
+            }
+            if (covariance < 0)
+            {
+                std::swap(low[channel], high[channel]);
+            }
+        }
+        for (u32 channel = channels; channel < 4; ++channel)
+        {
+            low[channel] = high[channel] = 255;
+        }
+        return {low, high};
+    }
+
+    // Index of every pixel projected onto the line between the endpoints, with maxIndex + 1 evenly spaced steps
+    std::array<u8, 16> ProjectIndices(const Pixels& pixels, const EndpointPair& endpoints, const u32 channels,
+                                      const u32 maxIndex)
+    {
+        std::array<i32, 4> axis{};
+        i32 length = 0;
+        for (u32 channel = 0; channel < channels; ++channel)
+        {
+            axis[channel] = endpoints[1][channel] - endpoints[0][channel];
+            length += axis[channel] * axis[channel];
+        }
+        std::array<u8, 16> indices{};
+        if (length == 0)
+        {
+            return indices;
+        }
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            i32 dot = 0;
+            for (u32 channel = 0; channel < channels; ++channel)
+            {
+                dot += (pixels[texel][channel] - endpoints[0][channel]) * axis[channel];
+            }
+            const i32 index = (dot * static_cast<i32>(maxIndex) + length / 2) / length;
+            indices[texel] = static_cast<u8>(std::clamp(index, 0, static_cast<i32>(maxIndex)));
+        }
+        return indices;
+    }
+
+    void EncodeBc7(const AstcBlock& block, const bool srgb, u8* destination)
+    {
+        if (block.isSolid)
+        {
+            const auto& table = GetBc7SingleColorTable();
+            EndpointPair color{};
+            for (u32 channel = 0; channel < 3; ++channel)
+            {
+                const auto& entry = table[block.solidColor[channel]];
+                color[0][channel] = static_cast<u8>(ExpandBc7(entry[0], 7));
+                color[1][channel] = static_cast<u8>(ExpandBc7(entry[1], 7));
+            }
+            std::array<u8, 16> colorIndices;
+            colorIndices.fill(1);
+            WriteBc7Mode5(color, {block.solidColor[3], block.solidColor[3]}, colorIndices, {}, 0, destination);
+            return;
+        }
+
+        const auto endpoints = GetEndpoints(block);
+        if (block.isDualPlane)
+        {
+            // The second plane goes into the alpha indices, the channel it belongs to swaps places with alpha
+            const u32 ccs = block.ccs;
+            EndpointPair color = endpoints[0];
+            const std::array<u8, 2> alpha = {endpoints[0][0][ccs], endpoints[0][1][ccs]};
+            if (ccs < 3)
+            {
+                color[0][ccs] = endpoints[0][0][3];
+                color[1][ccs] = endpoints[0][1][3];
+            }
+            std::array<u8, 16> colorIndices{};
+            std::array<u8, 16> alphaIndices{};
+            for (u32 texel = 0; texel < 16; ++texel)
+            {
+                colorIndices[texel] = bc7IndexLookup[0][GetWeight(block, texel, 0)];
+                alphaIndices[texel] = bc7IndexLookup[0][GetWeight(block, texel, 1)];
+            }
+            WriteBc7Mode5(color, alpha, colorIndices, alphaIndices, ccs == 3 ? 0 : ccs + 1, destination);
+            return;
+        }
+
+        const auto mapIndices = [&](const Bc7Mode& mode)
+        {
+            std::array<u8, 16> indices{};
+            for (u32 texel = 0; texel < 16; ++texel)
+            {
+                indices[texel] = bc7IndexLookup[mode.indexBits - 2][GetWeight(block, texel, 0)];
+            }
+            return indices;
+        };
+        if (block.subsets == 1)
+        {
+            WriteBc7(bc7Mode6, 0, endpoints, mapIndices(bc7Mode6), destination);
+            return;
+        }
+
+        const auto& partition = GetBc7Partition(block.subsets, block.partitionSeed);
+        const bool hasAlpha = block.components != 3;
+        if (partition.isValid && !(partition.isThreeSubsets && hasAlpha))
+        {
+            // Mode 3 has more endpoint precision, mode 1 the 3 bit indices of the UASTC modes that need them
+            const Bc7Mode* mode = &bc7Mode1;
+            if (partition.isThreeSubsets)
+            {
+                mode = &bc7Mode2;
+            } else if (hasAlpha)
+            {
+                mode = &bc7Mode7;
+            } else if (iseRanges[block.weightRange].bits <= 2)
+            {
+                mode = &bc7Mode3;
+            }
+            std::array<EndpointPair, 3> bc7Endpoints{};
+            for (u32 subset = 0; subset < mode->subsets; ++subset)
+            {
+                bc7Endpoints[subset] = endpoints[partition.astcSubsets[subset]];
+            }
+            WriteBc7(*mode, partition.pattern, bc7Endpoints, mapIndices(*mode), destination);
+            return;
+        }
+
+        // No BC7 pattern matches, which valid UASTC data never hits, so a plain single subset fit is good enough
+        Pixels pixels;
+        DecodeBlock(block, srgb, pixels);
+        const auto fitted = FitEndpoints(pixels, 4);
+        WriteBc7(bc7Mode6, 0, {fitted}, ProjectIndices(pixels, fitted, 4, 15), destination);
+    }
+
+    u16 To565(const Color& color)
+    {
+        return static_cast<u16>((color[0] * 31 + 127) / 255 << 11 | (color[1] * 63 + 127) / 255 << 5 |
+                                (color[2] * 31 + 127) / 255);
+    }
+
+    Color From565(const u16 value)
+    {
+        const u32 r = value >> 11;
+        const u32 g = (value >> 5) & 63;
+        const u32 b = value & 31;
+        return {static_cast<u8>(r << 3 | r >> 2), static_cast<u8>(g << 2 | g >> 4), static_cast<u8>(b << 3 | b >> 2),
+                255};
+    }
+
+    // Four color BC1 block, which is also the color half of BC3
+    void EncodeBc1(const Pixels& pixels, u8* destination)
+    {
+        const auto endpoints = FitEndpoints(pixels, 3);
+        u16 color0 = To565(endpoints[1]);
+        u16 color1 = To565(endpoints[0]);
+        if (color0 < color1)
+        {
+            std::swap(color0, color1);
+        }
+
+        u32 indices = 0;
+        if (color0 != color1)
+        {
+            std::array<Color, 4> palette = {From565(color0), From565(color1)};
+            for (u32 channel = 0; channel < 3; ++channel)
+            {
+                palette[2][channel] = static_cast<u8>((2 * palette[0][channel] + palette[1][channel]) / 3);
+                palette[3][channel] = static_cast<u8>((palette[0][channel] + 2 * palette[1][channel]) / 3);
+            }
+            for (u32 texel = 0; texel < 16; ++texel)
+            {
+                u32 best = 0;
+                u32 bestError = ~0u;
+                for (u32 entry = 0; entry < 4; ++entry)
+                {
+                    u32 error = 0;
+                    for (u32 channel = 0; channel < 3; ++channel)
+                    {
+                        const i32 difference = pixels[texel][channel] - palette[entry][channel];
+                        error += static_cast<u32>(difference * difference);
+                    }
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        best = entry;
+                    }
+                }
+                indices |= best << (texel * 2);
+            }
+        }
+        destination[0] = static_cast<u8>(color0);
+        destination[1] = static_cast<u8>(color0 >> 8);
+        destination[2] = static_cast<u8>(color1);
+        destination[3] = static_cast<u8>(color1 >> 8);
+        std::memcpy(destination + 4, &indices, sizeof(indices));
+    }
+
+    // Eight value BC4 block of one channel, which is also the alpha half of BC3
+    void EncodeBc4(const Pixels& pixels, const u32 channel, u8* destination)
+    {
+        u8 low = 255;
+        u8 high = 0;
+        for (const auto& pixel : pixels)
+        {
+            low = std::min(low, pixel[channel]);
+            high = std::max(high, pixel[channel]);
+        }
+        u64 indices = 0;
+        if (high != low)
+        {
+            // Palette positions from high to low are indices 0, 2, 3, 4, 5, 6, 7 and 1
+            constexpr std::array<u8, 8> positionToIndex = {0, 2, 3, 4, 5, 6, 7, 1};
+            for (u32 texel = 0; texel < 16; ++texel)
+            {
+                const u32 position = ((high - pixels[texel][channel]) * 7 + (high - low) / 2) / (high - low);
+                indices |= static_cast<u64>(positionToIndex[position]) << (texel * 3);
+            }
+        }
+        destination[0] = high;
+        destination[1] = low;
+        for (u32 i = 0; i < 6; ++i)
+        {
+            destination[2 + i] = static_cast<u8>(indices >> (i * 8));
+        }
+    }
+
+    // ETC1 block, which ETC2 RGB decoders read as is. Both flips are tried, each half gets the average color of its
+    // texels and the modifier table with the smallest error.
+    void EncodeEtc1(const Pixels& pixels, u8* destination)
+    {
+        u64 bestBlock = 0;
+        u32 bestError = ~0u;
+        for (u32 flip = 0; flip < 2; ++flip)
+        {
+            const auto getHalf = [flip](const u32 texel) { return flip ? texel / 4 >= 2 : texel % 4 >= 2; };
+            std::array<std::array<u32, 3>, 2> sums{};
+            for (u32 texel = 0; texel < 16; ++texel)
+            {
+                for (u32 channel = 0; channel < 3; ++channel)
+                {
+                    sums[getHalf(texel)][channel] += pixels[texel][channel];
+                }
+            }
+
+            // Differential mode keeps 5 bits of color when the halves are close enough, individual mode 4 bits
+            std::array<std::array<u32, 3>, 2> quantized5{};
+            std::array<std::array<u32, 3>, 2> quantized4{};
+            bool isDifferential = true;
+            for (u32 half = 0; half < 2; ++half)
+            {
+                for (u32 channel = 0; channel < 3; ++channel)
+                {
+                    quantized5[half][channel] = (sums[half][channel] * 31 + 4 * 255) / (8 * 255);
+                    quantized4[half][channel] = (sums[half][channel] * 15 + 4 * 255) / (8 * 255);
+                }
+            }
+            for (u32 channel = 0; channel < 3; ++channel)
+            {
+                const i32 delta = static_cast<i32>(quantized5[1][channel]) - static_cast<i32>(quantized5[0][channel]);
+                isDifferential &= delta >= -4 && delta <= 3;
+            }
+
+            u32 error = 0;
+            std::array<u32, 2> tables{};
+            std::array<u32, 2> indexBits{};
+            for (u32 half = 0; half < 2; ++half)
+            {
+                std::array<i32, 3> base{};
+                for (u32 channel = 0; channel < 3; ++channel)
+                {
+                    const u32 value5 = quantized5[half][channel];
+                    const u32 value4 = quantized4[half][channel];
+                    base[channel] = static_cast<i32>(isDifferential ? value5 << 3 | value5 >> 2 : value4 * 17);
+                }
+
+                u32 bestHalfError = ~0u;
+                for (u32 table = 0; table < Etc::modifiers.size(); ++table)
+                {
+                    u32 halfError = 0;
+                    u32 halfIndices = 0;
+                    for (u32 texel = 0; texel < 16; ++texel)
+                    {
+                        if (getHalf(texel) != half)
+                        {
+                            continue;
+                        }
+                        u32 bestIndex = 0;
+                        u32 bestTexelError = ~0u;
+                        for (u32 index = 0; index < 4; ++index)
+                        {
+                            u32 texelError = 0;
+                            for (u32 channel = 0; channel < 3; ++channel)
+                            {
+                                const i32 value = std::clamp(base[channel] + Etc::modifiers[table][index], 0, 255);
+                                const i32 difference = value - pixels[texel][channel];
+                                texelError += static_cast<u32>(difference * difference);
+                            }
+                            if (texelError < bestTexelError)
+                            {
+                                bestTexelError = texelError;
+                                bestIndex = index;
+                            }
+                        }
+                        halfError += bestTexelError;
+                        // Pixels are stored column by column, most significant bits in the upper half
+                        const u32 position = texel % 4 * 4 + texel / 4;
+                        halfIndices |= (bestIndex >> 1) << (position + 16) | (bestIndex & 1) << position;
+                    }
+                    if (halfError < bestHalfError)
+                    {
+                        bestHalfError = halfError;
+                        tables[half] = table;
+                        indexBits[half] = halfIndices;
+                    }
+                }
+                error += bestHalfError;
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                u32 header = tables[0] << 5 | tables[1] << 2 | (isDifferential ? 2u : 0u) | flip;
+                for (u32 channel = 0; channel < 3; ++channel)
+                {
+                    const u32 shift = 27 - channel * 8;
+                    if (isDifferential)
+                    {
+                        const u32 delta = (quantized5[1][channel] - quantized5[0][channel]) & 7;
+                        header |= quantized5[0][channel] << shift | delta << (shift - 3);
+                    } else
+                    {
+                        header |= quantized4[0][channel] << (shift + 1) | quantized4[1][channel] << (shift - 3);
+                    }
+                }
+                bestBlock = static_cast<u64>(header) << 32 | indexBits[0] | indexBits[1];
+            }
+        }
+        for (u32 i = 0; i < 8; ++i)
+        {
+            destination[i] = static_cast<u8>(bestBlock >> (56 - i * 8));
+        }
+    }
+
+    // EAC alpha block, every table is tried with the multiplier that stretches it over the range of the block
+    void EncodeEac(const Pixels& pixels, const u32 channel, u8* destination)
+    {
+        i32 low = 255;
+        i32 high = 0;
+        for (const auto& pixel : pixels)
+        {
+            low = std::min<i32>(low, pixel[channel]);
+            high = std::max<i32>(high, pixel[channel]);
+        }
+
+        // A single value is the base plus the 0 modifier of table 13
+        u32 bestBase = static_cast<u32>(low);
+        u32 bestMultiplierAndTable = 1 << 4 | 13;
+        u64 bestIndices = 0x924924924924; // Index 4 everywhere
+        u32 bestError = low == high ? 0 : ~0u;
+        for (u32 table = 0; table < Etc::eacModifiers.size() && bestError > 0; ++table)
+        {
+            const auto& modifiers = Etc::eacModifiers[table];
+            const i32 span = modifiers[7] - modifiers[3];
+            const i32 multiplier = std::clamp((high - low + span / 2) / span, 1, 15);
+            const i32 base = std::clamp((low + high - (modifiers[3] + modifiers[7]) * multiplier + 1) / 2, 0, 255);
+            u32 error = 0;
+            u64 indices = 0;
+            for (u32 texel = 0; texel < 16; ++texel)
+            {
+                u32 bestIndex = 0;
+                u32 bestTexelError = ~0u;
+                for (u32 index = 0; index < 8; ++index)
+                {
+                    const i32 difference =
+                            std::clamp(base + modifiers[index] * multiplier, 0, 255) - pixels[texel][channel];
+                    if (static_cast<u32>(difference * difference) < bestTexelError)
+                    {
+                        bestTexelError = static_cast<u32>(difference * difference);
+                        bestIndex = index;
+                    }
+                }
+                error += bestTexelError;
+                indices |= static_cast<u64>(bestIndex) << (45 - (texel % 4 * 4 + texel / 4) * 3);
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                bestBase = static_cast<u32>(base);
+                bestMultiplierAndTable = static_cast<u32>(multiplier) << 4 | table;
+                bestIndices = indices;
+            }
+        }
+        destination[0] = static_cast<u8>(bestBase);
+        destination[1] = static_cast<u8>(bestMultiplierAndTable);
+        for (u32 i = 0; i < 6; ++i)
+        {
+            destination[2 + i] = static_cast<u8>(bestIndices >> (40 - i * 8));
+        }
+    }
+
+    u32 GetBlockSize(const KtxTranscodeTarget target)
+    {
+        switch (target)
+        {
+            case KtxTranscodeTarget::eBC1:
+            case KtxTranscodeTarget::eBC4:
+            case KtxTranscodeTarget::eETC2RGB:
+                return 8;
+            default:
+                return 16;
+        }
+    }
+} // namespace
+
+bool KTX::Uastc::UnpackBlock(const u8* data, AstcBlock& block)
+{
+    BlockReader reader(data);
+    const u32 modeIndex = modeLookup[data[0] & 0x7F];
+    if (modeIndex >= modes.size())
+    {
+        return false;
+    }
+    const auto& mode = modes[modeIndex];
+    reader.Skip(mode.codeLength);
+
+    block = {};
+    if (modeIndex == solidMode)
+    {
+        block.isSolid = true;
+        for (auto& value : block.solidColor)
+        {
+            value = static_cast<u8>(reader.Get(8));
+        }
+        return true;
+    }
+
+    block.components = mode.components;
+    block.subsets = mode.subsets;
+    block.isDualPlane = mode.isDualPlane;
+    block.endpointRange = mode.endpointRange;
+    block.weightRange = static_cast<u8>(GetWeightRange(mode.weightBits));
+    reader.Skip(mode.hintBits);
+
+    if (mode.patternCount > 0)
+    {
+        const u32 pattern = reader.Get(std::bit_width(mode.patternCount - 1u));
+        if (pattern >= mode.patternCount)
+        {
+            return false;
+        }
+        block.partitionSeed = mode.subsets == 3 ? partitionSeeds3[pattern]
+                              : modeIndex == 7  ? partitionSeeds7[pattern]
+                                                : partitionSeeds2[pattern];
+    }
+    if (mode.isDualPlane)
+    {
+        block.ccs = modeIndex == luminanceAlphaDualPlaneMode ? 3 : static_cast<u8>(reader.Get(2));
+    }
+
+    // UASTC stores all trit or quint bundles of the endpoints first, then the plain bits of every value
+    const auto& range = iseRanges[mode.endpointRange];
+    const u32 valueCount = mode.subsets * mode.components * 2u;
+    std::array<u32, 18> digits{};
+    if (range.trits || range.quints)
+    {
+        const u32 base = range.trits ? 3 : 5;
+        const u32 bundleSize = range.trits ? 5 : 3;
+        constexpr std::array<u8, 6> tritBundleBits = {0, 2, 4, 5, 7, 8};
+        constexpr std::array<u8, 4> quintBundleBits = {0, 3, 5, 7};
+        for (u32 first = 0; first < valueCount; first += bundleSize)
+        {
+            const u32 count = std::min(valueCount - first, bundleSize);
+            u32 bundle = reader.Get(range.trits ? tritBundleBits[count] : quintBundleBits[count]);
+            u32 limit = 1;
+            for (u32 k = 0; k < count; ++k)
+            {
+                limit *= base;
+            }
+            if (bundle >= limit)
+            {
+                return false;
+            }
+            for (u32 k = 0; k < count; ++k)
+            {
+                digits[first + k] = bundle % base;
+                bundle /= base;
+            }
+        }
+    }
+    for (u32 value = 0; value < valueCount; ++value)
+    {
+        block.endpoints[value] = static_cast<u8>(digits[value] << range.bits | reader.Get(range.bits));
+    }
+
+    // Anchor weights drop their top bit, which is always 0
+    const u32 anchors = mode.isDualPlane ? 0b11 : GetPartition(mode.subsets, block.partitionSeed).anchors;
+    const u32 weightCount = mode.isDualPlane ? 32 : 16;
+    for (u32 weight = 0; weight < weightCount; ++weight)
+    {
+        block.weights[weight] = static_cast<u8>(reader.Get(mode.weightBits - ((anchors >> weight) & 1)));
+    }
+    return true;
+}
+
+KTX::u32 KTX::Uastc::GetEndpointRange(const u32 subsets, const u32 components, const bool isDualPlane,
+                                      const u32 weightRange)
+{
+    const u32 weightBits = GetIseBitCount(isDualPlane ? 32 : 16, iseRanges[weightRange]);
+    // Block mode, partition count, then the color endpoint mode (and partition seed) and the ccs
+    const u32 headerBits = 11 + 2 + (subsets == 1 ? 4 : 16) + (isDualPlane ? 2 : 0);
+    const u32 availableBits = 128 - headerBits - weightBits;
+    for (u32 range = iseRanges.size(); range-- > 0;)
+    {
+        if (GetIseBitCount(subsets * components * 2, iseRanges[range]) <= availableBits)
+        {
+            return range;
+        }
+    }
+    return 0;
+}
+
+KTX::u8 KTX::Uastc::QuantizeEndpoint(const u32 range, const u8 value)
+{
+    static const auto table = []
+    {
+        std::vector<std::array<u8, 256>> entries(iseRanges.size());
+        for (u32 rangeIndex = 0; rangeIndex < iseRanges.size(); ++rangeIndex)
+        {
+            const auto& ise = iseRanges[rangeIndex];
+            const u32 levels = (1u << ise.bits) * (ise.trits ? 3 : ise.quints ? 5 : 1);
+            for (u32 target = 0; target < 256; ++target)
+            {
+                u32 bestError = ~0u;
+                for (u32 level = 0; level < levels; ++level)
+                {
+                    const i32 difference = colorUnquantization[rangeIndex][level] - static_cast<i32>(target);
+                    if (static_cast<u32>(std::abs(difference)) < bestError)
+                    {
+                        bestError = static_cast<u32>(std::abs(difference));
+                        entries[rangeIndex][target] = static_cast<u8>(level);
+                    }
+                }
+            }
+        }
+        return entries;
+    }();
+    return table[range][value];
+}
+
+KTX::u8 KTX::Uastc::UnquantizeEndpoint(const u32 range, const u8 value)
+{
+    return colorUnquantization[range][value];
+}
+
+void KTX::Uastc::PackAstcBlock(const AstcBlock& block, u8* destination)
+{
+    if (block.isSolid)
+    {
+        // LDR void extent with all extent coordinates set, then the color as UNORM16
+        u64 color = 0;
+        for (u32 channel = 0; channel < 4; ++channel)
+        {
+            color |= static_cast<u64>(block.solidColor[channel] * 257u) << (channel * 16);
+        }
+        const std::array<u64, 2> words = {0xFFFFFFFFFFFFFDFC, color};
+        std::memcpy(destination, words.data(), sizeof(words));
+        return;
+    }
+
+    // ASTC decoders apply blue contraction when the second endpoint is darker, swapping the endpoints and inverting the
+    // weights avoids it without changing the decoded colors
+    std::array<u8, 18> endpoints = block.endpoints;
+    std::array<u8, 32> weights = block.weights;
+    const u32 maxWeight = (1u << iseRanges[block.weightRange].bits) - 1;
+    const u32 valuesPerSubset = block.components * 2u;
+    const auto& partition = GetPartition(block.subsets, block.partitionSeed);
+    const auto& unquantize = colorUnquantization[block.endpointRange];
+    for (u32 subset = 0; subset < block.subsets && block.components > 2; ++subset)
+    {
+        u8* values = endpoints.data() + subset * valuesPerSubset;
+        const u32 sum0 = unquantize[values[0]] + unquantize[values[2]] + unquantize[values[4]];
+        const u32 sum1 = unquantize[values[1]] + unquantize[values[3]] + unquantize[values[5]];
+        if (sum1 >= sum0)
+        {
+            continue;
+        }
+        for (u32 value = 0; value < valuesPerSubset; value += 2)
+        {
+            std::swap(values[value], values[value + 1]);
+        }
+        for (u32 texel = 0; texel < 16; ++texel)
+        {
+            if (((partition.texels >> (texel * 2)) & 3) != subset)
+            {
+                continue;
+            }
+            for (u32 plane = 0; plane < (block.isDualPlane ? 2u : 1u); ++plane)
+            {
+                auto& weight = weights[block.isDualPlane ? texel * 2 + plane : texel];
+                weight = static_cast<u8>(maxWeight - weight);
+            }
+        }
+    }
+
+    BlockWriter writer;
+    writer.Put(GetBlockMode(block.weightRange, block.isDualPlane), 11);
+    writer.Put(block.subsets - 1u, 2);
+    // Color endpoint modes 4, 8 and 12: direct luminance alpha, RGB and RGBA
+    const u32 endpointMode = (block.components - 1u) * 4;
+    if (block.subsets == 1)
+    {
+        writer.Put(endpointMode, 4);
+    } else
+    {
+        // Every subset shares the mode, which the low 2 bits of the field mark with 0
+        writer.Put(block.partitionSeed, 10);
+        writer.Put(endpointMode << 2, 6);
+    }
+    PutIse(writer, endpoints.data(), block.subsets * valuesPerSubset, iseRanges[block.endpointRange]);
+
+    // Weights are stored bit reversed from the top of the block down, the ccs sits right below them
+    BlockWriter weightWriter;
+    const u32 weightCount = block.isDualPlane ? 32 : 16;
+    PutIse(weightWriter, weights.data(), weightCount, iseRanges[block.weightRange]);
+    std::array<u64, 2> words = writer.words;
+    words[0] |= ReverseBits(weightWriter.words[1]);
+    words[1] |= ReverseBits(weightWriter.words[0]);
+    if (block.isDualPlane)
+    {
+        const u32 position = 128 - weightWriter.position - 2;
+        words[position / 64] |= static_cast<u64>(block.ccs) << (position % 64);
+        if (position % 64 == 63)
+        {
+            words[1] |= block.ccs >> 1;
+        }
+    }
+    std::memcpy(destination, words.data(), sizeof(words));
+}
+
+KTX::KtxResult KTX::Uastc::TranscodeRows(const std::span<const u8> blocks, const u32 width, const u32 height,
+                                         const u32 firstRow, const u32 rowCount, const KtxTranscodeTarget target,
+                                         const bool srgb, const bool hasAlpha, const std::span<u8> destination)
+{
+    const u32 blocksX = (width + 3) / 4;
+    assert(blocks.size() >= static_cast<size_t>(blocksX) * (firstRow + rowCount) * 16 && "Not enough blocks");
+    const u32 blockSize = GetBlockSize(target);
+    for (u32 blockY = firstRow; blockY < firstRow + rowCount; ++blockY)
+    {
+        for (u32 blockX = 0; blockX < blocksX; ++blockX)
+        {
+            const size_t block = static_cast<size_t>(blockY) * blocksX + blockX;
+            AstcBlock astc;
+            if (!UnpackBlock(blocks.data() + block * 16, astc))
+            {
+                return KtxResult::eFileDataError;
+            }
+            u8* output = destination.data() + block * blockSize;
+            if (target == KtxTranscodeTarget::eASTC4x4)
+            {
+                PackAstcBlock(astc, output);
+                continue;
+            }
+            if (target == KtxTranscodeTarget::eBC7)
+            {
+                EncodeBc7(astc, srgb, output);
+                continue;
+            }
+
+            Pixels pixels;
+            DecodeBlock(astc, srgb, pixels);
+            switch (target)
+            {
+                case KtxTranscodeTarget::eRGBA8:
+                    for (u32 y = 0; y < 4 && blockY * 4 + y < height; ++y)
+                    {
+                        u8* row = destination.data() + ((static_cast<size_t>(blockY) * 4 + y) * width + blockX * 4) * 4;
+                        const u32 columns = std::min(4u, width - blockX * 4);
+                        std::memcpy(row, reinterpret_cast<const u8*>(pixels.data()) + y * 16, columns * 4);
+                    }
+                    break;
+                case KtxTranscodeTarget::eBC1:
+                    EncodeBc1(pixels, output);
+                    break;
+                case KtxTranscodeTarget::eBC3:
+                    EncodeBc4(pixels, 3, output);
+                    EncodeBc1(pixels, output + 8);
+                    break;
+                case KtxTranscodeTarget::eBC4:
+                    EncodeBc4(pixels, 0, output);
+                    break;
+                case KtxTranscodeTarget::eBC5:
+                    EncodeBc4(pixels, 0, output);
+                    EncodeBc4(pixels, hasAlpha ? 3 : 1, output + 8);
+                    break;
+                case KtxTranscodeTarget::eETC2RGB:
+                    EncodeEtc1(pixels, output);
+                    break;
+                case KtxTranscodeTarget::eETC2RGBA:
+                    EncodeEac(pixels, 3, output);
+                    EncodeEtc1(pixels, output + 8);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    return KtxResult::eSuccess;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <array>
+#include <span>
+
+#include "KtxTranscoder.hpp"
+
+// UASTC blocks are ASTC 4x4 blocks limited to 19 modes, plus hints for transcoders. Every block is unpacked into its
+// ASTC form, which packs straight back into ASTC and decodes or re-encodes into the other targets.
+
+namespace KTX::Uastc
+{
+    // ASTC 4x4 block with direct LDR endpoints (color endpoint modes 4, 8 and 12). Endpoints and weights hold integer
+    // sequence encoded values of their range, not the unquantized ones.
+    struct AstcBlock
+    {
+        // Void extent block of a single color, nothing else is used
+        bool isSolid;
+        std::array<u8, 4> solidColor;
+        // 2 for luminance alpha, 3 for RGB and 4 for RGBA
+        u8 components;
+        u8 subsets;
+        bool isDualPlane;
+        // Channel the second plane of weights applies to
+        u8 ccs;
+        u16 partitionSeed;
+        u8 endpointRange;
+        u8 weightRange;
+        // Subsets one after another, each in ASTC order: r0 r1 g0 g1 b0 b1 a0 a1, or l0 l1 a0 a1
+        std::array<u8, 18> endpoints;
+        // One per texel in raster order, interleaved with the second plane for dual plane blocks
+        std::array<u8, 32> weights;
+    };
+
+    // Fails on malformed blocks and on the mode reserved for future use
+    bool UnpackBlock(const u8* data, AstcBlock& block);
+
+    // Endpoint range ASTC derives from the bits the rest of the block leaves over. Weight ranges have to be powers of
+    // two.
+    [[nodiscard]] u32 GetEndpointRange(u32 subsets, u32 components, bool isDualPlane, u32 weightRange);
+    // Integer sequence encoded value of the range that unquantizes closest to value
+    [[nodiscard]] u8 QuantizeEndpoint(u32 range, u8 value);
+    [[nodiscard]] u8 UnquantizeEndpoint(u32 range, u8 value);
+
+    // Writes the block as ASTC 4x4, bit exact with the UASTC block it came from
+    void PackAstcBlock(const AstcBlock& block, u8* destination);
+
+    // Transcodes the block rows [firstRow, firstRow + rowCount) of a width x height image. blocks holds every block of
+    // the image and destination the whole transcoded image, so row bands can be spread over threads.
+    KtxResult TranscodeRows(std::span<const u8> blocks, u32 width, u32 height, u32 firstRow, u32 rowCount,
+                            KtxTranscodeTarget target, bool srgb, bool hasAlpha, std::span<u8> destination);
+} // namespace KTX::Uastc
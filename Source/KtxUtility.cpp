@@ -1,13 +1,44 @@
 #include "KtxUtility.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
 #include <span>
 #include <vector>
 
-#include "GL_Format.hpp"
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "KtxDfd.hpp"
+#include "KtxFormat.hpp"
+#include "KtxHeader.hpp"
+#include "KtxIo.hpp"
+#include "KtxSupercompression.hpp"
 #include "array"
 #include "cassert"
+#include "expected"
 #include "fstream"
 #include "iostream"
+#include "optional"
+#include "string"
+#include "utility"
 #include "variant"
 
 using u8 = uint8_t;
@@ -23,391 +54,28 @@ constexpr std::array ktxIdentifier{0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xB
 
 constexpr u32 ktxHeaderSize = 64;
 
-constexpr std::array ktx2Identifier{0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
-constexpr u32 ktx2HeaderSize = 80;
+using KTX::Detail::ktx2HeaderSize;
+using KTX::Detail::ktx2Identifier;
+
+// Probing reads at most this much of a file, enough for the header and the key/value data of nearly every file
+constexpr u32 probeReadSize = 4096;
 
 constexpr u32 endianRef = 0x04030201;
 constexpr u32 endianRefRev = 0x01020304;
 
 namespace
 {
-    enum class KtxUtility_VkFormat
-    {
-        VK_FORMAT_UNDEFINED = 0,
-        VK_FORMAT_R4G4_UNORM_PACK8 = 1,
-        VK_FORMAT_R4G4B4A4_UNORM_PACK16 = 2,
-        VK_FORMAT_B4G4R4A4_UNORM_PACK16 = 3,
-        VK_FORMAT_R5G6B5_UNORM_PACK16 = 4,
-        VK_FORMAT_B5G6R5_UNORM_PACK16 = 5,
-        VK_FORMAT_R5G5B5A1_UNORM_PACK16 = 6,
-        VK_FORMAT_B5G5R5A1_UNORM_PACK16 = 7,
-        VK_FORMAT_A1R5G5B5_UNORM_PACK16 = 8,
-        VK_FORMAT_R8_UNORM = 9,
-        VK_FORMAT_R8_SNORM = 10,
-        VK_FORMAT_R8_USCALED = 11,
-        VK_FORMAT_R8_SSCALED = 12,
-        VK_FORMAT_R8_UINT = 13,
-        VK_FORMAT_R8_SINT = 14,
-        VK_FORMAT_R8_SRGB = 15,
-        VK_FORMAT_R8G8_UNORM = 16,
-        VK_FORMAT_R8G8_SNORM = 17,
-        VK_FORMAT_R8G8_USCALED = 18,
-        VK_FORMAT_R8G8_SSCALED = 19,
-        VK_FORMAT_R8G8_UINT = 20,
-        VK_FORMAT_R8G8_SINT = 21,
-        VK_FORMAT_R8G8_SRGB = 22,
-        VK_FORMAT_R8G8B8_UNORM = 23,
-        VK_FORMAT_R8G8B8_SNORM = 24,
-        VK_FORMAT_R8G8B8_USCALED = 25,
-        VK_FORMAT_R8G8B8_SSCALED = 26,
-        VK_FORMAT_R8G8B8_UINT = 27,
-        VK_FORMAT_R8G8B8_SINT = 28,
-        VK_FORMAT_R8G8B8_SRGB = 29,
-        VK_FORMAT_B8G8R8_UNORM = 30,
-        VK_FORMAT_B8G8R8_SNORM = 31,
-        VK_FORMAT_B8G8R8_USCALED = 32,
-        VK_FORMAT_B8G8R8_SSCALED = 33,
-        VK_FORMAT_B8G8R8_UINT = 34,
-        VK_FORMAT_B8G8R8_SINT = 35,
-        VK_FORMAT_B8G8R8_SRGB = 36,
-        VK_FORMAT_R8G8B8A8_UNORM = 37,
-        VK_FORMAT_R8G8B8A8_SNORM = 38,
-        VK_FORMAT_R8G8B8A8_USCALED = 39,
-        VK_FORMAT_R8G8B8A8_SSCALED = 40,
-        VK_FORMAT_R8G8B8A8_UINT = 41,
-        VK_FORMAT_R8G8B8A8_SINT = 42,
-        VK_FORMAT_R8G8B8A8_SRGB = 43,
-        VK_FORMAT_B8G8R8A8_UNORM = 44,
-        VK_FORMAT_B8G8R8A8_SNORM = 45,
-        VK_FORMAT_B8G8R8A8_USCALED = 46,
-        VK_FORMAT_B8G8R8A8_SSCALED = 47,
-        VK_FORMAT_B8G8R8A8_UINT = 48,
-        VK_FORMAT_B8G8R8A8_SINT = 49,
-        VK_FORMAT_B8G8R8A8_SRGB = 50,
-        VK_FORMAT_A8B8G8R8_UNORM_PACK32 = 51,
-        VK_FORMAT_A8B8G8R8_SNORM_PACK32 = 52,
-        VK_FORMAT_A8B8G8R8_USCALED_PACK32 = 53,
-        VK_FORMAT_A8B8G8R8_SSCALED_PACK32 = 54,
-        VK_FORMAT_A8B8G8R8_UINT_PACK32 = 55,
-        VK_FORMAT_A8B8G8R8_SINT_PACK32 = 56,
-        VK_FORMAT_A8B8G8R8_SRGB_PACK32 = 57,
-        VK_FORMAT_A2R10G10B10_UNORM_PACK32 = 58,
-        VK_FORMAT_A2R10G10B10_SNORM_PACK32 = 59,
-        VK_FORMAT_A2R10G10B10_USCALED_PACK32 = 60,
-        VK_FORMAT_A2R10G10B10_SSCALED_PACK32 = 61,
-        VK_FORMAT_A2R10G10B10_UINT_PACK32 = 62,
-        VK_FORMAT_A2R10G10B10_SINT_PACK32 = 63,
-        VK_FORMAT_A2B10G10R10_UNORM_PACK32 = 64,
-        VK_FORMAT_A2B10G10R10_SNORM_PACK32 = 65,
-        VK_FORMAT_A2B10G10R10_USCALED_PACK32 = 66,
-        VK_FORMAT_A2B10G10R10_SSCALED_PACK32 = 67,
-        VK_FORMAT_A2B10G10R10_UINT_PACK32 = 68,
-        VK_FORMAT_A2B10G10R10_SINT_PACK32 = 69,
-        VK_FORMAT_R16_UNORM = 70,
-        VK_FORMAT_R16_SNORM = 71,
-        VK_FORMAT_R16_USCALED = 72,
-        VK_FORMAT_R16_SSCALED = 73,
-        VK_FORMAT_R16_UINT = 74,
-        VK_FORMAT_R16_SINT = 75,
-        VK_FORMAT_R16_SFLOAT = 76,
-        VK_FORMAT_R16G16_UNORM = 77,
-        VK_FORMAT_R16G16_SNORM = 78,
-        VK_FORMAT_R16G16_USCALED = 79,
-        VK_FORMAT_R16G16_SSCALED = 80,
-        VK_FORMAT_R16G16_UINT = 81,
-        VK_FORMAT_R16G16_SINT = 82,
-        VK_FORMAT_R16G16_SFLOAT = 83,
-        VK_FORMAT_R16G16B16_UNORM = 84,
-        VK_FORMAT_R16G16B16_SNORM = 85,
-        VK_FORMAT_R16G16B16_USCALED = 86,
-        VK_FORMAT_R16G16B16_SSCALED = 87,
-        VK_FORMAT_R16G16B16_UINT = 88,
-        VK_FORMAT_R16G16B16_SINT = 89,
-        VK_FORMAT_R16G16B16_SFLOAT = 90,
-        VK_FORMAT_R16G16B16A16_UNORM = 91,
-        VK_FORMAT_R16G16B16A16_SNORM = 92,
-        VK_FORMAT_R16G16B16A16_USCALED = 93,
-        VK_FORMAT_R16G16B16A16_SSCALED = 94,
-        VK_FORMAT_R16G16B16A16_UINT = 95,
-        VK_FORMAT_R16G16B16A16_SINT = 96,
-        VK_FORMAT_R16G16B16A16_SFLOAT = 97,
-        VK_FORMAT_R32_UINT = 98,
-        VK_FORMAT_R32_SINT = 99,
-        VK_FORMAT_R32_SFLOAT = 100,
-        VK_FORMAT_R32G32_UINT = 101,
-        VK_FORMAT_R32G32_SINT = 102,
-        VK_FORMAT_R32G32_SFLOAT = 103,
-        VK_FORMAT_R32G32B32_UINT = 104,
-        VK_FORMAT_R32G32B32_SINT = 105,
-        VK_FORMAT_R32G32B32_SFLOAT = 106,
-        VK_FORMAT_R32G32B32A32_UINT = 107,
-        VK_FORMAT_R32G32B32A32_SINT = 108,
-        VK_FORMAT_R32G32B32A32_SFLOAT = 109,
-        VK_FORMAT_R64_UINT = 110,
-        VK_FORMAT_R64_SINT = 111,
-        VK_FORMAT_R64_SFLOAT = 112,
-        VK_FORMAT_R64G64_UINT = 113,
-        VK_FORMAT_R64G64_SINT = 114,
-        VK_FORMAT_R64G64_SFLOAT = 115,
-        VK_FORMAT_R64G64B64_UINT = 116,
-        VK_FORMAT_R64G64B64_SINT = 117,
-        VK_FORMAT_R64G64B64_SFLOAT = 118,
-        VK_FORMAT_R64G64B64A64_UINT = 119,
-        VK_FORMAT_R64G64B64A64_SINT = 120,
-        VK_FORMAT_R64G64B64A64_SFLOAT = 121,
-        VK_FORMAT_B10G11R11_UFLOAT_PACK32 = 122,
-        VK_FORMAT_E5B9G9R9_UFLOAT_PACK32 = 123,
-        VK_FORMAT_D16_UNORM = 124,
-        VK_FORMAT_X8_D24_UNORM_PACK32 = 125,
-        VK_FORMAT_D32_SFLOAT = 126,
-        VK_FORMAT_S8_UINT = 127,
-        VK_FORMAT_D16_UNORM_S8_UINT = 128,
-        VK_FORMAT_D24_UNORM_S8_UINT = 129,
-        VK_FORMAT_D32_SFLOAT_S8_UINT = 130,
-        VK_FORMAT_BC1_RGB_UNORM_BLOCK = 131,
-        VK_FORMAT_BC1_RGB_SRGB_BLOCK = 132,
-        VK_FORMAT_BC1_RGBA_UNORM_BLOCK = 133,
-        VK_FORMAT_BC1_RGBA_SRGB_BLOCK = 134,
-        VK_FORMAT_BC2_UNORM_BLOCK = 135,
-        VK_FORMAT_BC2_SRGB_BLOCK = 136,
-        VK_FORMAT_BC3_UNORM_BLOCK = 137,
-        VK_FORMAT_BC3_SRGB_BLOCK = 138,
-        VK_FORMAT_BC4_UNORM_BLOCK = 139,
-        VK_FORMAT_BC4_SNORM_BLOCK = 140,
-        VK_FORMAT_BC5_UNORM_BLOCK = 141,
-        VK_FORMAT_BC5_SNORM_BLOCK = 142,
-        VK_FORMAT_BC6H_UFLOAT_BLOCK = 143,
-        VK_FORMAT_BC6H_SFLOAT_BLOCK = 144,
-        VK_FORMAT_BC7_UNORM_BLOCK = 145,
-        VK_FORMAT_BC7_SRGB_BLOCK = 146,
-        VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK = 147,
-        VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK = 148,
-        VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK = 149,
-        VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK = 150,
-        VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK = 151,
-        VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK = 152,
-        VK_FORMAT_EAC_R11_UNORM_BLOCK = 153,
-        VK_FORMAT_EAC_R11_SNORM_BLOCK = 154,
-        VK_FORMAT_EAC_R11G11_UNORM_BLOCK = 155,
-        VK_FORMAT_EAC_R11G11_SNORM_BLOCK = 156,
-        VK_FORMAT_ASTC_4x4_UNORM_BLOCK = 157,
-        VK_FORMAT_ASTC_4x4_SRGB_BLOCK = 158,
-        VK_FORMAT_ASTC_5x4_UNORM_BLOCK = 159,
-        VK_FORMAT_ASTC_5x4_SRGB_BLOCK = 160,
-        VK_FORMAT_ASTC_5x5_UNORM_BLOCK = 161,
-        VK_FORMAT_ASTC_5x5_SRGB_BLOCK = 162,
-        VK_FORMAT_ASTC_6x5_UNORM_BLOCK = 163,
-        VK_FORMAT_ASTC_6x5_SRGB_BLOCK = 164,
-        VK_FORMAT_ASTC_6x6_UNORM_BLOCK = 165,
-        VK_FORMAT_ASTC_6x6_SRGB_BLOCK = 166,
-        VK_FORMAT_ASTC_8x5_UNORM_BLOCK = 167,
-        VK_FORMAT_ASTC_8x5_SRGB_BLOCK = 168,
-        VK_FORMAT_ASTC_8x6_UNORM_BLOCK = 169,
-        VK_FORMAT_ASTC_8x6_SRGB_BLOCK = 170,
-        VK_FORMAT_ASTC_8x8_UNORM_BLOCK = 171,
-        VK_FORMAT_ASTC_8x8_SRGB_BLOCK = 172,
-        VK_FORMAT_ASTC_10x5_UNORM_BLOCK = 173,
-        VK_FORMAT_ASTC_10x5_SRGB_BLOCK = 174,
-        VK_FORMAT_ASTC_10x6_UNORM_BLOCK = 175,
-        VK_FORMAT_ASTC_10x6_SRGB_BLOCK = 176,
-        VK_FORMAT_ASTC_10x8_UNORM_BLOCK = 177,
-        VK_FORMAT_ASTC_10x8_SRGB_BLOCK = 178,
-        VK_FORMAT_ASTC_10x10_UNORM_BLOCK = 179,
-        VK_FORMAT_ASTC_10x10_SRGB_BLOCK = 180,
-        VK_FORMAT_ASTC_12x10_UNORM_BLOCK = 181,
-        VK_FORMAT_ASTC_12x10_SRGB_BLOCK = 182,
-        VK_FORMAT_ASTC_12x12_UNORM_BLOCK = 183,
-        VK_FORMAT_ASTC_12x12_SRGB_BLOCK = 184,
-        VK_FORMAT_G8B8G8R8_422_UNORM = 1000156000,
-        VK_FORMAT_B8G8R8G8_422_UNORM = 1000156001,
-        VK_FORMAT_G8_B8_R8_3PLANE_420_UNORM = 1000156002,
-        VK_FORMAT_G8_B8R8_2PLANE_420_UNORM = 1000156003,
-        VK_FORMAT_G8_B8_R8_3PLANE_422_UNORM = 1000156004,
-        VK_FORMAT_G8_B8R8_2PLANE_422_UNORM = 1000156005,
-        VK_FORMAT_G8_B8_R8_3PLANE_444_UNORM = 1000156006,
-        VK_FORMAT_R10X6_UNORM_PACK16 = 1000156007,
-        VK_FORMAT_R10X6G10X6_UNORM_2PACK16 = 1000156008,
-        VK_FORMAT_R10X6G10X6B10X6A10X6_UNORM_4PACK16 = 1000156009,
-        VK_FORMAT_G10X6B10X6G10X6R10X6_422_UNORM_4PACK16 = 1000156010,
-        VK_FORMAT_B10X6G10X6R10X6G10X6_422_UNORM_4PACK16 = 1000156011,
-        VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_420_UNORM_3PACK16 = 1000156012,
-        VK_FORMAT_G10X6_B10X6R10X6_2PLANE_420_UNORM_3PACK16 = 1000156013,
-        VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_422_UNORM_3PACK16 = 1000156014,
-        VK_FORMAT_G10X6_B10X6R10X6_2PLANE_422_UNORM_3PACK16 = 1000156015,
-        VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_444_UNORM_3PACK16 = 1000156016,
-        VK_FORMAT_R12X4_UNORM_PACK16 = 1000156017,
-        VK_FORMAT_R12X4G12X4_UNORM_2PACK16 = 1000156018,
-        VK_FORMAT_R12X4G12X4B12X4A12X4_UNORM_4PACK16 = 1000156019,
-        VK_FORMAT_G12X4B12X4G12X4R12X4_422_UNORM_4PACK16 = 1000156020,
-        VK_FORMAT_B12X4G12X4R12X4G12X4_422_UNORM_4PACK16 = 1000156021,
-        VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_420_UNORM_3PACK16 = 1000156022,
-        VK_FORMAT_G12X4_B12X4R12X4_2PLANE_420_UNORM_3PACK16 = 1000156023,
-        VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_422_UNORM_3PACK16 = 1000156024,
-        VK_FORMAT_G12X4_B12X4R12X4_2PLANE_422_UNORM_3PACK16 = 1000156025,
-        VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_444_UNORM_3PACK16 = 1000156026,
-        VK_FORMAT_G16B16G16R16_422_UNORM = 1000156027,
-        VK_FORMAT_B16G16R16G16_422_UNORM = 1000156028,
-        VK_FORMAT_G16_B16_R16_3PLANE_420_UNORM = 1000156029,
-        VK_FORMAT_G16_B16R16_2PLANE_420_UNORM = 1000156030,
-        VK_FORMAT_G16_B16_R16_3PLANE_422_UNORM = 1000156031,
-        VK_FORMAT_G16_B16R16_2PLANE_422_UNORM = 1000156032,
-        VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM = 1000156033,
-        VK_FORMAT_G8_B8R8_2PLANE_444_UNORM = 1000330000,
-        VK_FORMAT_G10X6_B10X6R10X6_2PLANE_444_UNORM_3PACK16 = 1000330001,
-        VK_FORMAT_G12X4_B12X4R12X4_2PLANE_444_UNORM_3PACK16 = 1000330002,
-        VK_FORMAT_G16_B16R16_2PLANE_444_UNORM = 1000330003,
-        VK_FORMAT_A4R4G4B4_UNORM_PACK16 = 1000340000,
-        VK_FORMAT_A4B4G4R4_UNORM_PACK16 = 1000340001,
-        VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK = 1000066000,
-        VK_FORMAT_ASTC_5x4_SFLOAT_BLOCK = 1000066001,
-        VK_FORMAT_ASTC_5x5_SFLOAT_BLOCK = 1000066002,
-        VK_FORMAT_ASTC_6x5_SFLOAT_BLOCK = 1000066003,
-        VK_FORMAT_ASTC_6x6_SFLOAT_BLOCK = 1000066004,
-        VK_FORMAT_ASTC_8x5_SFLOAT_BLOCK = 1000066005,
-        VK_FORMAT_ASTC_8x6_SFLOAT_BLOCK = 1000066006,
-        VK_FORMAT_ASTC_8x8_SFLOAT_BLOCK = 1000066007,
-        VK_FORMAT_ASTC_10x5_SFLOAT_BLOCK = 1000066008,
-        VK_FORMAT_ASTC_10x6_SFLOAT_BLOCK = 1000066009,
-        VK_FORMAT_ASTC_10x8_SFLOAT_BLOCK = 1000066010,
-        VK_FORMAT_ASTC_10x10_SFLOAT_BLOCK = 1000066011,
-        VK_FORMAT_ASTC_12x10_SFLOAT_BLOCK = 1000066012,
-        VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK = 1000066013,
-        VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG = 1000054000,
-        VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG = 1000054001,
-        VK_FORMAT_PVRTC2_2BPP_UNORM_BLOCK_IMG = 1000054002,
-        VK_FORMAT_PVRTC2_4BPP_UNORM_BLOCK_IMG = 1000054003,
-        VK_FORMAT_PVRTC1_2BPP_SRGB_BLOCK_IMG = 1000054004,
-        VK_FORMAT_PVRTC1_4BPP_SRGB_BLOCK_IMG = 1000054005,
-        VK_FORMAT_PVRTC2_2BPP_SRGB_BLOCK_IMG = 1000054006,
-        VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG = 1000054007,
-        VK_FORMAT_R16G16_SFIXED5_NV = 1000464000,
-        VK_FORMAT_A1B5G5R5_UNORM_PACK16_KHR = 1000470000,
-        VK_FORMAT_A8_UNORM_KHR = 1000470001,
-        VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK,
-        VK_FORMAT_ASTC_5x4_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_5x4_SFLOAT_BLOCK,
-        VK_FORMAT_ASTC_5x5_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_5x5_SFLOAT_BLOCK,
-        VK_FORMAT_ASTC_6x5_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_6x5_SFLOAT_BLOCK,
-        VK_FORMAT_ASTC_6x6_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_6x6_SFLOAT_BLOCK,
-        VK_FORMAT_ASTC_8x5_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_8x5_SFLOAT_BLOCK,
-        VK_FORMAT_ASTC_8x6_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_8x6_SFLOAT_BLOCK,
-        VK_FORMAT_ASTC_8x8_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_8x8_SFLOAT_BLOCK,
-        VK_FORMAT_ASTC_10x5_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_10x5_SFLOAT_BLOCK,
-        VK_FORMAT_ASTC_10x6_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_10x6_SFLOAT_BLOCK,
-        VK_FORMAT_ASTC_10x8_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_10x8_SFLOAT_BLOCK,
-        VK_FORMAT_ASTC_10x10_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_10x10_SFLOAT_BLOCK,
-        VK_FORMAT_ASTC_12x10_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_12x10_SFLOAT_BLOCK,
-        VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK_EXT = VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK,
-        VK_FORMAT_G8B8G8R8_422_UNORM_KHR = VK_FORMAT_G8B8G8R8_422_UNORM,
-        VK_FORMAT_B8G8R8G8_422_UNORM_KHR = VK_FORMAT_B8G8R8G8_422_UNORM,
-        VK_FORMAT_G8_B8_R8_3PLANE_420_UNORM_KHR = VK_FORMAT_G8_B8_R8_3PLANE_420_UNORM,
-        VK_FORMAT_G8_B8R8_2PLANE_420_UNORM_KHR = VK_FORMAT_G8_B8R8_2PLANE_420_UNORM,
-        VK_FORMAT_G8_B8_R8_3PLANE_422_UNORM_KHR = VK_FORMAT_G8_B8_R8_3PLANE_422_UNORM,
-        VK_FORMAT_G8_B8R8_2PLANE_422_UNORM_KHR = VK_FORMAT_G8_B8R8_2PLANE_422_UNORM,
-        VK_FORMAT_G8_B8_R8_3PLANE_444_UNORM_KHR = VK_FORMAT_G8_B8_R8_3PLANE_444_UNORM,
-        VK_FORMAT_R10X6_UNORM_PACK16_KHR = VK_FORMAT_R10X6_UNORM_PACK16,
-        VK_FORMAT_R10X6G10X6_UNORM_2PACK16_KHR = VK_FORMAT_R10X6G10X6_UNORM_2PACK16,
-        VK_FORMAT_R10X6G10X6B10X6A10X6_UNORM_4PACK16_KHR = VK_FORMAT_R10X6G10X6B10X6A10X6_UNORM_4PACK16,
-        VK_FORMAT_G10X6B10X6G10X6R10X6_422_UNORM_4PACK16_KHR = VK_FORMAT_G10X6B10X6G10X6R10X6_422_UNORM_4PACK16,
-        VK_FORMAT_B10X6G10X6R10X6G10X6_422_UNORM_4PACK16_KHR = VK_FORMAT_B10X6G10X6R10X6G10X6_422_UNORM_4PACK16,
-        VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_420_UNORM_3PACK16_KHR = VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_420_UNORM_3PACK16,
-        VK_FORMAT_G10X6_B10X6R10X6_2PLANE_420_UNORM_3PACK16_KHR = VK_FORMAT_G10X6_B10X6R10X6_2PLANE_420_UNORM_3PACK16,
-        VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_422_UNORM_3PACK16_KHR = VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_422_UNORM_3PACK16,
-        VK_FORMAT_G10X6_B10X6R10X6_2PLANE_422_UNORM_3PACK16_KHR = VK_FORMAT_G10X6_B10X6R10X6_2PLANE_422_UNORM_3PACK16,
-        VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_444_UNORM_3PACK16_KHR = VK_FORMAT_G10X6_B10X6_R10X6_3PLANE_444_UNORM_3PACK16,
-        VK_FORMAT_R12X4_UNORM_PACK16_KHR = VK_FORMAT_R12X4_UNORM_PACK16,
-        VK_FORMAT_R12X4G12X4_UNORM_2PACK16_KHR = VK_FORMAT_R12X4G12X4_UNORM_2PACK16,
-        VK_FORMAT_R12X4G12X4B12X4A12X4_UNORM_4PACK16_KHR = VK_FORMAT_R12X4G12X4B12X4A12X4_UNORM_4PACK16,
-        VK_FORMAT_G12X4B12X4G12X4R12X4_422_UNORM_4PACK16_KHR = VK_FORMAT_G12X4B12X4G12X4R12X4_422_UNORM_4PACK16,
-        VK_FORMAT_B12X4G12X4R12X4G12X4_422_UNORM_4PACK16_KHR = VK_FORMAT_B12X4G12X4R12X4G12X4_422_UNORM_4PACK16,
-        VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_420_UNORM_3PACK16_KHR = VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_420_UNORM_3PACK16,
-        VK_FORMAT_G12X4_B12X4R12X4_2PLANE_420_UNORM_3PACK16_KHR = VK_FORMAT_G12X4_B12X4R12X4_2PLANE_420_UNORM_3PACK16,
-        VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_422_UNORM_3PACK16_KHR = VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_422_UNORM_3PACK16,
-        VK_FORMAT_G12X4_B12X4R12X4_2PLANE_422_UNORM_3PACK16_KHR = VK_FORMAT_G12X4_B12X4R12X4_2PLANE_422_UNORM_3PACK16,
-        VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_444_UNORM_3PACK16_KHR = VK_FORMAT_G12X4_B12X4_R12X4_3PLANE_444_UNORM_3PACK16,
-        VK_FORMAT_G16B16G16R16_422_UNORM_KHR = VK_FORMAT_G16B16G16R16_422_UNORM,
-        VK_FORMAT_B16G16R16G16_422_UNORM_KHR = VK_FORMAT_B16G16R16G16_422_UNORM,
-        VK_FORMAT_G16_B16_R16_3PLANE_420_UNORM_KHR = VK_FORMAT_G16_B16_R16_3PLANE_420_UNORM,
-        VK_FORMAT_G16_B16R16_2PLANE_420_UNORM_KHR = VK_FORMAT_G16_B16R16_2PLANE_420_UNORM,
-        VK_FORMAT_G16_B16_R16_3PLANE_422_UNORM_KHR = VK_FORMAT_G16_B16_R16_3PLANE_422_UNORM,
-        VK_FORMAT_G16_B16R16_2PLANE_422_UNORM_KHR = VK_FORMAT_G16_B16R16_2PLANE_422_UNORM,
-        VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM_KHR = VK_FORMAT_G16_B16_R16_3PLANE_444_UNORM,
-        VK_FORMAT_G8_B8R8_2PLANE_444_UNORM_EXT = VK_FORMAT_G8_B8R8_2PLANE_444_UNORM,
-        VK_FORMAT_G10X6_B10X6R10X6_2PLANE_444_UNORM_3PACK16_EXT = VK_FORMAT_G10X6_B10X6R10X6_2PLANE_444_UNORM_3PACK16,
-        VK_FORMAT_G12X4_B12X4R12X4_2PLANE_444_UNORM_3PACK16_EXT = VK_FORMAT_G12X4_B12X4R12X4_2PLANE_444_UNORM_3PACK16,
-        VK_FORMAT_G16_B16R16_2PLANE_444_UNORM_EXT = VK_FORMAT_G16_B16R16_2PLANE_444_UNORM,
-        VK_FORMAT_A4R4G4B4_UNORM_PACK16_EXT = VK_FORMAT_A4R4G4B4_UNORM_PACK16,
-        VK_FORMAT_A4B4G4R4_UNORM_PACK16_EXT = VK_FORMAT_A4B4G4R4_UNORM_PACK16,
-        // VK_FORMAT_R16G16_S10_5_NV is a deprecated alias
-        VK_FORMAT_R16G16_S10_5_NV = VK_FORMAT_R16G16_SFIXED5_NV,
-        VK_FORMAT_MAX_ENUM = 0x7FFFFFFF
-    };
-
-    enum class KtxFormatSizeFlagBits
-    {
-        eKtxFormatSizePackedBit = 0x00000001,
-        eKtxFormatSizeCompressedBit = 0x00000002,
-        eKtxFormatSizePalettizedBit = 0x00000004,
-        eKtxFormatSizeDepthBit = 0x00000008,
-        eKtxFormatSizeStencilBit = 0x00000010,
-        eKtxFormatSizeYuvsdaBit = 0x00000020,
-    };
-
-    template<typename Enum>
-    class Flags
-    {
-    public:
-        constexpr Flags(Enum value = static_cast<Enum>(0)) : enumValue(value) {}
-
-        constexpr Flags& operator=(int intValue)
-        {
-            enumValue = static_cast<Enum>(intValue);
-            return *this;
-        }
-
-        constexpr Flags operator|(Flags other) const
-        {
-            return Flags(static_cast<Enum>(static_cast<int>(enumValue) | static_cast<int>(other.enumValue)));
-        }
-
-        constexpr bool operator&(Flags other) const
-        {
-            return static_cast<int>(enumValue) & static_cast<int>(other.enumValue);
-        }
-
-        constexpr Flags operator^(Flags other) const
-        {
-            return Flags(static_cast<Enum>(static_cast<int>(enumValue) ^ static_cast<int>(other.enumValue)));
-        }
-
-        constexpr Enum value() const { return enumValue; }
-
-    private:
-        Enum enumValue;
-    };
-
-    template<typename Enum>
-    constexpr Flags<Enum> operator|(Enum lhs, Enum rhs)
-    {
-        return Flags<Enum>(lhs) | Flags<Enum>(rhs);
-    }
-
-    template<typename Enum>
-    constexpr bool operator&(Enum lhs, Enum rhs)
-    {
-        return Flags<Enum>(lhs) & Flags<Enum>(rhs);
-    }
-
-    struct KtxFormatSize
-    {
-        Flags<KtxFormatSizeFlagBits> flags;
-        u32 palleteSize;
-        u32 blockSize;
-        u32 blockWidth;
-        u32 blockHeight;
-        u32 blockDepth;
-        u32 minBlocksX;
-        u32 minBlocksY;
-    };
+    using KTX::KtxFormatSize;
+    using KTX::KtxFormatSizeFlagBits;
+    using KTX::KtxLevelIndexEntry;
+    using KTX::KtxLevelRange;
+    using KTX::KtxOrientationX;
+    using KTX::KtxOrientationY;
+    using KTX::KtxOrientationZ;
+    using KTX::KtxOrientation;
+    using KTX::KtxResult;
+    using KTX::KtxSupercompressionScheme;
+    using KTX::KtxTextureInfo;
 
     struct KtxHeader
     {
@@ -427,207 +95,190 @@ namespace
         u32 keyValueData;
     };
 
-    enum class KtxOrientationX
-    {
-        eLeft = 'l',
-        eRight = 'r',
-    };
-
-    enum class KtxOrientationY
-    {
-        eUp = 'u',
-        eDown = 'd',
-    };
-
-    enum class KtxOrientationZ
-    {
-        eIn = 'i',
-        eOut = 'o'
-    };
+    using KTX::Detail::Ktx2Header;
 
-    struct KtxOrientation
+    struct KtxSupplementalInfo
     {
-        KtxOrientationX x;
-        KtxOrientationY y;
-        KtxOrientationZ z;
+        u8 compressed;
+        u8 generateMipmaps;
+        u16 textureDimension;
     };
 
-    struct UT_HashHandle
-    {
-        void* prev;
-        void* next;
-        UT_HashHandle* hPrev;
-        UT_HashHandle* hNext;
+    using KtxFileHeader = std::variant<KtxHeader, Ktx2Header>;
 
-        void* key;
-        unsigned keyLen;
-        unsigned hashV;
-    };
+    static_assert(sizeof(KtxHeader) == ktxHeaderSize);
+    static_assert(sizeof(KTX::KtxLevelIndexEntry) == 24);
 
-    struct KtxHashList
+    std::expected<KtxFileHeader, KtxResult> DetermineHeader(const std::span<const u8> data)
     {
-        u32 keyLen;
-        char* key;
-        u32 valueLen;
-        void* value;
-        UT_HashHandle hh;
-    };
-
-    struct KtxTexture
-    {
-        KtxFormatSize formatSize;
-        u32 typeSize;
-        bool isArray;
-        bool isCubeMap;
-        bool isCompressed;
-        bool generateMipmaps;
-        u32 baseWidth;
-        u32 baseHeight;
-        u32 baseDepth;
-        u32 numDimensions;
-        u32 numLevels;
-        u32 numLayers;
-        u32 numFaces;
-        KtxOrientation orientation;
-        KtxHashList* kvDataHead;
-        u32 kvDataLen;
-        u8* kvData;
-        u64 dataSize;
-        u8* pData;
-    };
+        if (data.size() < ktxIdentifier.size())
+        {
+            return std::unexpected(KtxResult::eFileReadError);
+        }
 
-    struct KtxTexture1
-    {
-        KtxTexture texture;
-        u32 glFormat;
-        u32 glInternalFormat;
-        u32 glBaseInternalFormat;
-        u32 glType;
-        bool needSwap;
-    };
+        if (std::equal(ktxIdentifier.begin(), ktxIdentifier.end(), data.begin()))
+        {
+            if (data.size() < ktxHeaderSize)
+            {
+                return std::unexpected(KtxResult::eFileReadError);
+            }
+            KtxHeader header;
+            std::memcpy(&header, data.data(), ktxHeaderSize);
+            return header;
+        }
+        if (std::equal(ktx2Identifier.begin(), ktx2Identifier.end(), data.begin()))
+        {
+            if (data.size() < ktx2HeaderSize)
+            {
+                return std::unexpected(KtxResult::eFileReadError);
+            }
+            Ktx2Header header;
+            std::memcpy(&header, data.data(), ktx2HeaderSize);
+            return header;
+        }
+        return std::unexpected(KtxResult::eUnknownFileFormat);
+    }
 
-    typedef struct ktxIndexEntry32
+    // Reads the largest possible header in one go, memory backed streams are parsed in place
+    std::expected<KtxFileHeader, KtxResult> DetermineHeader(KTX::KtxStream& stream)
     {
-        u32 byteOffset;
-        u32 byteLength;
-    } ktxIndexEntry32;
+        if (const auto data = stream.GetData(); !data.empty())
+        {
+            return DetermineHeader(data);
+        }
 
-    typedef struct ktxIndexEntry64
-    {
-        u64 byteOffset;
-        u64 byteLength;
-    } ktxIndexEntry64;
+        alignas(16) std::array<u8, ktx2HeaderSize> buffer;
+        const auto bytesRead = std::min<u64>(stream.GetSize(), buffer.size());
+        if (!stream.Read(0, std::span(buffer).first(bytesRead)))
+        {
+            return std::unexpected(KtxResult::eFileReadError);
+        }
+        return DetermineHeader(std::span(buffer).first(bytesRead));
+    }
 
-    struct Ktx2Header
+    constexpr u32 SwapEndian32(u32 value)
     {
-        std::array<u8, 12> identifier;
-        u32 vkFormat;
-        u32 typeSize;
-        u32 pixelWidth;
-        u32 pixelHeight;
-        u32 pixelDepth;
-        u32 layerCount;
-        u32 faceCount;
-        u32 levelCount;
-        u32 superCompressionScheme;
-        ktxIndexEntry32 dataFormatDescriptor;
-        ktxIndexEntry32 keyValueData;
-        ktxIndexEntry64 superCompressionGlobalData;
-    };
+        return (value << 24) | ((value & 0xFF00) << 8) | ((value & 0xFF0000) >> 8) | (value >> 24);
+    }
 
-    struct KtxSupplementalInfo
+    // Copies size bytes and reverses the bytes of every typeSize (2 or 4) byte element on the way, 32 or 16 bytes at a
+    // time where the target has vector shuffles. Every block is loaded before anything is stored, so destination may
+    // be source or sit before it, which lets the swap ride along with a read or with the ktx1 compaction.
+    void CopySwapped(const u8* source, u8* destination, const u64 size, const u32 typeSize)
     {
-        u8 compressed;
-        u8 generateMipmaps;
-        u16 textureDimension;
-    };
-
-    std::variant<KtxHeader, Ktx2Header> DetermineHeader(std::fstream& file)
-    {
-        std::array<u8, 12> buffer{};
-        file.read(reinterpret_cast<char*>(buffer.data()), 12);
-        if (std::equal(buffer.begin(), buffer.end(), ktxIdentifier.begin()))
-        {
-            KtxHeader header{};
-            std::ranges::copy(buffer, header.identifier.begin());
-            file.read(reinterpret_cast<char*>(&header.endianness), 4);
-            file.read(reinterpret_cast<char*>(&header.glType), 4);
-            file.read(reinterpret_cast<char*>(&header.glTypeSize), 4);
-            file.read(reinterpret_cast<char*>(&header.glFormat), 4);
-            file.read(reinterpret_cast<char*>(&header.glInternalFormat), 4);
-            file.read(reinterpret_cast<char*>(&header.glBaseInternalFormat), 4);
-            file.read(reinterpret_cast<char*>(&header.pixelWidth), 4);
-            file.read(reinterpret_cast<char*>(&header.pixelHeight), 4);
-            file.read(reinterpret_cast<char*>(&header.pixelDepth), 4);
-            file.read(reinterpret_cast<char*>(&header.numArrayElements), 4);
-            file.read(reinterpret_cast<char*>(&header.numFaces), 4);
-            file.read(reinterpret_cast<char*>(&header.numMipLevels), 4);
-            file.read(reinterpret_cast<char*>(&header.keyValueData), 4);
-            return header;
+        u64 i = 0;
+#if defined(__AVX2__)
+        const __m256i shuffle256 =
+                typeSize == 2 ? _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14, 1, 0, 3, 2, 5, 4,
+                                                 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+                              : _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6,
+                                                 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        for (; i + 32 <= size; i += 32)
+        {
+            const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_shuffle_epi8(value, shuffle256));
         }
-        if (std::equal(buffer.begin(), buffer.end(), ktx2Identifier.begin()))
-        {
-            Ktx2Header header{};
-            std::ranges::copy(buffer, header.identifier.begin());
-            file.read(reinterpret_cast<char*>(&header.vkFormat), 4);
-            file.read(reinterpret_cast<char*>(&header.typeSize), 4);
-            file.read(reinterpret_cast<char*>(&header.pixelWidth), 4);
-            file.read(reinterpret_cast<char*>(&header.pixelHeight), 4);
-            file.read(reinterpret_cast<char*>(&header.pixelDepth), 4);
-            file.read(reinterpret_cast<char*>(&header.layerCount), 4);
-            file.read(reinterpret_cast<char*>(&header.faceCount), 4);
-            file.read(reinterpret_cast<char*>(&header.levelCount), 4);
-            file.read(reinterpret_cast<char*>(&header.superCompressionScheme), 4);
-            file.read(reinterpret_cast<char*>(&header.dataFormatDescriptor), 8);
-            file.read(reinterpret_cast<char*>(&header.keyValueData), 8);
-            file.read(reinterpret_cast<char*>(&header.superCompressionGlobalData), 16);
-            return header;
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+        const __m128i shuffle = typeSize == 2
+                                        ? _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+                                        : _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_shuffle_epi8(value, shuffle));
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        for (; i + 16 <= size; i += 16)
+        {
+            // Swap the 16 bit halves of 32 bit elements, then the bytes within each half
+            __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+            if (typeSize == 4)
+            {
+                value = _mm_or_si128(_mm_slli_epi32(value, 16), _mm_srli_epi32(value, 16));
+            }
+            value = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), value);
+        }
+#elif defined(__ARM_NEON)
+        for (; i + 16 <= size; i += 16)
+        {
+            const uint8x16_t value = vld1q_u8(source + i);
+            vst1q_u8(destination + i, typeSize == 2 ? vrev16q_u8(value) : vrev32q_u8(value));
+        }
+#endif
+        for (; i + typeSize <= size; i += typeSize)
+        {
+            u8 element[4];
+            std::memcpy(element, source + i, typeSize);
+            std::reverse(element, element + typeSize);
+            std::memcpy(destination + i, element, typeSize);
+        }
+        // A trailing partial element has nothing to swap with
+        for (; i < size; ++i)
+        {
+            destination[i] = source[i];
         }
-        assert(false && "File is not a ktx texture!");
-        return {};
     }
 
-    constexpr u32 SwapEndian32(u32 value)
+    void SwapEndian32(const std::span<u32> values)
     {
-        return (value << 24) | ((value & 0xFF00) << 8) | ((value & 0xFF0000) >> 8) | (value >> 24);
+        auto* bytes = reinterpret_cast<u8*>(values.data());
+        CopySwapped(bytes, bytes, values.size_bytes(), sizeof(u32));
+    }
+
+    // Size of the elements ktx1 image data needs swapped, 1 when it is already in native order
+    u32 GetSwapSize(const KtxTextureInfo& info)
+    {
+        return !info.isKtx2 && info.needSwap ? info.typeSize : 1;
     }
 
-    KtxSupplementalInfo CheckHeader(KtxHeader& header)
+    std::expected<KtxSupplementalInfo, KtxResult> CheckHeader(KtxHeader& header)
     {
         KtxSupplementalInfo info{};
         if (header.endianness == endianRefRev)
         {
-            auto* start = &header.glType;
-            for (u32 i = 0; i < 12; ++i)
+            // Every field after the endianness marker is a u32
+            std::array<u32, 12> fields;
+            static_assert(sizeof(fields) == sizeof(KtxHeader) - offsetof(KtxHeader, glType));
+            std::memcpy(fields.data(), &header.glType, sizeof(fields));
+            SwapEndian32(fields);
+            std::memcpy(&header.glType, fields.data(), sizeof(fields));
+
+            if (header.glTypeSize != 1 && header.glTypeSize != 2 && header.glTypeSize != 4)
             {
-                start[i] = SwapEndian32(start[i]);
+                return std::unexpected(KtxResult::eFileDataError);
             }
-
-            assert(header.glTypeSize != 1 && header.glTypeSize != 2 && header.glTypeSize != 4 && "Unsupported size!");
         } else if (header.endianness != endianRef)
         {
-            assert(false && "Corrupt Data");
+            return std::unexpected(KtxResult::eFileDataError);
         }
 
         if (header.glType == 0 || header.glFormat == 0)
         {
             if (header.glType + header.glFormat != 0)
             {
-                assert(false && "Unsupported format!");
+                return std::unexpected(KtxResult::eFileDataError);
             }
             info.compressed = 1;
         }
 
-        assert(header.glFormat != header.glInternalFormat && "Corrupt Data");
-        assert(header.pixelWidth > 0 && "Image must width greater than 0");
-        if (header.pixelDepth > 0)
+        if (header.glFormat == header.glInternalFormat || header.pixelWidth == 0)
+        {
+            return std::unexpected(KtxResult::eFileDataError);
+        }
+        if (header.pixelDepth > 0 && header.pixelHeight == 0)
         {
-            assert(header.pixelHeight > 0 && "3D Image must have height greater than 0");
+            return std::unexpected(KtxResult::eFileDataError);
         }
 
         if (header.pixelDepth > 0)
         {
-            assert(header.numArrayElements == 0 && "3D array textures not supported");
+            if (header.numArrayElements > 0)
+            {
+                // 3D array textures
+                return std::unexpected(KtxResult::eUnsupportedFeature);
+            }
             info.textureDimension = 3;
         } else if (header.pixelHeight > 0)
         {
@@ -639,10 +290,13 @@ namespace
 
         if (header.numFaces == 6)
         {
-            assert(info.textureDimension == 2 && "Cube map must have 2D faces");
+            if (info.textureDimension != 2)
+            {
+                return std::unexpected(KtxResult::eFileDataError);
+            }
         } else if (header.numFaces != 1)
         {
-            assert(false && "Unsupported faces!");
+            return std::unexpected(KtxResult::eFileDataError);
         }
 
         if (header.numMipLevels == 0)
@@ -656,1014 +310,1553 @@ namespace
 
         const auto maxDim = std::max(std::max(header.pixelWidth, header.pixelHeight), header.pixelDepth);
         // Bit magic to check mip levels are a maximum of 1 + log2(max(width, height, depth)
-        if (maxDim < 1u << header.numMipLevels - 1)
+        if (header.numMipLevels > 32 || maxDim < 1u << (header.numMipLevels - 1))
         {
-            assert(false && "Unsupported mipmap count");
+            return std::unexpected(KtxResult::eFileDataError);
         }
 
         return info;
     }
 
-    u32 CalculatePadding(const int n, const int nBytes)
+    KtxResult CheckHeader(const Ktx2Header& header)
     {
-        return static_cast<u32>(n * std::ceil(static_cast<float>(nBytes) / n));
-    }
-
-    void AddKvPair(const KtxHashList* pHead, const char* key, const u32 valueLen, const void* value)
-    {
-        assert(pHead && key && "Invalid data");
-        assert((valueLen == 0 || value) && " Invalid values");
-
-        u32 keyLen = std::strlen(key) + 1;
-        KtxHashList kv;
-
-        assert(keyLen != -1 && "Invalid value");
-
-        kv.key = reinterpret_cast<char*>(&kv) + sizeof(KtxHashList);
-        kv.keyLen = keyLen;
-        std::memcpy(kv.key, key, keyLen);
-        kv.valueLen = valueLen;
-
-        if (valueLen > 0)
+        if (header.pixelWidth == 0 || (header.pixelDepth > 0 && header.pixelHeight == 0))
         {
-            kv.value = kv.key + keyLen;
-            std::memcpy(kv.value, value, valueLen);
+            return KtxResult::eFileDataError;
         }
-        else
+        if (header.faceCount != 1 && header.faceCount != 6)
         {
-            kv.value = nullptr;
+            return KtxResult::eFileDataError;
         }
-    }
-    
-    void HashListDeserialize(const KtxHashList* pHead, const u32 kvdLen, void* pKvd)
-    {
-        char* src = static_cast<char*>(pKvd);
-
-        assert(kvdLen > 0 && pKvd != nullptr && pHead != nullptr);
-
-        while (src < static_cast<char*>(pKvd) + kvdLen)
+        if (header.faceCount == 6 && (header.pixelHeight == 0 || header.pixelDepth > 0))
         {
-            char* key;
-            u32 keyLen, valueLen;
-            void* value;
-            u32 keyAndValueByteSize = *reinterpret_cast<u32*>(src);
-
-            src += sizeof(keyAndValueByteSize);
-            key = src;
-            keyLen = keyAndValueByteSize;
-
-            while (keyLen < keyAndValueByteSize && key[keyLen] != '\0') keyLen++;
-
-            assert(keyLen != keyAndValueByteSize && key[keyLen] == '\0' && "Unsupported key length!");
-
-            if (keyLen >= 3 && key[0] == '\xEF' && key[1] == '\xBB' && key[2] == '\xBF') {
-                // Forbidden BOM
-                assert(false && "Unsupported key length!");
-            }
-
-            keyLen += 1;
-            value = key + keyLen;
-            valueLen = keyAndValueByteSize - keyLen;
+            return KtxResult::eFileDataError;
+        }
 
-            AddKvPair(pHead, key, valueLen, valueLen > 0 ? value : nullptr);
-            src += CalculatePadding(4, keyAndValueByteSize);
+        const auto maxDim = std::max(std::max(header.pixelWidth, header.pixelHeight), header.pixelDepth);
+        if (header.levelCount > 32 || (header.levelCount > 0 && maxDim < 1u << (header.levelCount - 1)))
+        {
+            return KtxResult::eFileDataError;
         }
+        return KtxResult::eSuccess;
     }
 
-    void FindHash()
+    u64 CalculatePadding(const u32 n, const u64 nBytes)
     {
+        return (nBytes + n - 1) / n * n;
     }
-    
-    KtxHashList HashListFindEntry(const KtxHashList* pHead, const char* key)
+
+    bool IsInRange(const u64 size, const u64 offset, const u64 length)
     {
-        assert(pHead && key && "Invalid data");
-        KtxHashList* kv;
+        return offset <= size && length <= size - offset;
     }
-    
-    void* HashListFindValue(KtxHashList* pHead, const char* key, u32 valueLen)
+
+    bool IsInRange(const std::span<const u8> data, const u64 offset, const u64 length)
     {
-        assert(valueLen > 0 && "Invalid value");
-        KtxHashList* entry;
-        HashListFindEntry()
+        return IsInRange(data.size(), offset, length);
     }
-    
-    KtxFormatSize GetFormatSize(const u32 internalFormat)
-    {
-        KtxFormatSize formatSize{.minBlocksX = 1, .minBlocksY = 1};
-        switch (internalFormat)
-        {
-            case GL_R8: // 1-component, 8-bit unsigned normalized
-            case GL_R8_SNORM: // 1-component, 8-bit signed normalized
-            case GL_R8UI: // 1-component, 8-bit unsigned integer
-            case GL_R8I: // 1-component, 8-bit signed integer
-            case GL_SR8: // 1-component, 8-bit sRGB
-                formatSize.flags = 0;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 1 * 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RG8: // 2-component, 8-bit unsigned normalized
-            case GL_RG8_SNORM: // 2-component, 8-bit signed normalized
-            case GL_RG8UI: // 2-component, 8-bit unsigned integer
-            case GL_RG8I: // 2-component, 8-bit signed integer
-            case GL_SRG8: // 2-component, 8-bit sRGB
-                formatSize.flags = 0;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 2 * 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGB8: // 3-component, 8-bit unsigned normalized
-            case GL_RGB8_SNORM: // 3-component, 8-bit signed normalized
-            case GL_RGB8UI: // 3-component, 8-bit unsigned integer
-            case GL_RGB8I: // 3-component, 8-bit signed integer
-            case GL_SRGB8: // 3-component, 8-bit sRGB
-                formatSize.flags = 0;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 3 * 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGBA8: // 4-component, 8-bit unsigned normalized
-            case GL_RGBA8_SNORM: // 4-component, 8-bit signed normalized
-            case GL_RGBA8UI: // 4-component, 8-bit unsigned integer
-            case GL_RGBA8I: // 4-component, 8-bit signed integer
-            case GL_SRGB8_ALPHA8: // 4-component, 8-bit sRGB
-                formatSize.flags = 0;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 4 * 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-
-            //
-            // 16 bits per component
-            //
-            case GL_R16: // 1-component, 16-bit unsigned normalized
-            case GL_R16_SNORM: // 1-component, 16-bit signed normalized
-            case GL_R16UI: // 1-component, 16-bit unsigned integer
-            case GL_R16I: // 1-component, 16-bit signed integer
-            case GL_R16F: // 1-component, 16-bit floating-point
-                formatSize.flags = 0;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 2 * 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RG16: // 2-component, 16-bit unsigned normalized
-            case GL_RG16_SNORM: // 2-component, 16-bit signed normalized
-            case GL_RG16UI: // 2-component, 16-bit unsigned integer
-            case GL_RG16I: // 2-component, 16-bit signed integer
-            case GL_RG16F: // 2-component, 16-bit floating-point
-                formatSize.flags = 0;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 4 * 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGB16: // 3-component, 16-bit unsigned normalized
-            case GL_RGB16_SNORM: // 3-component, 16-bit signed normalized
-            case GL_RGB16UI: // 3-component, 16-bit unsigned integer
-            case GL_RGB16I: // 3-component, 16-bit signed integer
-            case GL_RGB16F: // 3-component, 16-bit floating-point
-                formatSize.flags = 0;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 6 * 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGBA16: // 4-component, 16-bit unsigned normalized
-            case GL_RGBA16_SNORM: // 4-component, 16-bit signed normalized
-            case GL_RGBA16UI: // 4-component, 16-bit unsigned integer
-            case GL_RGBA16I: // 4-component, 16-bit signed integer
-            case GL_RGBA16F: // 4-component, 16-bit floating-point
-                formatSize.flags = 0;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 8 * 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-
-            //
-            // 32 bits per component
-            //
-            case GL_R32UI: // 1-component, 32-bit unsigned integer
-            case GL_R32I: // 1-component, 32-bit signed integer
-            case GL_R32F: // 1-component, 32-bit floating-point
-                formatSize.flags = 0;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 4 * 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RG32UI: // 2-component, 32-bit unsigned integer
-            case GL_RG32I: // 2-component, 32-bit signed integer
-            case GL_RG32F: // 2-component, 32-bit floating-point
-                formatSize.flags = 0;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 8 * 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGB32UI: // 3-component, 32-bit unsigned integer
-            case GL_RGB32I: // 3-component, 32-bit signed integer
-            case GL_RGB32F: // 3-component, 32-bit floating-point
-                formatSize.flags = 0;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 12 * 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGBA32UI: // 4-component, 32-bit unsigned integer
-            case GL_RGBA32I: // 4-component, 32-bit signed integer
-            case GL_RGBA32F: // 4-component, 32-bit floating-point
-                formatSize.flags = 0;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 16 * 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-
-            //
-            // Packed
-            //
-            case GL_R3_G3_B2: // 3-component 3:3:2, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGB4: // 3-component 4:4:4, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 12;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGB5: // 3-component 5:5:5, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 16;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGB565: // 3-component 5:6:5, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 16;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGB10: // 3-component 10:10:10, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 32;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGB12: // 3-component 12:12:12, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 36;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGBA2: // 4-component 2:2:2:2, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGBA4: // 4-component 4:4:4:4, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 16;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGBA12: // 4-component 12:12:12:12, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 48;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGB5_A1: // 4-component 5:5:5:1, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 32;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGB10_A2: // 4-component 10:10:10:2, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 32;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_RGB10_A2UI: // 4-component 10:10:10:2, unsigned integer
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 32;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_R11F_G11F_B10F: // 3-component 11:11:10, floating-point
-            case GL_RGB9_E5: // 3-component/exp 9:9:9/5, floating-point
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePackedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 32;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-
-            //
-            // S3TC/DXT/BC
-            //
-            case GL_COMPRESSED_RGB_S3TC_DXT1_EXT: // line through 3D space, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT: // line through 3D space plus 1-bit alpha, 4x4 blocks, unsigned
-                                                   // normalized
-            case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT: // line through 3D space, 4x4 blocks, sRGB
-            case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT: // line through 3D space plus 1-bit alpha, 4x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 64;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT: // line through 3D space plus line through 1D space, 4x4 blocks,
-                                                   // unsigned normalized
-            case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT: // line through 3D space plus 4-bit alpha, 4x4 blocks, unsigned
-                                                   // normalized
-            case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT: // line through 3D space plus line through 1D space, 4x4
-                                                         // blocks, sRGB
-            case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT: // line through 3D space plus 4-bit alpha, 4x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-
-            case GL_COMPRESSED_LUMINANCE_LATC1_EXT: // line through 1D space, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SIGNED_LUMINANCE_LATC1_EXT: // line through 1D space, 4x4 blocks, signed normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 64;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_LUMINANCE_ALPHA_LATC2_EXT: // two lines through 1D space, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SIGNED_LUMINANCE_ALPHA_LATC2_EXT: // two lines through 1D space, 4x4 blocks, signed
-                                                                 // normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-
-            case GL_COMPRESSED_RED_RGTC1: // line through 1D space, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SIGNED_RED_RGTC1: // line through 1D space, 4x4 blocks, signed normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 64;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RG_RGTC2: // two lines through 1D space, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SIGNED_RG_RGTC2: // two lines through 1D space, 4x4 blocks, signed normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-
-            case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT: // 3-component, 4x4 blocks, unsigned floating-point
-            case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT: // 3-component, 4x4 blocks, signed floating-point
-            case GL_COMPRESSED_RGBA_BPTC_UNORM: // 4-component, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM: // 4-component, 4x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-
-            //
-            // ETC
-            //
-            case GL_ETC1_RGB8_OES: // 3-component ETC1, 4x4 blocks, unsigned normalized" ),
-            case GL_COMPRESSED_RGB8_ETC2: // 3-component ETC2, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ETC2: // 3-component ETC2, 4x4 blocks, sRGB
-            case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2: // 4-component ETC2 with 1-bit alpha, 4x4 blocks, unsigned
-                                                              // normalized
-            case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2: // 4-component ETC2 with 1-bit alpha, 4x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 64;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA8_ETC2_EAC: // 4-component ETC2, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC: // 4-component ETC2, 4x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-
-            case GL_COMPRESSED_R11_EAC: // 1-component ETC, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SIGNED_R11_EAC: // 1-component ETC, 4x4 blocks, signed normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 64;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RG11_EAC: // 2-component ETC, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SIGNED_RG11_EAC: // 2-component ETC, 4x4 blocks, signed normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-
-            //
-            // PVRTC
-            //
-            case GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG: // 3-component PVRTC, 8x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB_PVRTC_2BPPV1_EXT: // 3-component PVRTC, 8x4 blocks, sRGB
-            case GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG: // 4-component PVRTC, 8x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB_ALPHA_PVRTC_2BPPV1_EXT: // 4-component PVRTC, 8x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 64;
-                formatSize.blockWidth = 8;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                formatSize.minBlocksX = 2;
-                formatSize.minBlocksY = 2;
-                break;
-            case GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG: // 3-component PVRTC, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB_PVRTC_4BPPV1_EXT: // 3-component PVRTC, 4x4 blocks, sRGB
-            case GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG: // 4-component PVRTC, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB_ALPHA_PVRTC_4BPPV1_EXT: // 4-component PVRTC, 4x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 64;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                formatSize.minBlocksX = 2;
-                formatSize.minBlocksY = 2;
-                break;
-            case GL_COMPRESSED_RGBA_PVRTC_2BPPV2_IMG: // 4-component PVRTC, 8x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB_ALPHA_PVRTC_2BPPV2_IMG: // 4-component PVRTC, 8x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 64;
-                formatSize.blockWidth = 8;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_PVRTC_4BPPV2_IMG: // 4-component PVRTC, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB_ALPHA_PVRTC_4BPPV2_IMG: // 4-component PVRTC, 4x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 64;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-
-            //
-            // ASTC
-            //
-            case GL_COMPRESSED_RGBA_ASTC_4x4_KHR: // 4-component ASTC, 4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR: // 4-component ASTC, 4x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_5x4_KHR: // 4-component ASTC, 5x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x4_KHR: // 4-component ASTC, 5x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 5;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_5x5_KHR: // 4-component ASTC, 5x5 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x5_KHR: // 4-component ASTC, 5x5 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 5;
-                formatSize.blockHeight = 5;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_6x5_KHR: // 4-component ASTC, 6x5 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x5_KHR: // 4-component ASTC, 6x5 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 6;
-                formatSize.blockHeight = 5;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_6x6_KHR: // 4-component ASTC, 6x6 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6_KHR: // 4-component ASTC, 6x6 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 6;
-                formatSize.blockHeight = 6;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_8x5_KHR: // 4-component ASTC, 8x5 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x5_KHR: // 4-component ASTC, 8x5 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 8;
-                formatSize.blockHeight = 5;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_8x6_KHR: // 4-component ASTC, 8x6 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x6_KHR: // 4-component ASTC, 8x6 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 8;
-                formatSize.blockHeight = 6;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_8x8_KHR: // 4-component ASTC, 8x8 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x8_KHR: // 4-component ASTC, 8x8 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 8;
-                formatSize.blockHeight = 8;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_10x5_KHR: // 4-component ASTC, 10x5 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x5_KHR: // 4-component ASTC, 10x5 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 10;
-                formatSize.blockHeight = 5;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_10x6_KHR: // 4-component ASTC, 10x6 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x6_KHR: // 4-component ASTC, 10x6 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 10;
-                formatSize.blockHeight = 6;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_10x8_KHR: // 4-component ASTC, 10x8 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x8_KHR: // 4-component ASTC, 10x8 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 10;
-                formatSize.blockHeight = 8;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_10x10_KHR: // 4-component ASTC, 10x10 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x10_KHR: // 4-component ASTC, 10x10 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 10;
-                formatSize.blockHeight = 10;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_12x10_KHR: // 4-component ASTC, 12x10 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x10_KHR: // 4-component ASTC, 12x10 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 12;
-                formatSize.blockHeight = 10;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_12x12_KHR: // 4-component ASTC, 12x12 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12_KHR: // 4-component ASTC, 12x12 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 12;
-                formatSize.blockHeight = 12;
-                formatSize.blockDepth = 1;
-                break;
-
-            case GL_COMPRESSED_RGBA_ASTC_3x3x3_OES: // 4-component ASTC, 3x3x3 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_3x3x3_OES: // 4-component ASTC, 3x3x3 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 3;
-                formatSize.blockHeight = 3;
-                formatSize.blockDepth = 3;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_4x3x3_OES: // 4-component ASTC, 4x3x3 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x3x3_OES: // 4-component ASTC, 4x3x3 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 3;
-                formatSize.blockDepth = 3;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_4x4x3_OES: // 4-component ASTC, 4x4x3 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4x3_OES: // 4-component ASTC, 4x4x3 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 3;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_4x4x4_OES: // 4-component ASTC, 4x4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4x4_OES: // 4-component ASTC, 4x4x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 4;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_5x4x4_OES: // 4-component ASTC, 5x4x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x4x4_OES: // 4-component ASTC, 5x4x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 5;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 4;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_5x5x4_OES: // 4-component ASTC, 5x5x4 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x5x4_OES: // 4-component ASTC, 5x5x4 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 5;
-                formatSize.blockHeight = 5;
-                formatSize.blockDepth = 4;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_5x5x5_OES: // 4-component ASTC, 5x5x5 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x5x5_OES: // 4-component ASTC, 5x5x5 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 5;
-                formatSize.blockHeight = 5;
-                formatSize.blockDepth = 5;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_6x5x5_OES: // 4-component ASTC, 6x5x5 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x5x5_OES: // 4-component ASTC, 6x5x5 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 6;
-                formatSize.blockHeight = 5;
-                formatSize.blockDepth = 5;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_6x6x5_OES: // 4-component ASTC, 6x6x5 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6x5_OES: // 4-component ASTC, 6x6x5 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 6;
-                formatSize.blockHeight = 6;
-                formatSize.blockDepth = 5;
-                break;
-            case GL_COMPRESSED_RGBA_ASTC_6x6x6_OES: // 4-component ASTC, 6x6x6 blocks, unsigned normalized
-            case GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6x6_OES: // 4-component ASTC, 6x6x6 blocks, sRGB
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 6;
-                formatSize.blockHeight = 6;
-                formatSize.blockDepth = 6;
-                break;
-
-            //
-            // ATC
-            //
-            case GL_ATC_RGB_AMD: // 3-component, 4x4 blocks, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 64;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_ATC_RGBA_EXPLICIT_ALPHA_AMD: // 4-component, 4x4 blocks, unsigned normalized
-            case GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD: // 4-component, 4x4 blocks, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 128;
-                formatSize.blockWidth = 4;
-                formatSize.blockHeight = 4;
-                formatSize.blockDepth = 1;
-                break;
-
-            //
-            // Palletized
-            //
-            case GL_PALETTE4_RGB8_OES: // 3-component 8:8:8,   4-bit palette, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePalettizedBit;
-                formatSize.palleteSize = 16 * 24;
-                formatSize.blockSize = 4;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_PALETTE4_RGBA8_OES: // 4-component 8:8:8:8, 4-bit palette, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePalettizedBit;
-                formatSize.palleteSize = 16 * 32;
-                formatSize.blockSize = 4;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_PALETTE4_R5_G6_B5_OES: // 3-component 5:6:5,   4-bit palette, unsigned normalized
-            case GL_PALETTE4_RGBA4_OES: // 4-component 4:4:4:4, 4-bit palette, unsigned normalized
-            case GL_PALETTE4_RGB5_A1_OES: // 4-component 5:5:5:1, 4-bit palette, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePalettizedBit;
-                formatSize.palleteSize = 16 * 16;
-                formatSize.blockSize = 4;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_PALETTE8_RGB8_OES: // 3-component 8:8:8,   8-bit palette, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePalettizedBit;
-                formatSize.palleteSize = 256 * 24;
-                formatSize.blockSize = 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_PALETTE8_RGBA8_OES: // 4-component 8:8:8:8, 8-bit palette, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePalettizedBit;
-                formatSize.palleteSize = 256 * 32;
-                formatSize.blockSize = 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_PALETTE8_R5_G6_B5_OES: // 3-component 5:6:5,   8-bit palette, unsigned normalized
-            case GL_PALETTE8_RGBA4_OES: // 4-component 4:4:4:4, 8-bit palette, unsigned normalized
-            case GL_PALETTE8_RGB5_A1_OES: // 4-component 5:5:5:1, 8-bit palette, unsigned normalized
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizePalettizedBit;
-                formatSize.palleteSize = 256 * 16;
-                formatSize.blockSize = 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
 
-            //
-            // Depth/stencil
-            //
-            case GL_DEPTH_COMPONENT16:
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeDepthBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 16;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_DEPTH_COMPONENT24:
-            case GL_DEPTH_COMPONENT32:
-            case GL_DEPTH_COMPONENT32F:
-            case GL_DEPTH_COMPONENT32F_NV:
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeDepthBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 32;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_STENCIL_INDEX1:
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeStencilBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 1;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_STENCIL_INDEX4:
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeStencilBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 4;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_STENCIL_INDEX8:
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeStencilBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_STENCIL_INDEX16:
-                formatSize.flags = KtxFormatSizeFlagBits::eKtxFormatSizeStencilBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 16;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_DEPTH24_STENCIL8:
-                formatSize.flags =
-                        KtxFormatSizeFlagBits::eKtxFormatSizeDepthBit | KtxFormatSizeFlagBits::eKtxFormatSizeStencilBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 32;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
-            case GL_DEPTH32F_STENCIL8:
-            case GL_DEPTH32F_STENCIL8_NV:
-                formatSize.flags =
-                        KtxFormatSizeFlagBits::eKtxFormatSizeDepthBit | KtxFormatSizeFlagBits::eKtxFormatSizeStencilBit;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 64;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
+    const KtxOrientation defaultOrientation{KtxOrientationX::eRight, KtxOrientationY::eDown, KtxOrientationZ::eOut};
 
-            default:
-                formatSize.flags = 0;
-                formatSize.palleteSize = 0;
-                formatSize.blockSize = 0 * 8;
-                formatSize.blockWidth = 1;
-                formatSize.blockHeight = 1;
-                formatSize.blockDepth = 1;
-                break;
+    std::expected<KtxTextureInfo, KtxResult> CreateTextureInfo(KtxHeader& header)
+    {
+        const bool needSwap = header.endianness == endianRefRev;
+        const auto checkedInfo = CheckHeader(header);
+        if (!checkedInfo)
+        {
+            return std::unexpected(checkedInfo.error());
         }
-        return formatSize;
-    }
-} // namespace
-
+        const auto& supplementInfo = *checkedInfo;
 
-void KTX::LoadKTXFromFile(const std::string_view fileName, const KtxCreateFlags flags)
-{
-    std::fstream file(fileName.data(), std::ios::in | std::ios::binary);
-
-    if (!file.is_open())
-        assert(false && "Failed to open file");
-
-    const auto header = DetermineHeader(file);
-    if (std::holds_alternative<KtxHeader>(header))
-    {
-        auto header1 = std::get<KtxHeader>(header);
-        auto supplementInfo = CheckHeader(header1);
-        KtxTexture texture{
-                .formatSize = GetFormatSize(header1.glInternalFormat),
-                .typeSize = header1.glTypeSize,
-                .baseWidth = header1.pixelWidth,
-                .numDimensions = supplementInfo.textureDimension,
-                .orientation{KtxOrientationX::eRight, KtxOrientationY::eDown, KtxOrientationZ::eOut},
-        };
-        assert(supplementInfo.textureDimension > 0 && supplementInfo.textureDimension < 4);
+        KtxTextureInfo info{};
+        info.formatSize = KTX::GetGlFormatSize(header.glInternalFormat);
+        info.typeSize = header.glTypeSize;
+        info.baseWidth = header.pixelWidth;
+        info.numDimensions = supplementInfo.textureDimension;
+        info.orientation = defaultOrientation;
 
         switch (supplementInfo.textureDimension)
         {
             case 1:
-                texture.baseHeight = texture.baseDepth = 1;
+                info.baseHeight = info.baseDepth = 1;
                 break;
             case 2:
-                texture.baseHeight = header1.pixelHeight;
-                texture.baseDepth = 1;
+                info.baseHeight = header.pixelHeight;
+                info.baseDepth = 1;
                 break;
             case 3:
-                texture.baseHeight = header1.pixelHeight;
-                texture.baseDepth = header1.pixelDepth;
+                info.baseHeight = header.pixelHeight;
+                info.baseDepth = header.pixelDepth;
                 break;
         }
 
 
-        if (header1.numArrayElements > 0)
+        if (header.numArrayElements > 0)
         {
-            texture.numLayers = header1.numArrayElements;
-            texture.isArray = true;
+            info.numLayers = header.numArrayElements;
+            info.isArray = true;
         } else
         {
-            texture.numLayers = 1;
-            texture.isArray = false;
+            info.numLayers = 1;
+            info.isArray = false;
         }
-        texture.numFaces = header1.numFaces;
-        if (header1.numFaces == 6)
+        info.numFaces = header.numFaces;
+        if (header.numFaces == 6)
         {
-            texture.isCubeMap = true;
+            info.isCubeMap = true;
         } else
         {
-            texture.isCubeMap = false;
+            info.isCubeMap = false;
         }
-        texture.numLevels = header1.numMipLevels;
-        texture.isCompressed = supplementInfo.compressed;
-        texture.generateMipmaps = supplementInfo.generateMipmaps;
-        texture.typeSize = header1.glTypeSize;
+        info.numLevels = header.numMipLevels;
+        info.isCompressed = supplementInfo.compressed;
+        info.generateMipmaps = supplementInfo.generateMipmaps;
+        info.needSwap = needSwap;
+        info.glFormat = header.glFormat;
+        info.glInternalFormat = header.glInternalFormat;
+        info.vkFormat = KTX::GetVkFormatFromGl(header.glInternalFormat);
+        info.glBaseInternalFormat = header.glBaseInternalFormat;
+        info.glType = header.glType;
+        return info;
+    }
 
-        KtxTexture1 texture1{
-                .texture = texture,
-                .glFormat = header1.glFormat,
-                .glBaseInternalFormat = header1.glBaseInternalFormat,
-                .glType = header1.glType,
-        };
-        if (header1.endianness == endianRefRev)
+    std::expected<KtxTextureInfo, KtxResult> CreateTextureInfo(const Ktx2Header& header)
+    {
+        if (const auto result = CheckHeader(header); result != KtxResult::eSuccess)
         {
-            texture1.needSwap = true;
+            return std::unexpected(result);
         }
 
-        texture.kvData = nullptr;
-        if (header1.keyValueData > 0)
+        const KtxFormatSize formatSize = KTX::GetVkFormatSize(header.vkFormat);
+        KtxTextureInfo info{};
+        info.formatSize = formatSize;
+        info.typeSize = header.typeSize;
+        info.isKtx2 = true;
+        info.isArray = header.layerCount > 0;
+        info.isCubeMap = header.faceCount == 6;
+        info.isCompressed = formatSize.flags & KtxFormatSizeFlagBits::eKtxFormatSizeCompressedBit;
+        info.generateMipmaps = header.levelCount == 0;
+        info.baseWidth = header.pixelWidth;
+        info.baseHeight = std::max(header.pixelHeight, 1u);
+        info.baseDepth = std::max(header.pixelDepth, 1u);
+        info.numDimensions = header.pixelDepth > 0 ? 3u : header.pixelHeight > 0 ? 2u : 1u;
+        info.numLevels = std::max(header.levelCount, 1u);
+        info.numLayers = std::max(header.layerCount, 1u);
+        info.numFaces = header.faceCount;
+        info.orientation = defaultOrientation;
+        info.glInternalFormat = KTX::GetGlFormatFromVk(header.vkFormat);
+        info.vkFormat = header.vkFormat;
+        info.superCompressionScheme = header.superCompressionScheme;
+        return info;
+    }
+
+    // Key/value lengths of a ktx1 file from a machine with the other endianness need swapping too
+    void SwapKeyValueLengths(const std::span<u8> kvData)
+    {
+        u8* src = kvData.data();
+        const u8* end = kvData.data() + kvData.size();
+        while (src + sizeof(u32) <= end)
         {
-            const auto kvdLen = header1.keyValueData;
-            auto pKvd = std::vector<u8>(kvdLen);
-            file.read(reinterpret_cast<char*>(pKvd.data()), kvdLen);
+            u32 keyAndValueByteSize;
+            std::memcpy(&keyAndValueByteSize, src, sizeof(u32));
+            keyAndValueByteSize = SwapEndian32(keyAndValueByteSize);
+            std::memcpy(src, &keyAndValueByteSize, sizeof(u32));
+            src += sizeof(u32) + CalculatePadding(4, keyAndValueByteSize);
+        }
+    }
 
-            if (texture1.needSwap)
+    // Calls visitor(key, value) for every well formed entry of a key/value block until it returns true. Keys have to
+    // be terminated and must not start with a BOM, a length running past the end of the block ends the walk.
+    template<typename Visitor>
+    void VisitKeyValues(const std::span<const u8> kvData, const bool swapLengths, Visitor&& visitor)
+    {
+        u64 offset = 0;
+        while (offset + sizeof(u32) <= kvData.size())
+        {
+            u32 keyAndValueByteSize;
+            std::memcpy(&keyAndValueByteSize, kvData.data() + offset, sizeof(u32));
+            if (swapLengths)
             {
-                u8* src = pKvd.data();
-                u8* end = pKvd.data() + kvdLen;
-                while (src < end)
+                keyAndValueByteSize = SwapEndian32(keyAndValueByteSize);
+            }
+            offset += sizeof(u32);
+            if (!IsInRange(kvData, offset, keyAndValueByteSize))
+            {
+                return;
+            }
+
+            const std::string_view entry(reinterpret_cast<const char*>(kvData.data() + offset), keyAndValueByteSize);
+            const auto keyLength = entry.find('\0');
+            if (keyLength != std::string_view::npos && keyLength > 0 && !entry.starts_with("\xEF\xBB\xBF"))
+            {
+                if (visitor(entry.substr(0, keyLength), kvData.subspan(offset + keyLength + 1,
+                                                                       keyAndValueByteSize - keyLength - 1)))
                 {
-                    auto keyAndValueByteSize = static_cast<u32>(*src);
-                    SwapEndian32(keyAndValueByteSize);
-                    src += CalculatePadding(4, keyAndValueByteSize);
+                    return;
                 }
             }
+            offset += CalculatePadding(4, keyAndValueByteSize);
+        }
+    }
+
+    std::string_view AsString(const std::span<const u8> value)
+    {
+        std::string_view string(reinterpret_cast<const char*>(value.data()), value.size());
+        if (string.ends_with('\0'))
+        {
+            string.remove_suffix(1);
+        }
+        return string;
+    }
+
+    // Ktx1 writes "S=r,T=d,R=i" and ktx2 "rd" or "rdi", the letters of each axis are distinct so order doesn't matter
+    KtxOrientation ParseOrientation(const std::string_view value, KtxOrientation orientation)
+    {
+        for (const char axis : value)
+        {
+            switch (axis)
+            {
+                case 'l':
+                case 'r':
+                    orientation.x = static_cast<KtxOrientationX>(axis);
+                    break;
+                case 'u':
+                case 'd':
+                    orientation.y = static_cast<KtxOrientationY>(axis);
+                    break;
+                case 'i':
+                case 'o':
+                    orientation.z = static_cast<KtxOrientationZ>(axis);
+                    break;
+                default:
+                    break;
+            }
+        }
+        return orientation;
+    }
+
+    // Decodes whatever part of a file is in the buffer: the header has to be complete, key/value entries past the end
+    // are ignored
+    std::expected<KtxTextureInfo, KtxResult> ProbeBuffer(const std::span<const u8> data)
+    {
+        auto header = DetermineHeader(data);
+        if (!header)
+        {
+            return std::unexpected(header.error());
+        }
+
+        std::expected<KtxTextureInfo, KtxResult> info;
+        u64 kvOffset;
+        u64 kvLength;
+        if (auto* header1 = std::get_if<KtxHeader>(&*header))
+        {
+            info = CreateTextureInfo(*header1);
+            kvOffset = ktxHeaderSize;
+            kvLength = header1->keyValueData;
+        } else
+        {
+            const auto& header2 = std::get<Ktx2Header>(*header);
+            info = CreateTextureInfo(header2);
+            kvOffset = header2.keyValueData.byteOffset;
+            kvLength = header2.keyValueData.byteLength;
+        }
+        if (!info || kvOffset >= data.size())
+        {
+            return info;
+        }
+
+        // A linear walk, building a map would allocate
+        const auto kvData = data.subspan(kvOffset, std::min(kvLength, data.size() - kvOffset));
+        VisitKeyValues(kvData, info->needSwap,
+                       [&](const std::string_view key, const std::span<const u8> value)
+                       {
+                           if (key != "KTXorientation")
+                           {
+                               return false;
+                           }
+                           info->orientation = ParseOrientation(AsString(value), info->orientation);
+                           return true;
+                       });
+        return info;
+    }
+
+    // Packs the raw ktx1 level data that follows the key/value block in place, dropping the imageSize fields as well
+    // as the cube and mip padding. Returns the packed size.
+    std::expected<u64, KtxResult> CompactKtx1ImageData(const std::span<u8> data, const KtxHeader& header,
+                                                       const bool needSwap, std::vector<KtxLevelRange>& levels)
+    {
+        const bool perFaceImageSize = header.numFaces == 6 && header.numArrayElements == 0;
+        levels.resize(header.numMipLevels);
+
+        u64 readOffset = 0;
+        u64 dataSize = 0;
+        for (u32 level = 0; level < header.numMipLevels; ++level)
+        {
+            u32 imageSize = 0;
+            if (!IsInRange(data, readOffset, sizeof(imageSize)))
+            {
+                return std::unexpected(KtxResult::eFileReadError);
+            }
+            std::memcpy(&imageSize, data.data() + readOffset, sizeof(imageSize));
+            if (needSwap)
+            {
+                imageSize = SwapEndian32(imageSize);
+            }
+            readOffset += sizeof(imageSize);
+
+            const u32 numChunks = perFaceImageSize ? header.numFaces : 1;
+            levels[level] = {.byteOffset = dataSize, .byteLength = static_cast<u64>(numChunks) * imageSize};
+            for (u32 chunk = 0; chunk < numChunks; ++chunk)
+            {
+                if (!IsInRange(data, readOffset, imageSize))
+                {
+                    return std::unexpected(KtxResult::eFileReadError);
+                }
+                // The write position always trails the read position, so moving forward is safe. Big endian data is
+                // swapped on the way, the bytes are touched anyway.
+                if (needSwap && header.glTypeSize > 1)
+                {
+                    CopySwapped(data.data() + readOffset, data.data() + dataSize, imageSize, header.glTypeSize);
+                } else
+                {
+                    std::memmove(data.data() + dataSize, data.data() + readOffset, imageSize);
+                }
+                dataSize += imageSize;
+                readOffset += CalculatePadding(4, imageSize);
+            }
+        }
+        return dataSize;
+    }
+
+    // Reads every level with a single read and packs them into one buffer
+    KtxResult ReadKtx1ImageData(KTX::KtxStream& stream, const u64 dataStart, const KtxHeader& header,
+                                const bool needSwap, KTX::KtxTexture& texture)
+    {
+        if (dataStart > stream.GetSize())
+        {
+            return KtxResult::eFileReadError;
+        }
+        const u64 remaining = stream.GetSize() - dataStart;
+        auto data = std::make_unique_for_overwrite<u8[]>(remaining);
+        if (!stream.Read(dataStart, {data.get(), remaining}))
+        {
+            return KtxResult::eFileReadError;
+        }
+
+        std::vector<KtxLevelRange> levels;
+        const auto dataSize = CompactKtx1ImageData({data.get(), remaining}, header, needSwap, levels);
+        if (!dataSize)
+        {
+            return dataSize.error();
+        }
+        texture.SetImageData(std::move(data), *dataSize, std::move(levels));
+        return KtxResult::eSuccess;
+    }
+
+    // Builds a level index for a ktx1 file by hopping from one imageSize field to the next, only 4 bytes per level
+    // are read
+    std::vector<KtxLevelIndexEntry> WalkKtx1Levels(KTX::KtxStream& stream, u64 offset, const KtxHeader& header,
+                                                   const bool needSwap)
+    {
+        const bool perFaceImageSize = header.numFaces == 6 && header.numArrayElements == 0;
+        std::vector<KtxLevelIndexEntry> levelIndex;
+        levelIndex.reserve(header.numMipLevels);
+
+        for (u32 level = 0; level < header.numMipLevels; ++level)
+        {
+            u32 imageSize = 0;
+            if (!stream.Read(offset, {reinterpret_cast<u8*>(&imageSize), sizeof(imageSize)}))
+            {
+                break;
+            }
+            if (needSwap)
+            {
+                imageSize = SwapEndian32(imageSize);
+            }
+            offset += sizeof(imageSize);
+
+            const u32 numChunks = perFaceImageSize ? header.numFaces : 1;
+            const u64 levelSize = static_cast<u64>(numChunks) * imageSize;
+            levelIndex.push_back({.byteOffset = offset, .byteLength = levelSize, .uncompressedByteLength = levelSize});
+            offset += numChunks * CalculatePadding(4, imageSize);
+        }
+        return levelIndex;
+    }
+
+    std::expected<std::vector<u8>, KtxResult> ReadStreamRange(KTX::KtxStream& stream, const u64 offset,
+                                                               const u64 length)
+    {
+        if (offset > stream.GetSize() || length > stream.GetSize() - offset)
+        {
+            return std::unexpected(KtxResult::eFileDataError);
+        }
+        std::vector<u8> data(length);
+        if (!stream.Read(offset, data))
+        {
+            return std::unexpected(KtxResult::eFileReadError);
+        }
+        return data;
+    }
+
+    // Runs task(index) for every index, spread over the pool if there is one
+    template<typename Task>
+    void RunParallel(KTX::KtxThreadPool* pool, const u32 count, const Task& task)
+    {
+        if (pool != nullptr)
+        {
+            pool->ParallelFor(count, task);
+            return;
+        }
+        for (u32 index = 0; index < count; ++index)
+        {
+            task(index);
+        }
+    }
+
+    // BasisLZ levels are handed out as stored, KtxTranscoder turns them into blocks afterwards
+    KtxSupercompressionScheme GetLevelScheme(const u32 superCompressionScheme)
+    {
+        const auto scheme = static_cast<KtxSupercompressionScheme>(superCompressionScheme);
+        return scheme == KtxSupercompressionScheme::eBasisLZ ? KtxSupercompressionScheme::eNone : scheme;
+    }
+
+    // Size of a level once decoded, BasisLZ files leave uncompressedByteLength at 0
+    u64 GetDecodedSize(const KtxLevelIndexEntry& entry, const KtxSupercompressionScheme scheme)
+    {
+        return scheme == KtxSupercompressionScheme::eNone ? entry.byteLength : entry.uncompressedByteLength;
+    }
+
+    u64 GetUncompressedSize(const std::span<const KtxLevelIndexEntry> levelIndex,
+                            const KtxSupercompressionScheme scheme)
+    {
+        u64 size = 0;
+        for (const auto& entry : levelIndex)
+        {
+            size += GetDecodedSize(entry, scheme);
+        }
+        return size;
+    }
+
+    // Decompresses every level into the destination, back to back starting with level 0. data holds the stored
+    // levels and starts at dataOffset in the file. Levels are independent, so each one is a task of its own.
+    KtxResult DecompressKtx2Levels(const KtxSupercompressionScheme scheme,
+                                   const std::span<const KtxLevelIndexEntry> levelIndex, const std::span<const u8> data,
+                                   const u64 dataOffset, const std::span<u8> destination, KTX::KtxThreadPool* pool)
+    {
+        if (!KTX::Supercompression::IsSupported(scheme))
+        {
+            return KtxResult::eUnsupportedFeature;
+        }
+
+        std::vector<u64> destinationOffsets(levelIndex.size());
+        u64 destinationOffset = 0;
+        for (u32 level = 0; level < levelIndex.size(); ++level)
+        {
+            const auto& entry = levelIndex[level];
+            if (entry.byteOffset < dataOffset || !IsInRange(data, entry.byteOffset - dataOffset, entry.byteLength) ||
+                !IsInRange(destination, destinationOffset, GetDecodedSize(entry, scheme)))
+            {
+                return KtxResult::eFileDataError;
+            }
+            destinationOffsets[level] = destinationOffset;
+            destinationOffset += GetDecodedSize(entry, scheme);
+        }
+
+        std::vector results(levelIndex.size(), KtxResult::eSuccess);
+        RunParallel(pool, static_cast<u32>(levelIndex.size()),
+                    [&](const u32 level)
+                    {
+                        const auto& entry = levelIndex[level];
+                        results[level] = KTX::Supercompression::DecompressLevel(
+                                scheme, data.subspan(entry.byteOffset - dataOffset, entry.byteLength),
+                                destination.subspan(destinationOffsets[level], GetDecodedSize(entry, scheme)));
+                    });
+        for (const auto result : results)
+        {
+            if (result != KtxResult::eSuccess)
+            {
+                return result;
+            }
+        }
+        return KtxResult::eSuccess;
+    }
+
+    // Reads the range covering every stored level of a ktx2 file, levels are stored back to back so this is one read
+    std::expected<std::vector<u8>, KtxResult> ReadKtx2Levels(KTX::KtxStream& stream,
+                                                              const std::span<const KtxLevelIndexEntry> levelIndex,
+                                                              u64& dataOffset)
+    {
+        u64 levelsBegin = stream.GetSize();
+        u64 levelsEnd = 0;
+        for (const auto& entry : levelIndex)
+        {
+            levelsBegin = std::min(levelsBegin, entry.byteOffset);
+            levelsEnd = std::max(levelsEnd, entry.byteOffset + entry.byteLength);
+        }
+        dataOffset = levelsBegin;
+        return ReadStreamRange(stream, levelsBegin, levelsEnd > levelsBegin ? levelsEnd - levelsBegin : 0);
+    }
+
+    std::span<const u8> MapFile(const std::string_view fileName)
+    {
+        const std::string path(fileName);
+#if defined(_WIN32)
+        const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                        FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return {};
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return {};
+        }
+
+        // The view keeps the mapping alive, so both handles can be closed straight away
+        const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr)
+        {
+            return {};
+        }
+        const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (view == nullptr)
+        {
+            return {};
+        }
+        return {static_cast<const u8*>(view), static_cast<size_t>(fileSize.QuadPart)};
+#else
+        const int file = open(path.c_str(), O_RDONLY);
+        if (file == -1)
+        {
+            return {};
+        }
+
+        struct stat fileStat{};
+        if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+        {
+            close(file);
+            return {};
+        }
+
+        void* view = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (view == MAP_FAILED)
+        {
+            return {};
+        }
+        return {static_cast<const u8*>(view), static_cast<size_t>(fileStat.st_size)};
+#endif
+    }
+
+    void UnmapFile(const std::span<const u8> view)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(view.data());
+#else
+        munmap(const_cast<u8*>(view.data()), view.size());
+#endif
+    }
+} // namespace
+
+
+std::string_view KTX::ToString(const KtxResult result)
+{
+    switch (result)
+    {
+        case KtxResult::eSuccess:
+            return "Success";
+        case KtxResult::eFileOpenFailed:
+            return "File open failed";
+        case KtxResult::eFileReadError:
+            return "File read error";
+        case KtxResult::eUnknownFileFormat:
+            return "Unknown file format";
+        case KtxResult::eFileDataError:
+            return "File data error";
+        case KtxResult::eUnsupportedFeature:
+            return "Unsupported feature";
+        case KtxResult::eFileWriteError:
+            return "File write error";
+    }
+    return "Unknown result";
+}
+
+KTX::KtxKeyValueMap::KtxKeyValueMap(const std::span<const u8> kvData, const bool swapLengths)
+{
+    // Count first so the entries land in one allocation
+    u64 entryCount = 0;
+    VisitKeyValues(kvData, swapLengths,
+                   [&](std::string_view, std::span<const u8>)
+                   {
+                       ++entryCount;
+                       return false;
+                   });
+
+    entries.reserve(entryCount);
+    VisitKeyValues(kvData, swapLengths,
+                   [&](const std::string_view key, const std::span<const u8> value)
+                   {
+                       entries.push_back({key, value});
+                       return false;
+                   });
+    std::ranges::sort(entries, {}, &KtxKeyValue::key);
+}
+
+const KTX::KtxKeyValue* KTX::KtxKeyValueMap::Find(const std::string_view key) const
+{
+    const auto entry = std::ranges::lower_bound(entries, key, {}, &KtxKeyValue::key);
+    return entry != entries.end() && entry->key == key ? &*entry : nullptr;
+}
+
+std::string_view KTX::KtxKeyValueMap::FindString(const std::string_view key) const
+{
+    const auto* entry = Find(key);
+    return entry != nullptr ? AsString(entry->value) : std::string_view();
+}
+
+KTX::KtxTexture::KtxTexture(const KtxTextureInfo& info, std::vector<u8> keyValueData) :
+    info(info), keyValueData(std::move(keyValueData)), keyValues(this->keyValueData)
+{
+    if (const auto orientation = keyValues.FindString("KTXorientation"); !orientation.empty())
+    {
+        this->info.orientation = ParseOrientation(orientation, this->info.orientation);
+    }
+}
+
+KTX::KtxTexture::~KtxTexture() = default;
+KTX::KtxTexture::KtxTexture(KtxTexture&& other) noexcept = default;
+KTX::KtxTexture& KTX::KtxTexture::operator=(KtxTexture&& other) noexcept = default;
+
+KTX::u64 KTX::KtxTexture::GetLevelSize(const u32 level) const
+{
+    const auto& formatSize = info.formatSize;
+    if (formatSize.blockSize == 0)
+    {
+        return 0;
+    }
+
+    const u64 blocksX = std::max((GetLevelWidth(level) + formatSize.blockWidth - 1) / formatSize.blockWidth,
+                                 formatSize.minBlocksX);
+    const u64 blocksY = std::max((GetLevelHeight(level) + formatSize.blockHeight - 1) / formatSize.blockHeight,
+                                 formatSize.minBlocksY);
+    const u64 blocksZ = (GetLevelDepth(level) + formatSize.blockDepth - 1) / formatSize.blockDepth;
+
+    u64 rowSize = blocksX * formatSize.blockSize / 8;
+    if (!info.isKtx2 && !info.isCompressed)
+    {
+        // Ktx1 rows follow GL_UNPACK_ALIGNMENT 4
+        rowSize = CalculatePadding(4, rowSize);
+    }
+    return rowSize * blocksY * blocksZ * info.numLayers * info.numFaces;
+}
+
+KTX::u64 KTX::KtxTexture::GetUncompressedSize() const
+{
+    return ::GetUncompressedSize(levelIndex, GetLevelScheme(info.superCompressionScheme));
+}
+
+bool KTX::KtxTexture::ReadLevel(const u32 level, const std::span<u8> destination)
+{
+    assert(stream != nullptr && "Texture has no open source to read from");
+    assert(level < levelIndex.size() && "Level out of range");
+    const auto& entry = levelIndex[level];
+    const auto scheme = GetLevelScheme(info.superCompressionScheme);
+    assert(destination.size() >= GetDecodedSize(entry, scheme) && "Destination is too small");
+
+    if (scheme != KtxSupercompressionScheme::eNone)
+    {
+        // Reused by every read on this thread, streaming levels one after another doesn't allocate
+        thread_local std::vector<u8> compressed;
+        compressed.resize(entry.byteLength);
+        return stream->Read(entry.byteOffset, compressed) &&
+               Supercompression::DecompressLevel(scheme, compressed,
+                                                 destination.first(entry.uncompressedByteLength)) ==
+                       KtxResult::eSuccess;
+    }
+
+    // Non array ktx1 cube maps pad every face to 4 bytes, everything else is one contiguous range. Big endian data is
+    // swapped chunk by chunk while it is still in cache from the read.
+    const u32 numChunks = !info.isKtx2 && info.isCubeMap && !info.isArray ? info.numFaces : 1;
+    const u64 chunkSize = entry.byteLength / numChunks;
+    const u32 swapSize = GetSwapSize(info);
+    for (u32 chunk = 0; chunk < numChunks; ++chunk)
+    {
+        const auto chunkData = destination.subspan(chunk * chunkSize, chunkSize);
+        if (!stream->Read(entry.byteOffset + chunk * CalculatePadding(4, chunkSize), chunkData))
+        {
+            return false;
+        }
+        if (swapSize > 1)
+        {
+            CopySwapped(chunkData.data(), chunkData.data(), chunkData.size(), swapSize);
+        }
+    }
+    return true;
+}
+
+bool KTX::KtxTexture::StreamLevel(const u32 level, const std::span<u8> buffer, const KtxChunkCallback& onChunk)
+{
+    assert(stream != nullptr && "Texture has no open source to read from");
+    assert(level < levelIndex.size() && "Level out of range");
+    const auto& entry = levelIndex[level];
+
+    // Offsets are relative to the stored level, non array ktx1 cube maps skip the padding after every face. Big endian
+    // data is swapped as it is read, with chunks cut to whole elements so none is split between two reads.
+    const u32 numChunks = !info.isKtx2 && info.isCubeMap && !info.isArray ? info.numFaces : 1;
+    const u64 chunkSize = entry.byteLength / numChunks;
+    const u32 swapSize = GetSwapSize(info);
+    if (buffer.size() < swapSize)
+    {
+        return false;
+    }
+    const auto chunkBuffer = buffer.first(buffer.size() / swapSize * swapSize);
+    const auto read = [&](u64 offset, std::span<u8> destination)
+    {
+        while (!destination.empty())
+        {
+            const u64 chunk = offset / chunkSize;
+            const u64 length = std::min<u64>(destination.size(), chunkSize - offset % chunkSize);
+            if (!stream->Read(entry.byteOffset + chunk * CalculatePadding(4, chunkSize) + offset % chunkSize,
+                              destination.first(length)))
+            {
+                return false;
+            }
+            if (swapSize > 1)
+            {
+                CopySwapped(destination.data(), destination.data(), length, swapSize);
+            }
+            offset += length;
+            destination = destination.subspan(length);
+        }
+        return true;
+    };
+
+    bool stopped = false;
+    const auto scheme = GetLevelScheme(info.superCompressionScheme);
+    const auto result = Supercompression::DecompressLevelStreaming(
+            scheme, entry.byteLength, GetDecodedSize(entry, scheme), read, chunkBuffer,
+            [&](const std::span<const u8> chunk)
+            {
+                stopped = !onChunk(chunk);
+                return !stopped;
+            });
+    return result == KtxResult::eSuccess && !stopped;
+}
+
+bool KTX::KtxTexture::ReadLevels(KtxThreadPool& pool, const std::span<u8> destination)
+{
+    assert(stream != nullptr && "Texture has no open source to read from");
+    assert(destination.size() >= GetUncompressedSize() && "Destination is too small");
+    if (!info.isKtx2)
+    {
+        // Ktx1 levels are interleaved with imageSize fields, there is nothing to decompress anyway
+        u64 offset = 0;
+        for (u32 level = 0; level < levelIndex.size(); ++level)
+        {
+            if (!ReadLevel(level, destination.subspan(offset, levelIndex[level].byteLength)))
+            {
+                return false;
+            }
+            offset += levelIndex[level].byteLength;
+        }
+        return true;
+    }
+
+    u64 dataOffset = 0;
+    const auto data = ReadKtx2Levels(*stream, levelIndex, dataOffset);
+    return data && DecompressKtx2Levels(GetLevelScheme(info.superCompressionScheme), levelIndex, *data, dataOffset,
+                                        destination, &pool) == KtxResult::eSuccess;
+}
+
+KTX::u64 KTX::KtxMipStreamer::GetNextLevelSize() const
+{
+    assert(HasNext() && "No levels left to stream");
+    const auto scheme = GetLevelScheme(texture->GetInfo().superCompressionScheme);
+    return GetDecodedSize(texture->GetLevelIndex()[GetNextLevel()], scheme);
+}
+
+bool KTX::KtxMipStreamer::StreamNext(const std::span<u8> destination)
+{
+    assert(HasNext() && "No levels left to stream");
+    if (!texture->ReadLevel(GetNextLevel(), destination))
+    {
+        return false;
+    }
+    --remainingLevels;
+    return true;
+}
+
+std::span<const KTX::u8> KTX::KtxTexture::GetLevel(const u32 level) const
+{
+    assert(HasImageData() && "Image data was not loaded");
+    assert(level < levels.size() && "Level out of range");
+    return GetImageData().subspan(levels[level].byteOffset, levels[level].byteLength);
+}
+
+void KTX::KtxTexture::SetImageData(std::unique_ptr<u8[]> data, const u64 size, std::vector<KtxLevelRange> levelRanges)
+{
+    imageData = std::move(data);
+    imageSize = size;
+    levels = std::move(levelRanges);
+}
+
+KTX::KtxFileStream::KtxFileStream(const std::string_view fileName) :
+    file(std::make_unique<std::fstream>(std::string(fileName), std::ios::in | std::ios::binary))
+{
+    if (file->is_open())
+    {
+        file->seekg(0, std::ios::end);
+        size = static_cast<u64>(file->tellg());
+    }
+}
+
+KTX::KtxFileStream::~KtxFileStream() = default;
+
+bool KTX::KtxFileStream::IsOpen() const
+{
+    return file->is_open();
+}
+
+bool KTX::KtxFileStream::Read(const u64 offset, const std::span<u8> destination)
+{
+    file->clear();
+    file->seekg(static_cast<std::streamoff>(offset));
+    file->read(reinterpret_cast<char*>(destination.data()), static_cast<std::streamsize>(destination.size()));
+    return static_cast<bool>(*file);
+}
+
+bool KTX::KtxMemoryStream::Read(const u64 offset, const std::span<u8> destination)
+{
+    if (!IsInRange(data, offset, destination.size()))
+    {
+        return false;
+    }
+    if (!destination.empty())
+    {
+        std::memcpy(destination.data(), data.data() + offset, destination.size());
+    }
+    return true;
+}
+
+KTX::KtxLoadResult KTX::LoadKTXFromFile(const std::string_view fileName, const KtxCreateFlags flags)
+{
+    auto stream = std::make_unique<KtxFileStream>(fileName);
+    if (!stream->IsOpen())
+    {
+        return std::unexpected(KtxResult::eFileOpenFailed);
+    }
+    return LoadKTXFromStream(std::move(stream), flags);
+}
+
+KTX::KtxLoadResult KTX::LoadKTXFromMemory(const std::span<const u8> data, const KtxCreateFlags flags)
+{
+    return LoadKTXFromStream(std::make_unique<KtxMemoryStream>(data), flags);
+}
+
+KTX::KtxLoadResult KTX::LoadKTXFromStream(std::unique_ptr<KtxStream> stream, const KtxCreateFlags flags)
+{
+    assert(stream != nullptr && "Invalid stream");
+    const auto header = DetermineHeader(*stream);
+    if (!header)
+    {
+        return std::unexpected(header.error());
+    }
+    if (std::holds_alternative<KtxHeader>(*header))
+    {
+        auto header1 = std::get<KtxHeader>(*header);
+        const auto info = CreateTextureInfo(header1);
+        if (!info)
+        {
+            return std::unexpected(info.error());
+        }
+
+        auto kvData = ReadStreamRange(*stream, ktxHeaderSize, header1.keyValueData);
+        if (!kvData)
+        {
+            return std::unexpected(kvData.error() == KtxResult::eFileDataError ? KtxResult::eFileReadError
+                                                                              : kvData.error());
+        }
+        if (info->needSwap)
+        {
+            SwapKeyValueLengths(*kvData);
+        }
+
+        KtxTexture texture(*info, std::move(*kvData));
+        const u64 dataStart = ktxHeaderSize + static_cast<u64>(header1.keyValueData);
+        if (flags & KtxCreateFlags::eLoadImageData)
+        {
+            if (const auto result = ReadKtx1ImageData(*stream, dataStart, header1, info->needSwap, texture);
+                result != KtxResult::eSuccess)
+            {
+                return std::unexpected(result);
+            }
+        } else
+        {
+            texture.levelIndex = WalkKtx1Levels(*stream, dataStart, header1, info->needSwap);
+            if (texture.levelIndex.size() != info->numLevels)
+            {
+                return std::unexpected(KtxResult::eFileReadError);
+            }
+            texture.stream = std::move(stream);
+        }
+        return texture;
+    }
+
+    const auto& header2 = std::get<Ktx2Header>(*header);
+    const auto info = CreateTextureInfo(header2);
+    if (!info)
+    {
+        return std::unexpected(info.error());
+    }
 
-            char* orientation;
-            u32 orientationLen;
+    // The level index directly follows the header
+    std::vector<KtxLevelIndexEntry> levelIndex(info->numLevels);
+    if (!stream->Read(ktx2HeaderSize, {reinterpret_cast<u8*>(levelIndex.data()),
+                                       levelIndex.size() * sizeof(KtxLevelIndexEntry)}))
+    {
+        return std::unexpected(KtxResult::eFileReadError);
+    }
 
-            HashListDeserialize(texture.kvDataHead, kvdLen, pKvd.data());
-            HashListFindValue
+    auto kvData = ReadStreamRange(*stream, header2.keyValueData.byteOffset, header2.keyValueData.byteLength);
+    auto dfdData =
+            ReadStreamRange(*stream, header2.dataFormatDescriptor.byteOffset, header2.dataFormatDescriptor.byteLength);
+    auto sgdData = ReadStreamRange(*stream, header2.superCompressionGlobalData.byteOffset,
+                                   header2.superCompressionGlobalData.byteLength);
+    for (const auto* range : {&kvData, &dfdData, &sgdData})
+    {
+        if (!*range)
+        {
+            return std::unexpected(range->error());
+        }
+    }
+
+    KtxTexture texture(*info, std::move(*kvData));
+    texture.dataFormatDescriptor = std::move(*dfdData);
+    texture.formatDescriptor = InternDataFormatDescriptor(texture.dataFormatDescriptor);
+    texture.superCompressionGlobalData = std::move(*sgdData);
+
+    if (flags & KtxCreateFlags::eLoadImageData)
+    {
+        const auto scheme = GetLevelScheme(info->superCompressionScheme);
+        const bool supercompressed = scheme != KtxSupercompressionScheme::eNone;
+        u64 dataSize = 0;
+        std::vector<KtxLevelRange> levels(levelIndex.size());
+        for (u32 level = 0; level < levelIndex.size(); ++level)
+        {
+            const u64 levelSize = GetDecodedSize(levelIndex[level], scheme);
+            levels[level] = {.byteOffset = dataSize, .byteLength = levelSize};
+            dataSize += levelSize;
         }
 
+        auto data = std::make_unique_for_overwrite<u8[]>(dataSize);
+        if (supercompressed)
+        {
+            u64 storedOffset = 0;
+            const auto stored = ReadKtx2Levels(*stream, levelIndex, storedOffset);
+            if (!stored)
+            {
+                return std::unexpected(stored.error());
+            }
+            if (const auto result = DecompressKtx2Levels(scheme, levelIndex, *stored, storedOffset,
+                                                         {data.get(), dataSize}, nullptr);
+                result != KtxResult::eSuccess)
+            {
+                return std::unexpected(result);
+            }
+        } else
+        {
+            for (u32 level = 0; level < levelIndex.size(); ++level)
+            {
+                if (!stream->Read(levelIndex[level].byteOffset,
+                                  {data.get() + levels[level].byteOffset, levelIndex[level].byteLength}))
+                {
+                    return std::unexpected(KtxResult::eFileReadError);
+                }
+            }
+        }
+        texture.SetImageData(std::move(data), dataSize, std::move(levels));
     } else
     {
-        auto header2 = std::get<Ktx2Header>(header);
+        texture.stream = std::move(stream);
+    }
+    texture.levelIndex = std::move(levelIndex);
+    return texture;
+}
+
+KTX::KtxMappedFile::~KtxMappedFile()
+{
+    Unmap();
+}
+
+KTX::KtxMappedFile::KtxMappedFile(KtxMappedFile&& other) noexcept :
+    data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)), isKtx2(other.isKtx2),
+    needSwap(other.needSwap), typeSize(other.typeSize), keyValueData(std::exchange(other.keyValueData, {})),
+    levels(std::move(other.levels))
+{
+}
+
+KTX::KtxMappedFile& KTX::KtxMappedFile::operator=(KtxMappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Unmap();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+        isKtx2 = other.isKtx2;
+        needSwap = other.needSwap;
+        typeSize = other.typeSize;
+        keyValueData = std::exchange(other.keyValueData, {});
+        levels = std::move(other.levels);
+    }
+    return *this;
+}
+
+std::span<const KTX::u8> KTX::KtxMappedFile::GetHeader() const
+{
+    if (data == nullptr)
+    {
+        return {};
+    }
+    return {data, isKtx2 ? ktx2HeaderSize : ktxHeaderSize};
+}
+
+std::span<const KTX::u8> KTX::KtxMappedFile::GetLevel(const u32 level) const
+{
+    assert(level < levels.size() && "Level out of range");
+    return levels[level];
+}
+
+std::vector<KTX::u8> KTX::KtxMappedFile::CopyLevel(const u32 level) const
+{
+    const auto levelData = GetLevel(level);
+    if (!needSwap || typeSize == 1)
+    {
+        return {levelData.begin(), levelData.end()};
+    }
+    std::vector<u8> copy(levelData.size());
+    CopySwapped(levelData.data(), copy.data(), levelData.size(), typeSize);
+    return copy;
+}
+
+void KTX::KtxMappedFile::Unmap()
+{
+    if (data != nullptr)
+    {
+        UnmapFile({data, size});
+    }
+    data = nullptr;
+    size = 0;
+    keyValueData = {};
+    levels.clear();
+}
+
+std::vector<std::future<KTX::KtxLoadResult>> KTX::LoadKTXBatch(KtxThreadPool& pool,
+                                                                const std::span<const std::string> fileNames,
+                                                                const KtxCreateFlags flags)
+{
+    std::vector<std::future<KtxLoadResult>> results;
+    results.reserve(fileNames.size());
+    for (const auto& fileName : fileNames)
+    {
+        auto promise = std::make_shared<std::promise<KtxLoadResult>>();
+        results.emplace_back(promise->get_future());
+        pool.Submit([promise, fileName, flags] { promise->set_value(LoadKTXFromFile(fileName, flags)); });
+    }
+    return results;
+}
+
+void KTX::LoadKTXBatch(KtxThreadPool& pool, const std::span<const std::string> fileNames, const KtxCreateFlags flags,
+                       KtxLoadCallback onLoaded)
+{
+    auto callback = std::make_shared<KtxLoadCallback>(std::move(onLoaded));
+    for (size_t index = 0; index < fileNames.size(); ++index)
+    {
+        pool.Submit([callback, index, fileName = fileNames[index], flags]
+                    { (*callback)(index, LoadKTXFromFile(fileName, flags)); });
+    }
+}
+
+std::vector<KTX::KtxLoadResult> KTX::LoadKTXBulk(const std::span<const std::string> fileNames,
+                                                const KtxCreateFlags flags)
+{
+    std::vector<KtxLoadResult> results;
+    results.reserve(fileNames.size());
+#if defined(_WIN32)
+    for (const auto& fileName : fileNames)
+    {
+        results.emplace_back(LoadKTXFromFile(fileName, flags));
+    }
+#else
+    // Big enough for the header, level index, DFD and key/value data of nearly every file
+    constexpr u32 slotSize = 4096;
+    constexpr u32 groupSize = 64;
+    const auto backend = Io::CreateBackend(groupSize, slotSize);
+
+    struct PendingFile
+    {
+        int file = -1;
+        u64 fileSize = 0;
+        KtxResult result = KtxResult::eSuccess;
+        std::variant<KtxHeader, Ktx2Header> header;
+        KtxTextureInfo info{};
+        std::vector<u8> metadata;
+        std::optional<KtxTexture> texture;
+        std::unique_ptr<u8[]> imageData;
+        u64 imageDataOffset = 0;
+        u64 imageDataLength = 0;
+    };
+
+    std::vector<PendingFile> group;
+    std::vector<Io::ReadRequest> requests;
+    std::vector<u32> requestOwners;
+    const auto readAll = [&]
+    {
+        backend->Read(requests);
+        for (u32 i = 0; i < requests.size(); ++i)
+        {
+            if (requests[i].result < 0 || static_cast<u64>(requests[i].result) != requests[i].length)
+            {
+                group[requestOwners[i]].result = KtxResult::eFileReadError;
+            }
+        }
+        requests.clear();
+        requestOwners.clear();
+    };
+
+    for (size_t first = 0; first < fileNames.size(); first += groupSize)
+    {
+        const auto names = fileNames.subspan(first, std::min<size_t>(groupSize, fileNames.size() - first));
+        group.clear();
+        group.resize(names.size());
+
+        // Open everything, then read the first slot worth of every file in one go
+        for (u32 i = 0; i < names.size(); ++i)
+        {
+            auto& pending = group[i];
+            pending.file = open(names[i].c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat fileStat{};
+            if (pending.file == -1 || fstat(pending.file, &fileStat) != 0)
+            {
+                pending.result = KtxResult::eFileOpenFailed;
+                continue;
+            }
+            pending.fileSize = static_cast<u64>(fileStat.st_size);
+            requests.push_back({.file = pending.file,
+                                .offset = 0,
+                                .length = std::min<u64>(pending.fileSize, slotSize),
+                                .destination = nullptr,
+                                .stagingSlot = i,
+                                .result = 0});
+            requestOwners.push_back(i);
+        }
+        readAll();
+
+        // Decode the headers and fetch the metadata that didn't fit into the first read
+        for (u32 i = 0; i < names.size(); ++i)
+        {
+            auto& pending = group[i];
+            if (pending.result != KtxResult::eSuccess)
+            {
+                continue;
+            }
+
+            const auto prefix = backend->GetStagingSlot(i).first(std::min<u64>(pending.fileSize, slotSize));
+            const auto header = DetermineHeader(prefix);
+            if (!header)
+            {
+                pending.result = header.error();
+                continue;
+            }
+            pending.header = *header;
+
+            // Ktx1 headers are brought into native order here, before any offset is taken from them
+            const auto info = std::visit([](auto& fileHeader) { return CreateTextureInfo(fileHeader); },
+                                         pending.header);
+            if (!info)
+            {
+                pending.result = info.error();
+                continue;
+            }
+            pending.info = *info;
+
+            u64 metadataEnd;
+            bool validRanges = true;
+            if (const auto* header1 = std::get_if<KtxHeader>(&pending.header))
+            {
+                metadataEnd = ktxHeaderSize + static_cast<u64>(header1->keyValueData);
+            } else
+            {
+                const auto& header2 = std::get<Ktx2Header>(pending.header);
+                metadataEnd = ktx2HeaderSize + std::max(header2.levelCount, 1u) * sizeof(KtxLevelIndexEntry);
+                const auto addRange = [&](const u64 offset, const u64 length)
+                {
+                    validRanges = validRanges && IsInRange(pending.fileSize, offset, length);
+                    metadataEnd = validRanges ? std::max(metadataEnd, offset + length) : metadataEnd;
+                };
+                addRange(header2.dataFormatDescriptor.byteOffset, header2.dataFormatDescriptor.byteLength);
+                addRange(header2.keyValueData.byteOffset, header2.keyValueData.byteLength);
+                addRange(header2.superCompressionGlobalData.byteOffset, header2.superCompressionGlobalData.byteLength);
+            }
+            if (!validRanges || metadataEnd > pending.fileSize)
+            {
+                pending.result = KtxResult::eFileDataError;
+                continue;
+            }
+
+            if (metadataEnd <= prefix.size())
+            {
+                pending.metadata.assign(prefix.begin(), prefix.begin() + static_cast<std::ptrdiff_t>(metadataEnd));
+            } else
+            {
+                pending.metadata.resize(metadataEnd);
+                requests.push_back({.file = pending.file,
+                                    .offset = 0,
+                                    .length = metadataEnd,
+                                    .destination = pending.metadata.data(),
+                                    .stagingSlot = 0,
+                                    .result = 0});
+                requestOwners.push_back(i);
+            }
+        }
+        readAll();
+
+        // Build the textures and queue the image data reads
+        for (u32 i = 0; i < names.size(); ++i)
+        {
+            auto& pending = group[i];
+            if (pending.result != KtxResult::eSuccess)
+            {
+                continue;
+            }
+
+            const auto& info = pending.info;
+            if (std::holds_alternative<KtxHeader>(pending.header))
+            {
+                std::vector kvData(pending.metadata.begin() + ktxHeaderSize, pending.metadata.end());
+                if (info.needSwap)
+                {
+                    SwapKeyValueLengths(kvData);
+                }
+                pending.texture.emplace(info, std::move(kvData));
+                pending.imageDataOffset = pending.metadata.size();
+                pending.imageDataLength = pending.fileSize - pending.imageDataOffset;
+            } else
+            {
+                const auto& header2 = std::get<Ktx2Header>(pending.header);
+                const std::span<const u8> metadata = pending.metadata;
+                const auto copyRange = [&](const u64 offset, const u64 length)
+                {
+                    const auto range = metadata.subspan(offset, length);
+                    return std::vector(range.begin(), range.end());
+                };
+                pending.texture.emplace(info,
+                                        copyRange(header2.keyValueData.byteOffset, header2.keyValueData.byteLength));
+                auto& texture = *pending.texture;
+                texture.dataFormatDescriptor =
+                        copyRange(header2.dataFormatDescriptor.byteOffset, header2.dataFormatDescriptor.byteLength);
+                texture.formatDescriptor = InternDataFormatDescriptor(texture.dataFormatDescriptor);
+                texture.superCompressionGlobalData = copyRange(header2.superCompressionGlobalData.byteOffset,
+                                                               header2.superCompressionGlobalData.byteLength);
+                texture.levelIndex.resize(info.numLevels);
+                std::memcpy(texture.levelIndex.data(), metadata.data() + ktx2HeaderSize,
+                            texture.levelIndex.size() * sizeof(KtxLevelIndexEntry));
+
+                // Levels are stored back to back, so a single read covers all of them
+                u64 levelsBegin = pending.fileSize;
+                u64 levelsEnd = 0;
+                for (const auto& entry : texture.levelIndex)
+                {
+                    if (!IsInRange(pending.fileSize, entry.byteOffset, entry.byteLength))
+                    {
+                        pending.result = KtxResult::eFileDataError;
+                    }
+                    levelsBegin = std::min(levelsBegin, entry.byteOffset);
+                    levelsEnd = std::max(levelsEnd, entry.byteOffset + entry.byteLength);
+                }
+                pending.imageDataOffset = levelsBegin;
+                pending.imageDataLength = levelsEnd > levelsBegin ? levelsEnd - levelsBegin : 0;
+            }
+
+            if (pending.result != KtxResult::eSuccess || !(flags & KtxCreateFlags::eLoadImageData))
+            {
+                continue;
+            }
+            const auto& levelIndex = pending.texture->levelIndex;
+            if (info.isKtx2 && GetLevelScheme(info.superCompressionScheme) == KtxSupercompressionScheme::eNone)
+            {
+                // One read per level straight into place, the image data holds the levels back to back without the
+                // padding between them like LoadKTXFromStream
+                pending.imageDataLength = ::GetUncompressedSize(levelIndex, KtxSupercompressionScheme::eNone);
+                pending.imageData = std::make_unique_for_overwrite<u8[]>(pending.imageDataLength);
+                u64 offset = 0;
+                for (const auto& entry : levelIndex)
+                {
+                    requests.push_back({.file = pending.file,
+                                        .offset = entry.byteOffset,
+                                        .length = entry.byteLength,
+                                        .destination = pending.imageData.get() + offset,
+                                        .stagingSlot = 0,
+                                        .result = 0});
+                    requestOwners.push_back(i);
+                    offset += entry.byteLength;
+                }
+                continue;
+            }
+            pending.imageData = std::make_unique_for_overwrite<u8[]>(pending.imageDataLength);
+            requests.push_back({.file = pending.file,
+                                .offset = pending.imageDataOffset,
+                                .length = pending.imageDataLength,
+                                .destination = pending.imageData.get(),
+                                .stagingSlot = 0,
+                                .result = 0});
+            requestOwners.push_back(i);
+        }
+        readAll();
+
+        for (u32 i = 0; i < names.size(); ++i)
+        {
+            auto& pending = group[i];
+            if (pending.file != -1)
+            {
+                close(pending.file);
+            }
+            if (pending.result != KtxResult::eSuccess)
+            {
+                results.emplace_back(std::unexpected(pending.result));
+                continue;
+            }
+
+            auto& texture = *pending.texture;
+            const bool isKtx1 = std::holds_alternative<KtxHeader>(pending.header);
+            const auto scheme = GetLevelScheme(texture.info.superCompressionScheme);
+            if (flags & KtxCreateFlags::eLoadImageData)
+            {
+                std::vector<KtxLevelRange> levels;
+                u64 dataSize = pending.imageDataLength;
+                if (isKtx1)
+                {
+                    const auto packedSize =
+                            CompactKtx1ImageData({pending.imageData.get(), pending.imageDataLength},
+                                                 std::get<KtxHeader>(pending.header), texture.info.needSwap, levels);
+                    if (!packedSize)
+                    {
+                        results.emplace_back(std::unexpected(packedSize.error()));
+                        continue;
+                    }
+                    dataSize = *packedSize;
+                } else if (scheme != KtxSupercompressionScheme::eNone)
+                {
+                    dataSize = ::GetUncompressedSize(texture.levelIndex, scheme);
+                    auto data = std::make_unique_for_overwrite<u8[]>(dataSize);
+                    if (const auto result = DecompressKtx2Levels(
+                                scheme, texture.levelIndex, {pending.imageData.get(), pending.imageDataLength},
+                                pending.imageDataOffset, {data.get(), dataSize}, nullptr);
+                        result != KtxResult::eSuccess)
+                    {
+                        results.emplace_back(std::unexpected(result));
+                        continue;
+                    }
+                    for (const auto& entry : texture.levelIndex)
+                    {
+                        const u64 offset = levels.empty() ? 0 : levels.back().byteOffset + levels.back().byteLength;
+                        levels.push_back({.byteOffset = offset, .byteLength = entry.uncompressedByteLength});
+                    }
+                    pending.imageData = std::move(data);
+                } else
+                {
+                    for (const auto& entry : texture.levelIndex)
+                    {
+                        const u64 offset = levels.empty() ? 0 : levels.back().byteOffset + levels.back().byteLength;
+                        levels.push_back({.byteOffset = offset, .byteLength = entry.byteLength});
+                    }
+                }
+                texture.SetImageData(std::move(pending.imageData), dataSize, std::move(levels));
+            } else
+            {
+                // Keep a stream around for ReadLevel, same as LoadKTXFromFile
+                auto stream = std::make_unique<KtxFileStream>(names[i]);
+                if (isKtx1)
+                {
+                    texture.levelIndex = WalkKtx1Levels(*stream, pending.imageDataOffset,
+                                                        std::get<KtxHeader>(pending.header), texture.info.needSwap);
+                    if (texture.levelIndex.size() != texture.info.numLevels)
+                    {
+                        results.emplace_back(std::unexpected(KtxResult::eFileReadError));
+                        continue;
+                    }
+                }
+                texture.stream = std::move(stream);
+            }
+            results.emplace_back(std::move(texture));
+        }
+    }
+#endif
+    return results;
+}
+
+std::expected<KTX::KtxMappedFile, KTX::KtxResult> KTX::MapKTXFromFile(const std::string_view fileName)
+{
+    KtxMappedFile mappedFile;
+    const auto view = MapFile(fileName);
+    if (view.empty())
+    {
+        return std::unexpected(KtxResult::eFileOpenFailed);
+    }
+    mappedFile.data = view.data();
+    mappedFile.size = view.size();
+
+    const auto header = DetermineHeader(view);
+    if (!header)
+    {
+        return std::unexpected(header.error());
+    }
+    if (std::holds_alternative<KtxHeader>(*header))
+    {
+        auto header1 = std::get<KtxHeader>(*header);
+        mappedFile.needSwap = header1.endianness == endianRefRev;
+        if (const auto checkedInfo = CheckHeader(header1); !checkedInfo)
+        {
+            return std::unexpected(checkedInfo.error());
+        }
+        mappedFile.typeSize = header1.glTypeSize;
+
+        if (!IsInRange(view, ktxHeaderSize, header1.keyValueData))
+        {
+            return std::unexpected(KtxResult::eFileDataError);
+        }
+        mappedFile.keyValueData = view.subspan(ktxHeaderSize, header1.keyValueData);
+
+        // Non array cube maps store imageSize per face and pad every face, everything else stores it per level
+        const bool perFaceImageSize = header1.numFaces == 6 && header1.numArrayElements == 0;
+        u64 offset = ktxHeaderSize + header1.keyValueData;
+        mappedFile.levels.reserve(header1.numMipLevels);
+        for (u32 level = 0; level < header1.numMipLevels; ++level)
+        {
+            u32 imageSize = 0;
+            if (!IsInRange(view, offset, sizeof(imageSize)))
+            {
+                return std::unexpected(KtxResult::eFileDataError);
+            }
+            std::memcpy(&imageSize, view.data() + offset, sizeof(imageSize));
+            if (mappedFile.needSwap)
+            {
+                imageSize = SwapEndian32(imageSize);
+            }
+            offset += sizeof(imageSize);
+
+            const u64 levelSize = perFaceImageSize ? header1.numFaces * CalculatePadding(4, imageSize) : imageSize;
+            if (!IsInRange(view, offset, levelSize))
+            {
+                return std::unexpected(KtxResult::eFileDataError);
+            }
+            mappedFile.levels.emplace_back(view.subspan(offset, levelSize));
+            offset += CalculatePadding(4, levelSize);
+        }
+        return mappedFile;
+    }
+
+    const auto& header2 = std::get<Ktx2Header>(*header);
+    if (const auto result = CheckHeader(header2); result != KtxResult::eSuccess)
+    {
+        return std::unexpected(result);
+    }
+    mappedFile.isKtx2 = true;
+
+    if (!IsInRange(view, header2.keyValueData.byteOffset, header2.keyValueData.byteLength))
+    {
+        return std::unexpected(KtxResult::eFileDataError);
+    }
+    mappedFile.keyValueData = view.subspan(header2.keyValueData.byteOffset, header2.keyValueData.byteLength);
+
+    const u32 levelCount = std::max(header2.levelCount, 1u);
+    if (!IsInRange(view, ktx2HeaderSize, static_cast<u64>(levelCount) * sizeof(KtxLevelIndexEntry)))
+    {
+        return std::unexpected(KtxResult::eFileDataError);
+    }
+
+    mappedFile.levels.reserve(levelCount);
+    for (u32 level = 0; level < levelCount; ++level)
+    {
+        KtxLevelIndexEntry entry{};
+        std::memcpy(&entry, view.data() + ktx2HeaderSize + level * sizeof(KtxLevelIndexEntry), sizeof(entry));
+        if (!IsInRange(view, entry.byteOffset, entry.byteLength))
+        {
+            return std::unexpected(KtxResult::eFileDataError);
+        }
+        mappedFile.levels.emplace_back(view.subspan(entry.byteOffset, entry.byteLength));
+    }
+    return mappedFile;
+}
+
+std::expected<KTX::KtxTextureInfo, KTX::KtxResult> KTX::DecodeKTXHeader(const std::span<const u8> data)
+{
+    auto header = DetermineHeader(data);
+    if (!header)
+    {
+        return std::unexpected(header.error());
+    }
+    if (auto* header1 = std::get_if<KtxHeader>(&*header))
+    {
+        return CreateTextureInfo(*header1);
+    }
+    return CreateTextureInfo(std::get<Ktx2Header>(*header));
+}
+
+std::expected<KTX::KtxTextureInfo, KTX::KtxResult> KTX::ProbeKTXFromMemory(const std::span<const u8> data)
+{
+    return ProbeBuffer(data.first(std::min<size_t>(data.size(), probeReadSize)));
+}
+
+std::expected<KTX::KtxTextureInfo, KTX::KtxResult> KTX::ProbeKTXFromFile(const std::string_view fileName)
+{
+    // The path needs a terminator, copy it to the stack instead of going through std::string
+    std::array<char, 4096> path;
+    if (fileName.size() >= path.size())
+    {
+        return std::unexpected(KtxResult::eFileOpenFailed);
+    }
+    std::ranges::copy(fileName, path.begin());
+    path[fileName.size()] = '\0';
+
+    alignas(16) std::array<u8, probeReadSize> buffer;
+    size_t bytesRead = 0;
+#if defined(_WIN32)
+    const HANDLE file = CreateFileA(path.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return std::unexpected(KtxResult::eFileOpenFailed);
+    }
+    DWORD length = 0;
+    const bool success = ReadFile(file, buffer.data(), static_cast<DWORD>(buffer.size()), &length, nullptr);
+    CloseHandle(file);
+    if (!success)
+    {
+        return std::unexpected(KtxResult::eFileReadError);
+    }
+    bytesRead = length;
+#else
+    const int file = open(path.data(), O_RDONLY | O_CLOEXEC);
+    if (file == -1)
+    {
+        return std::unexpected(KtxResult::eFileOpenFailed);
+    }
+    ssize_t length;
+    do
+    {
+        length = pread(file, buffer.data(), buffer.size(), 0);
+    } while (length < 0 && errno == EINTR);
+    close(file);
+    if (length < 0)
+    {
+        return std::unexpected(KtxResult::eFileReadError);
     }
+    bytesRead = static_cast<size_t>(length);
+#endif
+    return ProbeBuffer(std::span(buffer).first(bytesRead));
 }
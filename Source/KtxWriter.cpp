@@ -0,0 +1,787 @@
+#include "KtxWriter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <string>
+
+#include "KtxFormat.hpp"
+#include "KtxHeader.hpp"
+#include "KtxSupercompression.hpp"
+
+namespace
+{
+    using namespace KTX;
+    using enum KtxUtility_VkFormat;
+
+    // Khronos data format descriptor (version 1.3) values of the basic descriptor block
+    constexpr u32 dfdVersion = 2;
+    constexpr u32 dfdBlockHeaderSize = 24;
+    constexpr u32 dfdSampleSize = 16;
+    constexpr u8 dfdPrimariesBt709 = 1;
+    constexpr u8 dfdTransferLinear = 1;
+    constexpr u8 dfdTransferSrgb = 2;
+    constexpr u8 dfdModelRgbsda = 1;
+    constexpr u8 dfdModelBc1a = 128;
+    constexpr u8 dfdModelBc2 = 129;
+    constexpr u8 dfdModelBc3 = 130;
+    constexpr u8 dfdModelBc4 = 131;
+    constexpr u8 dfdModelBc5 = 132;
+    constexpr u8 dfdModelBc6h = 133;
+    constexpr u8 dfdModelBc7 = 134;
+    constexpr u8 dfdModelEtc2 = 161;
+    constexpr u8 dfdModelAstc = 162;
+    constexpr u8 dfdChannelStencil = 13;
+    constexpr u8 dfdChannelDepth = 14;
+    constexpr u8 dfdChannelAlpha = 15;
+    // Qualifiers in the top bits of a sample's channel type
+    constexpr u8 dfdQualifierLinear = 0x10;
+    constexpr u8 dfdQualifierExponent = 0x20;
+    constexpr u8 dfdQualifierSigned = 0x40;
+    constexpr u8 dfdQualifierFloat = 0x80;
+    // Float sample bounds are stored as float32 bits
+    constexpr u32 floatOne = 0x3F800000;
+    constexpr u32 floatMinusOne = 0xBF800000;
+    // E5B9G9R9 bounds: 1.0 is mantissa 256 with exponent 16 (bias 15)
+    constexpr u32 sharedExponentMantissaUpper = 8448;
+    constexpr u32 sharedExponentLower = 15;
+    constexpr u32 sharedExponentUpper = 31;
+
+    struct DfdSample
+    {
+        u16 bitOffset;
+        u8 bitLength;
+        u8 channelType;
+        u32 lower;
+        u32 upper;
+    };
+
+    enum class Numeric : u8
+    {
+        eUnorm,
+        eSnorm,
+        eUscaled,
+        eSscaled,
+        eUint,
+        eSint,
+        eSrgb,
+        eUfloat,
+        eSfloat,
+    };
+
+    // Runs of plain VkFormats with the same channels, every run goes through the numeric types of its channel size
+    struct PlainFormatRun
+    {
+        KtxUtility_VkFormat first;
+        u8 channelCount;
+        u8 channelBits;
+        bool isBgr;
+    };
+
+    constexpr std::array numerics8{Numeric::eUnorm, Numeric::eSnorm, Numeric::eUscaled, Numeric::eSscaled,
+                                   Numeric::eUint,  Numeric::eSint,  Numeric::eSrgb};
+    constexpr std::array numerics16{Numeric::eUnorm, Numeric::eSnorm, Numeric::eUscaled, Numeric::eSscaled,
+                                    Numeric::eUint,  Numeric::eSint,  Numeric::eSfloat};
+    constexpr std::array numerics32{Numeric::eUint, Numeric::eSint, Numeric::eSfloat};
+
+    constexpr std::array plainFormatRuns = std::to_array<PlainFormatRun>({
+            {VK_FORMAT_R8_UNORM, 1, 8, false},
+            {VK_FORMAT_R8G8_UNORM, 2, 8, false},
+            {VK_FORMAT_R8G8B8_UNORM, 3, 8, false},
+            {VK_FORMAT_B8G8R8_UNORM, 3, 8, true},
+            {VK_FORMAT_R8G8B8A8_UNORM, 4, 8, false},
+            {VK_FORMAT_B8G8R8A8_UNORM, 4, 8, true},
+            {VK_FORMAT_R16_UNORM, 1, 16, false},
+            {VK_FORMAT_R16G16_UNORM, 2, 16, false},
+            {VK_FORMAT_R16G16B16_UNORM, 3, 16, false},
+            {VK_FORMAT_R16G16B16A16_UNORM, 4, 16, false},
+            {VK_FORMAT_R32_UINT, 1, 32, false},
+            {VK_FORMAT_R32G32_UINT, 2, 32, false},
+            {VK_FORMAT_R32G32B32_UINT, 3, 32, false},
+            {VK_FORMAT_R32G32B32A32_UINT, 4, 32, false},
+    });
+
+    // Channel of a packed format, packed formats list theirs from the least significant bit up
+    struct PackedChannel
+    {
+        u8 channel;
+        u8 bits;
+        Numeric numeric;
+    };
+
+    struct PackedFormat
+    {
+        KtxUtility_VkFormat format;
+        u8 channelCount;
+        std::array<PackedChannel, 4> channels;
+    };
+
+    // The packed and depth/stencil formats ktx1 files map to, channels in the order KTX-Software writes them
+    constexpr std::array packedFormats = std::to_array<PackedFormat>({
+            {VK_FORMAT_R4G4B4A4_UNORM_PACK16,
+             4,
+             {{{dfdChannelAlpha, 4, Numeric::eUnorm},
+               {2, 4, Numeric::eUnorm},
+               {1, 4, Numeric::eUnorm},
+               {0, 4, Numeric::eUnorm}}}},
+            {VK_FORMAT_R5G6B5_UNORM_PACK16,
+             3,
+             {{{2, 5, Numeric::eUnorm}, {1, 6, Numeric::eUnorm}, {0, 5, Numeric::eUnorm}}}},
+            {VK_FORMAT_R5G5B5A1_UNORM_PACK16,
+             4,
+             {{{dfdChannelAlpha, 1, Numeric::eUnorm},
+               {2, 5, Numeric::eUnorm},
+               {1, 5, Numeric::eUnorm},
+               {0, 5, Numeric::eUnorm}}}},
+            {VK_FORMAT_A2B10G10R10_UNORM_PACK32,
+             4,
+             {{{0, 10, Numeric::eUnorm},
+               {1, 10, Numeric::eUnorm},
+               {2, 10, Numeric::eUnorm},
+               {dfdChannelAlpha, 2, Numeric::eUnorm}}}},
+            {VK_FORMAT_A2B10G10R10_UINT_PACK32,
+             4,
+             {{{0, 10, Numeric::eUint},
+               {1, 10, Numeric::eUint},
+               {2, 10, Numeric::eUint},
+               {dfdChannelAlpha, 2, Numeric::eUint}}}},
+            {VK_FORMAT_B10G11R11_UFLOAT_PACK32,
+             3,
+             {{{0, 11, Numeric::eUfloat}, {1, 11, Numeric::eUfloat}, {2, 10, Numeric::eUfloat}}}},
+            {VK_FORMAT_D16_UNORM, 1, {{{dfdChannelDepth, 16, Numeric::eUnorm}}}},
+            // The top 8 bits are unused
+            {VK_FORMAT_X8_D24_UNORM_PACK32, 1, {{{dfdChannelDepth, 24, Numeric::eUnorm}}}},
+            {VK_FORMAT_D32_SFLOAT, 1, {{{dfdChannelDepth, 32, Numeric::eSfloat}}}},
+            {VK_FORMAT_S8_UINT, 1, {{{dfdChannelStencil, 8, Numeric::eUint}}}},
+            {VK_FORMAT_D24_UNORM_S8_UINT,
+             2,
+             {{{dfdChannelDepth, 24, Numeric::eUnorm}, {dfdChannelStencil, 8, Numeric::eUint}}}},
+            {VK_FORMAT_D32_SFLOAT_S8_UINT,
+             2,
+             {{{dfdChannelDepth, 32, Numeric::eSfloat}, {dfdChannelStencil, 8, Numeric::eUint}}}},
+    });
+
+    // How the formats of a block format run differ from each other
+    enum class BlockVariant : u8
+    {
+        eUnormSrgb, // UNORM and SRGB pairs
+        eUnormSnorm, // UNORM and SNORM pairs
+        eUfloatSfloat, // UFLOAT and SFLOAT pairs
+        eSfloat, // SFLOAT only
+    };
+
+    // Compressed formats get a sample per 64 bits of the block when they have more than one
+    struct BlockFormatRun
+    {
+        KtxUtility_VkFormat first;
+        KtxUtility_VkFormat last;
+        u8 colorModel;
+        BlockVariant variant;
+        u8 sampleCount;
+        std::array<u8, 2> channels;
+    };
+
+    constexpr std::array blockFormatRuns = std::to_array<BlockFormatRun>({
+            {VK_FORMAT_BC1_RGB_UNORM_BLOCK, VK_FORMAT_BC1_RGB_SRGB_BLOCK, dfdModelBc1a, BlockVariant::eUnormSrgb, 1,
+             {0}},
+            // Channel 1 is BC1A's alpha present
+            {VK_FORMAT_BC1_RGBA_UNORM_BLOCK, VK_FORMAT_BC1_RGBA_SRGB_BLOCK, dfdModelBc1a, BlockVariant::eUnormSrgb, 1,
+             {1}},
+            {VK_FORMAT_BC2_UNORM_BLOCK, VK_FORMAT_BC2_SRGB_BLOCK, dfdModelBc2, BlockVariant::eUnormSrgb, 2,
+             {dfdChannelAlpha, 0}},
+            {VK_FORMAT_BC3_UNORM_BLOCK, VK_FORMAT_BC3_SRGB_BLOCK, dfdModelBc3, BlockVariant::eUnormSrgb, 2,
+             {dfdChannelAlpha, 0}},
+            {VK_FORMAT_BC4_UNORM_BLOCK, VK_FORMAT_BC4_SNORM_BLOCK, dfdModelBc4, BlockVariant::eUnormSnorm, 1, {0}},
+            {VK_FORMAT_BC5_UNORM_BLOCK, VK_FORMAT_BC5_SNORM_BLOCK, dfdModelBc5, BlockVariant::eUnormSnorm, 2, {0, 1}},
+            {VK_FORMAT_BC6H_UFLOAT_BLOCK, VK_FORMAT_BC6H_SFLOAT_BLOCK, dfdModelBc6h, BlockVariant::eUfloatSfloat, 1,
+             {0}},
+            {VK_FORMAT_BC7_UNORM_BLOCK, VK_FORMAT_BC7_SRGB_BLOCK, dfdModelBc7, BlockVariant::eUnormSrgb, 1, {0}},
+            // Channel 2 is ETC2's color
+            {VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK, dfdModelEtc2,
+             BlockVariant::eUnormSrgb, 1, {2}},
+            {VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK, dfdModelEtc2,
+             BlockVariant::eUnormSrgb, 2, {dfdChannelAlpha, 2}},
+            {VK_FORMAT_EAC_R11_UNORM_BLOCK, VK_FORMAT_EAC_R11_SNORM_BLOCK, dfdModelEtc2, BlockVariant::eUnormSnorm, 1,
+             {0}},
+            {VK_FORMAT_EAC_R11G11_UNORM_BLOCK, VK_FORMAT_EAC_R11G11_SNORM_BLOCK, dfdModelEtc2,
+             BlockVariant::eUnormSnorm, 2, {0, 1}},
+            {VK_FORMAT_ASTC_4x4_UNORM_BLOCK, VK_FORMAT_ASTC_12x12_SRGB_BLOCK, dfdModelAstc, BlockVariant::eUnormSrgb, 1,
+             {0}},
+            {VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK, VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK, dfdModelAstc, BlockVariant::eSfloat, 1,
+             {0}},
+    });
+
+    void AppendU32(std::vector<u8>& data, const u32 value)
+    {
+        const auto* bytes = reinterpret_cast<const u8*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(value));
+    }
+
+    DfdSample GetPlainSample(const Numeric numeric, const u32 bitOffset, const u32 bits, const u8 channel)
+    {
+        DfdSample sample{.bitOffset = static_cast<u16>(bitOffset),
+                         .bitLength = static_cast<u8>(bits - 1),
+                         .channelType = channel,
+                         .lower = 0,
+                         .upper = 0};
+        const u32 maxSigned = (1u << (bits - 1)) - 1;
+        switch (numeric)
+        {
+            case Numeric::eUnorm:
+            case Numeric::eSrgb:
+                sample.upper = bits == 32 ? ~0u : (1u << bits) - 1;
+                break;
+            case Numeric::eSnorm:
+                sample.channelType |= dfdQualifierSigned;
+                sample.lower = static_cast<u32>(-static_cast<i32>(maxSigned));
+                sample.upper = maxSigned;
+                break;
+            case Numeric::eUint:
+                sample.upper = 1;
+                break;
+            case Numeric::eSint:
+                sample.channelType |= dfdQualifierSigned;
+                sample.lower = static_cast<u32>(-1);
+                sample.upper = 1;
+                break;
+            case Numeric::eUfloat:
+                sample.channelType |= dfdQualifierFloat;
+                sample.upper = floatOne;
+                break;
+            default:
+                sample.channelType |= dfdQualifierSigned | dfdQualifierFloat;
+                sample.lower = floatMinusOne;
+                sample.upper = floatOne;
+                break;
+        }
+        // sRGB only applies to the color channels
+        if (numeric == Numeric::eSrgb && channel == dfdChannelAlpha)
+        {
+            sample.channelType |= dfdQualifierLinear;
+        }
+        return sample;
+    }
+
+    // Basic descriptor block of a format, the same one KTX-Software writes. Scaled formats and the packed formats
+    // missing from packedFormats have none.
+    bool BuildDataFormatDescriptor(const u32 vkFormat, const bool isSupercompressed, std::vector<u8>& dfd)
+    {
+        const KtxFormatSize formatSize = GetVkFormatSize(vkFormat);
+        std::array<DfdSample, 6> samples{};
+        u32 sampleCount = 0;
+        u8 colorModel = dfdModelRgbsda;
+        u8 transfer = dfdTransferLinear;
+
+        const auto plainRun = std::ranges::find_if(plainFormatRuns,
+                                                   [&](const PlainFormatRun& run)
+                                                   {
+                                                       const auto first = static_cast<u32>(run.first);
+                                                       const u32 count = run.channelBits == 32 ? 3 : 7;
+                                                       return vkFormat >= first && vkFormat < first + count;
+                                                   });
+        const auto packedFormat = std::ranges::find(packedFormats, static_cast<KtxUtility_VkFormat>(vkFormat),
+                                                    &PackedFormat::format);
+        const auto blockRun = std::ranges::find_if(blockFormatRuns,
+                                                   [&](const BlockFormatRun& run)
+                                                   {
+                                                       return vkFormat >= static_cast<u32>(run.first) &&
+                                                              vkFormat <= static_cast<u32>(run.last);
+                                                   });
+        if (plainRun != plainFormatRuns.end())
+        {
+            const u32 index = vkFormat - static_cast<u32>(plainRun->first);
+            const Numeric numeric = plainRun->channelBits == 8    ? numerics8[index]
+                                    : plainRun->channelBits == 16 ? numerics16[index]
+                                                                  : numerics32[index];
+            if (numeric == Numeric::eUscaled || numeric == Numeric::eSscaled)
+            {
+                return false;
+            }
+            transfer = numeric == Numeric::eSrgb ? dfdTransferSrgb : dfdTransferLinear;
+            constexpr std::array<u8, 4> rgba{0, 1, 2, dfdChannelAlpha};
+            constexpr std::array<u8, 4> bgra{2, 1, 0, dfdChannelAlpha};
+            for (; sampleCount < plainRun->channelCount; ++sampleCount)
+            {
+                const u8 channel = plainRun->isBgr ? bgra[sampleCount] : rgba[sampleCount];
+                samples[sampleCount] = GetPlainSample(numeric, sampleCount * plainRun->channelBits,
+                                                      plainRun->channelBits, channel);
+            }
+        } else if (packedFormat != packedFormats.end())
+        {
+            u32 bitOffset = 0;
+            for (; sampleCount < packedFormat->channelCount; ++sampleCount)
+            {
+                const auto& [channel, bits, numeric] = packedFormat->channels[sampleCount];
+                samples[sampleCount] = GetPlainSample(numeric, bitOffset, bits, channel);
+                bitOffset += bits;
+            }
+        } else if (vkFormat == static_cast<u32>(VK_FORMAT_E5B9G9R9_UFLOAT_PACK32))
+        {
+            // A mantissa and an exponent sample per channel, the exponent bits are shared
+            for (u32 channel = 0; channel < 3; ++channel)
+            {
+                samples[sampleCount++] = {.bitOffset = static_cast<u16>(channel * 9),
+                                          .bitLength = 8,
+                                          .channelType = static_cast<u8>(channel),
+                                          .lower = 0,
+                                          .upper = sharedExponentMantissaUpper};
+                samples[sampleCount++] = {.bitOffset = 27,
+                                          .bitLength = 4,
+                                          .channelType = static_cast<u8>(channel | dfdQualifierExponent),
+                                          .lower = sharedExponentLower,
+                                          .upper = sharedExponentUpper};
+            }
+        } else if (blockRun != blockFormatRuns.end())
+        {
+            // The second format of every pair is the SRGB, SNORM or SFLOAT one
+            const bool isSecond = blockRun->variant == BlockVariant::eSfloat ||
+                                  (vkFormat - static_cast<u32>(blockRun->first)) % 2 == 1;
+            const bool isSigned = isSecond && blockRun->variant != BlockVariant::eUnormSrgb;
+            const bool isFloat = blockRun->variant == BlockVariant::eUfloatSfloat ||
+                                 blockRun->variant == BlockVariant::eSfloat;
+            colorModel = blockRun->colorModel;
+            transfer = isSecond && blockRun->variant == BlockVariant::eUnormSrgb ? dfdTransferSrgb : dfdTransferLinear;
+            sampleCount = blockRun->sampleCount;
+            const u32 sampleBits = formatSize.blockSize / sampleCount;
+            for (u32 i = 0; i < sampleCount; ++i)
+            {
+                const u8 channel = blockRun->channels[i];
+                auto& sample = samples[i];
+                sample = {.bitOffset = static_cast<u16>(i * sampleBits),
+                          .bitLength = static_cast<u8>(sampleBits - 1),
+                          .channelType = channel,
+                          .lower = isSigned ? 0x80000000 : 0,
+                          .upper = isSigned ? 0x7FFFFFFF : ~0u};
+                if (isFloat)
+                {
+                    sample.lower = isSigned ? floatMinusOne : 0;
+                    sample.upper = floatOne;
+                    sample.channelType |= dfdQualifierFloat;
+                }
+                if (isSigned)
+                {
+                    sample.channelType |= dfdQualifierSigned;
+                }
+                if (transfer == dfdTransferSrgb && channel == dfdChannelAlpha)
+                {
+                    sample.channelType |= dfdQualifierLinear;
+                }
+            }
+        } else
+        {
+            return false;
+        }
+
+        const u32 blockSize = dfdBlockHeaderSize + sampleCount * dfdSampleSize;
+        // Supercompressed levels have no fixed number of bytes per block
+        const u32 bytesPlane0 = isSupercompressed ? 0 : formatSize.blockSize / 8;
+        dfd.clear();
+        dfd.reserve(sizeof(u32) + blockSize);
+        AppendU32(dfd, sizeof(u32) + blockSize);
+        AppendU32(dfd, 0); // Khronos vendor, basic descriptor type
+        AppendU32(dfd, dfdVersion | blockSize << 16);
+        AppendU32(dfd, colorModel | dfdPrimariesBt709 << 8 | transfer << 16);
+        AppendU32(dfd, (formatSize.blockWidth - 1) | (formatSize.blockHeight - 1) << 8 |
+                               (formatSize.blockDepth - 1) << 16);
+        AppendU32(dfd, bytesPlane0);
+        AppendU32(dfd, 0);
+        for (u32 i = 0; i < sampleCount; ++i)
+        {
+            const auto& sample = samples[i];
+            AppendU32(dfd, sample.bitOffset | sample.bitLength << 16 | static_cast<u32>(sample.channelType) << 24);
+            AppendU32(dfd, 0); // Sample position
+            AppendU32(dfd, sample.lower);
+            AppendU32(dfd, sample.upper);
+        }
+        return true;
+    }
+
+    // Entries sorted by key as the spec requires, each padded to 4 bytes
+    std::vector<u8> BuildKeyValueData(const KtxWriteSource& source)
+    {
+        constexpr std::string_view writerKey = "KTXwriter";
+        constexpr std::string_view writerValue{"KTX-Utility", sizeof("KTX-Utility")};
+        const KtxKeyValueMap keyValues(source.keyValues.empty() ? source.keyValueData : std::span<const u8>());
+        std::vector<KtxKeyValue> entries(keyValues.GetEntries().begin(), keyValues.GetEntries().end());
+        entries.insert(entries.end(), source.keyValues.begin(), source.keyValues.end());
+        if (std::ranges::find(entries, writerKey, &KtxKeyValue::key) == entries.end())
+        {
+            entries.push_back(
+                    {writerKey, std::span(reinterpret_cast<const u8*>(writerValue.data()), writerValue.size())});
+        }
+        std::ranges::sort(entries, {}, &KtxKeyValue::key);
+
+        std::vector<u8> data;
+        for (const auto& [key, value] : entries)
+        {
+            const auto keyAndValueByteLength = static_cast<u32>(key.size() + 1 + value.size());
+            AppendU32(data, keyAndValueByteLength);
+            data.insert(data.end(), key.begin(), key.end());
+            data.push_back(0);
+            data.insert(data.end(), value.begin(), value.end());
+            data.resize((data.size() + 3) & ~size_t{3});
+        }
+        return data;
+    }
+
+    u64 AlignUp(const u64 value, const u64 alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Size of an uncompressed level in a ktx2 file, 0 if the format has no known size
+    u64 GetLevelSize(const KtxTextureInfo& info, const KtxFormatSize& formatSize, const u32 level)
+    {
+        if (formatSize.blockSize == 0)
+        {
+            return 0;
+        }
+        const u64 width = std::max(info.baseWidth >> level, 1u);
+        const u64 height = std::max(info.baseHeight >> level, 1u);
+        const u64 depth = std::max(info.baseDepth >> level, 1u);
+        const u64 blocksX = std::max<u64>((width + formatSize.blockWidth - 1) / formatSize.blockWidth,
+                                          formatSize.minBlocksX);
+        const u64 blocksY = std::max<u64>((height + formatSize.blockHeight - 1) / formatSize.blockHeight,
+                                          formatSize.minBlocksY);
+        const u64 blocksZ = (depth + formatSize.blockDepth - 1) / formatSize.blockDepth;
+        return blocksX * blocksY * blocksZ * formatSize.blockSize / 8 * info.numLayers * info.numFaces;
+    }
+
+    // Uncompressed levels have to hold exactly what the format needs, formats without a known size are let through
+    bool HasValidLevelSizes(const KtxWriteSource& source)
+    {
+        const KtxFormatSize formatSize = GetVkFormatSize(source.info.vkFormat);
+        for (u32 level = 0; level < source.levels.size(); ++level)
+        {
+            const u64 levelSize = GetLevelSize(source.info, formatSize, level);
+            if (levelSize != 0 && source.levels[level].size() != levelSize)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Everything in front of the levels, with the level index filled in, and where the levels go
+    struct FileLayout
+    {
+        std::vector<u8> metadata;
+        std::vector<u64> levelOffsets;
+        u64 fileSize;
+    };
+
+    std::expected<FileLayout, KtxResult> CreateLayout(const KtxWriteSource& source, const KtxWriteOptions& options)
+    {
+        const auto& info = source.info;
+        const auto scheme = static_cast<KtxSupercompressionScheme>(info.superCompressionScheme);
+        const bool isSupercompressed = scheme != KtxSupercompressionScheme::eNone;
+        const bool hasUncompressedLengths =
+                scheme == KtxSupercompressionScheme::eZstd || scheme == KtxSupercompressionScheme::eZlib;
+        const u32 levelCount = std::max(info.numLevels, 1u);
+        if (info.baseWidth == 0 || (info.numFaces != 1 && info.numFaces != 6) || source.levels.size() != levelCount ||
+            (hasUncompressedLengths && source.uncompressedByteLengths.size() != levelCount))
+        {
+            return std::unexpected(KtxResult::eFileDataError);
+        }
+
+        const KtxFormatSize formatSize = GetVkFormatSize(info.vkFormat);
+        if (!isSupercompressed && !HasValidLevelSizes(source))
+        {
+            return std::unexpected(KtxResult::eFileDataError);
+        }
+
+        std::vector<u8> builtDfd;
+        auto dfd = source.dataFormatDescriptor;
+        if (dfd.empty())
+        {
+            if (!BuildDataFormatDescriptor(info.vkFormat, isSupercompressed, builtDfd))
+            {
+                return std::unexpected(KtxResult::eUnsupportedFeature);
+            }
+            dfd = builtDfd;
+        }
+        const auto keyValueData = BuildKeyValueData(source);
+        const auto& globalData = source.superCompressionGlobalData;
+
+        // Header, level index, DFD and key/value data follow each other, the global data is 8 byte aligned
+        const u64 levelIndexSize = levelCount * sizeof(KtxLevelIndexEntry);
+        const u64 dfdOffset = Detail::ktx2HeaderSize + levelIndexSize;
+        const u64 keyValueOffset = dfdOffset + dfd.size();
+        const u64 globalDataOffset = globalData.empty() ? 0 : AlignUp(keyValueOffset + keyValueData.size(), 8);
+        const u64 metadataSize = globalData.empty() ? keyValueOffset + keyValueData.size()
+                                                    : globalDataOffset + globalData.size();
+
+        // Uncompressed levels start on whole texel blocks and 4 bytes, the caller's alignment comes on top
+        u64 alignment = isSupercompressed ? 1 : std::lcm<u64>(std::max(formatSize.blockSize / 8, 1u), 4);
+        if (options.levelAlignment > 1)
+        {
+            alignment = std::lcm<u64>(alignment, options.levelAlignment);
+        }
+
+        // Levels are stored from the smallest to the largest so streaming can start with a low resolution
+        FileLayout layout{.metadata = std::vector<u8>(metadataSize),
+                          .levelOffsets = std::vector<u64>(levelCount),
+                          .fileSize = 0};
+        std::vector<KtxLevelIndexEntry> levelIndex(levelCount);
+        u64 offset = metadataSize;
+        for (u32 level = levelCount; level-- > 0;)
+        {
+            offset = AlignUp(offset, alignment);
+            const u64 length = source.levels[level].size();
+            // BasisLZ levels have no size of their own once decoded
+            u64 uncompressedLength = scheme == KtxSupercompressionScheme::eBasisLZ ? 0 : length;
+            if (hasUncompressedLengths)
+            {
+                uncompressedLength = source.uncompressedByteLengths[level];
+            }
+            levelIndex[level] = {
+                    .byteOffset = offset, .byteLength = length, .uncompressedByteLength = uncompressedLength};
+            layout.levelOffsets[level] = offset;
+            offset += length;
+        }
+        layout.fileSize = offset;
+
+        Detail::Ktx2Header header{};
+        header.identifier = Detail::ktx2Identifier;
+        header.vkFormat = info.vkFormat;
+        header.typeSize = info.typeSize;
+        header.pixelWidth = info.baseWidth;
+        header.pixelHeight = info.numDimensions == 1 ? 0 : info.baseHeight;
+        header.pixelDepth = info.numDimensions == 3 ? info.baseDepth : 0;
+        header.layerCount = info.isArray ? info.numLayers : 0;
+        header.faceCount = info.numFaces;
+        header.levelCount = info.generateMipmaps ? 0 : levelCount;
+        header.superCompressionScheme = info.superCompressionScheme;
+        header.dataFormatDescriptor = {static_cast<u32>(dfdOffset), static_cast<u32>(dfd.size())};
+        header.keyValueData = {keyValueData.empty() ? 0 : static_cast<u32>(keyValueOffset),
+                               static_cast<u32>(keyValueData.size())};
+        header.superCompressionGlobalData = {globalDataOffset, globalData.size()};
+
+        u8* metadata = layout.metadata.data();
+        std::memcpy(metadata, &header, sizeof(header));
+        std::memcpy(metadata + Detail::ktx2HeaderSize, levelIndex.data(), levelIndexSize);
+        std::memcpy(metadata + dfdOffset, dfd.data(), dfd.size());
+        if (!keyValueData.empty())
+        {
+            std::memcpy(metadata + keyValueOffset, keyValueData.data(), keyValueData.size());
+        }
+        if (!globalData.empty())
+        {
+            std::memcpy(metadata + globalDataOffset, globalData.data(), globalData.size());
+        }
+        return layout;
+    }
+
+    constexpr u32 bytesPlane0Offset = sizeof(u32) + 16;
+
+    // A source with its levels supercompressed, keeps the compressed levels and the patched DFD alive
+    struct CompressedSource
+    {
+        KtxWriteSource source;
+        std::vector<std::vector<u8>> compressedLevels;
+        std::vector<std::span<const u8>> levels;
+        std::vector<u64> uncompressedByteLengths;
+        std::vector<u8> dataFormatDescriptor;
+    };
+
+    // Points source at the write source to use, which is the caller's own unless options ask for supercompression
+    KtxResult CompressSource(const KtxWriteSource*& source, const KtxWriteOptions& options,
+                             CompressedSource& compressedSource)
+    {
+        if (options.superCompressionScheme == KtxSupercompressionScheme::eNone)
+        {
+            return KtxResult::eSuccess;
+        }
+        if (source->info.superCompressionScheme != static_cast<u32>(KtxSupercompressionScheme::eNone) ||
+            !Supercompression::IsSupported(options.superCompressionScheme))
+        {
+            return KtxResult::eUnsupportedFeature;
+        }
+        if (!HasValidLevelSizes(*source))
+        {
+            return KtxResult::eFileDataError;
+        }
+
+        const auto levelCount = source->levels.size();
+        compressedSource.compressedLevels.resize(levelCount);
+        compressedSource.levels.resize(levelCount);
+        compressedSource.uncompressedByteLengths.resize(levelCount);
+        for (size_t level = 0; level < levelCount; ++level)
+        {
+            const auto levelData = source->levels[level];
+            auto& compressed = compressedSource.compressedLevels[level];
+            if (const auto result = Supercompression::CompressLevel(options.superCompressionScheme, levelData,
+                                                                    options.compressionLevel, compressed);
+                result != KtxResult::eSuccess)
+            {
+                return result;
+            }
+            compressedSource.levels[level] = compressed;
+            compressedSource.uncompressedByteLengths[level] = levelData.size();
+        }
+
+        auto& compressedWriteSource = compressedSource.source;
+        compressedWriteSource = *source;
+        compressedWriteSource.info.superCompressionScheme = static_cast<u32>(options.superCompressionScheme);
+        compressedWriteSource.levels = compressedSource.levels;
+        compressedWriteSource.uncompressedByteLengths = compressedSource.uncompressedByteLengths;
+        if (!source->dataFormatDescriptor.empty())
+        {
+            // Supercompressed levels have no fixed number of bytes per block
+            compressedSource.dataFormatDescriptor.assign(source->dataFormatDescriptor.begin(),
+                                                         source->dataFormatDescriptor.end());
+            if (compressedSource.dataFormatDescriptor.size() > bytesPlane0Offset)
+            {
+                compressedSource.dataFormatDescriptor[bytesPlane0Offset] = 0;
+            }
+            compressedWriteSource.dataFormatDescriptor = compressedSource.dataFormatDescriptor;
+        }
+        source = &compressedWriteSource;
+        return KtxResult::eSuccess;
+    }
+
+    // A texture as a write source, keeps the levels it had to read and the patched DFD alive
+    struct TextureSource
+    {
+        KtxWriteSource source;
+        std::vector<std::vector<u8>> readLevels;
+        std::vector<std::span<const u8>> levels;
+        std::vector<u8> dataFormatDescriptor;
+    };
+
+    KtxResult GetTextureSource(KtxTexture& texture, TextureSource& textureSource)
+    {
+        const auto& info = texture.GetInfo();
+        const auto scheme = static_cast<KtxSupercompressionScheme>(info.superCompressionScheme);
+        const bool isDecoded = scheme == KtxSupercompressionScheme::eZstd || scheme == KtxSupercompressionScheme::eZlib;
+        textureSource.levels.resize(info.numLevels);
+        textureSource.readLevels.reserve(info.numLevels);
+        for (u32 level = 0; level < info.numLevels; ++level)
+        {
+            if (texture.HasImageData())
+            {
+                textureSource.levels[level] = texture.GetLevel(level);
+                continue;
+            }
+            const auto& entry = texture.GetLevelIndex()[level];
+            auto& stored = textureSource.readLevels.emplace_back(isDecoded ? entry.uncompressedByteLength
+                                                                           : entry.byteLength);
+            if (!texture.ReadLevel(level, stored))
+            {
+                return KtxResult::eFileReadError;
+            }
+            textureSource.levels[level] = stored;
+        }
+
+        auto& source = textureSource.source;
+        source.info = info;
+        source.levels = textureSource.levels;
+        source.keyValueData = texture.GetKeyValueData();
+        source.superCompressionGlobalData = texture.GetSuperCompressionGlobalData();
+        const auto dfd = texture.GetDataFormatDescriptor();
+        textureSource.dataFormatDescriptor.assign(dfd.begin(), dfd.end());
+        if (isDecoded)
+        {
+            // The levels come out of the loader decompressed, so their DFD needs bytesPlane0 back
+            source.info.superCompressionScheme = static_cast<u32>(KtxSupercompressionScheme::eNone);
+            const u32 blockSize = info.formatSize.blockSize / 8;
+            if (textureSource.dataFormatDescriptor.size() > bytesPlane0Offset && blockSize <= 0xFF)
+            {
+                textureSource.dataFormatDescriptor[bytesPlane0Offset] = static_cast<u8>(blockSize);
+            }
+        }
+        source.dataFormatDescriptor = textureSource.dataFormatDescriptor;
+        return KtxResult::eSuccess;
+    }
+} // namespace
+
+std::expected<std::vector<KTX::u8>, KTX::KtxResult> KTX::WriteKTX2ToMemory(const KtxWriteSource& writeSource,
+                                                                         const KtxWriteOptions& options)
+{
+    const KtxWriteSource* compressed = &writeSource;
+    CompressedSource compressedSource;
+    if (const auto result = CompressSource(compressed, options, compressedSource); result != KtxResult::eSuccess)
+    {
+        return std::unexpected(result);
+    }
+    const auto& source = *compressed;
+    const auto layout = CreateLayout(source, options);
+    if (!layout)
+    {
+        return std::unexpected(layout.error());
+    }
+    // Zero filled, which covers the padding in front of every level
+    std::vector<u8> data(layout->fileSize);
+    std::ranges::copy(layout->metadata, data.begin());
+    for (u32 level = 0; level < source.levels.size(); ++level)
+    {
+        const auto levelOffset = static_cast<std::ptrdiff_t>(layout->levelOffsets[level]);
+        std::ranges::copy(source.levels[level], data.begin() + levelOffset);
+    }
+    return data;
+}
+
+KTX::KtxResult KTX::WriteKTX2ToFile(const std::string_view fileName, const KtxWriteSource& writeSource,
+                                    const KtxWriteOptions& options)
+{
+    const KtxWriteSource* compressed = &writeSource;
+    CompressedSource compressedSource;
+    if (const auto result = CompressSource(compressed, options, compressedSource); result != KtxResult::eSuccess)
+    {
+        return result;
+    }
+    const auto& source = *compressed;
+    const auto layout = CreateLayout(source, options);
+    if (!layout)
+    {
+        return layout.error();
+    }
+    std::ofstream file(std::string(fileName), std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        return KtxResult::eFileOpenFailed;
+    }
+
+    const auto write = [&](const std::span<const u8> data)
+    { file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size())); };
+    constexpr std::array<u8, 4096> zeros{};
+    write(layout->metadata);
+    u64 offset = layout->metadata.size();
+    for (u32 level = static_cast<u32>(source.levels.size()); level-- > 0;)
+    {
+        while (offset < layout->levelOffsets[level])
+        {
+            const u64 padding = std::min<u64>(zeros.size(), layout->levelOffsets[level] - offset);
+            write(std::span(zeros).first(padding));
+            offset += padding;
+        }
+        write(source.levels[level]);
+        offset += source.levels[level].size();
+    }
+    file.flush();
+    return file ? KtxResult::eSuccess : KtxResult::eFileWriteError;
+}
+
+std::expected<std::vector<KTX::u8>, KTX::KtxResult> KTX::WriteKTX2ToMemory(KtxTexture& texture,
+                                                                         const KtxWriteOptions& options)
+{
+    TextureSource textureSource;
+    if (const auto result = GetTextureSource(texture, textureSource); result != KtxResult::eSuccess)
+    {
+        return std::unexpected(result);
+    }
+    return WriteKTX2ToMemory(textureSource.source, options);
+}
+
+KTX::KtxResult KTX::WriteKTX2ToFile(const std::string_view fileName, KtxTexture& texture,
+                                    const KtxWriteOptions& options)
+{
+    TextureSource textureSource;
+    if (const auto result = GetTextureSource(texture, textureSource); result != KtxResult::eSuccess)
+    {
+        return result;
+    }
+    return WriteKTX2ToFile(fileName, textureSource.source, options);
+}
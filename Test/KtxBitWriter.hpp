@@ -0,0 +1,59 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "KtxUtility.hpp"
+
+// Bit stream writing shared by the tests and benchmarks that build BasisLZ and UASTC data by hand
+
+namespace KTX::Test
+{
+    // LSB first bit writer matching the BasisLZ bit streams
+    struct BitWriter
+    {
+        // Writes the low count bits of value, bits past the 32 of value are written as 0 so long runs of zero bits can
+        // go in one call
+        void Put(const u32 value, const u32 count)
+        {
+            for (u32 bit = 0; bit < count; ++bit, ++position)
+            {
+                if (position % 8 == 0)
+                {
+                    bytes.push_back(0);
+                }
+                const u32 valueBit = bit < 32 ? (value >> bit) & 1 : 0;
+                bytes.back() |= static_cast<u8>(valueBit << (position % 8));
+            }
+        }
+
+        // Huffman codes go most significant bit first
+        void PutCode(const u32 code, const u32 length)
+        {
+            for (u32 bit = length; bit-- > 0;)
+            {
+                Put((code >> bit) & 1, 1);
+            }
+        }
+
+        std::vector<u8> bytes;
+        u32 position = 0;
+    };
+
+    // Huffman table where every symbol is codeLength bits long, so symbol s is coded as s itself. The code sizes are
+    // coded with a single 1 bit code, for the size codeLength.
+    inline void PutFlatHuffmanTable(BitWriter& writer, const u32 symbolCount, const u32 codeLength)
+    {
+        constexpr std::array<u8, 21> codeLengthOrder = {17, 18, 19, 20, 0, 8, 7, 9, 6, 10, 5,
+                                                        11, 4, 12, 3, 13, 2, 14, 1, 15, 16};
+        const auto position =
+                static_cast<u32>(std::ranges::find(codeLengthOrder, codeLength) - codeLengthOrder.begin());
+        writer.Put(symbolCount, 14);
+        writer.Put(position + 1, 5);
+        for (u32 i = 0; i <= position; ++i)
+        {
+            writer.Put(i == position, 3);
+        }
+        writer.Put(0, symbolCount);
+    }
+} // namespace KTX::Test
@@ -1,6 +1,1058 @@
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "GL_Format.hpp"
+#include "KtxConvert.hpp"
+#include "KtxBitWriter.hpp"
+#include "KtxDecoder.hpp"
+#include "KtxDfd.hpp"
+#include "KtxFormat.hpp"
+#include "KtxMipmap.hpp"
+#include "KtxTranscoder.hpp"
 #include "KtxUtility.hpp"
+#include "KtxWriter.hpp"
+#include "VK_Format.hpp"
+
+namespace
+{
+    using KTX::Test::BitWriter;
+    using KTX::Test::PutFlatHuffmanTable;
+
+    // HDR ASTC has no GL format of its own and maps to the LDR one, which keeps mapping back to UNORM
+    using enum KTX::KtxUtility_VkFormat;
+    static_assert(KTX::GetGlFormatFromVk(static_cast<KTX::u32>(VK_FORMAT_ASTC_6x5_SFLOAT_BLOCK)) ==
+                  GL_COMPRESSED_RGBA_ASTC_6x5_KHR);
+    static_assert(KTX::GetVkFormatFromGl(GL_COMPRESSED_RGBA_ASTC_6x5_KHR) ==
+                  static_cast<KTX::u32>(VK_FORMAT_ASTC_6x5_UNORM_BLOCK));
+
+    // Field by field, KtxFormatSize and its Flags have no operator==
+    bool SameFormatSize(const KTX::KtxFormatSize& a, const KTX::KtxFormatSize& b)
+    {
+        return a.flags.value() == b.flags.value() && a.palleteSize == b.palleteSize && a.blockSize == b.blockSize &&
+               a.blockWidth == b.blockWidth && a.blockHeight == b.blockHeight && a.blockDepth == b.blockDepth &&
+               a.minBlocksX == b.minBlocksX && a.minBlocksY == b.minBlocksY;
+    }
+
+    // Known answers of the GL format table at run time: a block compressed format, a packed one, a depth/stencil one
+    // through FormatTraits and enums that miss the perfect hash
+    bool TestGlFormatSize()
+    {
+        using enum KTX::KtxFormatSizeFlagBits;
+        const auto dxt5 = KTX::GetGlFormatSize(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+        bool passed = dxt5.blockSize == 128 && dxt5.blockWidth == 4 && dxt5.blockHeight == 4 && dxt5.blockDepth == 1 &&
+                      (dxt5.flags & eKtxFormatSizeCompressedBit) && !(dxt5.flags & eKtxFormatSizePackedBit);
+        using Dxt5Traits = KTX::FormatTraits<GL_COMPRESSED_RGBA_S3TC_DXT5_EXT>;
+        passed = passed && SameFormatSize(Dxt5Traits::formatSize, dxt5) && Dxt5Traits::blockSize == 128 &&
+                 Dxt5Traits::blockWidth == 4 && Dxt5Traits::isCompressed && !Dxt5Traits::isPacked;
+
+        const auto rgb565 = KTX::GetGlFormatSize(GL_RGB565);
+        passed = passed && rgb565.blockSize == 16 && rgb565.blockWidth == 1 && rgb565.blockHeight == 1 &&
+                 (rgb565.flags & eKtxFormatSizePackedBit) && !(rgb565.flags & eKtxFormatSizeCompressedBit);
+        using DepthStencilTraits = KTX::FormatTraits<GL_DEPTH24_STENCIL8>;
+        passed = passed && DepthStencilTraits::blockSize == 32 && DepthStencilTraits::hasDepth &&
+                 DepthStencilTraits::hasStencil && !DepthStencilTraits::isCompressed;
+
+        // 0x83F4 follows GL_COMPRESSED_RGBA_S3TC_DXT5_EXT in the enum space but is no internal format
+        for (const KTX::u32 unknown : {0u, 0x1234u, 0x83F4u, 0xFFFFFFFFu})
+        {
+            passed = passed && SameFormatSize(KTX::GetGlFormatSize(unknown), KTX::Detail::unknownFormatSize) &&
+                     KTX::GetVkFormatFromGl(unknown) == 0;
+        }
+        return passed;
+    }
+
+    // Known answers of the VkFormat table at run time, unknown and multi-planar formats included, and translations
+    // between GL and Vulkan that have to land on a format of the same size both ways
+    bool TestVkFormatSize()
+    {
+        using enum KTX::KtxFormatSizeFlagBits;
+        const auto vkSize = [](const KTX::KtxUtility_VkFormat format)
+        { return KTX::GetVkFormatSize(static_cast<KTX::u32>(format)); };
+        bool passed = SameFormatSize(vkSize(VK_FORMAT_BC3_UNORM_BLOCK),
+                                     KTX::GetGlFormatSize(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT));
+        const auto r5g6b5 = vkSize(VK_FORMAT_R5G6B5_UNORM_PACK16);
+        const auto depthStencil = vkSize(VK_FORMAT_D24_UNORM_S8_UINT);
+        passed = passed && r5g6b5.blockSize == 16 && (r5g6b5.flags & eKtxFormatSizePackedBit) &&
+                 depthStencil.blockSize == 32 && (depthStencil.flags & eKtxFormatSizeDepthBit) &&
+                 (depthStencil.flags & eKtxFormatSizeStencilBit);
+        for (const KTX::u32 unknown : {static_cast<KTX::u32>(VK_FORMAT_UNDEFINED),
+                                       static_cast<KTX::u32>(VK_FORMAT_G8_B8_R8_3PLANE_420_UNORM), 12345u, 0x7FFFFFFFu})
+        {
+            passed = passed && SameFormatSize(KTX::GetVkFormatSize(unknown), KTX::Detail::unknownFormatSize) &&
+                     KTX::GetGlFormatFromVk(unknown) == 0;
+        }
+
+        const std::pair<KTX::u32, KTX::KtxUtility_VkFormat> pairs[] = {
+                {GL_RGBA8, VK_FORMAT_R8G8B8A8_UNORM},
+                {GL_RGB565, VK_FORMAT_R5G6B5_UNORM_PACK16},
+                {GL_DEPTH24_STENCIL8, VK_FORMAT_D24_UNORM_S8_UINT},
+                {GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, VK_FORMAT_BC3_UNORM_BLOCK},
+        };
+        for (const auto& [gl, vk] : pairs)
+        {
+            passed = passed && KTX::GetVkFormatFromGl(gl) == static_cast<KTX::u32>(vk) &&
+                     KTX::GetGlFormatFromVk(static_cast<KTX::u32>(vk)) == gl;
+        }
+        for (const auto& descriptor : KTX::Detail::glFormatDescriptors)
+        {
+            const KTX::u32 vk = KTX::GetVkFormatFromGl(descriptor.glInternalFormat);
+            passed = passed && (vk == 0 || KTX::GetVkFormatSize(vk).blockSize == descriptor.formatSize.blockSize);
+        }
+        return passed;
+    }
+
+    // Writes a page aligned 2 layer RGBA8 array with a full mip chain, loads it back and writes the loaded texture
+    // again, which has to give the same bytes
+    bool TestWriterRoundTrip()
+    {
+        constexpr auto fileName = "KtxWriterRoundTrip.ktx2";
+        KTX::KtxTextureInfo info{};
+        info.vkFormat = static_cast<KTX::u32>(KTX::KtxUtility_VkFormat::VK_FORMAT_R8G8B8A8_SRGB);
+        info.typeSize = 1;
+        info.isArray = true;
+        info.baseWidth = 16;
+        info.baseHeight = 8;
+        info.baseDepth = 1;
+        info.numDimensions = 2;
+        info.numLevels = 5;
+        info.numLayers = 2;
+        info.numFaces = 1;
+
+        std::vector<std::vector<KTX::u8>> levelData;
+        std::vector<std::span<const KTX::u8>> levels;
+        for (KTX::u32 level = 0; level < info.numLevels; ++level)
+        {
+            const KTX::u32 texels = std::max(16u >> level, 1u) * std::max(8u >> level, 1u) * info.numLayers;
+            auto& data = levelData.emplace_back(texels * 4);
+            for (KTX::u32 i = 0; i < data.size(); ++i)
+            {
+                data[i] = static_cast<KTX::u8>(i * 7 + level);
+            }
+        }
+        for (const auto& data : levelData)
+        {
+            levels.emplace_back(data);
+        }
+        // One key/value entry: "KTXorientation" = "rd"
+        const std::vector<KTX::u8> keyValueData{18, 0,   0,   0,   'K', 'T', 'X', 'o', 'r', 'i', 'e', 'n',
+                                                't', 'a', 't', 'i', 'o', 'n', 0,   'r', 'd', 0,   0,   0};
+        const KTX::KtxWriteSource source{.info = info, .levels = levels, .keyValueData = keyValueData};
+        const KTX::KtxWriteOptions options{.levelAlignment = KTX::ktxPageAlignment};
+        if (KTX::WriteKTX2ToFile(fileName, source, options) != KTX::KtxResult::eSuccess)
+        {
+            return false;
+        }
+
+        auto loaded = KTX::LoadKTXFromFile(fileName, KTX::KtxCreateFlags::eLoadImageData);
+        if (!loaded)
+        {
+            return false;
+        }
+        const auto& loadedInfo = loaded->GetInfo();
+        bool passed = loadedInfo.vkFormat == info.vkFormat && loadedInfo.baseWidth == info.baseWidth &&
+                      loadedInfo.baseHeight == info.baseHeight && loadedInfo.numLevels == info.numLevels &&
+                      loadedInfo.numLayers == info.numLayers && loadedInfo.isArray &&
+                      loaded->GetKeyValues().FindString("KTXorientation") == "rd" &&
+                      !loaded->GetKeyValues().FindString("KTXwriter").empty() &&
+                      loaded->GetDataFormatDescriptor().size() == 4 + 24 + 4 * 16;
+        for (KTX::u32 level = 0; level < info.numLevels; ++level)
+        {
+            const auto levelData = loaded->GetLevel(level);
+            passed = passed && loaded->GetLevelIndex()[level].byteOffset % KTX::ktxPageAlignment == 0 &&
+                     std::ranges::equal(levelData, levels[level]);
+        }
+
+        std::ifstream file(fileName, std::ios::binary);
+        const std::vector<KTX::u8> fileData((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const auto rewritten = KTX::WriteKTX2ToMemory(*loaded, options);
+        passed = passed && rewritten && *rewritten == fileData;
+        // The bulk loader leaves out the alignment padding between levels too
+        const std::string fileNames[] = {fileName};
+        const auto bulk = KTX::LoadKTXBulk(fileNames, KTX::KtxCreateFlags::eLoadImageData);
+        passed = passed && bulk[0] && std::ranges::equal(bulk[0]->GetImageData(), loaded->GetImageData());
+        file.close();
+        std::remove(fileName);
+        return passed;
+    }
+
+    // RGBA8 ktx2 file with a full set of levelCount levels, every byte depends on its position and level. Empty if the
+    // writer fails.
+    std::vector<KTX::u8> MakeRgba8Ktx2(const KTX::u32 width, const KTX::u32 height, const KTX::u32 levelCount,
+                                       const std::span<const KTX::KtxKeyValue> keyValues = {})
+    {
+        KTX::KtxTextureInfo info{};
+        info.vkFormat = static_cast<KTX::u32>(VK_FORMAT_R8G8B8A8_UNORM);
+        info.typeSize = 1;
+        info.baseWidth = width;
+        info.baseHeight = height;
+        info.baseDepth = 1;
+        info.numDimensions = 2;
+        info.numLevels = levelCount;
+        info.numLayers = 1;
+        info.numFaces = 1;
+
+        std::vector<std::vector<KTX::u8>> levelData(levelCount);
+        std::vector<std::span<const KTX::u8>> levels;
+        for (KTX::u32 level = 0; level < levelCount; ++level)
+        {
+            levelData[level].resize(KTX::u64{std::max(width >> level, 1u)} * std::max(height >> level, 1u) * 4);
+            for (KTX::u32 i = 0; i < levelData[level].size(); ++i)
+            {
+                levelData[level][i] = static_cast<KTX::u8>(i * 13 + level * 101);
+            }
+            levels.emplace_back(levelData[level]);
+        }
+        const auto fileData = KTX::WriteKTX2ToMemory({.info = info, .levels = levels, .keyValues = keyValues});
+        return fileData ? *fileData : std::vector<KTX::u8>();
+    }
+
+    // Streams a 4 level texture loaded without image data and checks that the levels come coarsest first, with the
+    // sizes GetNextLevelSize announces and the bytes the eager load holds
+    bool TestMipStreamer()
+    {
+        const auto fileData = MakeRgba8Ktx2(16, 8, 4);
+        const auto eager = KTX::LoadKTXFromMemory(fileData, KTX::KtxCreateFlags::eLoadImageData);
+        auto lazy = KTX::LoadKTXFromMemory(fileData);
+        if (!eager || !lazy)
+        {
+            return false;
+        }
+
+        KTX::KtxMipStreamer streamer(*lazy);
+        bool passed = true;
+        for (KTX::u32 expectedLevel = 4; passed && expectedLevel-- > 0;)
+        {
+            const KTX::u64 expectedSize = KTX::u64{16u >> expectedLevel} * (8u >> expectedLevel) * 4;
+            std::vector<KTX::u8> level(streamer.HasNext() ? streamer.GetNextLevelSize() : 0);
+            passed = streamer.HasNext() && streamer.GetNextLevel() == expectedLevel && level.size() == expectedSize &&
+                     streamer.StreamNext(level) && std::ranges::equal(level, eager->GetLevel(expectedLevel));
+        }
+        return passed && !streamer.HasNext();
+    }
+
+    // Decodes the same RGBA8 ktx1 header in both byte orders and a ktx2 header, from nothing but the header bytes.
+    // Truncated headers have to fail instead of reading past the buffer.
+    bool TestDecodeHeader()
+    {
+        constexpr KTX::u8 identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+        // glType UNSIGNED_BYTE, glFormat RGBA, glInternalFormat RGBA8, 16x8, five levels
+        constexpr KTX::u32 fields[13] = {0x04030201, 0x1401, 1, 0x1908, 0x8058, 0x1908, 16, 8, 0, 0, 1, 5, 0};
+        const auto makeKtx1Header = [&](const bool bigEndian)
+        {
+            std::vector<KTX::u8> header(identifier, identifier + sizeof(identifier));
+            for (const auto field : fields)
+            {
+                for (KTX::u32 i = 0; i < 4; ++i)
+                {
+                    header.push_back(static_cast<KTX::u8>(field >> (bigEndian ? 24 - i * 8 : i * 8)));
+                }
+            }
+            return header;
+        };
+        const auto isKtx1Info = [](const std::expected<KTX::KtxTextureInfo, KTX::KtxResult>& info, const bool needSwap)
+        {
+            return info && !info->isKtx2 && info->needSwap == needSwap && info->baseWidth == 16 &&
+                   info->baseHeight == 8 && info->numDimensions == 2 && info->numLevels == 5 &&
+                   info->numFaces == 1 && info->glInternalFormat == 0x8058 && info->glType == 0x1401 &&
+                   info->typeSize == 1 && info->vkFormat == static_cast<KTX::u32>(VK_FORMAT_R8G8B8A8_UNORM) &&
+                   info->formatSize.blockSize == 32;
+        };
+        const auto littleEndian = makeKtx1Header(false);
+        const auto bigEndian = makeKtx1Header(true);
+        bool passed = isKtx1Info(KTX::DecodeKTXHeader(littleEndian), false) &&
+                      isKtx1Info(KTX::DecodeKTXHeader(bigEndian), true);
+
+        // Only the 80 header bytes of the ktx2 file are handed over
+        const auto ktx2File = MakeRgba8Ktx2(8, 4, 3);
+        const auto ktx2 = KTX::DecodeKTXHeader(std::span(ktx2File).first(80));
+        passed = passed && ktx2 && ktx2->isKtx2 && !ktx2->needSwap && ktx2->baseWidth == 8 && ktx2->baseHeight == 4 &&
+                 ktx2->numLevels == 3 && ktx2->vkFormat == static_cast<KTX::u32>(VK_FORMAT_R8G8B8A8_UNORM) &&
+                 ktx2->glInternalFormat == 0x8058;
+
+        const auto failsWith = [](const std::span<const KTX::u8> data, const KTX::KtxResult expected)
+        {
+            const auto info = KTX::DecodeKTXHeader(data);
+            return !info && info.error() == expected;
+        };
+        constexpr KTX::u8 garbage[80] = {'n', 'o', 't', ' ', 'a', ' ', 'k', 't', 'x', ' ', 'f', 'i', 'l', 'e'};
+        return passed && failsWith(std::span(littleEndian).first(63), KTX::KtxResult::eFileReadError) &&
+               failsWith(std::span(bigEndian).first(20), KTX::KtxResult::eFileReadError) &&
+               failsWith(std::span(ktx2File).first(79), KTX::KtxResult::eFileReadError) &&
+               failsWith(std::span(ktx2File).first(5), KTX::KtxResult::eFileReadError) &&
+               failsWith({}, KTX::KtxResult::eFileReadError) && failsWith(garbage, KTX::KtxResult::eUnknownFileFormat);
+    }
+
+    // Probes a file from disk and from memory and compares the result with the info of a full load, including a
+    // non default orientation. An orientation past the first 4 KiB is out of reach of a probe but not of a load.
+    bool TestProbe()
+    {
+        constexpr auto fileName = "KtxProbe.ktx2";
+        const auto sameInfo = [](const KTX::KtxTextureInfo& a, const KTX::KtxTextureInfo& b)
+        {
+            return a.formatSize.blockSize == b.formatSize.blockSize && a.typeSize == b.typeSize &&
+                   a.isKtx2 == b.isKtx2 && a.isArray == b.isArray && a.isCubeMap == b.isCubeMap &&
+                   a.isCompressed == b.isCompressed && a.needSwap == b.needSwap &&
+                   a.baseWidth == b.baseWidth && a.baseHeight == b.baseHeight && a.baseDepth == b.baseDepth &&
+                   a.numDimensions == b.numDimensions && a.numLevels == b.numLevels && a.numLayers == b.numLayers &&
+                   a.numFaces == b.numFaces && a.orientation.x == b.orientation.x &&
+                   a.orientation.y == b.orientation.y && a.orientation.z == b.orientation.z &&
+                   a.glInternalFormat == b.glInternalFormat && a.vkFormat == b.vkFormat &&
+                   a.superCompressionScheme == b.superCompressionScheme;
+        };
+        const auto writeFile = [&](const std::span<const KTX::u8> data)
+        {
+            std::ofstream(fileName, std::ios::binary)
+                    .write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        };
+        constexpr char orientation[] = "lu";
+        const KTX::KtxKeyValue orientationEntry = {
+                "KTXorientation", std::span(reinterpret_cast<const KTX::u8*>(orientation), sizeof(orientation))};
+        const auto fileData = MakeRgba8Ktx2(16, 8, 3, std::span(&orientationEntry, 1));
+        writeFile(fileData);
+        const auto loaded = KTX::LoadKTXFromFile(fileName);
+        const auto probedFile = KTX::ProbeKTXFromFile(fileName);
+        const auto probedMemory = KTX::ProbeKTXFromMemory(fileData);
+        bool passed = loaded && probedFile && probedMemory && sameInfo(loaded->GetInfo(), *probedFile) &&
+                      sameInfo(loaded->GetInfo(), *probedMemory) &&
+                      probedFile->orientation.x == KTX::KtxOrientationX::eLeft &&
+                      probedFile->orientation.y == KTX::KtxOrientationY::eUp;
+
+        // "KTXbig" sorts before "KTXorientation" and pushes it past the 4 KiB a probe reads
+        const std::vector<KTX::u8> bigValue(5000, 0x5A);
+        const KTX::KtxKeyValue cappedEntries[] = {{"KTXbig", bigValue}, orientationEntry};
+        const auto cappedData = MakeRgba8Ktx2(16, 8, 3, cappedEntries);
+        writeFile(cappedData);
+        const auto cappedLoad = KTX::LoadKTXFromFile(fileName);
+        const auto cappedFile = KTX::ProbeKTXFromFile(fileName);
+        const auto cappedMemory = KTX::ProbeKTXFromMemory(cappedData);
+        passed = passed && cappedLoad && cappedFile && cappedMemory &&
+                 cappedLoad->GetInfo().orientation.x == KTX::KtxOrientationX::eLeft &&
+                 cappedLoad->GetInfo().orientation.y == KTX::KtxOrientationY::eUp &&
+                 cappedFile->orientation.x == KTX::KtxOrientationX::eRight &&
+                 cappedFile->orientation.y == KTX::KtxOrientationY::eDown &&
+                 sameInfo(*cappedFile, *cappedMemory) && cappedFile->baseWidth == 16 && cappedFile->numLevels == 3;
+        std::remove(fileName);
+        return passed && !KTX::ProbeKTXFromFile(fileName);
+    }
+
+    // Batch loads two valid files around a missing and a corrupt one through both overloads, the two bad files have to
+    // fail on their own while the others load
+    bool TestLoadBatch()
+    {
+        const std::string fileNames[] = {"KtxBatch0.ktx2", "KtxBatchMissing.ktx2", "KtxBatchCorrupt.ktx2",
+                                         "KtxBatch1.ktx2"};
+        const auto fileData = MakeRgba8Ktx2(8, 8, 2);
+        const std::vector<KTX::u8> corrupt(fileData.begin(), fileData.begin() + 100);
+        for (const auto& [name, data] : {std::pair{fileNames[0], &fileData}, std::pair{fileNames[2], &corrupt},
+                                         std::pair{fileNames[3], &fileData}})
+        {
+            std::ofstream(name, std::ios::binary)
+                    .write(reinterpret_cast<const char*>(data->data()), static_cast<std::streamsize>(data->size()));
+        }
+        const auto isExpected = [&](const size_t index, const KTX::KtxLoadResult& result)
+        {
+            if (index == 1 || index == 2)
+            {
+                return !result.has_value();
+            }
+            return result && result->GetInfo().numLevels == 2 && result->GetImageData().size() == (64 + 16) * 4;
+        };
+
+        KTX::KtxThreadPool pool(2);
+        auto futures = KTX::LoadKTXBatch(pool, fileNames, KTX::KtxCreateFlags::eLoadImageData);
+        bool passed = futures.size() == std::size(fileNames);
+        for (size_t i = 0; passed && i < futures.size(); ++i)
+        {
+            passed = isExpected(i, futures[i].get());
+        }
+
+        std::mutex mutex;
+        std::vector<bool> reported(std::size(fileNames));
+        std::vector<bool> matched(std::size(fileNames));
+        KTX::LoadKTXBatch(pool, fileNames, KTX::KtxCreateFlags::eLoadImageData,
+                          [&](const size_t index, KTX::KtxLoadResult result)
+                          {
+                              const bool isMatch = isExpected(index, result);
+                              std::lock_guard lock(mutex);
+                              reported[index] = true;
+                              matched[index] = isMatch;
+                          });
+        pool.WaitIdle();
+        passed = passed && std::ranges::all_of(reported, std::identity()) &&
+                 std::ranges::all_of(matched, std::identity());
+        for (const auto& name : fileNames)
+        {
+            std::remove(name.c_str());
+        }
+        return passed;
+    }
+
+    // Box filters a 4x2 RGBA8 texture that leaves its mip chain to the reader, every level is the average of the one
+    // before it
+    bool TestMipGeneration()
+    {
+        KTX::KtxTextureInfo info{};
+        info.vkFormat = static_cast<KTX::u32>(KTX::KtxUtility_VkFormat::VK_FORMAT_R8G8B8A8_UNORM);
+        info.typeSize = 1;
+        info.isKtx2 = true;
+        info.generateMipmaps = true;
+        info.baseWidth = 4;
+        info.baseHeight = 2;
+        info.baseDepth = 1;
+        info.numDimensions = 2;
+        info.numLevels = 1;
+        info.numLayers = 1;
+        info.numFaces = 1;
+        constexpr KTX::u32 levelSize = 4 * 2 * 4;
+        auto data = std::make_unique<KTX::u8[]>(levelSize);
+        for (KTX::u32 i = 0; i < levelSize; ++i)
+        {
+            data[i] = static_cast<KTX::u8>(i * 8);
+        }
+        KTX::KtxTexture texture(info);
+        texture.SetImageData(std::move(data), levelSize, {{.byteOffset = 0, .byteLength = levelSize}});
+
+        KTX::KtxThreadPool pool(2);
+        const auto mipmapped = KTX::GenerateMipmaps(pool, texture);
+        if (!mipmapped || mipmapped->GetInfo().numLevels != 3 || mipmapped->GetInfo().generateMipmaps)
+        {
+            return false;
+        }
+        // Texel (x, y) channel c of level 0 holds 8 * (16 * y + 4 * x + c)
+        const std::vector<KTX::u8> level1{80, 88, 96, 104, 144, 152, 160, 168};
+        const std::vector<KTX::u8> level2{112, 120, 128, 136};
+        return std::ranges::equal(mipmapped->GetLevel(1), level1) && std::ranges::equal(mipmapped->GetLevel(2), level2);
+    }
+
+    // Writes a big endian ktx1 RGBA16 texture with rows of 3 texels and an orientation, and checks that loading, bulk
+    // loading, reading, streaming and mapping all hand the texels over in native order
+    bool TestKtx1EndianSwap()
+    {
+        constexpr auto fileName = "KtxEndianSwap.ktx";
+        constexpr KTX::u8 identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+        constexpr KTX::u32 texelCount = 3 * 2 * 4;
+        constexpr KTX::u32 levelSize = texelCount * 2;
+        // One key/value entry: "KTXorientation" = "S=r,T=u"
+        constexpr KTX::u8 keyValue[] = {'K', 'T', 'X', 'o', 'r', 'i', 'e', 'n', 't', 'a', 't', 'i',
+                                        'o', 'n', 0,   'S', '=', 'r', ',', 'T', '=', 'u', 0,   0};
+        // glType UNSIGNED_SHORT, glFormat RGBA, glInternalFormat RGBA16, one level
+        const KTX::u32 fields[13] = {0x04030201, 0x1403, 2, 0x1908, 0x805B, 0x1908, 3, 2, 0, 0, 1, 1,
+                                     4 + sizeof(keyValue)};
+        std::vector<KTX::u8> fileData(identifier, identifier + sizeof(identifier));
+        std::vector<KTX::u16> texels(texelCount);
+        const auto appendBigEndian = [&](const KTX::u32 value)
+        {
+            for (KTX::u32 shift = 32; shift > 0; shift -= 8)
+            {
+                fileData.push_back(static_cast<KTX::u8>(value >> (shift - 8)));
+            }
+        };
+        for (const auto field : fields)
+        {
+            appendBigEndian(field);
+        }
+        appendBigEndian(sizeof(keyValue) - 1);
+        fileData.insert(fileData.end(), std::begin(keyValue), std::end(keyValue));
+        appendBigEndian(levelSize);
+        for (KTX::u32 i = 0; i < texelCount; ++i)
+        {
+            texels[i] = static_cast<KTX::u16>(i * 0x0901 + 0x0102);
+            fileData.push_back(static_cast<KTX::u8>(texels[i] >> 8));
+            fileData.push_back(static_cast<KTX::u8>(texels[i]));
+        }
+        const auto native = std::as_bytes(std::span(texels));
+        const auto matches = [&](const std::span<const KTX::u8> data)
+        { return std::ranges::equal(std::as_bytes(data), native); };
+
+        const auto loaded = KTX::LoadKTXFromMemory(fileData, KTX::KtxCreateFlags::eLoadImageData);
+        bool passed = loaded && loaded->GetInfo().needSwap && matches(loaded->GetLevel(0)) &&
+                      loaded->GetKeyValues().FindString("KTXorientation") == "S=r,T=u";
+
+        std::ofstream(fileName, std::ios::binary)
+                .write(reinterpret_cast<const char*>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+        auto streamed = KTX::LoadKTXFromFile(fileName);
+        std::vector<KTX::u8> level(levelSize);
+        passed = passed && streamed && streamed->ReadLevel(0, level) && matches(level);
+        // 7 bytes only fit 3 whole texels, every chunk has to end on a texel
+        std::vector<KTX::u8> chunks;
+        std::array<KTX::u8, 7> buffer{};
+        passed = passed && streamed->StreamLevel(0, buffer,
+                                                 [&](const std::span<const KTX::u8> chunk)
+                                                 {
+                                                     chunks.insert(chunks.end(), chunk.begin(), chunk.end());
+                                                     return chunk.size() % 2 == 0;
+                                                 }) &&
+                 matches(chunks);
+        const auto mapped = KTX::MapKTXFromFile(fileName);
+        passed = passed && mapped && matches(mapped->CopyLevel(0));
+        const std::string fileNames[] = {fileName};
+        const auto bulk = KTX::LoadKTXBulk(fileNames, KTX::KtxCreateFlags::eLoadImageData);
+        passed = passed && bulk[0] && matches(bulk[0]->GetLevel(0)) &&
+                 bulk[0]->GetKeyValues().FindString("KTXorientation") == "S=r,T=u";
+        std::remove(fileName);
+        return passed;
+    }
+
+    // Converts a big endian ktx1 RGB565 texture with rows of 3 texels, padded to 8 bytes, and checks that the ktx2 file
+    // holds the texels unpadded and in native order
+    bool TestConvertKtx1()
+    {
+        constexpr auto inputName = "KtxConvert.ktx";
+        constexpr auto outputName = "KtxConvert.ktx2";
+        constexpr KTX::u8 identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+        // glType UNSIGNED_SHORT_5_6_5, glFormat RGB, glInternalFormat RGB565, 3x2, one level
+        constexpr KTX::u32 fields[13] = {0x04030201, 0x8363, 2, 0x1907, 0x8D62, 0x1907, 3, 2, 0, 0, 1, 1, 0};
+        std::vector<KTX::u8> fileData(identifier, identifier + sizeof(identifier));
+        const auto appendBigEndian = [&](const KTX::u32 value)
+        {
+            for (KTX::u32 shift = 32; shift > 0; shift -= 8)
+            {
+                fileData.push_back(static_cast<KTX::u8>(value >> (shift - 8)));
+            }
+        };
+        for (const auto field : fields)
+        {
+            appendBigEndian(field);
+        }
+        appendBigEndian(2 * 8);
+        std::vector<KTX::u16> texels(3 * 2);
+        for (KTX::u32 i = 0; i < texels.size(); ++i)
+        {
+            texels[i] = static_cast<KTX::u16>(i * 0x2B1D + 0xF00F);
+            fileData.push_back(static_cast<KTX::u8>(texels[i] >> 8));
+            fileData.push_back(static_cast<KTX::u8>(texels[i]));
+            if (i % 3 == 2)
+            {
+                fileData.insert(fileData.end(), {0xEE, 0xEE});
+            }
+        }
+        std::ofstream(inputName, std::ios::binary)
+                .write(reinterpret_cast<const char*>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+
+        const auto size = KTX::ConvertKTXFile(inputName, outputName, {});
+        const auto converted = KTX::LoadKTXFromFile(outputName, KTX::KtxCreateFlags::eLoadImageData);
+        bool passed = size && *size == std::filesystem::file_size(outputName) && converted &&
+                      converted->GetInfo().isKtx2 &&
+                      converted->GetInfo().vkFormat == static_cast<KTX::u32>(VK_FORMAT_R5G6B5_UNORM_PACK16) &&
+                      converted->GetFormatDescriptor() != nullptr &&
+                      std::ranges::equal(std::as_bytes(converted->GetLevel(0)), std::as_bytes(std::span(texels)));
+        // Ktx2 inputs are skipped, failed writes leave no file behind
+        const auto skipped = KTX::ConvertKTXFile(outputName, "KtxConvertSkipped.ktx2", {});
+        passed = passed && skipped && *skipped == 0 && !std::filesystem::exists("KtxConvertSkipped.ktx2") &&
+                 !KTX::ConvertKTXFile(inputName, "KtxMissingDirectory/KtxConvert.ktx2", {});
+        std::remove(inputName);
+        std::remove(outputName);
+        return passed;
+    }
+
+    // Parses the DFD the writer builds for RGBA8 sRGB, and checks that two loads of the file share one descriptor
+    bool TestDataFormatDescriptor()
+    {
+        KTX::KtxTextureInfo info{};
+        info.vkFormat = static_cast<KTX::u32>(KTX::KtxUtility_VkFormat::VK_FORMAT_R8G8B8A8_SRGB);
+        info.typeSize = 1;
+        info.baseWidth = 2;
+        info.baseHeight = 2;
+        info.baseDepth = 1;
+        info.numDimensions = 2;
+        info.numLevels = 1;
+        info.numLayers = 1;
+        info.numFaces = 1;
+        const std::vector<KTX::u8> level(2 * 2 * 4);
+        const std::span<const KTX::u8> levels[] = {level};
+        const auto fileData = KTX::WriteKTX2ToMemory({.info = info, .levels = levels});
+        if (!fileData)
+        {
+            return false;
+        }
+        const auto first = KTX::LoadKTXFromMemory(*fileData);
+        const auto second = KTX::LoadKTXFromMemory(*fileData);
+        if (!first || !second || first->GetFormatDescriptor() == nullptr ||
+            first->GetFormatDescriptor() != second->GetFormatDescriptor())
+        {
+            return false;
+        }
+
+        const auto& descriptor = *first->GetFormatDescriptor();
+        bool passed = descriptor.colorModel == KTX::KtxDfdColorModel::eRgbsda &&
+                      descriptor.colorPrimaries == KTX::KtxDfdColorPrimaries::eBt709 &&
+                      descriptor.transferFunction == KTX::KtxDfdTransferFunction::eSrgb &&
+                      !descriptor.isPremultiplied &&
+                      descriptor.texelBlockDimensions == std::array<KTX::u32, 4>{1, 1, 1, 1} &&
+                      descriptor.bytesPlane[0] == 4 && descriptor.samples.size() == 4;
+        constexpr KTX::u8 channels[] = {0, 1, 2, 15};
+        for (KTX::u32 i = 0; passed && i < 4; ++i)
+        {
+            const auto& sample = descriptor.samples[i];
+            passed = sample.channelId == channels[i] && sample.bitOffset == i * 8 && sample.bitLength == 8 &&
+                     sample.isLinear == (i == 3) && !sample.isSigned && !sample.isFloat && sample.sampleUpper == 255;
+        }
+        // Without its last word the basic block runs past the end of the descriptor
+        const auto original = first->GetDataFormatDescriptor();
+        auto dfd = std::vector(original.begin(), original.end());
+        dfd.resize(dfd.size() - 4);
+        dfd[0] -= 4;
+        passed = passed && !KTX::ParseDataFormatDescriptor(dfd) && KTX::InternDataFormatDescriptor(dfd) == nullptr;
+
+        // 64 more samples make a valid descriptor that is too large to be interned
+        dfd.assign(original.begin(), original.end());
+        for (KTX::u32 i = 0; i < 64; ++i)
+        {
+            dfd.insert(dfd.end(), original.end() - 16, original.end());
+        }
+        const auto totalSize = static_cast<KTX::u32>(dfd.size());
+        const auto blockSize = static_cast<KTX::u16>(totalSize - 4);
+        std::memcpy(dfd.data(), &totalSize, sizeof(totalSize));
+        std::memcpy(dfd.data() + 10, &blockSize, sizeof(blockSize));
+        const auto large = KTX::ParseDataFormatDescriptor(dfd);
+        passed = passed && large && large->samples.size() == 68 && KTX::InternDataFormatDescriptor(dfd) == nullptr;
+
+        // Packed formats list their channels from the least significant bit up, 565 is blue, green, red
+        info.vkFormat = static_cast<KTX::u32>(VK_FORMAT_R5G6B5_UNORM_PACK16);
+        const std::vector<KTX::u8> packedLevel(2 * 2 * 2);
+        const std::span<const KTX::u8> packedLevels[] = {packedLevel};
+        const auto packedData = KTX::WriteKTX2ToMemory({.info = info, .levels = packedLevels});
+        const auto packed = packedData ? KTX::LoadKTXFromMemory(*packedData) : std::unexpected(packedData.error());
+        if (!passed || !packed || packed->GetFormatDescriptor() == nullptr)
+        {
+            return false;
+        }
+        const auto& packedDescriptor = *packed->GetFormatDescriptor();
+        passed = packedDescriptor.transferFunction == KTX::KtxDfdTransferFunction::eLinear &&
+                 packedDescriptor.bytesPlane[0] == 2 && packedDescriptor.samples.size() == 3;
+        constexpr KTX::u16 packedOffsets[] = {0, 5, 11};
+        constexpr KTX::u16 packedLengths[] = {5, 6, 5};
+        for (KTX::u32 i = 0; passed && i < 3; ++i)
+        {
+            const auto& sample = packedDescriptor.samples[i];
+            passed = sample.channelId == 2 - i && sample.bitOffset == packedOffsets[i] &&
+                     sample.bitLength == packedLengths[i] && sample.sampleUpper == (1u << packedLengths[i]) - 1;
+        }
+
+        // Depth/stencil and shared exponent formats have descriptors too
+        for (const auto format : {VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_E5B9G9R9_UFLOAT_PACK32})
+        {
+            info.vkFormat = static_cast<KTX::u32>(format);
+            const std::vector<KTX::u8> level32(2 * 2 * 4);
+            const std::span<const KTX::u8> levels32[] = {level32};
+            const auto data = KTX::WriteKTX2ToMemory({.info = info, .levels = levels32});
+            const auto texture = data ? KTX::LoadKTXFromMemory(*data) : std::unexpected(data.error());
+            passed = passed && texture && texture->GetFormatDescriptor() != nullptr &&
+                     texture->GetFormatDescriptor()->samples.size() ==
+                             (format == VK_FORMAT_D24_UNORM_S8_UINT ? 2u : 6u);
+        }
+        return passed;
+    }
+
+    // Decodes a single 4x4 block, empty if the decoder fails
+    std::vector<KTX::u8> DecodeBlock(const KTX::KtxUtility_VkFormat format, const std::span<const KTX::u8> block)
+    {
+        const auto vkFormat = static_cast<KTX::u32>(format);
+        std::vector<KTX::u8> texels(KTX::GetDecodedImageSize(vkFormat, 4, 4));
+        if (KTX::DecodeImageRows(vkFormat, block, 4, 4, 0, 1, texels) != KTX::KtxResult::eSuccess)
+        {
+            return {};
+        }
+        return texels;
+    }
+
+    // BC1 block in 4 color mode, pure red and blue endpoints and every row using the indices 0 to 3 left to right
+    bool TestBc1Block()
+    {
+        constexpr KTX::u8 block[8] = {0x00, 0xF8, 0x1F, 0x00, 0xE4, 0xE4, 0xE4, 0xE4};
+        constexpr KTX::u8 palette[4][4] = {{255, 0, 0, 255}, {0, 0, 255, 255}, {170, 0, 85, 255}, {85, 0, 170, 255}};
+        const auto texels = DecodeBlock(VK_FORMAT_BC1_RGB_UNORM_BLOCK, block);
+        bool passed = texels.size() == 16 * 4;
+        for (KTX::u32 i = 0; passed && i < 16; ++i)
+        {
+            passed = std::ranges::equal(std::span(texels).subspan(i * 4, 4), palette[i % 4]);
+        }
+        return passed;
+    }
+
+    // ETC1 individual mode block with two 2x4 subblocks: 136 grey with table 0 on the left and 68 grey with table 1 on
+    // the right. Texel (0, 0) takes -8, (1, 2) takes -2, (3, 3) takes +17 and every other texel the small positive
+    // modifier of its subblock.
+    bool TestEtc1Block()
+    {
+        constexpr KTX::u8 block[8] = {0x84, 0x84, 0x84, 0x04, 0x00, 0x41, 0x80, 0x01};
+        const auto texels = DecodeBlock(VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, block);
+        bool passed = texels.size() == 16 * 4;
+        for (KTX::u32 y = 0; passed && y < 4; ++y)
+        {
+            for (KTX::u32 x = 0; passed && x < 4; ++x)
+            {
+                KTX::u8 grey = x < 2 ? 138 : 73;
+                grey = x == 0 && y == 0 ? 128 : x == 1 && y == 2 ? 134 : x == 3 && y == 3 ? 85 : grey;
+                const KTX::u8 expected[4] = {grey, grey, grey, 255};
+                passed = std::ranges::equal(std::span(texels).subspan((y * 4 + x) * 4, 4), expected);
+            }
+        }
+        return passed;
+    }
+
+    // ASTC LDR void extent block without extent coordinates, every texel takes the block's constant color
+    bool TestAstcVoidExtentBlock()
+    {
+        constexpr KTX::u8 block[16] = {0xFC, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                       0xFF, 0xFF, 0x80, 0x80, 0x40, 0x40, 0xFF, 0xFF};
+        constexpr KTX::u8 color[4] = {255, 128, 64, 255};
+        const auto texels = DecodeBlock(VK_FORMAT_ASTC_4x4_UNORM_BLOCK, block);
+        bool passed = texels.size() == 16 * 4;
+        for (KTX::u32 i = 0; passed && i < 16; ++i)
+        {
+            passed = std::ranges::equal(std::span(texels).subspan(i * 4, 4), color);
+        }
+        return passed;
+    }
+
+    // 16x8 UASTC texture with one fixed block per mode whose endpoints take any bits (8 bit endpoints, no partition
+    // pattern) and the solid color mode. Transcoding it to RGBA8 has to give the same texels as transcoding it to ASTC
+    // 4x4 and decoding that, which ties the UASTC block unpacking, the ASTC block packing and the ASTC decoder
+    // together.
+    bool TestUastcTranscode()
+    {
+        // Mode code and code length of modes 1, 5, 8, 13, 14, 15, 17 and 1 again
+        constexpr std::pair<KTX::u8, KTX::u8> modes[8] = {{0x35, 6}, {0x0B, 5}, {0x17, 5}, {0x1F, 5},
+                                                          {0x0D, 5}, {0x05, 7}, {0x25, 6}, {0x35, 6}};
+        std::vector<KTX::u8> level(std::size(modes) * 16);
+        for (KTX::u32 i = 0; i < level.size(); ++i)
+        {
+            level[i] = static_cast<KTX::u8>(i * 97 + (i >> 3) * 29 + 13);
+        }
+        for (KTX::u32 block = 0; block < std::size(modes); ++block)
+        {
+            const auto [code, length] = modes[block];
+            const auto mask = static_cast<KTX::u8>((1u << length) - 1);
+            level[block * 16] = static_cast<KTX::u8>((level[block * 16] & ~mask) | code);
+        }
+
+        KTX::KtxTextureInfo info{};
+        info.typeSize = 1;
+        info.baseWidth = 16;
+        info.baseHeight = 8;
+        info.baseDepth = 1;
+        info.numDimensions = 2;
+        info.numLevels = 1;
+        info.numLayers = 1;
+        info.numFaces = 1;
+        // Basic descriptor block with one RGBA sample of the UASTC color model, 4x4 blocks of 16 bytes
+        const KTX::u32 dfd[11] = {44, 0, 2 | 40 << 16, 166 | 1 << 8 | 1 << 16, 3 | 3 << 8, 16, 0,
+                                  127 << 16 | 3u << 24, 0, 0, 0xFFFFFFFF};
+        const std::span<const KTX::u8> levels[] = {level};
+        const std::span descriptor(reinterpret_cast<const KTX::u8*>(dfd), sizeof(dfd));
+        const auto fileData =
+                KTX::WriteKTX2ToMemory({.info = info, .levels = levels, .dataFormatDescriptor = descriptor});
+        if (!fileData)
+        {
+            return false;
+        }
+        const auto texture = KTX::LoadKTXFromMemory(*fileData, KTX::KtxCreateFlags::eLoadImageData);
+        if (!texture)
+        {
+            return false;
+        }
+        const auto transcoder = KTX::KtxTranscoder::Create(*texture);
+        if (!transcoder)
+        {
+            return false;
+        }
+
+        using enum KTX::KtxTranscodeTarget;
+        std::vector<KTX::u8> rgba(transcoder->GetTranscodedLevelSize(0, eRGBA8));
+        std::vector<KTX::u8> astc(transcoder->GetTranscodedLevelSize(0, eASTC4x4));
+        const auto astcFormat = static_cast<KTX::u32>(VK_FORMAT_ASTC_4x4_UNORM_BLOCK);
+        std::vector<KTX::u8> decoded(KTX::GetDecodedImageSize(astcFormat, 16, 8));
+        return rgba.size() == 16 * 8 * 4 && astc.size() == level.size() &&
+               transcoder->TranscodeLevel(0, texture->GetLevel(0), eRGBA8, rgba) == KTX::KtxResult::eSuccess &&
+               transcoder->TranscodeLevel(0, texture->GetLevel(0), eASTC4x4, astc) == KTX::KtxResult::eSuccess &&
+               KTX::DecodeImageRows(astcFormat, astc, 16, 8, 0, 2, decoded) == KTX::KtxResult::eSuccess &&
+               decoded == rgba;
+    }
+
+    // 4x4 BasisLZ texture of a single block: color 20, 16, 12 (5 bit) with modifier table 2, and a selector that uses
+    // selectors 0 to 3 left to right on every row. The RGBA8 target has to give the ETC1S colors and the ETC2 RGB
+    // target the same texels once decoded.
+    bool TestBasisLZTranscode()
+    {
+        // Colors are deltas from 16, the modifier table a delta from 0
+        BitWriter endpoints;
+        for (KTX::u32 model = 0; model < 3; ++model)
+        {
+            PutFlatHuffmanTable(endpoints, 32, 5);
+        }
+        PutFlatHuffmanTable(endpoints, 8, 3);
+        endpoints.Put(0, 1);
+        endpoints.PutCode(2, 3);
+        for (const KTX::u32 delta : {4, 0, 28})
+        {
+            endpoints.PutCode(delta, 5);
+        }
+
+        // One raw selector, one byte per row
+        BitWriter selectors;
+        selectors.Put(0b100, 3);
+        for (KTX::u32 row = 0; row < 4; ++row)
+        {
+            selectors.Put(0xE4, 8);
+        }
+
+        BitWriter tables;
+        PutFlatHuffmanTable(tables, 257, 9);
+        PutFlatHuffmanTable(tables, 2, 1);
+        PutFlatHuffmanTable(tables, 2, 1);
+        tables.Put(0, 14);
+        tables.Put(0, 13);
+
+        // Endpoint predicted as a delta of 0 from the previous one, then selector 0
+        BitWriter slice;
+        slice.PutCode(3, 9);
+        slice.PutCode(0, 1);
+        slice.PutCode(0, 1);
+
+        const KTX::u32 globalHeader[5] = {1 | 1 << 16, static_cast<KTX::u32>(endpoints.bytes.size()),
+                                          static_cast<KTX::u32>(selectors.bytes.size()),
+                                          static_cast<KTX::u32>(tables.bytes.size()), 0};
+        const KTX::u32 imageDesc[5] = {0, 0, static_cast<KTX::u32>(slice.bytes.size()), 0, 0};
+        std::vector<KTX::u8> globalData(sizeof(globalHeader) + sizeof(imageDesc));
+        std::memcpy(globalData.data(), globalHeader, sizeof(globalHeader));
+        std::memcpy(globalData.data() + sizeof(globalHeader), imageDesc, sizeof(imageDesc));
+        for (const auto* part : {&endpoints.bytes, &selectors.bytes, &tables.bytes})
+        {
+            globalData.insert(globalData.end(), part->begin(), part->end());
+        }
+
+        KTX::KtxTextureInfo info{};
+        info.typeSize = 1;
+        info.baseWidth = 4;
+        info.baseHeight = 4;
+        info.baseDepth = 1;
+        info.numDimensions = 2;
+        info.numLevels = 1;
+        info.numLayers = 1;
+        info.numFaces = 1;
+        info.superCompressionScheme = static_cast<KTX::u32>(KTX::KtxSupercompressionScheme::eBasisLZ);
+        // Basic descriptor block with one RGB sample of the ETC1S color model
+        const KTX::u32 dfd[11] = {44, 0, 2 | 40 << 16, 163 | 1 << 8 | 1 << 16, 3 | 3 << 8, 0, 0, 63 << 16, 0, 0,
+                                  0xFFFFFFFF};
+        const std::span<const KTX::u8> levels[] = {slice.bytes};
+        const std::span descriptor(reinterpret_cast<const KTX::u8*>(dfd), sizeof(dfd));
+        const auto fileData = KTX::WriteKTX2ToMemory({.info = info,
+                                                      .levels = levels,
+                                                      .dataFormatDescriptor = descriptor,
+                                                      .superCompressionGlobalData = globalData});
+        if (!fileData)
+        {
+            return false;
+        }
+        const auto texture = KTX::LoadKTXFromMemory(*fileData, KTX::KtxCreateFlags::eLoadImageData);
+        if (!texture)
+        {
+            return false;
+        }
+        const auto transcoder = KTX::KtxTranscoder::Create(*texture);
+        if (!transcoder)
+        {
+            return false;
+        }
+
+        using enum KTX::KtxTranscodeTarget;
+        std::vector<KTX::u8> rgba(transcoder->GetTranscodedLevelSize(0, eRGBA8));
+        std::vector<KTX::u8> etc(transcoder->GetTranscodedLevelSize(0, eETC2RGB));
+        if (rgba.size() != 16 * 4 || etc.size() != 8 ||
+            transcoder->TranscodeLevel(0, texture->GetLevel(0), eRGBA8, rgba) != KTX::KtxResult::eSuccess ||
+            transcoder->TranscodeLevel(0, texture->GetLevel(0), eETC2RGB, etc) != KTX::KtxResult::eSuccess)
+        {
+            return false;
+        }
+        const auto decoded = DecodeBlock(VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, etc);
+        // Expanded base color 165, 132, 99 plus the modifiers -29, -9, 9 and 29
+        constexpr KTX::u8 palette[4][4] = {
+                {136, 103, 70, 255}, {156, 123, 90, 255}, {174, 141, 108, 255}, {194, 161, 128, 255}};
+        bool passed = decoded == rgba;
+        for (KTX::u32 i = 0; passed && i < 16; ++i)
+        {
+            passed = std::ranges::equal(std::span(rgba).subspan(i * 4, 4), palette[i % 4]);
+        }
+        return passed;
+    }
+
+#if defined(KTX_WITH_ZSTD) || defined(KTX_WITH_ZLIB)
+    // Supercompresses a 3 level RGBA8 texture with the writer and decompresses it through the eager load, ReadLevels
+    // on a pool and StreamLevel, which all have to give back the original levels
+    bool TestSupercompressedRoundTrip(const KTX::KtxSupercompressionScheme scheme)
+    {
+        KTX::KtxTextureInfo info{};
+        info.vkFormat = static_cast<KTX::u32>(KTX::KtxUtility_VkFormat::VK_FORMAT_R8G8B8A8_UNORM);
+        info.typeSize = 1;
+        info.baseWidth = 64;
+        info.baseHeight = 32;
+        info.baseDepth = 1;
+        info.numDimensions = 2;
+        info.numLevels = 3;
+        info.numLayers = 1;
+        info.numFaces = 1;
+
+        std::vector<KTX::u8> original;
+        std::vector<std::span<const KTX::u8>> levels;
+        std::vector<KTX::u64> levelSizes;
+        for (KTX::u32 level = 0; level < info.numLevels; ++level)
+        {
+            levelSizes.push_back(KTX::u64{64u >> level} * (32u >> level) * 4);
+        }
+        original.resize(levelSizes[0] + levelSizes[1] + levelSizes[2]);
+        for (KTX::u32 i = 0; i < original.size(); ++i)
+        {
+            // Runs of equal bytes so there is something to compress
+            original[i] = static_cast<KTX::u8>(i / 16 * 37);
+        }
+        for (KTX::u64 offset = 0; const auto size : levelSizes)
+        {
+            levels.emplace_back(original.data() + offset, size);
+            offset += size;
+        }
+
+        const KTX::KtxWriteOptions options{.superCompressionScheme = scheme};
+        const auto fileData = KTX::WriteKTX2ToMemory({.info = info, .levels = levels}, options);
+        if (!fileData)
+        {
+            return false;
+        }
+
+        const auto loaded = KTX::LoadKTXFromMemory(*fileData, KTX::KtxCreateFlags::eLoadImageData);
+        bool passed = loaded && loaded->GetInfo().superCompressionScheme == static_cast<KTX::u32>(scheme) &&
+                      std::ranges::equal(loaded->GetImageData(), original);
+
+        auto streamed = KTX::LoadKTXFromMemory(*fileData);
+        KTX::KtxThreadPool pool(2);
+        std::vector<KTX::u8> readLevels(original.size());
+        passed = passed && streamed && streamed->ReadLevels(pool, readLevels) && readLevels == original;
+        std::vector<KTX::u8> chunks;
+        std::array<KTX::u8, 1000> buffer{};
+        for (KTX::u32 level = 0; passed && level < info.numLevels; ++level)
+        {
+            passed = streamed->StreamLevel(level, buffer,
+                                           [&](const std::span<const KTX::u8> chunk)
+                                           {
+                                               chunks.insert(chunks.end(), chunk.begin(), chunk.end());
+                                               return true;
+                                           });
+        }
+        return passed && chunks == original;
+    }
+#endif
+} // namespace
 
 int main()
 {
-    KTX::LoadKTXFromFile("../Test/Assets/Default_albedo.ktx2");
-}
\ No newline at end of file
+    const auto texture = KTX::LoadKTXFromFile("../Test/Assets/Default_albedo.ktx2");
+    const auto mappedFile = KTX::MapKTXFromFile("../Test/Assets/Default_albedo.ktx2");
+
+    std::ifstream file("../Test/Assets/Default_albedo.ktx2", std::ios::binary);
+    const std::vector<KTX::u8> fileData((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const auto memoryTexture = KTX::LoadKTXFromMemory(fileData, KTX::KtxCreateFlags::eLoadImageData);
+
+    if (!TestGlFormatSize())
+    {
+        std::printf("GL format size lookup failed\n");
+        return 1;
+    }
+    if (!TestVkFormatSize())
+    {
+        std::printf("Vulkan format size lookup failed\n");
+        return 1;
+    }
+    if (!TestWriterRoundTrip())
+    {
+        std::printf("Writer round trip failed\n");
+        return 1;
+    }
+    if (!TestMipStreamer())
+    {
+        std::printf("Mip streaming failed\n");
+        return 1;
+    }
+    if (!TestDecodeHeader())
+    {
+        std::printf("Header decoding failed\n");
+        return 1;
+    }
+    if (!TestProbe())
+    {
+        std::printf("Probing failed\n");
+        return 1;
+    }
+    if (!TestLoadBatch())
+    {
+        std::printf("Batch loading failed\n");
+        return 1;
+    }
+    if (!TestMipGeneration())
+    {
+        std::printf("Mip generation failed\n");
+        return 1;
+    }
+    if (!TestKtx1EndianSwap())
+    {
+        std::printf("Ktx1 endian swap failed\n");
+        return 1;
+    }
+    if (!TestConvertKtx1())
+    {
+        std::printf("Ktx1 conversion failed\n");
+        return 1;
+    }
+    if (!TestDataFormatDescriptor())
+    {
+        std::printf("Data format descriptor parsing failed\n");
+        return 1;
+    }
+    if (!TestBc1Block())
+    {
+        std::printf("BC1 block decoding failed\n");
+        return 1;
+    }
+    if (!TestEtc1Block())
+    {
+        std::printf("ETC1 block decoding failed\n");
+        return 1;
+    }
+    if (!TestAstcVoidExtentBlock())
+    {
+        std::printf("ASTC void extent block decoding failed\n");
+        return 1;
+    }
+    if (!TestUastcTranscode())
+    {
+        std::printf("UASTC transcoding failed\n");
+        return 1;
+    }
+    if (!TestBasisLZTranscode())
+    {
+        std::printf("BasisLZ transcoding failed\n");
+        return 1;
+    }
+#if defined(KTX_WITH_ZSTD)
+    if (!TestSupercompressedRoundTrip(KTX::KtxSupercompressionScheme::eZstd))
+    {
+        std::printf("Zstd round trip failed\n");
+        return 1;
+    }
+#endif
+#if defined(KTX_WITH_ZLIB)
+    if (!TestSupercompressedRoundTrip(KTX::KtxSupercompressionScheme::eZlib))
+    {
+        std::printf("Zlib round trip failed\n");
+        return 1;
+    }
+#endif
+}